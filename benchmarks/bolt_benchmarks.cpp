@@ -0,0 +1,553 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2016, University of Colorado, Boulder
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the Univ of CO, Boulder nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+/* Author: Dave Coleman <dave@dav.ee>
+   Desc:   End-to-end Bolt benchmarks in synthetic worlds, no ROS or visualizer required. Times roadmap generation,
+           saving, loading, nearest neighbor queries, A* and complete queries in N-D boxes with hyper-box obstacles
+*/
+
+// OMPL
+#include <ompl/base/ScopedState.h>
+#include <ompl/util/Console.h>
+#include <ompl/util/Time.h>
+
+// Bolt
+#include <ompl/tools/bolt/Bolt.h>
+#include <ompl/tools/bolt/BenchmarkLog.h>
+#include <ompl/tools/bolt/SparseCriteria.h>
+#include <ompl/tools/bolt/SparseGenerator.h>
+#include <ompl/tools/bolt/SparseStorage.h>
+#include <ompl/tools/bolt/SyntheticEnvironment.h>
+
+// C++
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <limits>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace ob = ompl::base;
+namespace otb = ompl::tools::bolt;
+
+namespace
+{
+struct Options
+{
+  std::vector<std::size_t> dimensions = {2, 4, 6};
+  std::size_t numObstacles = 20;
+  double obstacleDensity = 0.2;  // fraction of the space covered by obstacles, before overlap
+  double obstacleClearance = 0.05;
+  std::size_t terminateAfterFailures = 1000;
+  std::size_t fourthCriteriaAfterFailures = 500;
+  std::size_t numQueries = 100;
+  std::size_t numNNQueries = 1000;
+  unsigned int seed = 1;
+  bool useDiscretizedSamples = true;
+  bool smoothing = true;
+  bool deterministic = false;
+  bool freeze = false;
+  bool hierarchy = false;
+  bool bidirectional = false;
+  bool coverageGrid = false;
+  otb::StateEncoding stateEncoding = otb::STATE_ENCODING_NATIVE;
+  otb::SampleSequence sampleSequence = otb::SAMPLE_SEQUENCE_RANDOM;
+  otb::BoundarySampling boundarySampling = otb::BOUNDARY_SAMPLING_NONE;
+  std::string output = "bolt_benchmarks";
+  std::string tempDirectory = "/tmp";
+};
+
+void printUsage()
+{
+  std::cout << "Usage: bolt_benchmarks [options]\n"
+            << "  --dims 2,4,6          dimensions of the synthetic box worlds\n"
+            << "  --obstacles N         number of hyper-box obstacles per world\n"
+            << "  --density F           fraction of the space covered by obstacles\n"
+            << "  --clearance F         minimum obstacle clearance of roadmap vertices\n"
+            << "  --failures N          consecutive insertion failures before generation terminates\n"
+            << "  --queries N           number of A* and end-to-end queries\n"
+            << "  --nn-queries N        number of nearest neighbor queries\n"
+            << "  --seed N              random seed for the worlds and the queries\n"
+            << "  --no-discretize       only use random samples during generation\n"
+            << "  --no-smoothing        do not smooth end-to-end query results\n"
+            << "  --deterministic       generate the same roadmaps for the same seed at any thread count\n"
+            << "  --freeze              plan the end-to-end queries on frozen, read-only graphs\n"
+            << "  --hierarchy           also contract the frozen graphs and answer A* from the hierarchy\n"
+            << "  --bidirectional       search the task and sparse graphs from both ends of each query\n"
+            << "  --coverage-grid       skip random samples in regions that recently only produced rejections\n"
+            << "  --encoding NAME       how roadmap states are saved: native, float32 or int16\n"
+            << "  --sequence NAME       what random samples are drawn from: random or halton\n"
+            << "  --boundary NAME       also sample near obstacles: none, gaussian or bridge\n"
+            << "  --output PREFIX       results are written to PREFIX.json and PREFIX.csv\n"
+            << "  --tmp DIR             where to save the generated roadmaps\n";
+}
+
+bool parseOptions(int argc, char **argv, Options &options)
+{
+  for (int i = 1; i < argc; ++i)
+  {
+    std::string arg = argv[i];
+    bool hasValue = i + 1 < argc;
+
+    if (arg == "--help" || arg == "-h")
+      return false;
+    else if (arg == "--no-discretize")
+      options.useDiscretizedSamples = false;
+    else if (arg == "--no-smoothing")
+      options.smoothing = false;
+    else if (arg == "--deterministic")
+      options.deterministic = true;
+    else if (arg == "--freeze")
+      options.freeze = true;
+    else if (arg == "--hierarchy")
+      options.freeze = options.hierarchy = true;
+    else if (arg == "--bidirectional")
+      options.bidirectional = true;
+    else if (arg == "--coverage-grid")
+      options.coverageGrid = true;
+    else if (!hasValue)
+    {
+      std::cerr << "Missing value for " << arg << std::endl;
+      return false;
+    }
+    else if (arg == "--dims")
+    {
+      options.dimensions.clear();
+      std::stringstream ss(argv[++i]);
+      std::string dim;
+      while (std::getline(ss, dim, ','))
+        options.dimensions.push_back(std::stoul(dim));
+    }
+    else if (arg == "--encoding")
+    {
+      std::string encoding = argv[++i];
+      if (encoding == "native")
+        options.stateEncoding = otb::STATE_ENCODING_NATIVE;
+      else if (encoding == "float32")
+        options.stateEncoding = otb::STATE_ENCODING_FLOAT32;
+      else if (encoding == "int16")
+        options.stateEncoding = otb::STATE_ENCODING_INT16;
+      else
+      {
+        std::cerr << "Unknown state encoding " << encoding << std::endl;
+        return false;
+      }
+    }
+    else if (arg == "--sequence")
+    {
+      std::string sequence = argv[++i];
+      if (sequence == "random")
+        options.sampleSequence = otb::SAMPLE_SEQUENCE_RANDOM;
+      else if (sequence == "halton")
+        options.sampleSequence = otb::SAMPLE_SEQUENCE_HALTON;
+      else
+      {
+        std::cerr << "Unknown sample sequence " << sequence << std::endl;
+        return false;
+      }
+    }
+    else if (arg == "--boundary")
+    {
+      std::string boundary = argv[++i];
+      if (boundary == "none")
+        options.boundarySampling = otb::BOUNDARY_SAMPLING_NONE;
+      else if (boundary == "gaussian")
+        options.boundarySampling = otb::BOUNDARY_SAMPLING_GAUSSIAN;
+      else if (boundary == "bridge")
+        options.boundarySampling = otb::BOUNDARY_SAMPLING_BRIDGE;
+      else
+      {
+        std::cerr << "Unknown boundary sampling " << boundary << std::endl;
+        return false;
+      }
+    }
+    else if (arg == "--obstacles")
+      options.numObstacles = std::stoul(argv[++i]);
+    else if (arg == "--density")
+      options.obstacleDensity = std::stod(argv[++i]);
+    else if (arg == "--clearance")
+      options.obstacleClearance = std::stod(argv[++i]);
+    else if (arg == "--failures")
+      options.terminateAfterFailures = std::stoul(argv[++i]);
+    else if (arg == "--queries")
+      options.numQueries = std::stoul(argv[++i]);
+    else if (arg == "--nn-queries")
+      options.numNNQueries = std::stoul(argv[++i]);
+    else if (arg == "--seed")
+      options.seed = std::stoul(argv[++i]);
+    else if (arg == "--output")
+      options.output = argv[++i];
+    else if (arg == "--tmp")
+      options.tempDirectory = argv[++i];
+    else
+    {
+      std::cerr << "Unknown option " << arg << std::endl;
+      return false;
+    }
+  }
+
+  options.fourthCriteriaAfterFailures = options.terminateAfterFailures / 2;
+  return true;
+}
+
+/** \brief Turn off everything that would require a GUI or slow down the benchmark */
+void configureHeadless(otb::BoltPtr bolt, const Options &options)
+{
+  otb::SparseGraphPtr sg = bolt->getSparseGraph();
+  sg->obstacleClearance_ = options.obstacleClearance;
+  sg->visualizeSparseGraph_ = false;
+  sg->visualizeGraphAfterLoading_ = false;
+  sg->visualizeGraphAfterGeneration_ = false;
+  sg->visualizeVoronoiDiagram_ = false;
+  sg->visualizeVoronoiDiagramAnimated_ = false;
+  sg->visualizeAstar_ = false;
+  sg->visualizeQualityPathSimp_ = false;
+
+  otb::SparseCriteriaPtr sc = bolt->getSparseCriteria();
+  sc->visualizeAttemptedStates_ = false;
+  sc->visualizeConnectivity_ = false;
+  sc->visualizeQualityCriteria_ = false;
+  sc->visualizeQualityCriteriaCloseReps_ = false;
+  sc->visualizeQualityCriteriaSampler_ = false;
+  sc->visualizeQualityCriteriaAstar_ = false;
+  sc->visualizeRemoveCloseVertices_ = false;
+
+  otb::SparseGeneratorPtr generator = bolt->getSparseGenerator();
+  generator->useDiscretizedSamples_ = options.useDiscretizedSamples;
+  generator->useRandomSamples_ = true;
+  generator->terminateAfterFailures_ = options.terminateAfterFailures;
+  generator->fourthCriteriaAfterFailures_ = options.fourthCriteriaAfterFailures;
+  generator->saveInterval_ = std::numeric_limits<std::size_t>::max();
+  generator->deterministic_ = options.deterministic;
+  generator->seed_ = options.seed;
+  generator->useCoverageGrid_ = options.coverageGrid;
+  generator->sampleSequence_ = options.sampleSequence;
+  generator->boundarySampling_ = options.boundarySampling;
+
+  sg->getSparseStorage()->stateEncoding_ = options.stateEncoding;
+
+  otb::TaskGraphPtr tg = bolt->getTaskGraph();
+  tg->visualizeAstar_ = false;
+  tg->visualizeTaskGraph_ = false;
+  tg->visualizeCartPath_ = false;
+  tg->verbose_ = false;
+
+  bolt->getBoltPlanner()->enableSmoothing(options.smoothing);
+  bolt->visualizeRawTrajectory_ = false;
+  bolt->visualizeSmoothTrajectory_ = false;
+  bolt->visualizeRobotTrajectory_ = false;
+}
+
+std::size_t fileSize(const std::string &filePath)
+{
+  std::ifstream file(filePath.c_str(), std::ios::binary | std::ios::ate);
+  return file.is_open() ? static_cast<std::size_t>(file.tellg()) : 0;
+}
+
+/** \brief Pick two roadmap vertices that are connected, so that every query has a solution */
+bool chooseConnectedPair(otb::SparseGraphPtr sg, std::mt19937 &generator, otb::SparseVertex &start,
+                         otb::SparseVertex &goal)
+{
+  std::uniform_int_distribution<std::size_t> vertexDist(sg->getNumQueryVertices(), sg->getNumVertices() - 1);
+  for (std::size_t attempt = 0; attempt < 1000; ++attempt)
+  {
+    start = vertexDist(generator);
+    goal = vertexDist(generator);
+    if (start != goal && sg->sameComponent(start, goal))
+      return true;
+  }
+  return false;
+}
+
+void benchmarkEnvironment(const otb::SyntheticEnvironment &env, const Options &options, otb::BenchmarkLog &log)
+{
+  std::size_t indent = 0;
+  BOLT_INFO(indent, true, "Benchmarking environment " << env.name_ << " with obstacle density "
+                                                      << env.obstacleDensity_);
+  log.addValue(env.name_, "obstacle_density", env.obstacleDensity_, "fraction");
+
+  const std::string filePath = options.tempDirectory + "/bolt_benchmark_" + env.name_;
+  std::mt19937 generator(options.seed);
+
+  // Generation -------------------------------------------------------------------------
+  {
+    otb::BoltPtr bolt(new otb::Bolt(env.si_));
+    configureHeadless(bolt, options);
+    bolt->setFilePath(filePath);
+    bolt->setup();
+
+    ompl::time::point startTime = ompl::time::now();
+    bolt->getSparseGenerator()->createSPARS();
+    log.addValue(env.name_, "generation", ompl::time::seconds(ompl::time::now() - startTime), "seconds");
+
+    otb::SparseGraphPtr sg = bolt->getSparseGraph();
+    log.addValue(env.name_, "vertices", sg->getNumRealVertices());
+    log.addValue(env.name_, "edges", sg->getNumEdges());
+    log.addValue(env.name_, "connected_components", sg->getDisjointSetsCount());
+
+    // Where generation time went, summed over all threads
+    otb::GenerationProfilerPtr profiler = sg->getProfiler();
+    for (std::size_t i = 0; i < otb::NUM_PROFILE_PHASES; ++i)
+    {
+      const otb::ProfilePhase phase = static_cast<otb::ProfilePhase>(i);
+      log.addValue(env.name_, "generation_" + otb::GenerationProfiler::getPhaseName(phase),
+                   profiler->getPhase(phase).total_, "seconds");
+    }
+    for (std::size_t i = 0; i < otb::NUM_PROFILE_COUNTERS; ++i)
+    {
+      const otb::ProfileCounter counter = static_cast<otb::ProfileCounter>(i);
+      log.addValue(env.name_, "generation_" + otb::GenerationProfiler::getCounterName(counter),
+                   profiler->getCounter(counter));
+    }
+
+    // Every collision check of this Bolt instance was made during generation
+    const otb::CollisionCheckSnapshot checks = sg->getCollisionCheckCounter()->getSnapshot();
+    log.addValue(env.name_, "generation_state_checks", checks.getStateChecks());
+    log.addValue(env.name_, "generation_motion_checks", checks.getMotionChecks());
+
+    // Memory of the generated roadmap
+    const otb::MemoryReport memory = sg->getMemoryReport();
+    for (std::size_t i = 0; i < otb::NUM_MEMORY_COMPONENTS; ++i)
+    {
+      const otb::MemoryComponent component = static_cast<otb::MemoryComponent>(i);
+      log.addValue(env.name_, "memory_" + otb::MemoryReport::getComponentName(component), memory.get(component),
+                   "bytes");
+    }
+    log.addValue(env.name_, "memory_total", memory.getTotal(), "bytes");
+    log.addValue(env.name_, "generation_checks_per_vertex",
+                 (checks.getStateChecks() + checks.getMotionChecks()) / double(std::max(1u, sg->getNumRealVertices())));
+
+    startTime = ompl::time::now();
+    sg->save();
+    log.addValue(env.name_, "save", ompl::time::seconds(ompl::time::now() - startTime), "seconds");
+    log.addValue(env.name_, "file_size", fileSize(filePath + ".ompl"), "bytes");
+  }
+
+  // Loading ----------------------------------------------------------------------------
+  otb::BoltPtr bolt(new otb::Bolt(env.si_));
+  configureHeadless(bolt, options);
+  bolt->setFilePath(filePath);
+  bolt->setup();
+
+  ompl::time::point startTime = ompl::time::now();
+  if (!bolt->load())
+  {
+    OMPL_ERROR("Unable to load generated roadmap for %s", env.name_.c_str());
+    return;
+  }
+  log.addValue(env.name_, "load", ompl::time::seconds(ompl::time::now() - startTime), "seconds");
+
+  otb::SparseGraphPtr sg = bolt->getSparseGraph();
+  const std::size_t threadID = 0;
+
+  // Nearest neighbors ------------------------------------------------------------------
+  {
+    ob::StateSamplerPtr sampler = env.si_->allocStateSampler();
+    ob::State *state = env.si_->allocState();
+    std::vector<otb::SparseVertex> neighbors;
+    std::vector<double> nearestKTimes;
+    std::vector<double> nearestRTimes;
+    const std::size_t k = 10;
+    const double radius = bolt->getSparseCriteria()->getSparseDelta();
+
+    for (std::size_t i = 0; i < options.numNNQueries; ++i)
+    {
+      sampler->sampleUniform(state);
+      sg->getQueryStateNonConst(threadID) = state;
+
+      ompl::time::point queryStart = ompl::time::now();
+      sg->getNN()->nearestK(sg->getQueryVertices(threadID), k, neighbors);
+      nearestKTimes.push_back(ompl::time::seconds(ompl::time::now() - queryStart));
+
+      queryStart = ompl::time::now();
+      sg->getNN()->nearestR(sg->getQueryVertices(threadID), radius, neighbors);
+      nearestRTimes.push_back(ompl::time::seconds(ompl::time::now() - queryStart));
+
+      sg->getQueryStateNonConst(threadID) = nullptr;
+    }
+    env.si_->freeState(state);
+
+    log.addSamples(env.name_, "nn_nearest_k10", nearestKTimes);
+    log.addSamples(env.name_, "nn_nearest_r_sparse_delta", nearestRTimes);
+  }
+
+  // A* search on the sparse graph ------------------------------------------------------
+  {
+    std::vector<double> astarTimes;
+    std::vector<double> pathLengths;
+    std::vector<otb::SparseVertex> vertexPath;
+    for (std::size_t i = 0; i < options.numQueries; ++i)
+    {
+      otb::SparseVertex start, goal;
+      if (!chooseConnectedPair(sg, generator, start, goal))
+        break;
+
+      double distance;
+      ompl::time::point queryStart = ompl::time::now();
+      sg->astarSearch(start, goal, vertexPath, distance, indent);
+      astarTimes.push_back(ompl::time::seconds(ompl::time::now() - queryStart));
+      pathLengths.push_back(vertexPath.size());
+    }
+    log.addSamples(env.name_, "astar_search", astarTimes);
+    log.addSamples(env.name_, "astar_path_vertices", pathLengths, "count");
+  }
+
+  // End-to-end queries through the Bolt planner ----------------------------------------
+  {
+    startTime = ompl::time::now();
+    bolt->getTaskGraph()->generateTaskSpace(indent);
+    log.addValue(env.name_, "task_graph_generation", ompl::time::seconds(ompl::time::now() - startTime), "seconds");
+    log.addValue(env.name_, "task_graph_memory_total", bolt->getTaskGraph()->getMemoryReport().getTotal(), "bytes");
+
+    if (options.freeze)
+    {
+      startTime = ompl::time::now();
+      bolt->freeze();
+      log.addValue(env.name_, "freeze", ompl::time::seconds(ompl::time::now() - startTime), "seconds");
+      log.addValue(env.name_, "task_graph_memory_frozen", bolt->getTaskGraph()->getMemoryReport().getTotal(),
+                   "bytes");
+      log.addValue(env.name_, "sparse_graph_memory_frozen", sg->getMemoryReport().getTotal(), "bytes");
+    }
+
+    if (options.hierarchy)
+    {
+      startTime = ompl::time::now();
+      bolt->getTaskGraph()->buildHierarchy(indent);
+      sg->buildHierarchy(indent);
+      log.addValue(env.name_, "build_hierarchy", ompl::time::seconds(ompl::time::now() - startTime), "seconds");
+      log.addValue(env.name_, "task_graph_shortcuts", bolt->getTaskGraph()->getHierarchy().getNumShortcuts(),
+                   "count");
+      log.addValue(env.name_, "sparse_graph_shortcuts", sg->getHierarchy().getNumShortcuts(), "count");
+      log.addValue(env.name_, "task_graph_memory_hierarchy", bolt->getTaskGraph()->getMemoryReport().getTotal(),
+                   "bytes");
+    }
+
+    bolt->getTaskGraph()->bidirectionalSearch_ = options.bidirectional;
+    sg->bidirectionalSearch_ = options.bidirectional;
+
+    std::vector<double> queryTimes;
+    std::size_t numSolved = 0;
+    std::size_t numNodesClosed = 0;
+    for (std::size_t i = 0; i < options.numQueries; ++i)
+    {
+      otb::SparseVertex start, goal;
+      if (!chooseConnectedPair(sg, generator, start, goal))
+        break;
+
+      ob::ScopedState<> startState(env.space_, sg->getState(start));
+      ob::ScopedState<> goalState(env.space_, sg->getState(goal));
+      bolt->clear();
+      bolt->setStartAndGoalStates(startState, goalState);
+
+      startTime = ompl::time::now();
+      ob::PlannerStatus status = bolt->solve(10.0);
+      queryTimes.push_back(ompl::time::seconds(ompl::time::now() - startTime));
+      numNodesClosed += bolt->getTaskGraph()->getNumNodesClosed();
+
+      if (status == ob::PlannerStatus::EXACT_SOLUTION)
+        numSolved++;
+    }
+    log.addSamples(env.name_, "query", queryTimes);
+    log.addValue(env.name_, "queries_solved", numSolved);
+    log.addValue(env.name_, "query_task_nodes_closed",
+                 numNodesClosed / double(std::max<std::size_t>(1, queryTimes.size())));
+
+    const otb::CollisionCheckSnapshot &checks = bolt->getSolvedQueryCollisionChecks();
+    log.addValue(env.name_, "query_checks_per_solved_query",
+                 (checks.getStateChecks() + checks.getMotionChecks()) / double(std::max<std::size_t>(1, numSolved)));
+
+    // Tail latency of each query phase
+    for (std::size_t i = 0; i < otb::NUM_QUERY_PHASES; ++i)
+    {
+      const otb::QueryPhase phase = static_cast<otb::QueryPhase>(i);
+      const otb::LatencyHistogram histogram = bolt->getQueryLog()->getHistogram(phase);
+      const std::string name = "query_" + otb::QueryLog::getPhaseName(phase);
+      log.addValue(env.name_, name + "_p50", histogram.getPercentile(0.5), "seconds");
+      log.addValue(env.name_, name + "_p99", histogram.getPercentile(0.99), "seconds");
+      log.addValue(env.name_, name + "_p999", histogram.getPercentile(0.999), "seconds");
+    }
+  }
+}
+}  // namespace
+
+int main(int argc, char **argv)
+{
+  Options options;
+  if (!parseOptions(argc, argv, options))
+  {
+    printUsage();
+    return 1;
+  }
+
+  ompl::msg::setLogLevel(ompl::msg::LOG_WARN);
+
+  otb::BenchmarkLog log("bolt_benchmarks");
+  log.setParameter("seed", std::to_string(options.seed));
+  log.setParameter("obstacles", std::to_string(options.numObstacles));
+  log.setParameter("density", std::to_string(options.obstacleDensity));
+  log.setParameter("clearance", std::to_string(options.obstacleClearance));
+  log.setParameter("terminate_after_failures", std::to_string(options.terminateAfterFailures));
+  log.setParameter("queries", std::to_string(options.numQueries));
+  log.setParameter("smoothing", options.smoothing ? "true" : "false");
+  log.setParameter("deterministic", options.deterministic ? "true" : "false");
+  log.setParameter("freeze", options.freeze ? "true" : "false");
+  log.setParameter("hierarchy", options.hierarchy ? "true" : "false");
+  log.setParameter("bidirectional", options.bidirectional ? "true" : "false");
+  log.setParameter("coverage_grid", options.coverageGrid ? "true" : "false");
+  const char *encodingNames[] = {"native", "float32", "int16"};
+  log.setParameter("encoding", encodingNames[options.stateEncoding]);
+  const char *sequenceNames[] = {"random", "halton"};
+  log.setParameter("sequence", sequenceNames[options.sampleSequence]);
+  const char *boundaryNames[] = {"none", "gaussian", "bridge"};
+  log.setParameter("boundary", boundaryNames[options.boundarySampling]);
+
+  for (std::size_t dim : options.dimensions)
+  {
+    // Size each obstacle so that together they cover the requested fraction of the space
+    const double obstacleWidth = std::pow(options.obstacleDensity / options.numObstacles, 1.0 / dim);
+
+    otb::SyntheticEnvironment env =
+        otb::createHyperBoxEnvironment(dim, options.numObstacles, obstacleWidth, options.seed + dim);
+    benchmarkEnvironment(env, options, log);
+  }
+
+  log.print();
+  log.writeJSON(options.output + ".json");
+  log.writeCSV(options.output + ".csv");
+
+  return 0;
+}
@@ -0,0 +1,693 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2016, University of Colorado, Boulder
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the Univ of CO, Boulder nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+/* Author: Dave Coleman <dave@dav.ee>
+   Desc:   Microbenchmarks of the SparseGraph hot paths, isolated from collision checking by running in obstacle-free
+           unit hypercubes. Reports addVertex, addEdge, nearestR, sameComponent, getInterfaceData and astarSearch per
+           call and per million calls
+*/
+
+// OMPL
+#include <ompl/base/StateValidityChecker.h>
+#include <ompl/base/spaces/RealVectorStateSpace.h>
+#include <ompl/util/Console.h>
+#include <ompl/util/RandomNumbers.h>
+#include <ompl/util/Time.h>
+
+// Bolt
+#include <ompl/tools/bolt/Bolt.h>
+#include <ompl/tools/bolt/BenchmarkLog.h>
+#include <ompl/tools/bolt/CacheMissCounter.h>
+#include <ompl/tools/bolt/DistanceKernels.h>
+#include <ompl/tools/bolt/MotionCache.h>
+#include <ompl/tools/bolt/NearestNeighborsRealVector.h>
+#include <ompl/tools/bolt/SparseCriteria.h>
+#include <ompl/tools/bolt/StatePool.h>
+#include <ompl/tools/bolt/VertexOrdering.h>
+#include <ompl/tools/bolt/WorkspaceIndex.h>
+
+// Boost
+#include <boost/graph/connected_components.hpp>
+
+// C++
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace ob = ompl::base;
+namespace otb = ompl::tools::bolt;
+
+namespace
+{
+struct Options
+{
+  std::vector<std::size_t> sizes = {1000, 10000, 100000};
+  std::vector<std::size_t> dimensions = {2, 6};
+  std::vector<otb::NearestNeighborsType> nnTypes = {otb::NN_GNAT};
+  std::vector<otb::VertexOrder> orders;  // vertex orders A* is repeated in, applied one after the other
+  std::size_t degree = 4;             // nearest neighbors each vertex is connected to
+  std::size_t numOperations = 10000;  // for the query-style primitives
+  std::size_t numSearches = 100;
+  std::size_t numLandmarks = 16;  // for the A* heuristic, zero for the straight line distance only
+  std::size_t batchSize = 1000;  // calls per timer reading, keeps timer overhead out of the results
+  bool fourthCriteria = false;   // addVertex() also clears nearby interface data
+  unsigned int seed = 1;
+  std::string output = "bolt_microbenchmarks";
+};
+
+void printUsage()
+{
+  std::cout << "Usage: bolt_microbenchmarks [options]\n"
+            << "  --sizes 1000,10000    number of roadmap vertices, up to 10000000\n"
+            << "  --dims 2,6            dimensions of the unit hypercube the roadmap lives in\n"
+            << "  --nn gnat,kdtree      nearest neighbor structures to compare: gnat, kdtree, linear, kdtree_f32,\n"
+            << "                        linear_f32\n"
+            << "  --degree N            nearest neighbors each vertex is connected to\n"
+            << "  --ops N               number of nearestR, sameComponent and getInterfaceData calls\n"
+            << "  --searches N          number of A* searches\n"
+            << "  --landmarks N         landmarks of the A* heuristic, 0 for the straight line distance only\n"
+            << "  --batch N             calls timed together, per-call times are batch averages\n"
+            << "  --orders hilbert,bfs  renumber the vertices in each order in turn and repeat the A* searches:\n"
+            << "                        insertion, hilbert, bfs. Insertion only means the original order first\n"
+            << "  --fourth-criteria     enable the fourth criteria so addVertex() clears interface data\n"
+            << "  --seed N              random seed\n"
+            << "  --output PREFIX       results are written to PREFIX.json and PREFIX.csv\n";
+}
+
+std::vector<std::size_t> parseList(const std::string &text)
+{
+  std::vector<std::size_t> values;
+  std::stringstream ss(text);
+  std::string value;
+  while (std::getline(ss, value, ','))
+    values.push_back(std::stoul(value));
+  return values;
+}
+
+bool parseNearestNeighborsTypes(const std::string &text, std::vector<otb::NearestNeighborsType> &types)
+{
+  types.clear();
+  std::stringstream stream(text);
+  std::string item;
+  while (std::getline(stream, item, ','))
+  {
+    if (item == "gnat")
+      types.push_back(otb::NN_GNAT);
+    else if (item == "kdtree")
+      types.push_back(otb::NN_KDTREE);
+    else if (item == "linear")
+      types.push_back(otb::NN_LINEAR);
+    else if (item == "kdtree_f32")
+      types.push_back(otb::NN_KDTREE_FLOAT);
+    else if (item == "linear_f32")
+      types.push_back(otb::NN_LINEAR_FLOAT);
+    else
+    {
+      std::cerr << "Unknown nearest neighbor type " << item << std::endl;
+      return false;
+    }
+  }
+  return !types.empty();
+}
+
+bool parseVertexOrders(const std::string &text, std::vector<otb::VertexOrder> &orders)
+{
+  orders.clear();
+  std::stringstream stream(text);
+  std::string item;
+  while (std::getline(stream, item, ','))
+  {
+    otb::VertexOrder order;
+    if (!otb::parseVertexOrder(item, order))
+    {
+      std::cerr << "Unknown vertex order " << item << std::endl;
+      return false;
+    }
+    orders.push_back(order);
+  }
+  return true;
+}
+
+bool parseOptions(int argc, char **argv, Options &options)
+{
+  for (int i = 1; i < argc; ++i)
+  {
+    std::string arg = argv[i];
+    bool hasValue = i + 1 < argc;
+
+    if (arg == "--help" || arg == "-h")
+      return false;
+    else if (arg == "--fourth-criteria")
+      options.fourthCriteria = true;
+    else if (!hasValue)
+    {
+      std::cerr << "Missing value for " << arg << std::endl;
+      return false;
+    }
+    else if (arg == "--sizes")
+      options.sizes = parseList(argv[++i]);
+    else if (arg == "--dims")
+      options.dimensions = parseList(argv[++i]);
+    else if (arg == "--nn")
+    {
+      if (!parseNearestNeighborsTypes(argv[++i], options.nnTypes))
+        return false;
+    }
+    else if (arg == "--orders")
+    {
+      if (!parseVertexOrders(argv[++i], options.orders))
+        return false;
+    }
+    else if (arg == "--degree")
+      options.degree = std::stoul(argv[++i]);
+    else if (arg == "--ops")
+      options.numOperations = std::stoul(argv[++i]);
+    else if (arg == "--searches")
+      options.numSearches = std::stoul(argv[++i]);
+    else if (arg == "--landmarks")
+      options.numLandmarks = std::stoul(argv[++i]);
+    else if (arg == "--batch")
+      options.batchSize = std::max<std::size_t>(1, std::stoul(argv[++i]));
+    else if (arg == "--seed")
+      options.seed = std::stoul(argv[++i]);
+    else if (arg == "--output")
+      options.output = argv[++i];
+    else
+    {
+      std::cerr << "Unknown option " << arg << std::endl;
+      return false;
+    }
+  }
+  return true;
+}
+
+/**
+ * \brief Time a primitive in batches and record both the per-call distribution and the cost per million calls
+ * \param op - called with the index of the operation, 0 to numOperations - 1
+ */
+template <typename Operation>
+void timeOperation(otb::BenchmarkLog &log, const std::string &environment, const std::string &metric,
+                   std::size_t numOperations, std::size_t batchSize, Operation op)
+{
+  std::vector<double> perCall;
+  perCall.reserve(numOperations / batchSize + 1);
+  double total = 0;
+
+  for (std::size_t i = 0; i < numOperations; i += batchSize)
+  {
+    const std::size_t end = std::min(numOperations, i + batchSize);
+
+    ompl::time::point startTime = ompl::time::now();
+    for (std::size_t j = i; j < end; ++j)
+      op(j);
+    const double duration = ompl::time::seconds(ompl::time::now() - startTime);
+
+    total += duration;
+    perCall.push_back(duration / (end - i));
+  }
+
+  log.addSamples(environment, metric + "_per_call", perCall);
+  if (numOperations)
+    log.addValue(environment, metric + "_per_million_ops", total / numOperations * 1e6, "seconds");
+}
+
+void benchmarkGraph(std::size_t dim, std::size_t numVertices, otb::NearestNeighborsType nnType,
+                    const Options &options, otb::BenchmarkLog &log)
+{
+  std::stringstream name;
+  name << "unit" << dim << "d_" << numVertices << "v";
+  if (options.nnTypes.size() > 1)
+    name << "_" << otb::getNearestNeighborsName(nnType);
+  const std::string env = name.str();
+  std::size_t indent = 0;
+  BOLT_INFO(indent, true, "Benchmarking roadmap " << env);
+
+  // Free space everywhere, so that nothing but the graph itself is measured
+  ob::RealVectorStateSpace *rvSpace = new ob::RealVectorStateSpace(dim);
+  rvSpace->setBounds(0.0, 1.0);
+  ob::StateSpacePtr space(rvSpace);
+  ob::SpaceInformationPtr si(new ob::SpaceInformation(space));
+  si->setStateValidityChecker(ob::StateValidityCheckerPtr(new ob::AllValidStateValidityChecker(si)));
+  si->setup();
+
+  otb::BoltPtr bolt(new otb::Bolt(si));
+  bolt->getSparseGraph()->visualizeGraphAfterLoading_ = false;
+  bolt->getSparseGraph()->savingEnabled_ = false;
+  bolt->setup();
+  bolt->getSparseCriteria()->setUseFourthCriteria(options.fourthCriteria);
+
+  otb::SparseGraphPtr sg = bolt->getSparseGraph();
+  sg->setNearestNeighborsType(nnType);
+  const std::size_t threadID = 0;
+  std::mt19937 generator(options.seed);
+
+  // Sample all states up front so only the insertion is timed
+  ob::StateSamplerPtr sampler = si->allocStateSampler();
+  std::vector<ob::State *> states(numVertices);
+  for (ob::State *&state : states)
+  {
+    state = si->allocState();
+    sampler->sampleUniform(state);
+  }
+
+  // Candidate states, of which most are rejected and freed again -------------------------
+  {
+    otb::StatePool pool(si, 1);
+    timeOperation(log, env, "alloc_free_state", options.numOperations, options.batchSize, [&](std::size_t)
+                  {
+                    si->freeState(si->allocState());
+                  });
+    timeOperation(log, env, "alloc_free_state_pooled", options.numOperations, options.batchSize, [&](std::size_t)
+                  {
+                    pool.freeState(pool.allocState());
+                  });
+  }
+
+  // addVertex ---------------------------------------------------------------------------
+  std::vector<otb::SparseVertex> vertices(numVertices);
+  timeOperation(log, env, "add_vertex", numVertices, options.batchSize, [&](std::size_t i)
+                {
+                  vertices[i] = sg->addVertex(states[i], otb::COVERAGE, indent);
+                });
+
+  // Choose edges between nearest neighbors, each undirected pair once --------------------
+  std::vector<std::pair<otb::SparseVertex, otb::SparseVertex> > edges;
+  edges.reserve(numVertices * options.degree);
+  {
+    std::vector<otb::SparseVertex> neighbors;
+    for (otb::SparseVertex v : vertices)
+    {
+      sg->getNN()->nearestK(v, options.degree + 1, neighbors);
+      for (otb::SparseVertex u : neighbors)
+        if (u > v)
+          edges.push_back(std::make_pair(v, u));
+    }
+  }
+
+  // addEdge -----------------------------------------------------------------------------
+  timeOperation(log, env, "add_edge", edges.size(), options.batchSize, [&](std::size_t i)
+                {
+                  sg->addEdge(edges[i].first, edges[i].second, otb::eQUALITY, indent);
+                });
+
+  log.addValue(env, "vertices", sg->getNumRealVertices());
+  log.addValue(env, "edges", sg->getNumEdges());
+
+  // Landmarks for the A* heuristic, as computed after generation ---------------------------
+  {
+    sg->numLandmarks_ = options.numLandmarks;
+    ompl::time::point startTime = ompl::time::now();
+    sg->computeLandmarks(indent);
+    log.addValue(env, "compute_landmarks", ompl::time::seconds(ompl::time::now() - startTime), "seconds");
+  }
+
+  std::uniform_int_distribution<std::size_t> vertexDist(0, numVertices - 1);
+
+  // nearestR through getNN() ------------------------------------------------------------
+  {
+    std::vector<ob::State *> queries(options.numOperations);
+    for (ob::State *&state : queries)
+    {
+      state = si->allocState();
+      sampler->sampleUniform(state);
+    }
+
+    const double radius = bolt->getSparseCriteria()->getSparseDelta();
+    std::vector<otb::SparseVertex> neighbors;
+    std::size_t numFound = 0;
+    timeOperation(log, env, "nearest_r", queries.size(), options.batchSize, [&](std::size_t i)
+                  {
+                    sg->getQueryStateNonConst(threadID) = queries[i];
+                    sg->getNN()->nearestR(sg->getQueryVertices(threadID), radius, neighbors);
+                    numFound += neighbors.size();
+                  });
+    log.addValue(env, "nearest_r_mean_results", numFound / double(std::max<std::size_t>(1, queries.size())));
+
+    const std::size_t k = options.degree + 1;
+    timeOperation(log, env, "nearest_k", queries.size(), options.batchSize, [&](std::size_t i)
+                  {
+                    sg->getQueryStateNonConst(threadID) = queries[i];
+                    sg->getNN()->nearestK(sg->getQueryVertices(threadID), k, neighbors);
+                  });
+
+    // Cross-check a few queries against a brute force scan, so a faster structure can't be a wrong one
+    std::size_t numMismatches = 0;
+    std::vector<double> distances(numVertices);
+    for (std::size_t i = 0; i < std::min<std::size_t>(queries.size(), 100); ++i)
+    {
+      for (std::size_t j = 0; j < numVertices; ++j)
+        distances[j] = si->distance(queries[i], states[j]);
+      const std::size_t numInRadius = std::count_if(distances.begin(), distances.end(), [&](double distance)
+                                                    {
+                                                      return distance <= radius;
+                                                    });
+      std::nth_element(distances.begin(), distances.begin() + std::min(k, numVertices) - 1, distances.end());
+      const double kthDistance = distances[std::min(k, numVertices) - 1];
+
+      sg->getQueryStateNonConst(threadID) = queries[i];
+      sg->getNN()->nearestR(sg->getQueryVertices(threadID), radius, neighbors);
+      if (neighbors.size() != numInRadius)
+        numMismatches++;
+      sg->getNN()->nearestK(sg->getQueryVertices(threadID), k, neighbors);
+      if (neighbors.size() != std::min(k, numVertices) ||
+          std::abs(sg->distanceFunction(sg->getQueryVertices(threadID), neighbors.back()) - kthDistance) > 1e-9)
+        numMismatches++;
+    }
+    sg->getQueryStateNonConst(threadID) = nullptr;
+    log.addValue(env, "nearest_mismatches", numMismatches);
+
+    for (ob::State *state : queries)
+      si->freeState(state);
+  }
+
+  // distanceFunction ---------------------------------------------------------------------
+  {
+    std::vector<std::pair<otb::SparseVertex, otb::SparseVertex> > pairs(options.numOperations);
+    for (auto &pair : pairs)
+      pair = std::make_pair(vertices[vertexDist(generator)], vertices[vertexDist(generator)]);
+
+    double sum = 0;
+    timeOperation(log, env, "distance_function", pairs.size(), options.batchSize, [&](std::size_t i)
+                  {
+                    sum += sg->distanceFunction(pairs[i].first, pairs[i].second);
+                  });
+    log.addValue(env, "distance_function_mean", sum / std::max<std::size_t>(1, pairs.size()));
+  }
+
+  // sameComponent -----------------------------------------------------------------------
+  {
+    std::vector<std::pair<otb::SparseVertex, otb::SparseVertex> > pairs(options.numOperations);
+    for (auto &pair : pairs)
+      pair = std::make_pair(vertices[vertexDist(generator)], vertices[vertexDist(generator)]);
+
+    std::size_t numSame = 0;
+    timeOperation(log, env, "same_component", pairs.size(), options.batchSize, [&](std::size_t i)
+                  {
+                    numSame += sg->sameComponent(pairs[i].first, pairs[i].second);
+                  });
+    log.addValue(env, "same_component_fraction", numSame / double(std::max<std::size_t>(1, pairs.size())),
+                 "fraction");
+    log.addValue(env, "connected_components", sg->getDisjointSetsCount());
+  }
+
+  // getInterfaceData --------------------------------------------------------------------
+  {
+    // A vertex and two of its neighbors, as used by the fourth criteria
+    struct Triple
+    {
+      otb::SparseVertex v, vp, vpp;
+    };
+    std::vector<Triple> triples;
+    triples.reserve(options.numOperations);
+    for (std::size_t attempt = 0; triples.size() < options.numOperations && attempt < 10 * options.numOperations;
+         ++attempt)
+    {
+      otb::SparseVertex v = vertices[vertexDist(generator)];
+      if (boost::out_degree(v, sg->getGraph()) < 2)
+        continue;
+
+      otb::SparseAdjList::adjacency_iterator adj = boost::adjacent_vertices(v, sg->getGraph()).first;
+      Triple triple;
+      triple.v = v;
+      triple.vp = *adj++;
+      triple.vpp = *adj;
+      triples.push_back(triple);
+    }
+
+    timeOperation(log, env, "get_interface_data", triples.size(), options.batchSize, [&](std::size_t i)
+                  {
+                    sg->getInterfaceData(triples[i].v, triples[i].vp, triples[i].vpp, indent);
+                  });
+  }
+
+  // astarSearch -------------------------------------------------------------------------
+  {
+    std::vector<std::pair<otb::SparseVertex, otb::SparseVertex> > pairs;
+    for (std::size_t attempt = 0; pairs.size() < options.numSearches && attempt < 100 * options.numSearches;
+         ++attempt)
+    {
+      otb::SparseVertex start = vertices[vertexDist(generator)];
+      otb::SparseVertex goal = vertices[vertexDist(generator)];
+      if (start != goal && sg->sameComponent(start, goal))
+        pairs.push_back(std::make_pair(start, goal));
+    }
+
+    // Searches are slow enough to be timed individually
+    std::vector<otb::SparseVertex> vertexPath;
+    double distance;
+    otb::CacheMissCounter cacheMisses;
+    cacheMisses.start();
+    std::size_t numNodesClosed = 0;
+    timeOperation(log, env, "astar_search", pairs.size(), 1, [&](std::size_t i)
+                  {
+                    sg->astarSearch(pairs[i].first, pairs[i].second, vertexPath, distance, indent);
+                    numNodesClosed += sg->getNumNodesClosed();
+                  });
+    log.addValue(env, "astar_nodes_closed", numNodesClosed / double(std::max<std::size_t>(1, pairs.size())));
+    if (cacheMisses.isAvailable())
+      log.addValue(env, "astar_cache_misses", cacheMisses.stop() / double(std::max<std::size_t>(1, pairs.size())));
+
+    // The same searches from both ends, checking that they find paths just as short
+    std::vector<double> distances(pairs.size());
+    for (std::size_t i = 0; i < pairs.size(); ++i)
+      sg->astarSearch(pairs[i].first, pairs[i].second, vertexPath, distances[i], indent);
+    sg->bidirectionalSearch_ = true;
+    numNodesClosed = 0;
+    std::size_t numLonger = 0;
+    timeOperation(log, env, "astar_bidirectional_search", pairs.size(), 1, [&](std::size_t i)
+                  {
+                    sg->astarSearch(pairs[i].first, pairs[i].second, vertexPath, distance, indent);
+                    numNodesClosed += sg->getNumNodesClosed();
+                    if (distance > distances[i] * (1 + 1e-9))
+                      numLonger++;
+                  });
+    sg->bidirectionalSearch_ = false;
+    log.addValue(env, "astar_bidirectional_nodes_closed",
+                 numNodesClosed / double(std::max<std::size_t>(1, pairs.size())));
+    log.addValue(env, "astar_bidirectional_longer_paths", numLonger);
+
+    // The same searches after renumbering, so only the memory layout differs
+    std::vector<otb::SparseVertex> newIndex;
+    for (otb::VertexOrder order : options.orders)
+    {
+      const std::string orderName = otb::getVertexOrderName(order);
+      ompl::time::point startTime = ompl::time::now();
+      sg->reorderVertices(order, newIndex, indent);
+      log.addValue(env, "reorder_" + orderName, ompl::time::seconds(ompl::time::now() - startTime), "seconds");
+
+      for (otb::SparseVertex &v : vertices)
+        v = newIndex[v];
+      for (std::pair<otb::SparseVertex, otb::SparseVertex> &pair : pairs)
+        pair = std::make_pair(newIndex[pair.first], newIndex[pair.second]);
+
+      cacheMisses.start();
+      timeOperation(log, env, "astar_search_" + orderName, pairs.size(), 1, [&](std::size_t i)
+                    {
+                      sg->astarSearch(pairs[i].first, pairs[i].second, vertexPath, distance, indent);
+                    });
+      if (cacheMisses.isAvailable())
+        log.addValue(env, "astar_cache_misses_" + orderName,
+                     cacheMisses.stop() / double(std::max<std::size_t>(1, pairs.size())));
+    }
+  }
+
+  // Motion checks through the motion cache, repeated like the SPARS criteria repeat them ------
+  if (!edges.empty() && options.numOperations)
+  {
+    // Drawn from a pool of a quarter as many motions, so that most are checked again
+    std::uniform_int_distribution<std::size_t> poolDist(0, std::max<std::size_t>(1, options.numOperations / 4) - 1);
+    std::vector<std::pair<otb::SparseVertex, otb::SparseVertex> > motions(options.numOperations);
+    for (std::pair<otb::SparseVertex, otb::SparseVertex> &motion : motions)
+      motion = edges[poolDist(generator) % edges.size()];
+
+    timeOperation(log, env, "check_motion", motions.size(), options.batchSize, [&](std::size_t i)
+                  {
+                    si->checkMotion(sg->getState(motions[i].first), sg->getState(motions[i].second));
+                  });
+
+    sg->useMotionCache_ = true;
+    sg->getMotionCacheNonConst().resetCounters();
+    timeOperation(log, env, "check_motion_cached", motions.size(), options.batchSize, [&](std::size_t i)
+                  {
+                    sg->checkMotion(motions[i].first, motions[i].second);
+                  });
+    log.addValue(env, "motion_cache_hit_rate", sg->getMotionCache().getHitRate(), "fraction");
+
+    // Every thread looks up every motion at once, as the CandidateQueue threads would
+    const std::size_t numThreads = std::max(1u, std::thread::hardware_concurrency());
+    std::vector<std::thread> threads;
+    ompl::time::point startTime = ompl::time::now();
+    for (std::size_t t = 0; t < numThreads; ++t)
+      threads.push_back(std::thread([&]()
+                                    {
+                                      bool valid;
+                                      for (const std::pair<otb::SparseVertex, otb::SparseVertex> &motion : motions)
+                                        sg->getMotionCache().lookup(motion.first, motion.second, valid);
+                                    }));
+    for (std::thread &thread : threads)
+      thread.join();
+    log.addValue(env, "motion_cache_parallel_lookup_per_million_ops",
+                 ompl::time::seconds(ompl::time::now() - startTime) / (numThreads * motions.size()) * 1e6, "seconds");
+    sg->useMotionCache_ = false;
+  }
+
+  // Obstacle updates through the workspace index, against resetting every edge ---------------
+  {
+    // A point robot at the first three coordinates, whose straight motions sweep the box around their endpoints
+    const otb::SweptVolumeFunction sweptVolume = [dim](const ob::State *from, const ob::State *to,
+                                                       std::vector<otb::WorkspaceBox> &boxes)
+    {
+      const double *a = from->as<ob::RealVectorStateSpace::StateType>()->values;
+      const double *b = to->as<ob::RealVectorStateSpace::StateType>()->values;
+      otb::WorkspaceBox box;
+      for (std::size_t i = 0; i < 3; ++i)
+      {
+        box.low_[i] = i < dim ? std::min(a[i], b[i]) : 0.0;
+        box.high_[i] = i < dim ? std::max(a[i], b[i]) : 0.0;
+      }
+      boxes.push_back(box);
+    };
+
+    ompl::time::point startTime = ompl::time::now();
+    sg->buildWorkspaceIndex(sweptVolume, 0.05, indent);
+    log.addValue(env, "build_workspace_index", ompl::time::seconds(ompl::time::now() - startTime), "seconds");
+    log.addValue(env, "workspace_cells", sg->getWorkspaceIndex().getNumCells());
+
+    // Obstacles the size of one cell appearing anywhere in the unit cube
+    std::uniform_real_distribution<double> corner(0.0, 0.95);
+    std::vector<otb::WorkspaceBox> obstacles(std::min<std::size_t>(options.numOperations, 1000));
+    for (otb::WorkspaceBox &obstacle : obstacles)
+      for (std::size_t i = 0; i < 3; ++i)
+      {
+        obstacle.low_[i] = corner(generator);
+        obstacle.high_[i] = obstacle.low_[i] + 0.05;
+      }
+
+    otb::WorkspaceIndex index = sg->getWorkspaceIndex();
+    std::vector<otb::WorkspaceIndex::VertexPair> affected;
+    std::size_t numAffected = 0;
+    for (const otb::WorkspaceBox &obstacle : obstacles)
+    {
+      index.getEdges(obstacle, affected);
+      numAffected += affected.size();
+    }
+    log.addValue(env, "workspace_edges_per_update", numAffected / double(std::max<std::size_t>(1, obstacles.size())));
+
+    timeOperation(log, env, "invalidate_workspace", obstacles.size(), 1, [&](std::size_t i)
+                  {
+                    sg->invalidateWorkspace(obstacles[i], indent);
+                  });
+    timeOperation(log, env, "clear_edge_collision_states", obstacles.size(), 1, [&](std::size_t)
+                  {
+                    sg->clearEdgeCollisionStates();
+                  });
+  }
+
+  // removeVertex, last because it changes the graph ---------------------------------------
+  {
+    std::vector<otb::SparseVertex> removed(vertices);
+    std::shuffle(removed.begin(), removed.end(), generator);
+    removed.resize(std::min(options.numOperations, numVertices / 10));
+
+    const std::size_t relabeledBefore = sg->getConnectedComponents().getNumRelabeled();
+    timeOperation(log, env, "remove_vertex", removed.size(), options.batchSize, [&](std::size_t i)
+                  {
+                    sg->removeVertex(removed[i], indent);
+                  });
+    log.addValue(env, "remove_vertex_relabeled",
+                 (sg->getConnectedComponents().getNumRelabeled() - relabeledBefore) /
+                     double(std::max<std::size_t>(1, removed.size())));
+
+    // Cross-check against labelling the graph from scratch, skipping query and removed vertices
+    std::vector<std::size_t> component(boost::num_vertices(sg->getGraph()));
+    boost::connected_components(sg->getGraph(), &component[0]);
+    std::vector<bool> seen(component.size(), false);
+    std::size_t numComponents = 0;
+    for (otb::SparseVertex v : vertices)
+      if (sg->getState(v) != nullptr && !seen[component[v]])
+      {
+        seen[component[v]] = true;
+        numComponents++;
+      }
+    log.addValue(env, "connected_components_after_removal", sg->getDisjointSetsCount());
+    log.addValue(env, "component_mismatches", numComponents != sg->getDisjointSetsCount());
+  }
+}
+}  // namespace
+
+int main(int argc, char **argv)
+{
+  Options options;
+  if (!parseOptions(argc, argv, options))
+  {
+    printUsage();
+    return 1;
+  }
+
+  ompl::msg::setLogLevel(ompl::msg::LOG_WARN);
+  ompl::RNG::setSeed(options.seed);
+
+  otb::BenchmarkLog log("bolt_microbenchmarks");
+  log.setParameter("seed", std::to_string(options.seed));
+  log.setParameter("degree", std::to_string(options.degree));
+  std::string nnNames;
+  for (otb::NearestNeighborsType nnType : options.nnTypes)
+    nnNames += (nnNames.empty() ? "" : ",") + otb::getNearestNeighborsName(nnType);
+  log.setParameter("nearest_neighbors", nnNames);
+  log.setParameter("distance_kernel", otb::getDistanceKernels().name_);
+  log.setParameter("operations", std::to_string(options.numOperations));
+  log.setParameter("batch", std::to_string(options.batchSize));
+  log.setParameter("fourth_criteria", options.fourthCriteria ? "true" : "false");
+  log.setParameter("landmarks", std::to_string(options.numLandmarks));
+  std::string orderNames;
+  for (otb::VertexOrder order : options.orders)
+    orderNames += (orderNames.empty() ? "" : ",") + otb::getVertexOrderName(order);
+  log.setParameter("vertex_orders", orderNames);
+
+  for (std::size_t dim : options.dimensions)
+    for (std::size_t size : options.sizes)
+      for (otb::NearestNeighborsType nnType : options.nnTypes)
+        benchmarkGraph(dim, size, nnType, options, log);
+
+  log.print();
+  log.writeJSON(options.output + ".json");
+  log.writeCSV(options.output + ".csv");
+
+  return 0;
+}
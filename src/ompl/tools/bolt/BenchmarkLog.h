@@ -0,0 +1,138 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2016, University of Colorado, Boulder
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the Univ of CO, Boulder nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+/* Author: Dave Coleman <dave@dav.ee>
+   Desc:   Collects benchmark measurements and writes them in machine readable form for regression tracking
+*/
+
+#ifndef OMPL_TOOLS_BOLT_BENCHMARK_LOG_
+#define OMPL_TOOLS_BOLT_BENCHMARK_LOG_
+
+// OMPL
+#include <ompl/util/ClassForward.h>
+
+// C++
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace ompl
+{
+namespace tools
+{
+namespace bolt
+{
+/// @cond IGNORE
+OMPL_CLASS_FORWARD(BenchmarkLog);
+/// @endcond
+
+/** \class ompl::tools::bolt::BenchmarkLogPtr
+    \brief A boost shared pointer wrapper for ompl::tools::bolt::BenchmarkLog */
+
+/** \brief Summary of one measured quantity */
+struct BenchmarkRecord
+{
+  /** \brief Which world or configuration the measurement belongs to */
+  std::string environment_;
+
+  /** \brief What was measured, e.g. "astar_search" */
+  std::string metric_;
+
+  /** \brief Unit of every statistic below, e.g. "seconds" */
+  std::string unit_;
+
+  /** \brief Number of samples the statistics were computed from */
+  std::size_t count_ = 0;
+
+  double total_ = 0;
+  double mean_ = 0;
+  double min_ = 0;
+  double p50_ = 0;
+  double p90_ = 0;
+  double p99_ = 0;
+  double max_ = 0;
+};
+
+/** \brief Accumulates benchmark records and serializes them as JSON or CSV */
+class BenchmarkLog
+{
+public:
+  /** \brief Constructor
+   *  \param suite - name of the benchmark executable or suite, written into every output file
+   */
+  BenchmarkLog(const std::string &suite);
+
+  /** \brief Attach a key/value pair describing the run, e.g. the random seed */
+  void setParameter(const std::string &key, const std::string &value);
+
+  /** \brief Summarize a set of samples, such as per-call timings in seconds */
+  void addSamples(const std::string &environment, const std::string &metric, std::vector<double> samples,
+                  const std::string &unit = "seconds");
+
+  /** \brief Record a single value, such as the number of vertices in a graph */
+  void addValue(const std::string &environment, const std::string &metric, double value,
+                const std::string &unit = "count");
+
+  /** \brief Access all records */
+  const std::vector<BenchmarkRecord> &getRecords() const
+  {
+    return records_;
+  }
+
+  /** \brief Write all records as a single JSON document */
+  bool writeJSON(const std::string &filePath) const;
+
+  /** \brief Write all records as CSV with a header row */
+  bool writeCSV(const std::string &filePath) const;
+
+  /** \brief Human readable table */
+  void print(std::ostream &out = std::cout) const;
+
+private:
+  /** \brief Name of the suite */
+  std::string suite_;
+
+  /** \brief Description of the run */
+  std::map<std::string, std::string> parameters_;
+
+  /** \brief All measurements in the order they were added */
+  std::vector<BenchmarkRecord> records_;
+};
+
+}  // namespace bolt
+}  // namespace tools
+}  // namespace ompl
+
+#endif  // OMPL_TOOLS_BOLT_BENCHMARK_LOG_
@@ -0,0 +1,234 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2016, University of Colorado, Boulder
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the Univ of CO, Boulder nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+/* Author: Dave Coleman <dave@dav.ee>
+   Desc:   A* search from both ends of a query, for the mutable and the frozen graphs alike
+*/
+
+#ifndef OMPL_TOOLS_BOLT_BIDIRECTIONAL_ASTAR_
+#define OMPL_TOOLS_BOLT_BIDIRECTIONAL_ASTAR_
+
+// Bolt
+#include <ompl/tools/bolt/BoostGraphHeaders.h>
+#include <ompl/tools/bolt/CompactGraph.h>
+#include <ompl/tools/bolt/MemoryReport.h>
+
+// Boost
+#include <boost/function.hpp>
+
+// C++
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <queue>
+#include <utility>
+#include <vector>
+
+namespace ompl
+{
+namespace tools
+{
+namespace bolt
+{
+/** \brief Neighbors of \e v over edges not known to be in collision, with the edge weights */
+void getFreeNeighbors(const CompactGraph &g, std::size_t v, std::vector<std::pair<std::size_t, double> > &neighbors);
+
+template <class Graph>
+void getFreeNeighbors(const Graph &g, std::size_t v, std::vector<std::pair<std::size_t, double> > &neighbors)
+{
+  neighbors.clear();
+  typename boost::graph_traits<Graph>::out_edge_iterator e, end;
+  for (boost::tie(e, end) = boost::out_edges(v, g); e != end; ++e)
+  {
+    if (boost::get(edge_collision_state_t(), g, *e) == IN_COLLISION)
+      continue;
+    neighbors.push_back(std::make_pair(boost::target(*e, g), boost::get(boost::edge_weight, g, *e)));
+  }
+}
+
+/**
+ * \brief A* from the start and from the goal at once, meeting in the middle.
+ *
+ * Both directions use the average of the two heuristics as their potential, p(v) = (h_goal(v) - h_start(v)) / 2
+ * forwards and -p(v) backwards. The reduced edge costs are then the same in both directions, and they are
+ * non-negative whenever the heuristics are consistent. So the search can stop as soon as the two smallest keys add up
+ * to the best path found through a vertex reached from both sides, and that path is the shortest.
+ *
+ * Unlike a one directional search, this explores a ball around the start and one around the goal, which expands
+ * fewer vertices on long paths.
+ */
+class BidirectionalAstar
+{
+public:
+  /** \brief Lower bound on the cost from a vertex to the start or to the goal */
+  typedef boost::function<double(std::size_t)> HeuristicFunction;
+
+  void clear();
+
+  /**
+   * \brief Shortest path between two vertices of \e g, a boost::adjacency_list or a CompactGraph
+   * \param toGoal, toStart - heuristics towards either end
+   * \param vertexPath - filled with the vertices from \e goal back to \e start, as boost::astar_search is used, and
+   *                     left empty if the start is the goal
+   * \param nodesOpened - vertices discovered by either direction
+   * \param nodesClosed - vertices expanded by either direction
+   * \return true if the goal was reached
+   */
+  template <class Graph>
+  bool search(const Graph &g, std::size_t numVertices, std::size_t start, std::size_t goal,
+              const HeuristicFunction &toGoal, const HeuristicFunction &toStart, std::vector<std::size_t> &vertexPath,
+              double &distance, std::size_t &nodesOpened, std::size_t &nodesClosed)
+  {
+    nodesOpened = 0;
+    nodesClosed = 0;
+    prepare(numVertices);
+    const std::uint32_t REACHED = searchID_;
+    const std::uint32_t CLOSED = searchID_ + 1;
+
+    // Key and vertex, one queue per direction. Entries made stale by a cheaper path are skipped when popped
+    typedef std::pair<double, std::size_t> QueueEntry;
+    std::priority_queue<QueueEntry, std::vector<QueueEntry>, std::greater<QueueEntry> > open[2];
+    const std::size_t roots[2] = {start, goal};
+    for (std::size_t d = 0; d < 2; ++d)
+    {
+      costs_[d][roots[d]] = 0;
+      predecessors_[d][roots[d]] = roots[d];
+      visits_[d][roots[d]] = REACHED;
+      nodesOpened++;
+      open[d].push(std::make_pair(potential(roots[d], d, toGoal, toStart), roots[d]));
+    }
+
+    double best = start == goal ? 0 : std::numeric_limits<double>::infinity();
+    std::size_t meeting = start;
+    while (true)
+    {
+      const double topForward = open[0].empty() ? std::numeric_limits<double>::infinity() : open[0].top().first;
+      const double topBackward = open[1].empty() ? std::numeric_limits<double>::infinity() : open[1].top().first;
+      if (topForward + topBackward >= best)
+        break;
+
+      // Expand the direction with the smaller key, which keeps the two balls about the same size
+      const std::size_t d = topForward <= topBackward ? 0 : 1;
+      const std::size_t other = 1 - d;
+      const std::size_t v = open[d].top().second;
+      open[d].pop();
+      if (visits_[d][v] == CLOSED)  // a cheaper entry for the vertex was popped before
+        continue;
+
+      visits_[d][v] = CLOSED;
+      nodesClosed++;
+
+      getFreeNeighbors(g, v, neighbors_);
+      for (std::size_t i = 0; i < neighbors_.size(); ++i)
+      {
+        const std::size_t u = neighbors_[i].first;
+        const double cost = costs_[d][v] + neighbors_[i].second;
+        if (visits_[d][u] == REACHED || visits_[d][u] == CLOSED)
+        {
+          // Closed vertices are reopened, as in CompactGraph::astarSearch(), in case the heuristic is inconsistent
+          if (cost >= costs_[d][u])
+            continue;
+        }
+        else
+          nodesOpened++;
+
+        visits_[d][u] = REACHED;
+        costs_[d][u] = cost;
+        predecessors_[d][u] = v;
+        open[d].push(std::make_pair(cost + potential(u, d, toGoal, toStart), u));
+
+        if ((visits_[other][u] == REACHED || visits_[other][u] == CLOSED) && cost + costs_[other][u] < best)
+        {
+          best = cost + costs_[other][u];
+          meeting = u;
+        }
+      }
+    }
+
+    if (best == std::numeric_limits<double>::infinity())
+      return false;
+
+    // Trace back from the meeting vertex to the goal, then forward from the start to it, reversed
+    vertexPath.clear();
+    if (start != goal)
+    {
+      std::size_t v;
+      for (v = meeting; v != goal; v = predecessors_[1][v])
+        vertexPath.push_back(v);
+      vertexPath.push_back(goal);
+      std::reverse(vertexPath.begin(), vertexPath.end());
+      for (v = meeting; v != start; v = predecessors_[0][v])
+        vertexPath.push_back(predecessors_[0][v]);
+    }
+
+    distance = best;
+    return true;
+  }
+
+  void addToMemoryReport(MemoryReport &report) const;
+
+private:
+  /** \brief Size the scratch arrays for \e numVertices and start a new search id */
+  void prepare(std::size_t numVertices);
+
+  /** \brief Potential of \e v for direction \e d, 0 forwards and 1 backwards. Each vertex evaluates the heuristics
+   *         once per search */
+  double potential(std::size_t v, std::size_t d, const HeuristicFunction &toGoal, const HeuristicFunction &toStart)
+  {
+    if (potentialVisits_[v] != searchID_)
+    {
+      potentials_[v] = (toGoal(v) - toStart(v)) / 2;
+      potentialVisits_[v] = searchID_;
+    }
+    return d == 0 ? potentials_[v] : -potentials_[v];
+  }
+
+  /** \brief Reused between searches, one of each per direction. A vertex has been reached by the current search
+   *         when its visit equals searchID_, and closed when it equals searchID_ + 1 */
+  std::vector<double> costs_[2];
+  std::vector<std::size_t> predecessors_[2];
+  std::vector<std::uint32_t> visits_[2];
+  std::vector<double> potentials_;
+  std::vector<std::uint32_t> potentialVisits_;
+  std::uint32_t searchID_ = 0;
+
+  std::vector<std::pair<std::size_t, double> > neighbors_;
+};
+
+}  // namespace bolt
+}  // namespace tools
+}  // namespace ompl
+
+#endif  // OMPL_TOOLS_BOLT_BIDIRECTIONAL_ASTAR_
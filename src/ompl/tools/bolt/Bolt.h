@@ -44,6 +44,7 @@
 #include <ompl/tools/bolt/TaskGraph.h>
 #include <ompl/tools/debug/Visualizer.h>
 #include <ompl/tools/bolt/BoltPlanner.h>
+#include <ompl/tools/bolt/QueryLog.h>
 
 #include <ompl/base/Planner.h>
 #include <ompl/base/PlannerData.h>
@@ -106,6 +107,12 @@ public:
   /** \brief Load database from file  */
   bool load();
 
+  /** \brief For hosts that only plan: generate the task graph if needed, then freeze it and the sparse graph into
+   *         their compact read-only layout. See TaskGraph::freeze(). If the task graph is generated here, the sparse
+   *         graph is first renumbered in freezeOrder_ so the task graph inherits its locality. With buildHierarchy_
+   *         both graphs are then contracted */
+  void freeze();
+
   /** \brief Get the current planner */
   base::PlannerPtr &getPlanner()
   {
@@ -121,7 +128,7 @@ public:
   /** \brief Set the planner to use for repairing experience paths
       inside the BoltPlanner planner. If the planner is not
       set, a default planner is set. */
-  void setRepairPlanner(const base::PlannerPtr &planner)
+  void setRepairPlanner(const base::PlannerPtr & /*planner*/)
   {
     // This is required by the parent class but we no longer use this feature
     // static_cast<BoltPlanner&>(*boltPlanner_).setRepairPlanner(planner);
@@ -190,6 +197,27 @@ public:
     return sparseGenerator_;
   }
 
+  /** \brief Collision checks made by the most recent call to solve() */
+  const CollisionCheckSnapshot &getLastQueryCollisionChecks() const
+  {
+    return lastQueryChecks_;
+  }
+
+  /** \brief Collision checks summed over all queries that found an exact solution */
+  const CollisionCheckSnapshot &getSolvedQueryCollisionChecks() const
+  {
+    return solvedQueryChecks_;
+  }
+
+  /** \brief Per-query phase breakdown and latency histograms of every call to solve() */
+  QueryLogPtr getQueryLog() const
+  {
+    return queryLog_;
+  }
+
+  /** \brief Write the query log to filePath.json and filePath.csv. Safe to call from another thread */
+  bool dumpQueryLog(const std::string &filePath) const;
+
   /** \brief Allow accumlated experiences to be processed */
   bool doPostProcessing();
 
@@ -219,6 +247,13 @@ protected:
   /** \brief Location to save logging file for benchmarks */
   std::string benchmarkFilePath_;
 
+  /** \brief Collision check accounting of queries */
+  CollisionCheckSnapshot lastQueryChecks_;
+  CollisionCheckSnapshot solvedQueryChecks_;
+
+  /** \brief Structured record of every query */
+  QueryLogPtr queryLog_;
+
 public:
   /** \brief Visualize original solution from graph before smoothing */
   bool visualizeRawTrajectory_ = false;
@@ -226,6 +261,17 @@ public:
   bool visualizeSmoothTrajectory_ = true;
   bool visualizeRobotTrajectory_ = true;
 
+  /** \brief When set, the query log is written to this path (without extension) every queryLogDumpInterval_ queries */
+  std::string queryLogFilePath_;
+  std::size_t queryLogDumpInterval_ = 100;
+
+  /** \brief Order freeze() renumbers the sparse graph in, when the task graph has not been generated yet */
+  VertexOrder freezeOrder_ = ORDER_HILBERT;
+
+  /** \brief Whether freeze() also contracts both graphs, so that queries settle a few hundred vertices instead of
+   *         searching the roadmap */
+  bool buildHierarchy_ = false;
+
 };  // end of class Bolt
 
 }  // namespace bolt
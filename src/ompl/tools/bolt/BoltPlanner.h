@@ -41,6 +41,8 @@
 #include <ompl/geometric/PathGeometric.h>
 #include <ompl/geometric/PathSimplifier.h>
 #include <ompl/tools/bolt/TaskGraph.h>
+#include <ompl/tools/bolt/QueryLog.h>
+#include <ompl/tools/bolt/StatePool.h>
 #include <ompl/tools/debug/Visualizer.h>
 
 // Boost
@@ -183,6 +185,12 @@ public:
     return originalSolutionPath_;
   }
 
+  /** \brief Phase timings and search statistics of the most recent call to solve() */
+  const QueryRecord &getQueryRecord() const
+  {
+    return queryRecord_;
+  }
+
 protected:
   /** \brief The database of motions to search through */
   TaskGraphPtr taskGraph_;
@@ -196,6 +204,9 @@ protected:
   /** \brief The instance of the path simplifier */
   geometric::PathSimplifierPtr path_simplifier_;
 
+  /** \brief Copies of the start and goal states made by findGraphNeighbors() for every query */
+  StatePoolPtr statePool_;
+
   /** \brief Optionally smooth retrieved and repaired paths from database */
   bool smoothingEnabled_ = true;
 
@@ -203,6 +214,9 @@ protected:
   std::vector<bolt::TaskVertex> startVertexCandidateNeighbors_;
   std::vector<bolt::TaskVertex> goalVertexCandidateNeighbors_;
 
+  /** \brief Measurements of the query currently being solved */
+  QueryRecord queryRecord_;
+
 public:
   /** \brief Output user feedback to console */
   bool verbose_ = true;
@@ -186,8 +186,6 @@ enum EdgeCollisionState
 
    *Properties of vertices*
    - vertex_state_t:
-   - vertex_predecessor_t: Requred by incremental connected components algorithm (disjoint sets)
-   - vertex_rank_t: Requred by incremental connected components algorithm (disjoint sets)
    - vertex_type_t: The type of guard this node is
    - vertex_list_t: non interface list property?
 
@@ -203,12 +201,10 @@ enum EdgeCollisionState
 /** Wrapper for the vertex's multiple as its property. */
 // clang-format off
 typedef boost::property<vertex_state_t, base::State*, // State
-        boost::property<boost::vertex_predecessor_t, VertexIndexType, // Disjoint Sets
-        boost::property<boost::vertex_rank_t, VertexIndexType, // Disjoint Sets
         boost::property<vertex_type_t, VertexType, // Sparse Type
         boost::property<vertex_popularity_t, double, // Popularity
         boost::property<vertex_interface_data_t, InterfaceHash // Sparse meta data
-        > > > > > > SparseVertexProperties;
+        > > > > SparseVertexProperties;
 // clang-format on
 
 /** Wrapper for the double assigned to an edge as its weight property. */
@@ -445,14 +441,7 @@ public:
 };
 
 ////////////////////////////////////////////////////////////////////////////////////////
-/**
- * \brief Sparse disjoint sets structure
- */
-typedef boost::disjoint_sets<boost::property_map<SparseAdjList, boost::vertex_rank_t>::type,
-                             boost::property_map<SparseAdjList, boost::vertex_predecessor_t>::type>
-    SparseDisjointSetType;
-
-// Ability to copy the disjoint sets data into a hashtable
+// Ability to copy the connected components into a hashtable
 typedef std::map<SparseVertex, std::vector<SparseVertex> > SparseDisjointSetsMap;
 
 ////////////////////////////////////////////////////////////////////////////////////////
@@ -484,6 +473,9 @@ struct CandidateData
   // Graph version number - allow to determine if candidate was expired by time candidate was generated
   std::size_t graphVersion_;
 
+  // SparseGraph::getNeighborhoodVersion() when the neighborhoods were found, used in deterministic mode
+  std::size_t neighborhoodVersion_ = 0;
+
   // The sampled state to be added to the graph
   base::State* state_;
 
@@ -0,0 +1,161 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2016, University of Colorado, Boulder
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the Univ of CO, Boulder nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+/* Author: Dave Coleman <dave@dav.ee>
+   Desc:   Samples near obstacle boundaries, mixed with uniform samples by which criteria currently add vertices
+*/
+
+#ifndef OMPL_TOOLS_BOLT_BOUNDARY_SAMPLER_
+#define OMPL_TOOLS_BOLT_BOUNDARY_SAMPLER_
+
+// OMPL
+#include <ompl/base/SpaceInformation.h>
+#include <ompl/base/samplers/MinimumClearanceValidStateSampler.h>
+#include <ompl/util/ClassForward.h>
+
+// Bolt
+#include <ompl/tools/bolt/BoostGraphHeaders.h>
+
+// Boost
+#include <boost/noncopyable.hpp>
+
+// C++
+#include <atomic>
+
+namespace ompl
+{
+namespace tools
+{
+namespace bolt
+{
+/// @cond IGNORE
+OMPL_CLASS_FORWARD(SampleMixer);
+/// @endcond
+
+/** \class ompl::tools::bolt::SampleMixerPtr
+    \brief A boost shared pointer wrapper for ompl::tools::bolt::SampleMixer */
+
+/** \brief How samples near obstacles are found */
+enum BoundarySampling
+{
+  BOUNDARY_SAMPLING_NONE = 0,
+  BOUNDARY_SAMPLING_GAUSSIAN,  // of a uniform state and a Gaussian neighbor, the one that is valid if only one is
+  BOUNDARY_SAMPLING_BRIDGE     // the midpoint of two invalid states a Gaussian distance apart, if it is valid
+};
+
+/**
+ * \brief Minimum clearance sampler that only returns states close to the clearance boundary of the obstacles.
+ *
+ * A state counts as invalid if it is in collision or closer to an obstacle than the minimum clearance, so every
+ * sample returned is valid for the roadmap. Each pair of states drawn counts as one attempt. Bridge samples mostly
+ * land in narrow passages, Gaussian samples along every obstacle surface.
+ */
+class BoundarySampler : public base::MinimumClearanceValidStateSampler
+{
+public:
+  /** \brief \e stdDev is the standard deviation of the distance between the two states of a pair */
+  BoundarySampler(const base::SpaceInformation *si, BoundarySampling method, double stdDev);
+
+  ~BoundarySampler();
+
+  bool sample(base::State *state);
+
+private:
+  bool hasClearance(const base::State *state) const;
+
+  BoundarySampling method_;
+  double stdDev_;
+
+  /** \brief Second state of a pair, the sampler is used by a single thread */
+  base::State *pairState_;
+};
+
+/**
+ * \brief Fraction of the samples the SamplingQueue draws near obstacle boundaries.
+ *
+ * Early on the coverage criterion adds most vertices and uniform samples are what it needs. Once vertices are mostly
+ * added for connectivity or interfaces, which happens near obstacles and in narrow passages, the fraction rises. It
+ * follows a moving average over the last window_ vertices added, between minFraction_ and maxFraction_. The parent
+ * thread records additions and the sampling thread reads the fraction. When no boundary sample is found, the
+ * SamplingQueue draws a uniform one instead.
+ */
+class SampleMixer : private boost::noncopyable
+{
+public:
+  /** \brief \e stdDev is passed on to the BoundarySampler */
+  SampleMixer(BoundarySampling method, double stdDev);
+
+  BoundarySampling getMethod() const
+  {
+    return method_;
+  }
+
+  double getStdDev() const
+  {
+    return stdDev_;
+  }
+
+  /** \brief Probability that the next sample is drawn near a boundary */
+  double getBoundaryFraction() const
+  {
+    return fraction_;
+  }
+
+  /** \brief Called by the parent thread with the reason of every vertex added */
+  void recordAddition(VertexType reason);
+
+  /** \brief Return to the fraction used before any vertex was added */
+  void reset();
+
+  /** \brief Number of vertices the moving average reaches back */
+  double window_ = 100.0;
+
+  double minFraction_ = 0.05;
+  double maxFraction_ = 0.8;
+
+private:
+  BoundarySampling method_;
+  double stdDev_;
+
+  /** \brief Moving average of the share of vertices added for connectivity or interfaces */
+  double boundaryShare_ = 0.0;
+
+  std::atomic<double> fraction_;
+};
+
+}  // namespace bolt
+}  // namespace tools
+}  // namespace ompl
+
+#endif  // OMPL_TOOLS_BOLT_BOUNDARY_SAMPLER_
@@ -0,0 +1,87 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2016, University of Colorado, Boulder
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the Univ of CO, Boulder nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+/* Author: Dave Coleman <dave@dav.ee>
+   Desc:   Hardware cache miss counter for benchmarking memory layouts
+*/
+
+#ifndef OMPL_TOOLS_BOLT_CACHE_MISS_COUNTER_
+#define OMPL_TOOLS_BOLT_CACHE_MISS_COUNTER_
+
+// C++
+#include <cstdint>
+
+namespace ompl
+{
+namespace tools
+{
+namespace bolt
+{
+/**
+ * \brief Counts the last level cache misses of the calling thread between start() and stop()
+ *
+ * Uses perf_event_open() on Linux. Elsewhere, or when the kernel does not allow it (see
+ * /proc/sys/kernel/perf_event_paranoid), isAvailable() is false and stop() returns zero.
+ */
+class CacheMissCounter
+{
+public:
+  CacheMissCounter();
+
+  ~CacheMissCounter();
+
+  bool isAvailable() const
+  {
+    return fd_ >= 0;
+  }
+
+  /** \brief Reset the count and start counting */
+  void start();
+
+  /** \brief Stop counting and return the misses since start() */
+  std::uint64_t stop();
+
+private:
+  CacheMissCounter(const CacheMissCounter &);
+  CacheMissCounter &operator=(const CacheMissCounter &);
+
+  /** \brief File descriptor of the perf event, -1 if unavailable */
+  int fd_;
+};
+
+}  // namespace bolt
+}  // namespace tools
+}  // namespace ompl
+
+#endif  // OMPL_TOOLS_BOLT_CACHE_MISS_COUNTER_
@@ -45,6 +45,8 @@
 #include <ompl/tools/bolt/SamplingQueue.h>
 
 // C++
+#include <atomic>
+#include <map>
 #include <queue>
 #include <thread>
 
@@ -89,6 +91,17 @@ private:
   void generatingThread(std::size_t threadID, base::SpaceInformationPtr si, ClearanceSamplerPtr clearanceSampler,
                         std::size_t indent);
 
+  /** \brief Deterministic mode: candidate number i is drawn from stream i % numStreams, and each thread owns the
+   *         streams congruent to its index modulo the number of threads */
+  void deterministicThread(std::size_t threadID, std::vector<ClearanceSamplerPtr> streamSamplers, std::size_t indent);
+
+  /** \brief Deterministic mode: wait for the next candidate in sequence and find its neighbors again if the graph
+   *         changed since they were found */
+  CandidateData &getNextDeterministicCandidate(std::size_t indent);
+
+  /** \brief Whether the graph changed since the neighbors of a candidate were found */
+  bool isExpired(const CandidateData &candidateD);
+
   /** \brief Do not add more states if queue is full */
   void waitForQueueNotFull(std::size_t indent);
 
@@ -107,6 +120,11 @@ private:
 
   std::queue<CandidateData> queue_;
 
+  /** \brief Deterministic mode: finished candidates by sequence number, and the next one the parent will take */
+  std::map<std::size_t, CandidateData> pending_;
+  std::atomic<std::size_t> nextSequence_{0};
+  bool deterministic_ = false;
+
   std::size_t targetQueueSize_ = 10;
 
   std::vector<boost::thread *> generatorThreads_;
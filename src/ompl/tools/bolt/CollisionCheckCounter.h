@@ -0,0 +1,239 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2016, University of Colorado, Boulder
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the Univ of CO, Boulder nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+/* Author: Dave Coleman <dave@dav.ee>
+   Desc:   Counts and times every state validity and motion check, attributed to the part of Bolt that asked for it
+*/
+
+#ifndef OMPL_TOOLS_BOLT_COLLISION_CHECK_COUNTER_
+#define OMPL_TOOLS_BOLT_COLLISION_CHECK_COUNTER_
+
+// OMPL
+#include <ompl/base/SpaceInformation.h>
+#include <ompl/base/StateValidityChecker.h>
+#include <ompl/base/MotionValidator.h>
+#include <ompl/base/DiscreteMotionValidator.h>
+
+// C++
+#include <atomic>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <string>
+
+namespace ompl
+{
+namespace tools
+{
+namespace bolt
+{
+/** \brief Which part of Bolt requested a collision check */
+enum CollisionCheckSite
+{
+  SITE_OTHER,                 // anything not inside a ScopedCheckSite
+  SITE_SAMPLING,              // finding valid states with enough clearance
+  SITE_DISCRETIZATION,        // building the initial grid of vertices
+  SITE_CANDIDATE_QUEUE,       // visibility between a candidate and its graph neighborhood
+  SITE_SPARSE_CRITERIA,       // deciding whether a candidate is added to the sparse graph
+  SITE_GRAPH_VERIFICATION,    // SparseGraph::verifyGraph()
+  SITE_TASK_GRAPH,            // connecting the task graph layers
+  SITE_GET_PATH_ON_GRAPH,     // connecting the start and goal to the roadmap
+  SITE_LAZY_COLLISION_CHECK,  // validating the edges of a roadmap path
+  SITE_SIMPLIFICATION,        // path smoothing, both of solutions and quality paths
+  SITE_PLANNER,               // remaining checks made while solving a query
+  NUM_COLLISION_CHECK_SITES
+};
+
+/** \brief Number of checks and the time they took, per site */
+struct CollisionCheckSnapshot
+{
+  std::uint64_t stateChecks_[NUM_COLLISION_CHECK_SITES] = {};
+  std::uint64_t motionChecks_[NUM_COLLISION_CHECK_SITES] = {};
+  double stateTime_[NUM_COLLISION_CHECK_SITES] = {};
+  double motionTime_[NUM_COLLISION_CHECK_SITES] = {};
+
+  /** \brief Sum over all sites */
+  std::uint64_t getStateChecks() const;
+  std::uint64_t getMotionChecks() const;
+
+  /** \brief Checks made between an earlier snapshot and this one */
+  CollisionCheckSnapshot operator-(const CollisionCheckSnapshot &earlier) const;
+  CollisionCheckSnapshot &operator+=(const CollisionCheckSnapshot &other);
+};
+
+/// @cond IGNORE
+OMPL_CLASS_FORWARD(CollisionCheckCounter);
+/// @endcond
+
+/** \class ompl::tools::bolt::CollisionCheckCounterPtr
+    \brief A boost shared pointer wrapper for ompl::tools::bolt::CollisionCheckCounter */
+
+/**
+ * \brief Thread safe tally of collision checks.
+ *
+ * install() wraps the validity checker and motion validator of a SpaceInformation so that every call is counted.
+ * Callers label their checks with ScopedCheckSite, the label is kept per thread. State checks made by a motion
+ * validator while checking a motion are counted as state checks too.
+ *
+ * SparseGraph::setup() installs one. SparseGenerator::createSPARS() reports the checks per vertex added and
+ * Bolt::printLogs() the checks per solved query.
+ */
+class CollisionCheckCounter : public std::enable_shared_from_this<CollisionCheckCounter>
+{
+public:
+  CollisionCheckCounter();
+
+  /** \brief Wrap the state validity checker and motion validator of si, unless already wrapped. si is setup before, so
+   *         that its default motion validator exists, and again afterwards */
+  void install(const base::SpaceInformationPtr &si);
+
+  /** \brief Record a check made by the calling thread */
+  void recordStateCheck(double seconds);
+  void recordMotionCheck(double seconds);
+
+  /** \brief Time each check as well as counting it, costs two clock reads per check */
+  void setTiming(bool timing)
+  {
+    timing_ = timing;
+  }
+
+  bool getTiming() const
+  {
+    return timing_;
+  }
+
+  /** \brief Copy of all counts so far, subtract two snapshots to get the checks of an interval */
+  CollisionCheckSnapshot getSnapshot() const;
+
+  /** \brief Clear all counts */
+  void reset();
+
+  /** \brief Label the checks of the calling thread, returns the previous label */
+  static CollisionCheckSite setSite(CollisionCheckSite site);
+  static CollisionCheckSite getSite();
+
+  /** \brief Short lower case name, used in reports */
+  static std::string getSiteName(CollisionCheckSite site);
+
+  /** \brief Table of checks per site
+   *  \param snapshot - counts to print, e.g. the difference of two snapshots
+   *  \param normalizer - e.g. the number of vertices added, to also print checks per vertex. Ignored if zero
+   *  \param normalizerName - what the normalizer counts
+   */
+  static void print(const CollisionCheckSnapshot &snapshot, std::size_t normalizer = 0,
+                    const std::string &normalizerName = "", std::ostream &out = std::cout);
+
+  /** \brief Find the DiscreteMotionValidator of si, looking through the counting wrapper if installed */
+  static base::DiscreteMotionValidator *getDiscreteMotionValidator(const base::SpaceInformationPtr &si);
+
+private:
+  std::atomic<std::uint64_t> stateChecks_[NUM_COLLISION_CHECK_SITES];
+  std::atomic<std::uint64_t> motionChecks_[NUM_COLLISION_CHECK_SITES];
+
+  /** \brief Nanoseconds */
+  std::atomic<std::uint64_t> stateTime_[NUM_COLLISION_CHECK_SITES];
+  std::atomic<std::uint64_t> motionTime_[NUM_COLLISION_CHECK_SITES];
+
+  bool timing_ = true;
+};
+
+/** \brief Labels all collision checks of the calling thread until the end of the scope */
+class ScopedCheckSite
+{
+public:
+  ScopedCheckSite(CollisionCheckSite site) : previous_(CollisionCheckCounter::setSite(site))
+  {
+  }
+
+  ~ScopedCheckSite()
+  {
+    CollisionCheckCounter::setSite(previous_);
+  }
+
+private:
+  CollisionCheckSite previous_;
+};
+
+/** \brief Forwards to another validity checker and counts every call */
+class CountingValidityChecker : public base::StateValidityChecker
+{
+public:
+  CountingValidityChecker(const base::SpaceInformationPtr &si, const base::StateValidityCheckerPtr &checker,
+                          const CollisionCheckCounterPtr &counter);
+
+  virtual bool isValid(const base::State *state) const;
+  virtual bool isValid(const base::State *state, double &dist) const;
+  virtual double clearance(const base::State *state) const;
+
+  /** \brief The checker doing the actual work */
+  const base::StateValidityCheckerPtr &getWrappedChecker() const
+  {
+    return checker_;
+  }
+
+private:
+  /** \brief Bolt sets the clearance search distance on the checker it finds in SpaceInformation, i.e. this one */
+  void syncClearanceSearchDistance() const;
+
+  base::StateValidityCheckerPtr checker_;
+  CollisionCheckCounterPtr counter_;
+};
+
+/** \brief Forwards to another motion validator and counts every call */
+class CountingMotionValidator : public base::MotionValidator
+{
+public:
+  CountingMotionValidator(const base::SpaceInformationPtr &si, const base::MotionValidatorPtr &validator,
+                          const CollisionCheckCounterPtr &counter);
+
+  virtual bool checkMotion(const base::State *s1, const base::State *s2) const;
+  virtual bool checkMotion(const base::State *s1, const base::State *s2,
+                           std::pair<base::State *, double> &lastValid) const;
+
+  /** \brief The validator doing the actual work */
+  const base::MotionValidatorPtr &getWrappedValidator() const
+  {
+    return validator_;
+  }
+
+private:
+  base::MotionValidatorPtr validator_;
+  CollisionCheckCounterPtr counter_;
+};
+
+}  // namespace bolt
+}  // namespace tools
+}  // namespace ompl
+
+#endif  // OMPL_TOOLS_BOLT_COLLISION_CHECK_COUNTER_
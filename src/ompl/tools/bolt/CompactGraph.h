@@ -0,0 +1,239 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2016, University of Colorado, Boulder
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the Univ of CO, Boulder nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+/* Author: Dave Coleman <dave@dav.ee>
+   Desc:   Read-only roadmap in compressed sparse row layout
+*/
+
+#ifndef OMPL_TOOLS_BOLT_COMPACT_GRAPH_
+#define OMPL_TOOLS_BOLT_COMPACT_GRAPH_
+
+// Bolt
+#include <ompl/tools/bolt/BoostGraphHeaders.h>
+#include <ompl/tools/bolt/MemoryReport.h>
+
+// Boost
+#include <boost/function.hpp>
+
+// C++
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace ompl
+{
+namespace tools
+{
+namespace bolt
+{
+/**
+ * \brief Edges of a roadmap that no longer changes, in compressed sparse row layout.
+ *
+ * The neighbors of vertex v are targets_[offsets_[v]] to targets_[offsets_[v + 1] - 1], sorted, so iterating them
+ * reads one contiguous block and finding an edge is a binary search. Each undirected edge is stored once in the
+ * weight and collision state arrays and referenced from both of its endpoints. Vertices keep the indices they had
+ * in the graph it was built from. Only the collision states can change afterwards.
+ */
+class CompactGraph
+{
+public:
+  typedef std::uint32_t Index;
+
+  /** \brief Returned by findEdge() when two vertices are not adjacent */
+  static const Index NO_EDGE = std::numeric_limits<Index>::max();
+
+  /** \brief Lower bound on the cost from a vertex to the goal of a search */
+  typedef boost::function<double(Index)> HeuristicFunction;
+
+  /** \brief Copy the edges, weights and collision states of a boost::adjacency_list */
+  template <class Graph>
+  void build(const Graph &g)
+  {
+    if (boost::num_vertices(g) >= NO_EDGE || boost::num_edges(g) >= NO_EDGE)
+      throw std::length_error("CompactGraph: too many vertices or edges for 32 bit indices");
+
+    clear();
+    const std::size_t numVertices = boost::num_vertices(g);
+    offsets_.assign(numVertices + 1, 0);
+    weights_.reserve(boost::num_edges(g));
+    collisionStates_.reserve(boost::num_edges(g));
+
+    // Number the edges and count the degree of each vertex
+    std::vector<std::pair<Index, Index> > endpoints;
+    endpoints.reserve(boost::num_edges(g));
+    typename boost::graph_traits<Graph>::edge_iterator e, end;
+    for (boost::tie(e, end) = boost::edges(g); e != end; ++e)
+    {
+      const Index v1 = boost::source(*e, g);
+      const Index v2 = boost::target(*e, g);
+      endpoints.push_back(std::make_pair(v1, v2));
+      weights_.push_back(boost::get(boost::edge_weight, g, *e));
+      collisionStates_.push_back(boost::get(edge_collision_state_t(), g, *e));
+      offsets_[v1 + 1]++;
+      offsets_[v2 + 1]++;
+    }
+    for (std::size_t v = 0; v < numVertices; ++v)
+      offsets_[v + 1] += offsets_[v];
+
+    fill(endpoints);
+    labelComponents();
+  }
+
+  void clear();
+
+  bool empty() const
+  {
+    return offsets_.empty();
+  }
+
+  std::size_t getNumVertices() const
+  {
+    return offsets_.empty() ? 0 : offsets_.size() - 1;
+  }
+
+  std::size_t getNumEdges() const
+  {
+    return weights_.size();
+  }
+
+  std::size_t getDegree(Index v) const
+  {
+    return offsets_[v + 1] - offsets_[v];
+  }
+
+  /** \brief Range of positions in getNeighbor() and getNeighborEdge() that belong to vertex \e v */
+  Index beginNeighbors(Index v) const
+  {
+    return offsets_[v];
+  }
+
+  Index endNeighbors(Index v) const
+  {
+    return offsets_[v + 1];
+  }
+
+  Index getNeighbor(Index position) const
+  {
+    return targets_[position];
+  }
+
+  Index getNeighborEdge(Index position) const
+  {
+    return edges_[position];
+  }
+
+  /** \brief Edge between two vertices, or NO_EDGE */
+  Index findEdge(Index v1, Index v2) const;
+
+  double getWeight(Index e) const
+  {
+    return weights_[e];
+  }
+
+  EdgeCollisionState getCollisionState(Index e) const
+  {
+    return static_cast<EdgeCollisionState>(collisionStates_[e]);
+  }
+
+  void setCollisionState(Index e, EdgeCollisionState state)
+  {
+    collisionStates_[e] = state;
+  }
+
+  /** \brief Set every edge back to NOT_CHECKED */
+  void clearCollisionStates();
+
+  /** \brief Connected components are labeled when the graph is built */
+  bool sameComponent(Index v1, Index v2) const
+  {
+    return components_[v1] == components_[v2];
+  }
+
+  Index getComponent(Index v) const
+  {
+    return components_[v];
+  }
+
+  /**
+   * \brief A* search that skips edges known to be in collision
+   * \param vertexPath - filled with the vertices from \e goal back to \e start, as boost::astar_search is used
+   * \param nodesOpened - number of vertices discovered
+   * \param nodesClosed - number of vertices examined
+   * \return true if the goal was reached
+   */
+  bool astarSearch(Index start, Index goal, const HeuristicFunction &heuristic, std::vector<Index> &vertexPath,
+                   double &distance, std::size_t &nodesOpened, std::size_t &nodesClosed);
+
+  /** \brief True if no edge between consecutive vertices of \e vertexPath is known to be in collision */
+  bool isPathFree(const std::vector<Index> &vertexPath) const;
+
+  /** \brief Add the arrays to the adjacency, edge property and disjoint set components of a report */
+  void addToMemoryReport(MemoryReport &report) const;
+
+private:
+  /** \brief Fill targets_ and edges_ from the offsets and the endpoints of each edge, sorting every row */
+  void fill(const std::vector<std::pair<Index, Index> > &endpoints);
+
+  void labelComponents();
+
+  /** \brief First position of each vertex in targets_ and edges_, plus one past the end */
+  std::vector<Index> offsets_;
+
+  /** \brief Neighbor and undirected edge at each position */
+  std::vector<Index> targets_;
+  std::vector<Index> edges_;
+
+  /** \brief Properties of each undirected edge */
+  std::vector<double> weights_;
+  std::vector<std::uint8_t> collisionStates_;
+
+  /** \brief Connected component of each vertex */
+  std::vector<Index> components_;
+
+  /** \brief Reused between searches. A vertex has been reached by the current search when its visit equals
+   *         searchID_, and closed when it equals searchID_ + 1 */
+  std::vector<double> costs_;
+  std::vector<Index> predecessors_;
+  std::vector<std::uint32_t> visits_;
+  std::uint32_t searchID_ = 0;
+};
+
+}  // namespace bolt
+}  // namespace tools
+}  // namespace ompl
+
+#endif  // OMPL_TOOLS_BOLT_COMPACT_GRAPH_
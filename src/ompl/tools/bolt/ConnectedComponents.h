@@ -0,0 +1,150 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2016, University of Colorado, Boulder
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the Univ of CO, Boulder nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+/* Author: Dave Coleman <dave@dav.ee>
+   Desc:   Connected components of the sparse graph that stay exact when edges and vertices are removed
+*/
+
+#ifndef OMPL_TOOLS_BOLT_CONNECTED_COMPONENTS_
+#define OMPL_TOOLS_BOLT_CONNECTED_COMPONENTS_
+
+// Bolt
+#include <ompl/tools/bolt/BoostGraphHeaders.h>
+
+// C++
+#include <limits>
+#include <vector>
+
+namespace ompl
+{
+namespace tools
+{
+namespace bolt
+{
+/**
+ * \brief Labels every vertex with its connected component.
+ *
+ * Adding an edge between two components relabels the smaller one, so a vertex is relabeled at most log(n) times
+ * while the graph only grows. Removing edges starts one breadth first search from each endpoint. The searches
+ * advance in lockstep and merge when they meet. A search that runs out of vertices has found a complete component,
+ * which gets a new label. They stop once at most one is left, so a split costs about the size of the smaller parts,
+ * and an edge whose endpoints stay connected costs the size of the detour around it.
+ *
+ * SparseGraph::sameComponent() therefore stays exact after removeVertex() and clearEdgesNearVertex(), and the
+ * connectivity criterion does not skip vertices it wrongly believes are connected.
+ */
+class ConnectedComponents
+{
+public:
+  /** \brief Label of deleted vertices, which belong to no component */
+  static const std::size_t NO_COMPONENT = std::numeric_limits<std::size_t>::max();
+
+  explicit ConnectedComponents(const SparseAdjList &graph);
+
+  void clear();
+
+  /** \brief Relabel every vertex of the graph from its edges, vertices without a component must be removed again */
+  void rebuild();
+
+  /** \brief Give a new vertex its own component */
+  void addVertex(SparseVertex v);
+
+  /** \brief Call after adding an edge to the graph */
+  void addEdge(SparseVertex v1, SparseVertex v2);
+
+  /** \brief Call after removing edges from the graph, with the endpoints of every removed edge */
+  void removeEdges(const std::vector<SparseVertex> &endpoints);
+
+  /** \brief Call after removing all edges of a vertex that is being deleted */
+  void removeVertex(SparseVertex v);
+
+  bool sameComponent(SparseVertex v1, SparseVertex v2) const
+  {
+    return component_[v1] != NO_COMPONENT && component_[v1] == component_[v2];
+  }
+
+  std::size_t getComponent(SparseVertex v) const
+  {
+    return component_[v];
+  }
+
+  std::size_t getComponentSize(SparseVertex v) const
+  {
+    return component_[v] == NO_COMPONENT ? 0 : sizes_[component_[v]];
+  }
+
+  /** \brief Number of components, counting every isolated vertex */
+  std::size_t getNumComponents() const
+  {
+    return sizes_.size() - freeLabels_.size();
+  }
+
+  /** \brief Number of vertices relabeled since the last clear(), a measure of the work done */
+  std::size_t getNumRelabeled() const
+  {
+    return numRelabeled_;
+  }
+
+  std::size_t getMemoryBytes() const;
+
+private:
+  std::size_t newLabel(std::size_t size);
+
+  void freeLabel(std::size_t label);
+
+  /** \brief Give every vertex reachable from \e start that has label \e from the label \e to */
+  void relabel(SparseVertex start, std::size_t from, std::size_t to);
+
+  /** \brief Separate the parts of component \e label that \e endpoints may have been split into */
+  void split(std::size_t label, const std::vector<SparseVertex> &endpoints);
+
+  const SparseAdjList &graph_;
+
+  /** \brief Label of each vertex */
+  std::vector<std::size_t> component_;
+
+  /** \brief Number of vertices with each label */
+  std::vector<std::size_t> sizes_;
+
+  /** \brief Labels no vertex has, reused before new ones are made */
+  std::vector<std::size_t> freeLabels_;
+
+  std::size_t numRelabeled_ = 0;
+};
+
+}  // namespace bolt
+}  // namespace tools
+}  // namespace ompl
+
+#endif  // OMPL_TOOLS_BOLT_CONNECTED_COMPONENTS_
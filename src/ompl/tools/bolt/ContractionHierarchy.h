@@ -0,0 +1,143 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2016, University of Colorado, Boulder
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the Univ of CO, Boulder nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+/* Author: Dave Coleman <dave@dav.ee>
+   Desc:   Contraction hierarchy over a frozen roadmap for fast exact shortest path queries
+*/
+
+#ifndef OMPL_TOOLS_BOLT_CONTRACTION_HIERARCHY_
+#define OMPL_TOOLS_BOLT_CONTRACTION_HIERARCHY_
+
+// Bolt
+#include <ompl/tools/bolt/CompactGraph.h>
+#include <ompl/tools/bolt/MemoryReport.h>
+
+// C++
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace ompl
+{
+namespace tools
+{
+namespace bolt
+{
+/**
+ * \brief Shortcut overlay of a CompactGraph that answers shortest path queries by settling a few hundred vertices.
+ *
+ * Vertices are contracted one at a time, least important first: a contracted vertex is removed from the remaining
+ * graph and a shortcut is added between two of its neighbors unless a witness search finds a path between them
+ * that is no longer. Each vertex keeps the arcs to the neighbors it had when it was contracted, which all rank
+ * higher. A query is a bidirectional Dijkstra that only follows arcs upwards, and shortcuts are expanded back to
+ * original edges through the vertex they bypass.
+ *
+ * The collision states of the edges are ignored, so the hierarchy answers for the roadmap as it was validated. The
+ * caller checks the edges of the path and falls back to A* if any is known to be in collision: invalidating edges
+ * only makes other paths longer, so a path without such edges is still the shortest.
+ */
+class ContractionHierarchy
+{
+public:
+  typedef CompactGraph::Index Index;
+
+  /** \brief Middle of an arc that is an original edge */
+  static const Index NO_VERTEX = std::numeric_limits<Index>::max();
+
+  void clear();
+
+  bool empty() const
+  {
+    return rank_.empty();
+  }
+
+  /**
+   * \brief Contract every vertex of \e graph
+   * \param witnessLimit - vertices a witness search may settle before the shortcut is added anyway. Lower builds
+   *                       faster but adds shortcuts that are not needed
+   */
+  void build(const CompactGraph &graph, std::size_t witnessLimit = 500);
+
+  /**
+   * \brief Shortest path between two vertices, expanded to original edges
+   * \param vertexPath - filled with the vertices from \e goal back to \e start, like CompactGraph::astarSearch()
+   * \param nodesSettled - vertices settled by both directions together
+   * \return true if the goal is reachable
+   */
+  bool search(Index start, Index goal, std::vector<Index> &vertexPath, double &distance, std::size_t &nodesSettled);
+
+  /** \brief Number of arcs that are shortcuts rather than original edges */
+  std::size_t getNumShortcuts() const
+  {
+    return numShortcuts_;
+  }
+
+  /** \brief Position of each vertex in the contraction order */
+  Index getRank(Index v) const
+  {
+    return rank_[v];
+  }
+
+  void addToMemoryReport(MemoryReport &report) const;
+
+private:
+  /** \brief Arc from the lower ranked of \e v1 and \e v2 to the other, which must exist */
+  Index findArc(Index v1, Index v2) const;
+
+  /** \brief Append the original path from \e from to \e to, without \e from itself */
+  void unpack(Index from, Index to, std::vector<Index> &path) const;
+
+  std::vector<Index> rank_;
+
+  /** \brief Upward arcs of each vertex in compressed sparse row layout, sorted by target */
+  std::vector<Index> offsets_;
+  std::vector<Index> targets_;
+  std::vector<double> weights_;
+  std::vector<Index> middles_;
+
+  std::size_t numShortcuts_ = 0;
+
+  /** \brief Reused between queries, one of each per direction. A vertex has been reached by the current query when
+   *         its visit equals searchID_, and settled when it equals searchID_ + 1 */
+  std::vector<double> costs_[2];
+  std::vector<Index> predecessors_[2];
+  std::vector<std::uint32_t> visits_[2];
+  std::uint32_t searchID_ = 0;
+};
+
+}  // namespace bolt
+}  // namespace tools
+}  // namespace ompl
+
+#endif  // OMPL_TOOLS_BOLT_CONTRACTION_HIERARCHY_
@@ -0,0 +1,187 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2016, University of Colorado, Boulder
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the Univ of CO, Boulder nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+/* Author: Dave Coleman <dave@dav.ee>
+   Desc:   Coarse grid over a projection that steers sampling toward regions still producing roadmap vertices
+*/
+
+#ifndef OMPL_TOOLS_BOLT_COVERAGE_GRID_
+#define OMPL_TOOLS_BOLT_COVERAGE_GRID_
+
+// OMPL
+#include <ompl/base/SpaceInformation.h>
+#include <ompl/base/ProjectionEvaluator.h>
+#include <ompl/base/samplers/MinimumClearanceValidStateSampler.h>
+#include <ompl/util/ClassForward.h>
+#include <ompl/util/RandomNumbers.h>
+
+// Boost
+#include <boost/functional/hash.hpp>
+#include <boost/noncopyable.hpp>
+#include <boost/thread/shared_mutex.hpp>
+#include <boost/unordered_map.hpp>
+
+// C++
+#include <atomic>
+
+namespace ompl
+{
+namespace tools
+{
+namespace bolt
+{
+/// @cond IGNORE
+OMPL_CLASS_FORWARD(CoverageGrid);
+/// @endcond
+
+/** \class ompl::tools::bolt::CoverageGridPtr
+    \brief A boost shared pointer wrapper for ompl::tools::bolt::CoverageGrid */
+
+/**
+ * \brief Remembers which cells of a projection recently produced roadmap vertices and which only rejections.
+ *
+ * Each cell keeps a decayed count of the candidates evaluated in it and of those added to the graph. The weight of a
+ * cell is the fraction added, floored at minWeight_, and a cell never seen has weight one. The counts are scaled by
+ * decay_ every decayInterval_ candidates, so a region covered before the fourth criteria was enabled is sampled again.
+ * The parent thread records candidates while the sampling threads read weights.
+ */
+class CoverageGrid : private boost::noncopyable
+{
+public:
+  /** \brief Uses the cell sizes of \e projection, normally the default projection of the state space */
+  CoverageGrid(const base::SpaceInformationPtr &si, const base::ProjectionEvaluatorPtr &projection);
+
+  /** \brief Forget every cell */
+  void clear();
+
+  /** \brief Cell containing \e state, using scratch space owned by the caller */
+  void computeCell(const base::State *state, base::EuclideanProjection &projection,
+                   base::ProjectionCoordinates &cell) const;
+
+  /** \brief Probability in [minWeight_, 1] of keeping a sample drawn in \e cell */
+  double getWeight(const base::ProjectionCoordinates &cell) const;
+
+  /** \brief Called by the parent thread with the result of every candidate */
+  void recordCandidate(const base::State *state, bool added);
+
+  /** \brief Called by the samplers for every draw discarded without a collision check */
+  void recordSkipped()
+  {
+    numSkipped_++;
+  }
+
+  std::size_t getNumCells() const;
+
+  std::size_t getNumSkipped() const
+  {
+    return numSkipped_;
+  }
+
+  const base::ProjectionEvaluatorPtr &getProjection() const
+  {
+    return projection_;
+  }
+
+  /** \brief Factor applied to the counts of every cell each decayInterval_ candidates */
+  double decay_ = 0.5;
+  std::size_t decayInterval_ = 1000;
+
+  /** \brief Lowest weight of a cell, so that every region keeps being sampled. Must be positive */
+  double minWeight_ = 0.05;
+
+private:
+  struct Cell
+  {
+    double candidates_ = 0.0;
+    double added_ = 0.0;
+
+    /** \brief Epoch in which the counts were last decayed */
+    std::size_t epoch_ = 0;
+  };
+
+  /** \brief Bring the counts of \e cell up to the current epoch */
+  void decayCell(Cell &cell) const;
+
+  base::SpaceInformationPtr si_;
+  base::ProjectionEvaluatorPtr projection_;
+
+  boost::unordered_map<base::ProjectionCoordinates, Cell, boost::hash<base::ProjectionCoordinates> > cells_;
+  mutable boost::shared_mutex cellsMutex_;
+
+  /** \brief Number of decays so far, and candidates recorded since the last one */
+  std::size_t epoch_ = 0;
+  std::size_t numSinceDecay_ = 0;
+
+  /** \brief Scratch space of recordCandidate(), only used by the parent thread */
+  base::EuclideanProjection recordProjection_;
+  base::ProjectionCoordinates recordCell_;
+
+  std::atomic<std::size_t> numSkipped_;
+};
+
+/**
+ * \brief Minimum clearance sampler that discards uniform draws in cells of low weight before checking them.
+ *
+ * A discarded draw costs a projection instead of a clearance check, and only checked draws count against the attempts
+ * of the sampler. Once every cell has decayed to the floor the samples are uniform again.
+ */
+class CoverageSampler : public base::MinimumClearanceValidStateSampler
+{
+public:
+  /** \brief Draws from \e stateSampler, or from the default sampler of the space if it is null */
+  CoverageSampler(const base::SpaceInformation *si, const CoverageGridPtr &grid,
+                  const base::StateSamplerPtr &stateSampler = base::StateSamplerPtr());
+
+  bool sample(base::State *state);
+
+private:
+  CoverageGridPtr grid_;
+  RNG rng_;
+
+  /** \brief Scratch space, the sampler is used by a single thread */
+  base::EuclideanProjection projection_;
+  base::ProjectionCoordinates cell_;
+};
+
+/** \brief Sampler of states with at least \e clearance from obstacles, biased by \e grid unless it is null. The
+ *         candidates are drawn from \e stateSampler, or from the default sampler of the space if it is null */
+base::MinimumClearanceValidStateSamplerPtr
+allocClearanceSampler(const base::SpaceInformation *si, double clearance, const CoverageGridPtr &grid,
+                      const base::StateSamplerPtr &stateSampler = base::StateSamplerPtr());
+
+}  // namespace bolt
+}  // namespace tools
+}  // namespace ompl
+
+#endif  // OMPL_TOOLS_BOLT_COVERAGE_GRID_
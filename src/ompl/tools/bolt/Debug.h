@@ -114,6 +114,14 @@
 #define BOLT_BLUE_DEBUG(indent, flag, stream) BOLT_COLOR_DEBUG(indent, flag, stream, ANSI_COLOR_BLUE);
 #define BOLT_MAGENTA_DEBUG(indent, flag, stream) BOLT_COLOR_DEBUG(indent, flag, stream, ANSI_COLOR_MAGENTA);
 #define BOLT_CYAN_DEBUG(indent, flag, stream) BOLT_COLOR_DEBUG(indent, flag, stream, ANSI_COLOR_CYAN);
+// BOLT_VISUALIZE() - wrap visualization flags so that headless builds compile the visualization out. Class layouts
+// do not change, so headless and regular builds share the same headers
+#ifdef BOLT_HEADLESS
+#define BOLT_VISUALIZE(flag) (false)
+#else
+#define BOLT_VISUALIZE(flag) (flag)
+#endif
+
 // clang-format on
 
 #endif  // OMPL_TOOLS_BOLT_DEBUG_H
@@ -0,0 +1,98 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2016, University of Colorado, Boulder
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the Univ of CO, Boulder nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+/* Author: Dave Coleman <dave@dav.ee>
+   Desc:   Euclidean distance kernels for RealVector state spaces, selected for the CPU at runtime
+*/
+
+#ifndef OMPL_TOOLS_BOLT_DISTANCE_KERNELS_
+#define OMPL_TOOLS_BOLT_DISTANCE_KERNELS_
+
+// OMPL
+#include <ompl/base/StateSpace.h>
+
+// C++
+#include <cstddef>
+
+namespace ompl
+{
+namespace tools
+{
+namespace bolt
+{
+/** \brief Instruction sets a distance kernel can be built for. The SIMD kernels need GCC 5 (AVX2) or GCC 7 (AVX-512),
+ *         or clang, on x86-64 and are left out elsewhere */
+enum DistanceKernelLevel
+{
+  KERNEL_GENERIC,  // portable C++, left to the compiler to vectorize
+  KERNEL_AVX2,     // 4 doubles per instruction, with FMA
+  KERNEL_AVX512,   // 8 doubles per instruction, masked tails
+  KERNEL_BEST      // the widest level the CPU supports
+};
+
+/** \brief Squared Euclidean distance between two points */
+typedef double (*DistanceSquaredFn)(const double *a, const double *b, std::size_t dimension);
+
+/** \brief Squared Euclidean distances from \e query to \e count points stored one after another in \e points */
+typedef void (*DistanceSquaredBatchFn)(const double *query, const double *points, std::size_t count,
+                                       std::size_t dimension, double *distances);
+
+/** \brief Same as DistanceSquaredBatchFn for coordinates stored in single precision. Sums are accumulated in single
+ *         precision too, which moves twice the points through each instruction */
+typedef void (*DistanceSquaredBatchFloatFn)(const float *query, const float *points, std::size_t count,
+                                            std::size_t dimension, double *distances);
+
+/** \brief A set of kernels built for one instruction set */
+struct DistanceKernels
+{
+  DistanceKernelLevel level_;
+  const char *name_;
+  DistanceSquaredFn distanceSquared_;
+  DistanceSquaredBatchFn distanceSquaredBatch_;
+  DistanceSquaredBatchFloatFn distanceSquaredBatchFloat_;
+};
+
+/** \brief Kernels for \e level. Levels the compiler or the CPU do not support give the generic kernels. The CPU is
+ *         only checked once, so the result can be cached and called from any thread */
+const DistanceKernels &getDistanceKernels(DistanceKernelLevel level = KERNEL_BEST);
+
+/** \brief True if distances in \e space are plain Euclidean distances between the RealVector coordinates. Classes
+ *         derived from RealVectorStateSpace may override distance(), so they do not qualify */
+bool isEuclideanSpace(const base::StateSpacePtr &space);
+
+}  // namespace bolt
+}  // namespace tools
+}  // namespace ompl
+
+#endif  // OMPL_TOOLS_BOLT_DISTANCE_KERNELS_
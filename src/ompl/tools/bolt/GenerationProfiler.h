@@ -0,0 +1,239 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2016, University of Colorado, Boulder
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the Univ of CO, Boulder nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+/* Author: Dave Coleman <dave@dav.ee>
+   Desc:   Low overhead per-thread timers and counters for the phases of sparse graph generation
+*/
+
+#ifndef OMPL_TOOLS_BOLT_GENERATION_PROFILER_
+#define OMPL_TOOLS_BOLT_GENERATION_PROFILER_
+
+// OMPL
+#include <ompl/util/ClassForward.h>
+#include <ompl/util/Time.h>
+
+// C++
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace ompl
+{
+namespace tools
+{
+namespace bolt
+{
+/** \brief Where time is spent while generating a sparse graph. Phases may nest, e.g. PHASE_QUALITY includes the
+ *         nearest neighbor searches and A* searches it performs */
+enum ProfilePhase
+{
+  PHASE_SAMPLING,          // drawing valid states with sufficient clearance
+  PHASE_NEAREST_NEIGHBOR,  // radius searches in the NN structure
+  PHASE_VISIBILITY,        // motion checks between a candidate and its graph neighborhood
+  PHASE_COVERAGE,          // first SPARS criterion
+  PHASE_CONNECTIVITY,      // second SPARS criterion
+  PHASE_INTERFACE,         // third SPARS criterion
+  PHASE_QUALITY,           // fourth SPARS criterion
+  PHASE_ASTAR,             // searches on the sparse graph
+  PHASE_GRAPH_MUTATION,    // adding and removing vertices and edges
+  PHASE_SAVE,              // writing the graph to file
+  PHASE_QUEUE_WAIT,        // threads blocked on an empty or full SamplingQueue / CandidateQueue
+  PHASE_DISCRETIZATION,    // building the initial grid of vertices
+  NUM_PROFILE_PHASES
+};
+
+/** \brief Events that are counted rather than timed */
+enum ProfileCounter
+{
+  COUNT_SAMPLES,                // valid states drawn by any thread
+  COUNT_CANDIDATES,             // candidates evaluated by the SPARS criteria
+  COUNT_STALE_CANDIDATES,       // candidates discarded because the graph changed after their neighbors were found
+  COUNT_RECOMPUTED_CANDIDATES,  // stale candidates whose neighbors the parent found again in deterministic mode
+  COUNT_QUEUE_MISSES,           // times the parent thread found the CandidateQueue empty
+  COUNT_MOTION_CHECKS,          // motion checks made while computing visibility
+  COUNT_MOTION_CACHE_HITS,      // motion checks between vertices answered by the MotionCache
+  COUNT_BOUNDARY_SAMPLES,       // samples the SamplingQueue drew near obstacle boundaries
+  COUNT_VERTICES_ADDED,
+  COUNT_EDGES_ADDED,
+  NUM_PROFILE_COUNTERS
+};
+
+/** \brief Accumulated time of one phase */
+struct PhaseStatistics
+{
+  /** \brief Number of times the phase was entered */
+  std::size_t calls_ = 0;
+
+  /** \brief Time spent in the phase, in seconds */
+  double total_ = 0;
+  double max_ = 0;
+};
+
+/// @cond IGNORE
+OMPL_CLASS_FORWARD(GenerationProfiler);
+/// @endcond
+
+/** \class ompl::tools::bolt::GenerationProfilerPtr
+    \brief A boost shared pointer wrapper for ompl::tools::bolt::GenerationProfiler */
+
+/**
+ * \brief Collects time and event counts per phase of sparse graph generation.
+ *
+ * Every thread writes only to its own slot so recording needs no locks. Threads identify themselves once with
+ * setThreadID(), using the same IDs as the query vertices of the SparseGraph. Results are aggregated on demand,
+ * which should happen once the generating threads have stopped.
+ *
+ * SparseGenerator::createSPARS() always ends by printing the aggregate: sampling, nearest neighbor, visibility, each
+ * SPARS criterion, A*, graph mutation, saving and queue waits.
+ */
+class GenerationProfiler
+{
+public:
+  /** \brief Constructor
+   *  \param numThreads - number of slots, thread IDs outside of this range share the last slot
+   */
+  GenerationProfiler(std::size_t numThreads);
+
+  /** \brief Clear all timers and counters and restart the wall clock */
+  void reset();
+
+  /** \brief Turn recording on or off, when off the timers cost a single branch */
+  void setEnabled(bool enabled)
+  {
+    enabled_ = enabled;
+  }
+
+  bool isEnabled() const
+  {
+    return enabled_;
+  }
+
+  /** \brief Tell the profiler which slot the calling thread records into, the default is 0 (the parent thread) */
+  static void setThreadID(std::size_t threadID);
+  static std::size_t getThreadID();
+
+  std::size_t getNumThreads() const
+  {
+    return threads_.size();
+  }
+
+  /** \brief Add time to a phase for the calling thread */
+  void addTime(ProfilePhase phase, double seconds);
+
+  /** \brief Increment a counter for the calling thread */
+  void increment(ProfileCounter counter, std::size_t amount = 1);
+
+  /** \brief Statistics of a phase summed over all threads */
+  PhaseStatistics getPhase(ProfilePhase phase) const;
+
+  /** \brief Statistics of a phase for a single thread */
+  PhaseStatistics getPhase(ProfilePhase phase, std::size_t threadID) const;
+
+  /** \brief Value of a counter summed over all threads */
+  std::size_t getCounter(ProfileCounter counter) const;
+
+  /** \brief Value of a counter for a single thread */
+  std::size_t getCounter(ProfileCounter counter, std::size_t threadID) const;
+
+  /** \brief Seconds since the last reset */
+  double getWallTime() const;
+
+  /** \brief Short lower case names, used as keys in the reports */
+  static std::string getPhaseName(ProfilePhase phase);
+  static std::string getCounterName(ProfileCounter counter);
+
+  /** \brief Human readable breakdown of the aggregated results */
+  void print(std::ostream &out = std::cout) const;
+
+  /** \brief Write aggregated and per-thread results */
+  bool writeJSON(const std::string &filePath) const;
+  bool writeCSV(const std::string &filePath) const;
+
+private:
+  /** \brief Everything recorded by one thread, padded so that neighboring threads do not share a cache line */
+  struct ThreadProfile
+  {
+    PhaseStatistics phases_[NUM_PROFILE_PHASES];
+    std::size_t counters_[NUM_PROFILE_COUNTERS];
+    char padding_[64];
+  };
+
+  ThreadProfile &getThreadProfile();
+
+  /** \brief Short name of this class */
+  const std::string name_ = "GenerationProfiler";
+
+  std::vector<ThreadProfile> threads_;
+
+  /** \brief When the profiler was last reset */
+  time::point startTime_;
+
+  bool enabled_ = true;
+};
+
+/** \brief Adds the time between construction and destruction to a phase of the calling thread */
+class ScopedPhaseTimer
+{
+public:
+  ScopedPhaseTimer(const GenerationProfilerPtr &profiler, ProfilePhase phase)
+    : profiler_(profiler && profiler->isEnabled() ? profiler.get() : nullptr), phase_(phase)
+  {
+    if (profiler_)
+      startTime_ = time::now();
+  }
+
+  ~ScopedPhaseTimer()
+  {
+    stop();
+  }
+
+  /** \brief Record the elapsed time now instead of at the end of the scope */
+  void stop()
+  {
+    if (profiler_)
+      profiler_->addTime(phase_, time::seconds(time::now() - startTime_));
+    profiler_ = nullptr;
+  }
+
+private:
+  GenerationProfiler *profiler_;
+  ProfilePhase phase_;
+  time::point startTime_;
+};
+
+}  // namespace bolt
+}  // namespace tools
+}  // namespace ompl
+
+#endif  // OMPL_TOOLS_BOLT_GENERATION_PROFILER_
@@ -0,0 +1,121 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2016, University of Colorado, Boulder
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the Univ of CO, Boulder nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+/* Author: Dave Coleman <dave@dav.ee>
+   Desc:   Low discrepancy samples for roadmap generation, split into streams for the generation threads
+*/
+
+#ifndef OMPL_TOOLS_BOLT_HALTON_SAMPLER_
+#define OMPL_TOOLS_BOLT_HALTON_SAMPLER_
+
+// OMPL
+#include <ompl/base/SpaceInformation.h>
+#include <ompl/base/StateSampler.h>
+
+// C++
+#include <cstdint>
+#include <vector>
+
+namespace ompl
+{
+namespace tools
+{
+namespace bolt
+{
+/** \brief Sequence the random candidates of roadmap generation are drawn from. Independent uniform samples clump and
+ *         leave gaps, and SPARS only terminates once the gaps are found */
+enum SampleSequence
+{
+  SAMPLE_SEQUENCE_RANDOM = 0,  // independent uniform samples
+  SAMPLE_SEQUENCE_HALTON       // Halton sequence, only for RealVectorStateSpace
+};
+
+/**
+ * \brief Draws uniform samples from a Halton sequence over the bounds of a RealVectorStateSpace.
+ *
+ * Coordinate j of point i is the radical inverse of i in the j-th prime. Stream s of n takes points s, s + p, s + 2p,
+ * ... (leapfrog). The stride p must share no factor with any base, or a stream would only see part of a coordinate.
+ * If n qualifies, p = n and the streams together are exactly one Halton sequence. Otherwise p is the smallest prime
+ * above n and the bases, and each stream is its own leaped Halton sequence, disjoint from the others but covering
+ * only n of every p points. All streams add the same random shift modulo one, seeded, so the sequence does not start
+ * at the lower bounds. Samples near a state and Gaussian samples are uniform random, seeded per stream.
+ *
+ * The correlation between the large bases shows above roughly ten dimensions, where Halton points lose their
+ * advantage over random ones.
+ */
+class HaltonStateSampler : public base::StateSampler
+{
+public:
+  HaltonStateSampler(const base::StateSpace *space, std::size_t stream, std::size_t numStreams,
+                     std::uint_fast32_t seed);
+
+  void sampleUniform(base::State *state);
+  void sampleUniformNear(base::State *state, const base::State *near, double distance);
+  void sampleGaussian(base::State *state, const base::State *mean, double stdDev);
+
+  /** \brief Point of the sequence the next sample is taken from */
+  std::uint64_t getIndex() const
+  {
+    return index_;
+  }
+
+  /** \brief Radical inverse of \e index in \e base, the digits of \e index mirrored around the radix point */
+  static double radicalInverse(std::uint64_t index, unsigned int base);
+
+private:
+  std::vector<unsigned int> bases_;
+  std::vector<double> shift_;
+  std::vector<double> low_;
+  std::vector<double> extent_;
+
+  std::uint64_t index_;
+  std::uint64_t stride_;
+
+  /** \brief Used for everything but uniform samples, seeded per stream */
+  base::StateSamplerPtr randomSampler_;
+};
+
+/**
+ * \brief State sampler drawing stream \e stream of \e numStreams of \e sequence
+ * \return null for SAMPLE_SEQUENCE_RANDOM, or if the space does not support the sequence. The samplers of the space
+ *         are then used as before
+ */
+base::StateSamplerPtr allocSequenceStateSampler(SampleSequence sequence, const base::SpaceInformation *si,
+                                                std::size_t stream, std::size_t numStreams, std::uint_fast32_t seed);
+
+}  // namespace bolt
+}  // namespace tools
+}  // namespace ompl
+
+#endif  // OMPL_TOOLS_BOLT_HALTON_SAMPLER_
@@ -43,6 +43,9 @@
 #include <ompl/base/State.h>
 #include <ompl/base/SpaceInformation.h>
 
+// C++
+#include <utility>
+
 namespace ompl
 {
 namespace tools
@@ -139,13 +142,13 @@ public:
   }
 
   /** \brief Helper to determine wether interface 1 has been found */
-  bool hasInterface1()
+  bool hasInterface1() const
   {
     return interface1Inside_ != nullptr;
   }
 
   /** \brief Helper to determine wether interface 2 has been found */
-  bool hasInterface2()
+  bool hasInterface2() const
   {
     return interface2Inside_ != nullptr;
   }
@@ -219,6 +222,13 @@ public:
     return interface2Outside_;
   }
 
+  /** \brief Exchange the two interfaces, for when renumbering flips which neighbor has the lower index */
+  void swapInterfaces()
+  {
+    std::swap(interface1Inside_, interface2Inside_);
+    std::swap(interface1Outside_, interface2Outside_);
+  }
+
 private:
   // Note: interface1 is between this vertex v and the vertex with the lower index v'
   // Note: interface2 is between this vertex v and the vertex with the higher index v''
@@ -0,0 +1,146 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2016, University of Colorado, Boulder
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the Univ of CO, Boulder nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+/* Author: Dave Coleman <dave@dav.ee>
+   Desc:   Landmark lower bounds on graph distance (ALT) for the A* heuristic
+*/
+
+#ifndef OMPL_TOOLS_BOLT_LANDMARK_HEURISTIC_
+#define OMPL_TOOLS_BOLT_LANDMARK_HEURISTIC_
+
+// Bolt
+#include <ompl/tools/bolt/BoostGraphHeaders.h>
+
+// C++
+#include <limits>
+#include <vector>
+
+namespace ompl
+{
+namespace tools
+{
+namespace bolt
+{
+/**
+ * \brief Graph distances from a few landmark vertices to every vertex, for the ALT lower bound
+ *
+ * By the triangle inequality |d(l, a) - d(l, b)| <= d(a, b) for every landmark l, which in cluttered spaces is far
+ * tighter than the straight line distance. Adding an edge only shortens distances, so the tables are updated by
+ * continuing Dijkstra from the endpoint that got closer. Removing edges or vertices leaves the tables as they are:
+ * they are then exact distances in a supergraph of the roadmap, which are still admissible and consistent lower
+ * bounds, only looser. The task graph looks up the sparse vertex each of its level 0 and level 2 vertices was copied
+ * from.
+ */
+class LandmarkHeuristic
+{
+public:
+  /** \brief Distance to vertices a landmark does not reach */
+  static const double UNREACHED;
+
+  explicit LandmarkHeuristic(const SparseAdjList &graph);
+
+  void clear();
+
+  bool isEmpty() const
+  {
+    return landmarks_.empty();
+  }
+
+  std::size_t getNumLandmarks() const
+  {
+    return landmarks_.size();
+  }
+
+  const std::vector<SparseVertex> &getLandmarks() const
+  {
+    return landmarks_;
+  }
+
+  /**
+   * \brief Choose the landmarks and compute their distances to every vertex
+   * \param numLandmarks - the first is the vertex farthest from firstVertex, each next one the vertex farthest from
+   *                       those chosen so far. Components no landmark reaches are covered first
+   * \param firstVertex - vertices below it, i.e. the query vertices, are never landmarks
+   */
+  void compute(std::size_t numLandmarks, SparseVertex firstVertex);
+
+  /** \brief Replace the tables, e.g. with ones loaded from file. distances holds numLandmarks values per vertex */
+  void setTables(const std::vector<SparseVertex> &landmarks, const std::vector<double> &distances);
+
+  /** \brief Call after adding a vertex to the graph */
+  void addVertex(SparseVertex v);
+
+  /** \brief Call after adding an edge to the graph */
+  void addEdge(SparseVertex v1, SparseVertex v2, double weight);
+
+  /** \brief Move the tables along with a renumbering of the vertices, see SparseGraph::reorderVertices() */
+  void permute(const std::vector<SparseVertex> &newIndex);
+
+  /** \brief Graph distance from landmark \e i to \e v, UNREACHED if unknown */
+  double getDistance(SparseVertex v, std::size_t i) const
+  {
+    const std::size_t index = v * landmarks_.size() + i;
+    return index < distances_.size() ? distances_[index] : UNREACHED;
+  }
+
+  /** \brief Largest landmark bound on the graph distance between a and b, zero without landmarks */
+  double getLowerBound(SparseVertex a, SparseVertex b) const;
+
+  /** \brief Number of distances lowered by addEdge() since the last compute(), a measure of the work done */
+  std::size_t getNumUpdated() const
+  {
+    return numUpdated_;
+  }
+
+  std::size_t getMemoryBytes() const;
+
+private:
+  /** \brief Continue Dijkstra for landmark \e i from \e v, whose distance was just lowered to \e distance */
+  void propagate(std::size_t i, SparseVertex v, double distance);
+
+  const SparseAdjList &graph_;
+
+  std::vector<SparseVertex> landmarks_;
+
+  /** \brief The distances of each vertex to all landmarks are stored together, as the heuristic reads them */
+  std::vector<double> distances_;
+
+  std::size_t numUpdated_ = 0;
+};
+
+}  // namespace bolt
+}  // namespace tools
+}  // namespace ompl
+
+#endif  // OMPL_TOOLS_BOLT_LANDMARK_HEURISTIC_
@@ -0,0 +1,200 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2016, University of Colorado, Boulder
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the Univ of CO, Boulder nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+/* Author: Dave Coleman <dave@dav.ee>
+   Desc:   Estimate the memory used by the components of a roadmap
+*/
+
+#ifndef OMPL_TOOLS_BOLT_MEMORY_REPORT_
+#define OMPL_TOOLS_BOLT_MEMORY_REPORT_
+
+// OMPL
+#include <ompl/base/SpaceInformation.h>
+
+// C++
+#include <algorithm>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace ompl
+{
+namespace tools
+{
+namespace bolt
+{
+/** \brief Parts of a roadmap whose memory is accounted separately */
+enum MemoryComponent
+{
+  MEMORY_STATES,             // states owned by the vertices
+  MEMORY_VERTICES,           // vertex storage of the graph, including the vertex properties
+  MEMORY_ADJACENCY,          // out-edge lists and edge list nodes
+  MEMORY_EDGE_PROPERTIES,    // weight, type and collision state of each edge
+  MEMORY_INTERFACE_DATA,     // InterfaceHash buckets and nodes, and the states they own
+  MEMORY_NEAREST_NEIGHBORS,  // nodes of the nearest neighbor structure and its copies of the vertices
+  MEMORY_DISJOINT_SETS,      // connected component of each vertex
+  MEMORY_LANDMARKS,          // graph distances from the landmarks of the A* heuristic
+  MEMORY_HIERARCHY,          // upward arcs and shortcuts of the contraction hierarchy
+  MEMORY_WORKSPACE_INDEX,    // cells of the workspace and the edges listed in them
+  MEMORY_MOTION_CACHE,       // results of motion checks between vertices
+  MEMORY_STATE_POOL,         // freed states kept for reuse by the generation threads
+  NUM_MEMORY_COMPONENTS
+};
+
+/**
+ * \brief Bytes used by each component of a roadmap.
+ *
+ * Containers are measured from their sizes and capacities. Heap allocations are counted with an assumed overhead
+ * of 16 bytes, and the internals of the nearest neighbor structure are estimated from its number of elements, so
+ * the totals are close to but not exactly what the allocator reports. SparseGraph and TaskGraph both show theirs in
+ * printGraphStats().
+ */
+class MemoryReport
+{
+public:
+  MemoryReport();
+
+  void add(MemoryComponent component, std::size_t bytes)
+  {
+    bytes_[component] += bytes;
+  }
+
+  /** \brief Attribute bytes already counted in one component to another instead */
+  void transfer(MemoryComponent from, MemoryComponent to, std::size_t bytes)
+  {
+    bytes = std::min(bytes, bytes_[from]);
+    bytes_[from] -= bytes;
+    bytes_[to] += bytes;
+  }
+
+  std::size_t get(MemoryComponent component) const
+  {
+    return bytes_[component];
+  }
+
+  /** \brief Sum of all components */
+  std::size_t getTotal() const;
+
+  /** \brief Add all components of another report, e.g. to combine the SparseGraph and TaskGraph */
+  MemoryReport &operator+=(const MemoryReport &other);
+
+  /** \brief Short lower case names, used as keys in the reports */
+  static std::string getComponentName(MemoryComponent component);
+
+  /** \brief Human readable size, e.g. "12.3 MB" */
+  static std::string formatBytes(double bytes);
+
+  /** \brief Breakdown of the components with their share of the total and their size per vertex */
+  void print(const std::string &title, std::ostream &out = std::cout) const;
+
+  /** \brief Estimated size of one state allocated by the space, including allocation overhead */
+  static std::size_t estimateStateBytes(const base::SpaceInformationPtr &si);
+
+  /** \brief Estimated size of a GNAT holding \e size elements with the default degree and leaf size */
+  static std::size_t estimateNearestNeighborsBytes(std::size_t size, std::size_t elementBytes);
+
+  /** \brief Bucket array and nodes of an unordered map, not including memory owned by the values */
+  template <class Map>
+  static std::size_t estimateHashMapBytes(const Map &map)
+  {
+    // Each node holds the value, a next pointer and the cached hash
+    return map.bucket_count() * sizeof(void *) +
+           map.size() * (sizeof(typename Map::value_type) + 2 * sizeof(void *) + ALLOCATION_OVERHEAD);
+  }
+
+  /** \brief Add the storage of a boost::adjacency_list with vecS vertices and undirected edges */
+  template <class Graph>
+  void addAdjacencyList(const Graph &g)
+  {
+    // Vertex properties are stored inline with the out-edge list of each vertex
+    add(MEMORY_VERTICES, g.m_vertices.capacity() * sizeof(g.m_vertices.front()));
+    for (std::size_t i = 0; i < g.m_vertices.size(); ++i)
+    {
+      const std::size_t outEdges = g.m_vertices[i].m_out_edges.capacity();
+      if (outEdges)
+        add(MEMORY_ADJACENCY, outEdges * sizeof(g.m_vertices[i].m_out_edges.front()) + ALLOCATION_OVERHEAD);
+    }
+
+    // Undirected edges live once in a std::list, with their properties inline
+    const std::size_t edgeBytes = sizeof(g.m_edges.front());
+    const std::size_t propertyBytes = sizeof(g.m_edges.front().get_property());
+    add(MEMORY_ADJACENCY, g.m_edges.size() * (edgeBytes - propertyBytes + 2 * sizeof(void *) + ALLOCATION_OVERHEAD));
+    add(MEMORY_EDGE_PROPERTIES, g.m_edges.size() * propertyBytes);
+  }
+
+  /** \brief Assumed bookkeeping cost of every heap allocation */
+  static const std::size_t ALLOCATION_OVERHEAD = 16;
+
+  /** \brief Size of the graph the report was made for */
+  std::size_t numVertices_ = 0;
+  std::size_t numEdges_ = 0;
+
+private:
+  std::size_t bytes_[NUM_MEMORY_COMPONENTS];
+};
+
+/** \brief Keeps memory reports taken during generation to show which components grow the fastest */
+class MemoryTracker
+{
+public:
+  void reset()
+  {
+    history_.clear();
+  }
+
+  void record(const MemoryReport &report)
+  {
+    history_.push_back(report);
+  }
+
+  const std::vector<MemoryReport> &getHistory() const
+  {
+    return history_;
+  }
+
+  /** \brief Growth of each component from the first to the last report, largest first */
+  void printGrowth(std::ostream &out = std::cout) const;
+
+  /** \brief Write one row per recorded report */
+  bool writeCSV(const std::string &filePath) const;
+
+private:
+  std::vector<MemoryReport> history_;
+};
+
+}  // namespace bolt
+}  // namespace tools
+}  // namespace ompl
+
+#endif  // OMPL_TOOLS_BOLT_MEMORY_REPORT_
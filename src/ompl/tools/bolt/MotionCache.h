@@ -0,0 +1,131 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2016, University of Colorado, Boulder
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the Univ of CO, Boulder nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+/* Author: Dave Coleman <dave@dav.ee>
+   Desc:   Thread safe cache of the validity of motions between roadmap vertices
+*/
+
+#ifndef OMPL_TOOLS_BOLT_MOTION_CACHE_
+#define OMPL_TOOLS_BOLT_MOTION_CACHE_
+
+// Bolt
+#include <ompl/tools/bolt/MemoryReport.h>
+
+// Boost
+#include <boost/noncopyable.hpp>
+#include <boost/thread/shared_mutex.hpp>
+#include <boost/unordered_map.hpp>
+
+// C++
+#include <atomic>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace ompl
+{
+namespace tools
+{
+namespace bolt
+{
+/**
+ * \brief Remembers whether the motion between two vertices is valid, so the SPARS criteria do not check it again.
+ *
+ * Results are keyed by the unordered pair of vertex ids and split over shards by the hash of the key. Each shard has
+ * its own reader writer lock, so threads looking up different pairs rarely wait on each other and lookups of the
+ * same shard proceed together. The cache knows nothing about the graph: the owner clears it when vertex ids change
+ * or the obstacles move. The checks a CandidateQueue thread made for a candidate are added once the candidate
+ * becomes a vertex.
+ */
+class MotionCache : private boost::noncopyable
+{
+public:
+  typedef std::pair<std::size_t, std::size_t> VertexPair;
+
+  /** \brief \e numShards is rounded up to a power of two */
+  MotionCache(std::size_t numShards = 64);
+
+  /** \brief Forget every result. Not safe while other threads use the cache */
+  void clear();
+
+  /** \brief Number of cached results */
+  std::size_t size() const;
+
+  /** \brief True and the cached result in \e valid if the motion between \e v1 and \e v2 was checked before */
+  bool lookup(std::size_t v1, std::size_t v2, bool &valid) const;
+
+  /** \brief Remember the result of checking the motion between \e v1 and \e v2 */
+  void insert(std::size_t v1, std::size_t v2, bool valid);
+
+  /** \brief Move every result to the new ids of its vertices, e.g. after renumbering. Not thread safe */
+  void permute(const std::vector<std::size_t> &newIndex);
+
+  /** \brief Every cached result, for saving to file */
+  void getResults(std::vector<VertexPair> &validMotions, std::vector<VertexPair> &invalidMotions) const;
+
+  std::size_t getNumLookups() const;
+  std::size_t getNumHits() const;
+
+  /** \brief Share of lookups that found a result, zero before the first lookup */
+  double getHitRate() const;
+
+  void resetCounters();
+
+  void addToMemoryReport(MemoryReport &report) const;
+
+private:
+  struct Shard
+  {
+    mutable boost::shared_mutex mutex_;
+    boost::unordered_map<std::uint64_t, bool> results_;
+
+    /** \brief Counted per shard so that threads do not contend on one counter */
+    mutable std::atomic<std::size_t> lookups_{0};
+    mutable std::atomic<std::size_t> hits_{0};
+  };
+
+  /** \brief The lower vertex id in the high half, so that both directions share one key */
+  static std::uint64_t getKey(std::size_t v1, std::size_t v2);
+
+  std::size_t getShardIndex(std::uint64_t key) const;
+
+  /** \brief Constructed once, because shards can be neither copied nor moved */
+  std::vector<Shard> shards_;
+};
+
+}  // namespace bolt
+}  // namespace tools
+}  // namespace ompl
+
+#endif  // OMPL_TOOLS_BOLT_MOTION_CACHE_
@@ -0,0 +1,249 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2016, University of Colorado, Boulder
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the Univ of CO, Boulder nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+/* Author: Dave Coleman <dave@dav.ee>
+   Desc:   Nearest neighbor structures specialized for RealVector state spaces
+*/
+
+#ifndef OMPL_TOOLS_BOLT_NEAREST_NEIGHBORS_REAL_VECTOR_
+#define OMPL_TOOLS_BOLT_NEAREST_NEIGHBORS_REAL_VECTOR_
+
+// OMPL
+#include <ompl/base/StateSpace.h>
+#include <ompl/datastructures/NearestNeighbors.h>
+
+// Bolt
+#include <ompl/tools/bolt/DistanceKernels.h>
+
+// Boost
+#include <boost/function.hpp>
+#include <boost/unordered_map.hpp>
+
+// C++
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace ompl
+{
+namespace tools
+{
+namespace bolt
+{
+/** \brief Nearest neighbor structures a graph can use. The RealVector ones keep their own contiguous copy of the
+ *         coordinates and compute Euclidean distances directly, so they are only valid for RealVectorStateSpace */
+enum NearestNeighborsType
+{
+  NN_GNAT,          // OMPL's generic GNAT, through the graph's distance function
+  NN_KDTREE,        // k-d tree over a RealVectorStateSpace
+  NN_LINEAR,        // brute force scan over a RealVectorStateSpace
+  NN_KDTREE_FLOAT,  // k-d tree keeping its coordinates in single precision
+  NN_LINEAR_FLOAT   // brute force scan keeping its coordinates in single precision
+};
+
+/** \brief Returns the coordinates of a vertex, valid until the vertex's state is freed */
+typedef boost::function<const double *(std::size_t)> CoordinateFunction;
+
+/** \brief Common parts of the RealVector nearest neighbor structures. The distance function set by the graph is not
+ *         used. Results of nearestK() and nearestR() are sorted by distance */
+class NearestNeighborsRealVector : public NearestNeighbors<std::size_t>
+{
+public:
+  NearestNeighborsRealVector(std::size_t dimension, const CoordinateFunction &coordinates);
+
+  virtual ~NearestNeighborsRealVector()
+  {
+  }
+
+  virtual bool reportsSortedResults() const
+  {
+    return true;
+  }
+
+  /** \brief Bytes used by the structure, including the copy of the coordinates */
+  virtual std::size_t getMemoryBytes() const = 0;
+
+protected:
+  /** \brief Keeps the k closest elements within a radius */
+  class ResultSet
+  {
+  public:
+    ResultSet(std::size_t k, double radiusSquared);
+
+    /** \brief Elements further than this can not be part of the result */
+    double getBound() const
+    {
+      return results_.size() < k_ ? radiusSquared_ : results_.front().first;
+    }
+
+    void insert(double distanceSquared, std::size_t id);
+
+    /** \brief Copy the elements to \e ids, closest first */
+    void getSorted(std::vector<std::size_t> &ids);
+
+  private:
+    std::size_t k_;
+    double radiusSquared_;
+    std::vector<std::pair<double, std::size_t> > results_;  // max heap when k_ limits the size
+  };
+
+  /** \brief Compare \e query against \e count contiguous points, in chunks small enough to stay on the stack */
+  template <typename Scalar>
+  void scan(const Scalar *query, const Scalar *points, const std::size_t *ids, std::size_t count,
+            ResultSet &results) const;
+
+  /** \brief Batched distances through the kernel for the coordinate type */
+  void distanceSquaredBatch(const double *query, const double *points, std::size_t count, double *distances) const
+  {
+    kernels_.distanceSquaredBatch_(query, points, count, dimension_, distances);
+  }
+  void distanceSquaredBatch(const float *query, const float *points, std::size_t count, double *distances) const
+  {
+    kernels_.distanceSquaredBatchFloat_(query, points, count, dimension_, distances);
+  }
+
+  /** \brief Coordinates of an element as \e Scalar. Single precision queries are converted into a per-thread
+   *         buffer, so the returned pointer is only valid until the next call on the same thread */
+  const double *getQuery(std::size_t data, const double *) const
+  {
+    return coordinates_(data);
+  }
+  const float *getQuery(std::size_t data, const float *) const;
+
+  std::size_t dimension_;
+
+  CoordinateFunction coordinates_;
+
+  /** \brief Chosen for the CPU once, when the structure is created */
+  const DistanceKernels &kernels_;
+};
+
+/** \brief Brute force search over coordinates stored contiguously, which makes the scan easy to vectorize. Fast for
+ *         small graphs and for radii that cover a large fraction of the space. \e Scalar is double or float */
+template <typename Scalar>
+class NearestNeighborsLinearRV : public NearestNeighborsRealVector
+{
+public:
+  NearestNeighborsLinearRV(std::size_t dimension, const CoordinateFunction &coordinates);
+
+  virtual void clear();
+  virtual void add(const std::size_t &data);
+  virtual void add(const std::vector<std::size_t> &data);
+  virtual bool remove(const std::size_t &data);
+  virtual std::size_t nearest(const std::size_t &data) const;
+  virtual void nearestK(const std::size_t &data, std::size_t k, std::vector<std::size_t> &nbh) const;
+  virtual void nearestR(const std::size_t &data, double radius, std::vector<std::size_t> &nbh) const;
+  virtual std::size_t size() const;
+  virtual void list(std::vector<std::size_t> &data) const;
+  virtual std::size_t getMemoryBytes() const;
+
+private:
+  void search(const Scalar *query, ResultSet &results) const;
+
+  std::vector<Scalar> points_;
+  std::vector<std::size_t> ids_;
+  boost::unordered_map<std::size_t, std::size_t> slots_;  // id to index in ids_
+};
+
+/** \brief k-d tree with leaves stored contiguously in tree order. Inserts go to a small buffer that is scanned
+ *         linearly and removals leave tombstones. Both are folded into a rebuilt tree once they make up a quarter of
+ *         the elements, so queries never modify the structure and may run concurrently. \e Scalar is double or float */
+template <typename Scalar>
+class NearestNeighborsKDTreeRV : public NearestNeighborsRealVector
+{
+public:
+  NearestNeighborsKDTreeRV(std::size_t dimension, const CoordinateFunction &coordinates);
+
+  virtual void clear();
+  virtual void add(const std::size_t &data);
+  virtual void add(const std::vector<std::size_t> &data);
+  virtual bool remove(const std::size_t &data);
+  virtual std::size_t nearest(const std::size_t &data) const;
+  virtual void nearestK(const std::size_t &data, std::size_t k, std::vector<std::size_t> &nbh) const;
+  virtual void nearestR(const std::size_t &data, double radius, std::vector<std::size_t> &nbh) const;
+  virtual std::size_t size() const;
+  virtual void list(std::vector<std::size_t> &data) const;
+  virtual std::size_t getMemoryBytes() const;
+
+  /** \brief Elements per leaf */
+  static const std::size_t LEAF_SIZE = 16;
+
+private:
+  struct Node
+  {
+    std::size_t begin_, end_;    // range of elements in tree order
+    std::size_t left_, right_;  // children, 0 for leaves since the root is never a child
+    std::size_t splitDimension_;
+    double splitValue_;
+  };
+
+  void search(const Scalar *query, ResultSet &results) const;
+
+  /** \brief Rebuild the tree if the buffer or the tombstones have grown too large */
+  void maintain();
+
+  void rebuild();
+
+  std::size_t build(std::vector<std::size_t> &order, std::size_t begin, std::size_t end,
+                    const std::vector<Scalar> &points);
+
+  // Tree, in tree order
+  std::vector<Node> nodes_;
+  std::vector<Scalar> treePoints_;
+  std::vector<std::size_t> treeIds_;
+  std::vector<char> alive_;
+  std::size_t numDead_ = 0;
+
+  // Recently added elements
+  std::vector<Scalar> bufferPoints_;
+  std::vector<std::size_t> bufferIds_;
+
+  /** \brief Location of every element: index in the tree, or in the buffer if BUFFER_FLAG is set */
+  boost::unordered_map<std::size_t, std::size_t> locations_;
+  static const std::size_t BUFFER_FLAG = std::size_t(1) << (sizeof(std::size_t) * 8 - 1);
+};
+
+/** \brief Allocate a nearest neighbor structure of the requested type. RealVector types fall back to GNAT with a
+ *         warning if the space is not a RealVectorStateSpace. The caller still sets the distance function */
+NearestNeighbors<std::size_t> *allocNearestNeighbors(NearestNeighborsType type, const base::StateSpacePtr &space,
+                                                     const CoordinateFunction &coordinates);
+
+/** \brief Name of a nearest neighbor type, for logs and command line options */
+std::string getNearestNeighborsName(NearestNeighborsType type);
+
+}  // namespace bolt
+}  // namespace tools
+}  // namespace ompl
+
+#endif  // OMPL_TOOLS_BOLT_NEAREST_NEIGHBORS_REAL_VECTOR_
@@ -0,0 +1,260 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2016, University of Colorado, Boulder
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the Univ of CO, Boulder nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+/* Author: Dave Coleman <dave@dav.ee>
+   Desc:   Per-query records and latency histograms of experience planning
+*/
+
+#ifndef OMPL_TOOLS_BOLT_QUERY_LOG_
+#define OMPL_TOOLS_BOLT_QUERY_LOG_
+
+// OMPL
+#include <ompl/util/ClassForward.h>
+#include <ompl/util/Time.h>
+
+// Boost
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/lock_guard.hpp>
+
+// C++
+#include <cstdint>
+#include <deque>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace ompl
+{
+namespace tools
+{
+namespace bolt
+{
+/** \brief Where time is spent answering a query. The phases do not nest, QUERY_TOTAL includes all of them */
+enum QueryPhase
+{
+  QUERY_TOTAL,            // the full call to Bolt::solve()
+  QUERY_NEIGHBOR_SEARCH,  // nearest neighbor searches for the start and goal
+  QUERY_VISIBILITY,       // motion checks from the start and goal to their candidate neighbors
+  QUERY_ASTAR,            // searches on the task graph
+  QUERY_LAZY_CHECK,       // collision checking the edges of the A* results
+  QUERY_SIMPLIFICATION,   // smoothing the recalled path
+  NUM_QUERY_PHASES
+};
+
+/** \brief Everything measured while answering a single query */
+struct QueryRecord
+{
+  /** \brief Clear all measurements */
+  void reset()
+  {
+    *this = QueryRecord();
+  }
+
+  /** \brief Sequence number of the query, assigned by the QueryLog */
+  std::size_t id_ = 0;
+
+  /** \brief Name of the planner status, e.g. "Exact solution" */
+  std::string status_;
+  bool solved_ = false;
+
+  /** \brief Time spent per phase, in seconds */
+  double phaseTimes_[NUM_QUERY_PHASES] = {};
+
+  /** \brief Number of A* searches, one more than the number of times lazy collision checking invalidated a path */
+  std::size_t astarSearches_ = 0;
+
+  /** \brief Number of candidate paths that were lazily collision checked */
+  std::size_t lazyCheckRounds_ = 0;
+
+  /** \brief Number of start and goal candidates tested for visibility */
+  std::size_t visibilityChecks_ = 0;
+
+  /** \brief Nodes discovered and examined, summed over all A* searches */
+  std::size_t nodesOpened_ = 0;
+  std::size_t nodesClosed_ = 0;
+
+  /** \brief Collision checks of any kind made during the query */
+  std::size_t stateChecks_ = 0;
+  std::size_t motionChecks_ = 0;
+
+  /** \brief Size of the solution and of the graph it was recalled from */
+  std::size_t solutionStates_ = 0;
+  std::size_t graphVertices_ = 0;
+  std::size_t graphEdges_ = 0;
+};
+
+/**
+ * \brief Log-linear bucketed histogram of latencies, in the style of an HdrHistogram.
+ *
+ * Values are stored in microseconds. Each power of two is split into 64 sub buckets so that any percentile is
+ * reported with a relative error below 1.6%, using a fixed 16KB of memory regardless of the number of values.
+ */
+class LatencyHistogram
+{
+public:
+  LatencyHistogram();
+
+  /** \brief Clear all recorded values */
+  void reset();
+
+  /** \brief Add one value, in seconds */
+  void record(double seconds);
+
+  /** \brief Add all values of another histogram */
+  void merge(const LatencyHistogram &other);
+
+  std::size_t getCount() const
+  {
+    return count_;
+  }
+
+  /** \brief Exact statistics, in seconds */
+  double getMin() const;
+  double getMax() const;
+  double getMean() const;
+
+  /** \brief Value below which the given fraction of the recorded values fall, in seconds
+   *  \param fraction - between 0 and 1, e.g. 0.99 for the 99th percentile
+   */
+  double getPercentile(double fraction) const;
+
+private:
+  /** \brief Map a value in microseconds to its bucket and back to the largest value sharing that bucket */
+  static std::size_t getBucket(std::uint64_t micros);
+  static std::uint64_t getBucketUpperBound(std::size_t bucket);
+
+  std::vector<std::uint64_t> counts_;
+  std::size_t count_;
+  std::uint64_t min_;
+  std::uint64_t max_;
+  double total_;
+};
+
+/// @cond IGNORE
+OMPL_CLASS_FORWARD(QueryLog);
+/// @endcond
+
+/** \class ompl::tools::bolt::QueryLogPtr
+    \brief A boost shared pointer wrapper for ompl::tools::bolt::QueryLog */
+
+/**
+ * \brief Structured log of the queries answered by Bolt.
+ *
+ * Keeps the most recent records and a latency histogram per phase covering every query since the last reset. All
+ * methods lock, so the log can be printed or written to file from another thread while queries are being solved.
+ * Bolt::printLogs() shows the p50, p90, p99 and p999 latency of every phase.
+ */
+class QueryLog
+{
+public:
+  /** \brief Constructor
+   *  \param maxRecords - number of most recent records kept, the histograms are not limited
+   */
+  QueryLog(std::size_t maxRecords = 10000);
+
+  /** \brief Clear all records and histograms */
+  void reset();
+
+  /** \brief Add a finished query, assigning it the next id */
+  void addRecord(QueryRecord record);
+
+  /** \brief Number of queries added since the last reset */
+  std::size_t getNumQueries() const;
+
+  /** \brief Copy of the kept records, oldest first */
+  std::vector<QueryRecord> getRecords() const;
+
+  /** \brief Copy of the histogram of a phase, over all queries or only those that found a solution */
+  LatencyHistogram getHistogram(QueryPhase phase, bool solvedOnly = false) const;
+
+  /** \brief Short lower case names, used as keys in the reports */
+  static std::string getPhaseName(QueryPhase phase);
+
+  /** \brief Human readable p50/p99/p999 per phase */
+  void print(std::ostream &out = std::cout) const;
+
+  /** \brief Write the histogram summaries and the kept records */
+  bool writeJSON(const std::string &filePath) const;
+
+  /** \brief Write one row per kept record */
+  bool writeCSV(const std::string &filePath) const;
+
+private:
+  void writeHistogramJSON(std::ostream &out, const LatencyHistogram &histogram) const;
+
+  /** \brief Short name of this class */
+  const std::string name_ = "QueryLog";
+
+  mutable boost::mutex mutex_;
+
+  std::size_t maxRecords_;
+  std::size_t numQueries_ = 0;
+  std::deque<QueryRecord> records_;
+
+  LatencyHistogram histograms_[NUM_QUERY_PHASES];
+  LatencyHistogram solvedHistograms_[NUM_QUERY_PHASES];
+};
+
+/** \brief Adds the time between construction and destruction to a phase of a query record */
+class ScopedQueryTimer
+{
+public:
+  ScopedQueryTimer(QueryRecord &record, QueryPhase phase) : record_(&record), phase_(phase), startTime_(time::now())
+  {
+  }
+
+  ~ScopedQueryTimer()
+  {
+    stop();
+  }
+
+  /** \brief Record the elapsed time now instead of at the end of the scope */
+  void stop()
+  {
+    if (record_)
+      record_->phaseTimes_[phase_] += time::seconds(time::now() - startTime_);
+    record_ = nullptr;
+  }
+
+private:
+  QueryRecord *record_;
+  QueryPhase phase_;
+  time::point startTime_;
+};
+
+}  // namespace bolt
+}  // namespace tools
+}  // namespace ompl
+
+#endif  // OMPL_TOOLS_BOLT_QUERY_LOG_
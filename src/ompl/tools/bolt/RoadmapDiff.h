@@ -0,0 +1,156 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2016, University of Colorado, Boulder
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the Univ of CO, Boulder nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+/* Author: Dave Coleman <dave@dav.ee>
+   Desc:   Structural difference between two saved roadmaps, which can be stored and applied as a delta
+*/
+
+#ifndef OMPL_TOOLS_BOLT_ROADMAP_DIFF_
+#define OMPL_TOOLS_BOLT_ROADMAP_DIFF_
+
+// OMPL
+#include <ompl/tools/bolt/SparseStorage.h>
+#include <ompl/datastructures/NearestNeighbors.h>
+
+// C++
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace ompl
+{
+namespace tools
+{
+namespace bolt
+{
+/// @cond IGNORE
+OMPL_CLASS_FORWARD(RoadmapDiff);
+/// @endcond
+
+/** \class ompl::tools::bolt::RoadmapDiffPtr
+    \brief A boost shared pointer wrapper for ompl::tools::bolt::RoadmapDiff */
+
+/** \brief Changes that turn an old roadmap into a new one. Vertices are numbered with the old roadmap's vertices
+ *         first, followed by the added vertices in order */
+struct RoadmapDelta
+{
+  template <typename Archive>
+  void serialize(Archive &ar, const unsigned int /*version*/)
+  {
+    ar &marker_;
+    ar &signature_;
+    ar &numOldVertices_;
+    ar &removedVertices_;
+    ar &addedVertices_;
+    ar &removedEdges_;
+    ar &addedEdges_;
+  }
+
+  boost::uint32_t marker_ = 0;
+
+  /** \brief Signature of the state space of both roadmaps */
+  std::vector<int> signature_;
+
+  std::size_t numOldVertices_ = 0;
+
+  /** \brief Indices of old vertices not in the new roadmap. Their edges are removed with them */
+  std::vector<unsigned int> removedVertices_;
+
+  std::vector<SparseStorage::BoltVertexData> addedVertices_;
+
+  /** \brief Edges between two old vertices that are kept, but that are not in the new roadmap */
+  std::vector<std::pair<unsigned int, unsigned int> > removedEdges_;
+
+  std::vector<SparseStorage::BoltEdgeData> addedEdges_;
+};
+
+/** \brief Compares two roadmaps saved by SparseStorage. Vertices of the new roadmap that are within a tolerance of
+ *         a vertex of the old one are the same vertex. Works on the files alone, no SparseGraph is needed. The
+ *         delta can be saved, shipped and applied to the old file to reproduce the new one */
+class RoadmapDiff
+{
+public:
+  /** \brief Constructor */
+  RoadmapDiff(base::SpaceInformationPtr si);
+
+  /** \brief Compute the delta from the roadmap in \e oldFilePath to the one in \e newFilePath */
+  bool compute(const std::string &oldFilePath, const std::string &newFilePath, std::size_t indent = 0);
+
+  /** \brief Apply the current delta to the roadmap in \e oldFilePath and write the result to \e newFilePath */
+  bool apply(const std::string &oldFilePath, const std::string &newFilePath, std::size_t indent = 0);
+
+  /** \brief Save or load the current delta */
+  bool save(const std::string &filePath);
+  bool load(const std::string &filePath);
+
+  const RoadmapDelta &getDelta() const
+  {
+    return delta_;
+  }
+
+  /** \brief Summary of the current delta */
+  void print(std::ostream &out = std::cout) const;
+
+private:
+  /** \brief Distance between two old vertices, or the query state */
+  double distanceFunction(const std::size_t a, const std::size_t b) const;
+
+  /** \brief Free the states of the old roadmap */
+  void clearStates();
+
+  /** \brief Short name of this class */
+  const std::string name_ = "RoadmapDiff";
+
+  /** \brief The created space information */
+  base::SpaceInformationPtr si_;
+
+  SparseStorage storage_;
+
+  RoadmapDelta delta_;
+
+  /** \brief States of the old roadmap and the state being looked up, used by the nearest neighbor structure */
+  std::vector<base::State *> oldStates_;
+  base::State *queryState_ = nullptr;
+
+public:
+  /** \brief Vertices closer than this are the same vertex */
+  double tolerance_ = 1e-6;
+
+};  // end class RoadmapDiff
+
+}  // namespace bolt
+}  // namespace tools
+}  // namespace ompl
+
+#endif  // OMPL_TOOLS_BOLT_ROADMAP_DIFF_
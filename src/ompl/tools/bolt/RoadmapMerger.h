@@ -0,0 +1,143 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2016, University of Colorado, Boulder
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the Univ of CO, Boulder nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+/* Author: Dave Coleman <dave@dav.ee>
+   Desc:   Stitch the roadmaps of independently generated regions into one sparse graph
+*/
+
+#ifndef OMPL_TOOLS_BOLT_ROADMAP_MERGER_
+#define OMPL_TOOLS_BOLT_ROADMAP_MERGER_
+
+// OMPL
+#include <ompl/tools/bolt/RoadmapPartition.h>
+#include <ompl/tools/bolt/SparseGenerator.h>
+
+// C++
+#include <string>
+#include <vector>
+
+namespace ompl
+{
+namespace tools
+{
+namespace bolt
+{
+/// @cond IGNORE
+OMPL_CLASS_FORWARD(RoadmapMerger);
+/// @endcond
+
+/** \class ompl::tools::bolt::RoadmapMergerPtr
+    \brief A boost shared pointer wrapper for ompl::tools::bolt::RoadmapMerger */
+
+/** \brief Combines saved roadmaps into one sparse graph. Vertices and edges that are already well placed are copied
+ *         unchanged, and only the states where two roadmaps overlap are run through the coverage, connectivity and
+ *         interface criteria against the combined graph.
+ *
+ *         merge() combines the roadmaps generated for each region of a RoadmapPartition: every region contributes
+ *         the vertices in its core and the vertices it generated in the cores of its neighbors become candidates.
+ *         mergeFile() adds any saved roadmap to the current graph, e.g. one built later for another cell layout */
+class RoadmapMerger
+{
+public:
+  /** \brief Constructor. The partition is only needed by merge() */
+  RoadmapMerger(SparseGraphPtr sg, SparseGeneratorPtr sparseGenerator,
+                RoadmapPartitionPtr partition = RoadmapPartitionPtr());
+
+  /** \brief Combine one file per region, in the order of the regions, and save the result to \e filePath */
+  bool merge(const std::vector<std::string> &regionFilePaths, const std::string &filePath, std::size_t indent = 0);
+
+  /** \brief Add a saved roadmap to the sparse graph, which does not need to be empty. Incoming vertices within
+   *         dedupTolerance_ of an existing vertex are merged into it. Those within the sparse delta of an existing
+   *         vertex are candidates, and all others are copied along with the edges between copied or merged vertices.
+   *         Edges with a merged endpoint are collision checked again first. The graph is not saved */
+  bool mergeFile(const std::string &filePath, std::size_t indent = 0);
+
+  std::size_t getNumCandidates() const
+  {
+    return numCandidates_;
+  }
+
+  std::size_t getNumStitched() const
+  {
+    return numStitched_;
+  }
+
+  std::size_t getNumDeduplicated() const
+  {
+    return numDeduplicated_;
+  }
+
+private:
+  /** \brief Add the core of one region to the graph and keep its states in the overlap as candidates. Roadmap files
+   *         do not store interface data, so the merged graph starts without any, as after SparseStorage::load() */
+  bool addRegion(std::size_t id, const std::string &filePath, std::vector<base::State *> &candidates,
+                 std::size_t indent);
+
+  /** \brief Closest vertex of the graph to a state, or the query vertex if the graph is empty */
+  SparseVertex findNearestVertex(const base::State *state, double &distance);
+
+  /** \brief Offer the candidates to the SPARS criteria until a pass adds nothing. Returns the number added */
+  std::size_t stitch(std::vector<base::State *> &candidates, std::size_t indent);
+
+  /** \brief Short name of this class */
+  const std::string name_ = "RoadmapMerger";
+
+  SparseGraphPtr sg_;
+  SparseCriteriaPtr sparseCriteria_;
+  SparseGeneratorPtr sparseGenerator_;
+  RoadmapPartitionPtr partition_;
+
+  /** \brief The created space information */
+  base::SpaceInformationPtr si_;
+
+  std::size_t numCandidates_ = 0;
+  std::size_t numStitched_ = 0;
+  std::size_t numDeduplicated_ = 0;
+
+public:
+  /** \brief Passes over the candidates. Later passes pick up connections made possible by the earlier ones */
+  std::size_t maxStitchPasses_ = 3;
+
+  /** \brief Incoming vertices closer than this to an existing vertex are the same vertex in mergeFile() */
+  double dedupTolerance_ = 1e-6;
+
+  bool verbose_ = true;
+
+};  // end class RoadmapMerger
+
+}  // namespace bolt
+}  // namespace tools
+}  // namespace ompl
+
+#endif  // OMPL_TOOLS_BOLT_ROADMAP_MERGER_
@@ -0,0 +1,150 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2016, University of Colorado, Boulder
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the Univ of CO, Boulder nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+/* Author: Dave Coleman <dave@dav.ee>
+   Desc:   Split the state space into overlapping regions that are generated independently
+*/
+
+#ifndef OMPL_TOOLS_BOLT_ROADMAP_PARTITION_
+#define OMPL_TOOLS_BOLT_ROADMAP_PARTITION_
+
+// OMPL
+#include <ompl/base/SpaceInformation.h>
+#include <ompl/util/ClassForward.h>
+
+// C++
+#include <string>
+#include <vector>
+
+namespace ompl
+{
+namespace tools
+{
+namespace bolt
+{
+/// @cond IGNORE
+OMPL_CLASS_FORWARD(RoadmapPartition);
+/// @endcond
+
+/** \class ompl::tools::bolt::RoadmapPartitionPtr
+    \brief A boost shared pointer wrapper for ompl::tools::bolt::RoadmapPartition */
+
+/** \brief One slab of the state space along the split axis */
+struct PartitionRegion
+{
+  /** \brief The part of the axis this region owns after merging */
+  double coreLow_;
+  double coreHigh_;
+
+  /** \brief The part of the axis this region is generated in, i.e. the core plus the overlap with its neighbors */
+  double low_;
+  double high_;
+};
+
+/** \brief Divides the state space into slabs along one coordinate. Each slab is grown by an overlap on both sides
+ *         so that the roadmaps of neighboring regions share states near their common boundary, which the
+ *         RoadmapMerger uses to stitch them together.
+ *
+ *         Every process sets up Bolt as usual, calls split() with the same arguments, then restrictBounds(id) and
+ *         SparseGenerator::setPartitionRegion(partition, id), and saves its roadmap to getRegionFilePath(path, id).
+ *         RoadmapMerger::merge() then combines the region files */
+class RoadmapPartition
+{
+public:
+  /** \brief Constructor */
+  RoadmapPartition(base::SpaceInformationPtr si);
+
+  /** \brief Split the bounds of the state space along \e axis into \e numRegions slabs of equal width. The overlap
+   *         should be at least the sparse delta, so the merge has states to work with on both sides of a seam */
+  bool split(std::size_t numRegions, double overlap, std::size_t axis = 0);
+
+  std::size_t getNumRegions() const
+  {
+    return regions_.size();
+  }
+
+  const PartitionRegion &getRegion(std::size_t id) const
+  {
+    return regions_[id];
+  }
+
+  std::size_t getAxis() const
+  {
+    return axis_;
+  }
+
+  double getOverlap() const
+  {
+    return overlap_;
+  }
+
+  /** \brief Value of the split coordinate of a state */
+  double getCoordinate(const base::State *state) const;
+
+  /** \brief The region whose core contains the state */
+  std::size_t getOwner(const base::State *state) const;
+
+  /** \brief Whether a state may be added while generating region \e id */
+  bool inRegion(const base::State *state, std::size_t id) const;
+
+  /** \brief Whether a state is within the overlap of two regions, where the merge applies the SPARS criteria */
+  bool inOverlap(const base::State *state) const;
+
+  /** \brief Narrow the bounds of the split axis to region \e id, so that samplers only draw states there. Only
+   *         possible for RealVectorStateSpace, otherwise SparseGenerator rejects candidates outside the region */
+  bool restrictBounds(std::size_t id) const;
+
+  /** \brief Where the roadmap of a region is saved, derived from the path of the merged roadmap */
+  static std::string getRegionFilePath(const std::string &filePath, std::size_t id);
+
+private:
+  /** \brief Short name of this class */
+  const std::string name_ = "RoadmapPartition";
+
+  /** \brief The created space information */
+  base::SpaceInformationPtr si_;
+
+  std::vector<PartitionRegion> regions_;
+
+  std::size_t axis_ = 0;
+
+  double overlap_ = 0;
+
+};  // end class RoadmapPartition
+
+}  // namespace bolt
+}  // namespace tools
+}  // namespace ompl
+
+#endif  // OMPL_TOOLS_BOLT_ROADMAP_PARTITION_
@@ -45,6 +45,9 @@
 #include <ompl/tools/debug/Visualizer.h>
 #include <ompl/tools/bolt/Debug.h>
 #include <ompl/tools/bolt/BoostGraphHeaders.h>
+#include <ompl/tools/bolt/CoverageGrid.h>
+#include <ompl/tools/bolt/HaltonSampler.h>
+#include <ompl/tools/bolt/BoundarySampler.h>
 
 // Boost
 #include <boost/thread/shared_mutex.hpp>
@@ -99,8 +102,28 @@ public:
     targetQueueSize_ = 20 * numThreads;
   }
 
+  /** \brief Bias the samples of the next startSampling() by \e grid, or sample uniformly if it is null */
+  void setCoverageGrid(CoverageGridPtr grid)
+  {
+    coverageGrid_ = grid;
+  }
+
+  /** \brief Sequence the samples of the next startSampling() are drawn from, this queue takes the first stream */
+  void setSampleSequence(SampleSequence sequence, std::uint_fast32_t seed)
+  {
+    sampleSequence_ = sequence;
+    seed_ = seed;
+  }
+
+  /** \brief Mix samples near obstacle boundaries into those of the next startSampling(), or none if it is null */
+  void setSampleMixer(SampleMixerPtr mixer)
+  {
+    sampleMixer_ = mixer;
+  }
+
 private:
-  void samplingThread(base::SpaceInformationPtr si, ClearanceSamplerPtr clearanceSampler, std::size_t indent);
+  void samplingThread(base::SpaceInformationPtr si, ClearanceSamplerPtr clearanceSampler,
+                      ClearanceSamplerPtr boundarySampler, std::size_t indent);
 
   /** \brief Do not add more states if queue is full */
   void waitForQueueNotFull(std::size_t indent);
@@ -119,6 +142,15 @@ private:
 
   std::queue<base::State *> statesQueue_;
 
+  /** \brief Acceptance history of the samples, optional */
+  CoverageGridPtr coverageGrid_;
+
+  SampleSequence sampleSequence_ = SAMPLE_SEQUENCE_RANDOM;
+  std::uint_fast32_t seed_ = 1;
+
+  /** \brief Share of boundary samples, optional */
+  SampleMixerPtr sampleMixer_;
+
   // When to stop generating states - this is preferrably calculated by formulas, above
   std::size_t targetQueueSize_ = 100;
 
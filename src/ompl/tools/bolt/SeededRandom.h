@@ -0,0 +1,116 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2016, University of Colorado, Boulder
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the Univ of CO, Boulder nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+/* Author: Dave Coleman <dave@dav.ee>
+   Desc:   Seeding of the random number generators used during sparse graph generation
+*/
+
+#ifndef OMPL_TOOLS_BOLT_SEEDED_RANDOM_
+#define OMPL_TOOLS_BOLT_SEEDED_RANDOM_
+
+// OMPL
+#include <ompl/base/StateSampler.h>
+#include <ompl/base/samplers/MinimumClearanceValidStateSampler.h>
+#include <ompl/base/spaces/RealVectorStateSpace.h>
+#include <ompl/geometric/PathSimplifier.h>
+
+// C++
+#include <cstdint>
+
+namespace ompl
+{
+namespace tools
+{
+namespace bolt
+{
+/** \brief What a derived seed is used for, so that no two consumers share a random sequence */
+enum SeedPurpose
+{
+  SEED_CANDIDATES,  // one stream per CandidateQueue sample stream
+  SEED_CRITERIA,    // the sampler used by the SPARS quality criterion
+  SEED_SIMPLIFIER,  // the path simplifier used when adding quality paths
+  SEED_HALTON,      // the shift shared by all Halton streams, and their random neighborhood samples
+  SEED_SAMPLES      // the sampler of SparseGenerator::addRandomSamples()
+};
+
+/** \brief Derive the seed of one random stream from a base seed. Nearby inputs give unrelated outputs */
+std::uint_fast32_t deriveSeed(std::uint_fast32_t seed, SeedPurpose purpose, std::size_t stream = 0);
+
+/**
+ * \brief Uniform sampler of a real vector space whose random numbers only depend on \e seed.
+ *
+ * Each instance owns its generator, so the global seed of OMPL is left alone and streams can be created from any
+ * thread. Samples are drawn exactly like base::RealVectorStateSampler draws them.
+ */
+class SeededStateSampler : public base::RealVectorStateSampler
+{
+public:
+  SeededStateSampler(const base::StateSpace *space, std::uint_fast32_t seed);
+};
+
+/**
+ * \brief Allocate a state sampler whose random numbers only depend on \e seed.
+ *
+ * Only real vector spaces are supported. Other spaces get their default sampler, which is not reproducible.
+ */
+base::StateSamplerPtr allocSeededStateSampler(const base::SpaceInformation *si, std::uint_fast32_t seed);
+
+/** \brief Path simplifier that picks its shortcuts from a generator it seeds with \e seed, see SeededStateSampler */
+class SeededPathSimplifier : public geometric::PathSimplifier
+{
+public:
+  SeededPathSimplifier(const base::SpaceInformationPtr &si, std::uint_fast32_t seed);
+};
+
+/**
+ * \brief Minimum clearance sampler that draws its candidates from a given state sampler.
+ *
+ * Used for the seeded streams of deterministic generation, and for sequences other than the uniform random one, e.g.
+ * a HaltonStateSampler.
+ */
+class SeededClearanceSampler : public base::MinimumClearanceValidStateSampler
+{
+public:
+  /** \brief Draw from a state sampler seeded with \e seed, see allocSeededStateSampler() */
+  SeededClearanceSampler(const base::SpaceInformation *si, std::uint_fast32_t seed);
+
+  /** \brief Draw from \e stateSampler */
+  SeededClearanceSampler(const base::SpaceInformation *si, const base::StateSamplerPtr &stateSampler);
+};
+
+}  // namespace bolt
+}  // namespace tools
+}  // namespace ompl
+
+#endif  // OMPL_TOOLS_BOLT_SEEDED_RANDOM_
@@ -75,6 +75,9 @@ public:
     // TODO: move addVertex stats in SparseGraph here
   }
 
+  /** \brief Replace the sampler used by the quality criterion by a seeded one, for reproducible generation */
+  void seedRandom(std::uint_fast32_t seed);
+
   /**
    * \brief Run various checks/criteria to determine if to keep TaskVertex in sparse graph
    * \param denseVertex - the original vertex to consider
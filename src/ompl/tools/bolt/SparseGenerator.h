@@ -43,6 +43,10 @@
 #include <ompl/tools/bolt/SparseGraph.h>
 #include <ompl/tools/bolt/SamplingQueue.h>
 #include <ompl/tools/bolt/CandidateQueue.h>
+#include <ompl/tools/bolt/RoadmapPartition.h>
+#include <ompl/tools/bolt/CoverageGrid.h>
+#include <ompl/tools/bolt/HaltonSampler.h>
+#include <ompl/tools/bolt/BoundarySampler.h>
 
 namespace ompl
 {
@@ -117,6 +121,26 @@ public:
     return samplingQueue_;
   }
 
+  /** \brief Null unless useCoverageGrid_ was set for the last call to createSPARS() */
+  const CoverageGridPtr &getCoverageGrid() const
+  {
+    return coverageGrid_;
+  }
+
+  /** \brief Only generate the part of the graph in one region of a partition, to be merged with the others by a
+   *         RoadmapMerger. Pass a null partition to generate the whole space again */
+  void setPartitionRegion(RoadmapPartitionPtr partition, std::size_t regionID)
+  {
+    partition_ = partition;
+    regionID_ = regionID;
+  }
+
+  /** \brief Memory reports taken during the last call to createSPARS() */
+  const MemoryTracker &getMemoryTracker() const
+  {
+    return memoryTracker_;
+  }
+
 protected:
   /** \brief Short name of this class */
   const std::string name_ = "SparseGenerator";
@@ -135,6 +159,12 @@ protected:
   /** \brief Sampler user for generating valid samples in the state space */
   base::MinimumClearanceValidStateSamplerPtr clearanceSampler_;
 
+  /** \brief Acceptance history of the random samples, which biases the samplers toward uncovered regions */
+  CoverageGridPtr coverageGrid_;
+
+  /** \brief Share of the SamplingQueue's samples drawn near obstacles, null unless boundarySampling_ is set */
+  SampleMixerPtr sampleMixer_;
+
   /** \brief Secondary thread for sampling and garbage collection */
   SamplingQueuePtr samplingQueue_;
 
@@ -152,6 +182,13 @@ protected:
   time::point timeRandSamplesStarted_;  // calculate rate at which the graph is being built
   time::point timeDiscretizeAndRandomStarted_;
 
+  /** \brief Growth of the graph's memory over the course of generation */
+  MemoryTracker memoryTracker_;
+
+  /** \brief When set, candidates outside of region regionID_ are skipped */
+  RoadmapPartitionPtr partition_;
+  std::size_t regionID_ = 0;
+
 public:
   /** \brief Number of failed state insertion attempts before stopping the algorithm */
   std::size_t terminateAfterFailures_ = 1000;
@@ -167,6 +204,46 @@ public:
   bool useDiscretizedSamples_;
   bool useRandomSamples_;
 
+  /** \brief Sequence random samples are drawn from. The SamplingQueue and each CandidateQueue thread take their own
+   *         stream, or in deterministic mode each sample stream */
+  SampleSequence sampleSequence_ = SAMPLE_SEQUENCE_RANDOM;
+
+  /** \brief Let the SamplingQueue also draw samples near obstacles, more of them as the connectivity and interface
+   *         criteria take over from coverage. Not used in deterministic mode, which bypasses the SamplingQueue */
+  BoundarySampling boundarySampling_ = BOUNDARY_SAMPLING_NONE;
+
+  /** \brief Standard deviation of the distance between the states of a boundary sample pair, 0 for half the sparse
+   *         delta */
+  double boundaryStdDev_ = 0.0;
+
+  /** \brief Skip random samples in regions of the default projection that recently only produced rejections. Not
+   *         used in deterministic mode */
+  bool useCoverageGrid_ = false;
+
+  /** \brief When not empty, the generation profile is written to this path with .json and .csv extensions and the
+   *         memory growth to _memory.csv */
+  std::string profileFilePath_;
+
+  /** \brief Number of candidates between checks of the visualizer for a shutdown request */
+  std::size_t shutdownPollInterval_ = 100;
+
+  /** \brief Take a memory report every this many random samples added, 0 to only report at the start and end */
+  std::size_t memoryTrackingInterval_ = 1000;
+
+  /** \brief Generate the same graph for the same seed regardless of the number of threads or their timing. Candidates
+   *         are drawn from numDeterministicStreams_ seeded streams and evaluated strictly in order, and any candidate
+   *         whose neighbors were found before the last change to the graph has them found again by the parent. The
+   *         SamplingQueue is not used in this mode. addRandomSamples() draws from its own seeded stream, while
+   *         addRandomSamplesOneThread() still goes through the SamplingQueue and is not reproducible */
+  bool deterministic_ = false;
+
+  /** \brief Seed of all random streams in deterministic mode, and of the shift of the Halton streams */
+  std::uint_fast32_t seed_ = 1;
+
+  /** \brief Number of independent sample streams in deterministic mode. Part of the result, so keep it fixed when
+   *         comparing runs. Threads beyond this number stay idle */
+  std::size_t numDeterministicStreams_ = 16;
+
 };  // end SparseGenerator
 
 }  // namespace bolt
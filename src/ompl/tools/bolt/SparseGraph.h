@@ -49,10 +49,24 @@
 
 // Bolt
 #include <ompl/tools/debug/Visualizer.h>
+#include <ompl/tools/bolt/BidirectionalAstar.h>
 #include <ompl/tools/bolt/BoostGraphHeaders.h>
+#include <ompl/tools/bolt/CollisionCheckCounter.h>
+#include <ompl/tools/bolt/CompactGraph.h>
+#include <ompl/tools/bolt/ConnectedComponents.h>
+#include <ompl/tools/bolt/ContractionHierarchy.h>
 #include <ompl/tools/bolt/Debug.h>
+#include <ompl/tools/bolt/DistanceKernels.h>
+#include <ompl/tools/bolt/GenerationProfiler.h>
+#include <ompl/tools/bolt/LandmarkHeuristic.h>
+#include <ompl/tools/bolt/MemoryReport.h>
+#include <ompl/tools/bolt/MotionCache.h>
+#include <ompl/tools/bolt/NearestNeighborsRealVector.h>
 #include <ompl/tools/bolt/VertexDiscretizer.h>
+#include <ompl/tools/bolt/WorkspaceIndex.h>
 #include <ompl/tools/bolt/SparseStorage.h>
+#include <ompl/tools/bolt/StatePool.h>
+#include <ompl/tools/bolt/VertexOrdering.h>
 
 // Boost
 #include <boost/function.hpp>
@@ -62,6 +76,8 @@
 #include <list>
 #include <random>
 #include <mutex>
+#include <atomic>
+#include <cstdint>
 
 namespace ompl
 {
@@ -135,20 +151,98 @@ public:
     return visual_;
   }
 
+  /** \brief Ask the generation threads to stop. Only sets an atomic flag, so it may be called from any thread or
+   *         from a signal handler */
+  void requestShutdown()
+  {
+    shutdownRequested_.store(true);
+  }
+
+  /** \brief Check if a shutdown has been requested. Cheap enough to call on every iteration of a hot loop */
+  bool shutdownRequested() const
+  {
+    return shutdownRequested_.load(std::memory_order_relaxed);
+  }
+
+  /** \brief Forward a shutdown request made through the visualizer window, if one is attached. Polled periodically
+   *         by the parent thread, and a no-op in headless builds */
+  void pollVisualShutdown();
+
   /** \brief Get the nearest neighbor structure */
   std::shared_ptr<NearestNeighbors<SparseVertex> > getNN()
   {
     return nn_;
   }
 
+  /** \brief Replace the nearest neighbor structure with one of a different type. Vertices already in the graph are
+   *         moved over. The RealVector types fall back to GNAT for other state spaces */
+  void setNearestNeighborsType(NearestNeighborsType type);
+
+  NearestNeighborsType getNearestNeighborsType() const
+  {
+    return nnType_;
+  }
+
   std::mutex& getNNGuard()
   {
     return nearestNeighborMutex_;
   }
 
+  /** \brief Incremented under getNNGuard() whenever a vertex enters or leaves the nearest neighbor structure. A
+   *         neighborhood found while holding the guard stays exact for as long as the version is unchanged */
+  std::size_t getNeighborhoodVersion() const
+  {
+    return neighborhoodVersion_.load();
+  }
+
+  /** \brief Replace the path simplifier used while adding vertices by a seeded one, for reproducible generation */
+  void seedRandom(std::uint_fast32_t seed);
+
+  /** \brief Get the timers and counters shared by all classes taking part in graph generation */
+  GenerationProfilerPtr getProfiler()
+  {
+    return profiler_;
+  }
+
+  /** \brief Get the tally of collision checks, installed into the SpaceInformation by setup() */
+  CollisionCheckCounterPtr getCollisionCheckCounter()
+  {
+    return collisionCheckCounter_;
+  }
+
+  /** \brief Get the pool that candidate states are allocated from and rejected candidates are returned to */
+  StatePoolPtr getStatePool()
+  {
+    return statePool_;
+  }
+
   /** \brief Free all the memory allocated by the database */
   void freeMemory();
 
+  /** \brief Move the edges into a compressed sparse row layout and drop the interface data, for hosts that only
+   *         plan on the roadmap. A* then runs on the compact arrays, while adding or removing vertices and edges
+   *         throws and saving is refused. freeMemory() makes the graph mutable again */
+  void freeze(std::size_t indent = 0);
+
+  bool isFrozen() const
+  {
+    return !frozen_.empty();
+  }
+
+  const CompactGraph& getCompactGraph() const
+  {
+    return frozen_;
+  }
+
+  /** \brief Contract the frozen graph so that A* first answers from the hierarchy, and only searches the compact
+   *         graph when the path found crosses an edge that has since been found in collision */
+  void buildHierarchy(std::size_t indent = 0);
+
+  const ContractionHierarchy& getHierarchy() const
+  {
+    return hierarchy_;
+  }
+
   /** \brief Initialize database */
   bool setup();
 
@@ -196,12 +290,34 @@ public:
   bool astarSearch(const SparseVertex start, const SparseVertex goal, std::vector<SparseVertex>& vertexPath,
                    double& distance, std::size_t indent);
 
+  /** \brief astarSearch() from both ends, on the compact arrays once frozen. See BidirectionalAstar */
+  bool astarSearchBidirectional(const SparseVertex start, const SparseVertex goal,
+                                std::vector<SparseVertex>& vertexPath, double& distance, std::size_t indent);
+
   /** \brief Distance between two states with special bias using popularity */
   double astarHeuristic(const SparseVertex a, const SparseVertex b) const;
 
   /** \brief Compute distance between two milestones (this is simply distance between the states of the milestones) */
   double distanceFunction(const SparseVertex a, const SparseVertex b) const;
 
+  /** \brief Check the motion between two vertices, through the motion cache when useMotionCache_ is set. Thread safe
+   *         for lookups from the generation threads */
+  bool checkMotion(SparseVertex v1, SparseVertex v2);
+
+  /** \brief Remember the motion checks made while finding the visible neighborhood of a candidate, once it has been
+   *         added as candidateD.newVertex_ */
+  void cacheVisibility(const CandidateData& candidateD);
+
+  const MotionCache& getMotionCache() const
+  {
+    return motionCache_;
+  }
+
+  MotionCache& getMotionCacheNonConst()
+  {
+    return motionCache_;
+  }
+
   /** \brief Custom A* visitor statistics */
   void recordNodeOpened()  // discovered
   {
@@ -213,6 +329,17 @@ public:
     numNodesClosed_++;
   }
 
+  /** \brief Nodes discovered and examined by the most recent call to astarSearch() */
+  std::size_t getNumNodesOpened() const
+  {
+    return numNodesOpened_;
+  }
+
+  std::size_t getNumNodesClosed() const
+  {
+    return numNodesClosed_;
+  }
+
   /* ---------------------------------------------------------------------------------
    * Get graph properties
    * --------------------------------------------------------------------------------- */
@@ -237,7 +364,7 @@ public:
   /** \brief Get the number of edges in the sparse roadmap. */
   unsigned int getNumEdges() const
   {
-    return boost::num_edges(g_);
+    return isFrozen() ? frozen_.getNumEdges() : boost::num_edges(g_);
   }
 
   VertexType getVertexTypeProperty(SparseVertex v) const
@@ -271,9 +398,24 @@ public:
    * Error checking
    * --------------------------------------------------------------------------------- */
 
-  /** \brief Clear all past edge state information about in collision or not */
+  /** \brief Clear all past edge state information about in collision or not, and the motion cache */
   void clearEdgeCollisionStates();
 
+  /** \brief Index every edge by the workspace its motion sweeps through, in cubic cells of \e cellSize. Edges added
+   *         later are indexed as they are added, and the index is rebuilt when vertices are renumbered */
+  void buildWorkspaceIndex(const SweptVolumeFunction& sweptVolume, double cellSize, std::size_t indent = 0);
+
+  /** \brief Reset to NOT_CHECKED every edge whose swept volume overlaps \e region, such as the union of the old and
+   *         new bounds of an obstacle that moved, instead of every edge as clearEdgeCollisionStates() does.
+   *         The motion cache is cleared, because it also holds motions that are not edges
+   *  \return number of edges that had been checked and were reset */
+  std::size_t invalidateWorkspace(const WorkspaceBox& region, std::size_t indent = 0);
+
+  const WorkspaceIndex& getWorkspaceIndex() const
+  {
+    return workspaceIndex_;
+  }
+
   /** \brief Part of super debugging */
   void errorCheckDuplicateStates(std::size_t indent);
 
@@ -297,6 +439,25 @@ public:
   std::size_t checkConnectedComponents();
   bool sameComponent(SparseVertex v1, SparseVertex v2);
 
+  const ConnectedComponents& getConnectedComponents() const
+  {
+    return components_;
+  }
+
+  /** \brief Choose numLandmarks_ landmarks and compute their distances for the A* heuristic. From then on adding
+   *         edges keeps the distances exact. Does nothing if numLandmarks_ is zero */
+  void computeLandmarks(std::size_t indent);
+
+  const LandmarkHeuristic& getLandmarks() const
+  {
+    return landmarks_;
+  }
+
+  LandmarkHeuristic& getLandmarksNonConst()
+  {
+    return landmarks_;
+  }
+
   /* ---------------------------------------------------------------------------------
    * Add/remove vertices, edges, states
    * --------------------------------------------------------------------------------- */
@@ -313,6 +474,12 @@ public:
   /** \brief Cleanup graph because we leave deleted vertices in graph during construction */
   void removeDeletedVertices(std::size_t indent);
 
+  /** \brief Renumber the vertices so that vertices close in space, and their edges, are close in memory. Query
+   *         vertices keep their indices and deleted vertices move to the end. Must not run while the graph is being
+   *         generated, because candidates hold on to vertex ids, nor after the task graph mirrored it
+   *  \param newIndex - filled with the new index of every old vertex */
+  void reorderVertices(VertexOrder order, std::vector<SparseVertex>& newIndex, std::size_t indent);
+
   /** \brief Add edge to graph */
   SparseEdge addEdge(SparseVertex v1, SparseVertex v2, EdgeType type, std::size_t indent);
 
@@ -330,6 +497,9 @@ public:
   base::State*& getStateNonConst(SparseVertex v);
   const base::State* getState(SparseVertex v) const;
 
+  /** \brief Coordinates of a vertex in a RealVectorStateSpace, including query vertices */
+  const double* getCoordinates(SparseVertex v) const;
+
   /** \brief Determine if a vertex has been deleted (but not fully removed yet) */
   bool stateDeleted(SparseVertex v) const;
 
@@ -392,10 +562,22 @@ public:
   /** \brief Information about the loaded graph */
   void printGraphStats();
 
+  /** \brief Memory used by the graph, broken down by component */
+  MemoryReport getMemoryReport() const;
+
   /** \brief Verify graph is not in collision */
   bool verifyGraph(std::size_t indent);
 
 protected:
+  /** \brief Index all edges again, after the vertices were renumbered */
+  void indexWorkspace();
+
+  /** \brief Add the edge between \e v1 and \e v2 to the workspace index */
+  void indexEdgeWorkspace(SparseVertex v1, SparseVertex v2);
+
+  /** \brief Set every edge between \e v1 and \e v2 back to NOT_CHECKED and count those that were checked */
+  std::size_t resetEdgeCollisionStates(SparseVertex v1, SparseVertex v2);
+
   /** \brief Short name of this class */
   const std::string name_ = "SparseGraph";
 
@@ -413,6 +595,21 @@ protected:
 
   /** \brief Nearest neighbors data structure */
   std::shared_ptr<NearestNeighbors<SparseVertex> > nn_;
+  NearestNeighborsType nnType_ = NN_GNAT;
+
+  /** \brief Dimension of the space when distances are plain Euclidean, so distanceFunction() can skip the virtual
+   *         call into the state space. Zero otherwise */
+  std::size_t euclideanDimension_ = 0;
+  const DistanceKernels &distanceKernels_ = getDistanceKernels();
+
+  /** \brief Where the time goes during graph generation */
+  GenerationProfilerPtr profiler_;
+
+  /** \brief Counts every collision check made through si_ */
+  CollisionCheckCounterPtr collisionCheckCounter_;
+
+  /** \brief Recycles the states of rejected candidates, with one free list per profiler slot */
+  StatePoolPtr statePool_;
 
   /** \brief Connectivity graph */
   SparseAdjList g_;
@@ -443,7 +640,27 @@ protected:
   boost::property_map<SparseAdjList, vertex_popularity_t>::type vertexPopularity_;
 
   /** \brief Data structure that maintains the connected components */
-  SparseDisjointSetType disjointSets_;
+  ConnectedComponents components_;
+
+  /** \brief Graph distances from a few landmarks, which tighten the A* heuristic */
+  LandmarkHeuristic landmarks_;
+
+  /** \brief Edges once the graph is frozen, empty otherwise */
+  CompactGraph frozen_;
+
+  /** \brief Shortcuts over frozen_ when buildHierarchy() was called, empty otherwise */
+  ContractionHierarchy hierarchy_;
+
+  /** \brief Scratch space of astarSearchBidirectional(), reused between searches */
+  BidirectionalAstar bidirectional_;
+
+  /** \brief Edges by the cells of the workspace they sweep through, once buildWorkspaceIndex() was called */
+  WorkspaceIndex workspaceIndex_;
+  SweptVolumeFunction sweptVolume_;
+  std::vector<WorkspaceBox> sweptBoxes_;
+
+  /** \brief Results of checkMotion() by vertex pair, valid until vertices are renumbered or the obstacles change */
+  MotionCache motionCache_;
 
   /** \brief A path simplifier used to simplify dense paths added to S */
   geometric::PathSimplifierPtr pathSimplifier_;
@@ -454,6 +671,9 @@ protected:
   /** \brief Number of cores available on system */
   std::size_t numThreads_;
 
+  /** \brief Set by requestShutdown(), checked by every generation thread */
+  std::atomic<bool> shutdownRequested_{false};
+
   /** \brief Astar statistics */
   std::size_t numNodesOpened_ = 0;
   std::size_t numNodesClosed_ = 0;
@@ -466,6 +686,7 @@ protected:
 
   // Multi-threading modifying graph
   std::mutex nearestNeighborMutex_;
+  std::atomic<std::size_t> neighborhoodVersion_{0};
   std::mutex modifyGraphMutex_;
   time::point lastSampledModTime_;  // timestamp of the last graph modification - any sample taken before that is
                                     // invalid
@@ -486,6 +707,15 @@ public:  // user settings from other applications
   /** \brief Allow the database to save to file (new experiences) */
   bool savingEnabled_ = true;
 
+  /** \brief Landmarks chosen by computeLandmarks() after generation, or after loading a file without them */
+  std::size_t numLandmarks_ = 16;
+
+  /** \brief Search from the start and the goal at once in astarSearch(), which expands fewer vertices on long paths */
+  bool bidirectionalSearch_ = false;
+
+  /** \brief Remember the motion checks between vertices made while generating, see checkMotion() */
+  bool useMotionCache_ = false;
+
   /** \brief Various options for visualizing the algorithmns performance */
   bool visualizeAstar_ = false;
 
@@ -508,6 +738,7 @@ public:  // user settings from other applications
   bool visualizeDatabaseEdges_ = true;
   bool visualizeDatabaseCoverage_ = true;
   bool visualizeGraphAfterLoading_ = true;
+  bool visualizeGraphAfterGeneration_ = true;
   bool visualizeProjection_ = false;
   bool visualizeVoronoiDiagram_ = true;
   bool visualizeVoronoiDiagramAnimated_ = true;
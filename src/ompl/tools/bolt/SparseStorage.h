@@ -45,6 +45,7 @@
 #include <ompl/base/State.h>
 #include <ompl/base/SpaceInformation.h>
 #include <ompl/util/ClassForward.h>
+#include <ompl/tools/bolt/VertexOrdering.h>
 
 // Boost
 #include <boost/noncopyable.hpp>
@@ -54,6 +55,7 @@
 #include <boost/archive/archive_exception.hpp>
 #include <boost/archive/binary_iarchive.hpp>
 #include <boost/archive/binary_oarchive.hpp>
+#include <boost/serialization/version.hpp>
 
 namespace ompl
 {
@@ -75,6 +77,17 @@ OMPL_CLASS_FORWARD(SparseGraph);
     \brief A boost shared pointer wrapper for ompl::tools::bolt::SparseStorage */
 
 static const boost::uint32_t OMPL_PLANNER_DATA_ARCHIVE_MARKER = 0x5044414D;  // this spells PDAM
+static const boost::uint32_t MOTION_CACHE_ARCHIVE_MARKER = 0x4D434D44;       // this spells MCMD
+
+/** \brief How vertex states are written to file. The compact encodings only apply to RealVectorStateSpace. Their
+ *         error, at most 1/65535 of the range of a coordinate for int16, is far below any practical sparse delta.
+ *         Files saved before the encoding was recorded load as native */
+enum StateEncoding
+{
+  STATE_ENCODING_NATIVE = 0,  // the state space's own serialization, doubles for RealVector
+  STATE_ENCODING_FLOAT32,     // one float per coordinate
+  STATE_ENCODING_INT16        // one 16 bit integer per coordinate, quantized over the bounds of the space
+};
 
 class SparseStorage
 {
@@ -94,14 +107,32 @@ public:
     /* \brief Signature of state space that allocated the saved states in the vertices (see */
     std::vector<int> signature;
 
+    /* \brief StateEncoding of the vertex states, native in archives written before it was recorded */
+    int encoding = STATE_ENCODING_NATIVE;
+
+    /* \brief Bounds the int16 encoding quantizes over, empty for the other encodings */
+    std::vector<double> low;
+    std::vector<double> high;
+
+    /* \brief Number of landmarks whose distances follow the edges, zero in archives written before they were */
+    std::size_t landmark_count = 0;
+
     /* \brief boost::serialization routine */
     template <typename Archive>
-    void serialize(Archive &ar, const unsigned int /*version*/)
+    void serialize(Archive &ar, const unsigned int version)
     {
       ar &marker;
       ar &vertex_count;
       ar &edge_count;
       ar &signature;
+      if (version > 0)
+      {
+        ar &encoding;
+        ar &low;
+        ar &high;
+      }
+      if (version > 1)
+        ar &landmark_count;
     }
   };
 
@@ -148,6 +179,9 @@ public:
   /* \brief Serialize and store all edges in \e pd to the binary archive. */
   void saveEdges(boost::archive::binary_oarchive &oa);
 
+  /* \brief Store the landmarks of the A* heuristic and their distance to every vertex */
+  void saveLandmarks(boost::archive::binary_oarchive &oa);
+
   bool load(const std::string &filePath, std::size_t indent = 0);
 
   bool load(std::istream &in);
@@ -161,6 +195,42 @@ public:
   /* \brief Read \e numEdges from the binary input \e ia and store them as SparseStorage  */
   void loadEdges(unsigned int numEdges, boost::archive::binary_iarchive &ia, std::size_t indent = 0);
 
+  /* \brief Read the distances of \e numLandmarks landmarks and give them to the sparse graph */
+  void loadLandmarks(std::size_t numLandmarks, boost::archive::binary_iarchive &ia, std::size_t indent = 0);
+
+  /** \brief File the motion cache of the graph saved to \e filePath is kept in */
+  static std::string getMotionCachePath(const std::string &filePath)
+  {
+    return filePath + ".motions";
+  }
+
+  /* \brief Save the motion cache of the sparse graph, with the vertices numbered as in the last file save() wrote */
+  void saveMotionCache(const std::string &filePath, std::size_t indent = 0);
+
+  /* \brief Fill the motion cache of the sparse graph from a file saved with the graph that was just loaded. Returns
+   *        false if the file is missing or does not match the graph */
+  bool loadMotionCache(const std::string &filePath, std::size_t indent = 0);
+
+  /** \brief Read a saved graph without adding it to the sparse graph, e.g. to combine several files into one. Edge
+   *         endpoints index into \e vertices */
+  bool read(const std::string &filePath, std::vector<BoltVertexData> &vertices, std::vector<BoltEdgeData> &edges,
+            std::size_t indent = 0);
+
+  /** \brief Write vertices and edges that are not in a sparse graph in the same format as save() */
+  bool write(const std::string &filePath, const std::vector<BoltVertexData> &vertices,
+             const std::vector<BoltEdgeData> &edges, std::size_t indent = 0);
+
+  /** \brief Fill the encoding fields of \e header for writing with stateEncoding_. Falls back to the native
+   *         encoding if the space is not a RealVectorStateSpace */
+  void prepareEncoding(Header &header) const;
+
+  /** \brief Serialize \e state in the encoding described by \e header */
+  void encodeState(const Header &header, const base::State *state, std::vector<unsigned char> &bytes) const;
+
+  /** \brief Deserialize \e bytes written in the encoding described by \e header. Returns false if the number of
+   *         bytes does not match, or if a compact encoding is read into a space that is not a RealVectorStateSpace */
+  bool decodeState(const Header &header, const std::vector<unsigned char> &bytes, base::State *state) const;
+
   /** \brief Getter for where to save auditing data about size of graph, etc */
   const std::string &getLoggingPath() const
   {
@@ -190,10 +260,30 @@ public:
   /** \brief Where to save auditing data about size of graph, etc */
   std::string loggingPath_;
 
+  /** \brief Encoding used for vertex states by save() and write(). Files are always read in the encoding they were
+   *         written in, and the states in memory stay double precision */
+  StateEncoding stateEncoding_ = STATE_ENCODING_NATIVE;
+
+  /** \brief Order save() writes the vertices in. The graph in memory keeps its numbering, so this is safe to use
+   *         while the graph is still being generated */
+  VertexOrder vertexOrder_ = ORDER_INSERTION;
+
+  /** \brief Save the motion cache next to the graph file in save(filePath), and load it in load(filePath) */
+  bool persistMotionCache_ = false;
+
+  /** \brief Index in the file of each vertex of the graph being saved, including the query vertices */
+  std::vector<SparseVertex> fileIndex_;
+
+  /** \brief Header of the file being saved or loaded */
+  Header fileHeader_;
+
 };  // end of class SparseStorage
 
 }  // namespace bolt
 }  // namespace tools
 }  // namespace ompl
 
+// Version 1 added the state encoding, version 0 archives are read as native. Version 2 added the landmarks
+BOOST_CLASS_VERSION(ompl::tools::bolt::SparseStorage::Header, 2)
+
 #endif
@@ -0,0 +1,138 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2016, University of Colorado, Boulder
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the Univ of CO, Boulder nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+/* Author: Dave Coleman <dave@dav.ee>
+   Desc:   Recycles the states of rejected samples between the threads generating a sparse graph
+*/
+
+#ifndef OMPL_TOOLS_BOLT_STATE_POOL_
+#define OMPL_TOOLS_BOLT_STATE_POOL_
+
+// OMPL
+#include <ompl/base/SpaceInformation.h>
+#include <ompl/util/ClassForward.h>
+
+// Bolt
+#include <ompl/tools/bolt/MemoryReport.h>
+
+// Boost
+#include <boost/noncopyable.hpp>
+
+// C++
+#include <mutex>
+#include <vector>
+
+namespace ompl
+{
+namespace tools
+{
+namespace bolt
+{
+/// @cond IGNORE
+OMPL_CLASS_FORWARD(StatePool);
+/// @endcond
+
+/** \class ompl::tools::bolt::StatePoolPtr
+    \brief A boost shared pointer wrapper for ompl::tools::bolt::StatePool */
+
+/**
+ * \brief Keeps freed states for reuse instead of returning them to the heap.
+ *
+ * Every thread takes and returns states through its own free list, chosen by the thread ID of the
+ * GenerationProfiler. Samples are drawn by the sampling threads but mostly rejected by the parent thread, so a list
+ * that grows past two batches hands one batch to a shared list, and an empty list takes one batch back from it.
+ * The lists have their own locks, which are uncontended unless threads share an ID, e.g. several planners querying
+ * at once. States come from SpaceInformation::allocState(), so a state taken from the pool may also be freed
+ * directly with the SpaceInformation.
+ */
+class StatePool : private boost::noncopyable
+{
+public:
+  /** \brief \e numThreads free lists, threads with a higher ID share the last one */
+  StatePool(const base::SpaceInformationPtr &si, std::size_t numThreads, std::size_t batchSize = 64);
+
+  ~StatePool();
+
+  base::State *allocState();
+
+  /** \brief Allocate a state from the pool and copy \e source into it */
+  base::State *cloneState(const base::State *source);
+
+  void freeState(base::State *state);
+
+  /** \brief Return every pooled state to the heap. States in use are not affected */
+  void clear();
+
+  /** \brief States currently kept for reuse */
+  std::size_t getNumPooled() const;
+
+  /** \brief States allocated from the heap, and taken from the pool instead */
+  std::size_t getNumAllocated() const;
+  std::size_t getNumReused() const;
+
+  void addToMemoryReport(MemoryReport &report) const;
+
+private:
+  struct FreeList
+  {
+    mutable std::mutex mutex_;
+    std::vector<base::State *> states_;
+    std::size_t allocated_ = 0;
+    std::size_t reused_ = 0;
+  };
+
+  /** \brief List of the calling thread */
+  FreeList &getFreeList();
+
+  /** \brief Batches returned by threads that free more states than they allocate. Locked after a thread's list */
+  FreeList &getSharedList()
+  {
+    return freeLists_.back();
+  }
+
+  base::SpaceInformationPtr si_;
+
+  /** \brief States moved between the free lists and the shared list at once */
+  std::size_t batchSize_;
+
+  /** \brief One per thread followed by the shared list, constructed once because the locks can be neither copied
+   *         nor moved */
+  std::vector<FreeList> freeLists_;
+};
+
+}  // namespace bolt
+}  // namespace tools
+}  // namespace ompl
+
+#endif  // OMPL_TOOLS_BOLT_STATE_POOL_
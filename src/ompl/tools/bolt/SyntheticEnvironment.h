@@ -0,0 +1,132 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2016, University of Colorado, Boulder
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the Univ of CO, Boulder nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+/* Author: Dave Coleman <dave@dav.ee>
+   Desc:   Synthetic N-D box worlds with hyper-box obstacles, for benchmarking without a robot model or GUI
+*/
+
+#ifndef OMPL_TOOLS_BOLT_SYNTHETIC_ENVIRONMENT_
+#define OMPL_TOOLS_BOLT_SYNTHETIC_ENVIRONMENT_
+
+// OMPL
+#include <ompl/base/SpaceInformation.h>
+#include <ompl/base/StateValidityChecker.h>
+#include <ompl/base/spaces/RealVectorStateSpace.h>
+
+// C++
+#include <string>
+#include <vector>
+
+namespace ompl
+{
+namespace tools
+{
+namespace bolt
+{
+/// @cond IGNORE
+OMPL_CLASS_FORWARD(HyperBoxValidityChecker);
+/// @endcond
+
+/** \class ompl::tools::bolt::HyperBoxValidityCheckerPtr
+    \brief A boost shared pointer wrapper for ompl::tools::bolt::HyperBoxValidityChecker */
+
+/** \brief Validity checker for a RealVector space filled with axis-aligned hyper-box obstacles */
+class HyperBoxValidityChecker : public base::StateValidityChecker
+{
+public:
+  /** \brief Constructor */
+  HyperBoxValidityChecker(const base::SpaceInformationPtr &si);
+
+  /** \brief Add an axis aligned obstacle spanning [low, high] in every dimension */
+  void addObstacle(const std::vector<double> &low, const std::vector<double> &high);
+
+  /** \brief Number of obstacles in the world */
+  std::size_t getNumObstacles() const
+  {
+    return numObstacles_;
+  }
+
+  /** \brief Return true if the state is not inside any obstacle */
+  virtual bool isValid(const base::State *state) const;
+
+  /** \brief Return true if the state is valid, and also compute its distance to the nearest obstacle */
+  virtual bool isValid(const base::State *state, double &dist) const;
+
+  /** \brief Euclidean distance from the state to the nearest obstacle surface, 0 if in collision */
+  virtual double clearance(const base::State *state) const;
+
+private:
+  /** \brief Distance from a point to a single box, 0 if inside */
+  double distanceToBox(const double *values, std::size_t boxID) const;
+
+  /** \brief Obstacle corners, stored as dim_ values per obstacle */
+  std::vector<double> lows_;
+  std::vector<double> highs_;
+
+  /** \brief Number of obstacles */
+  std::size_t numObstacles_ = 0;
+
+  /** \brief Dimension of the state space */
+  std::size_t dim_;
+};
+
+/** \brief Everything needed to run Bolt in a synthetic world */
+struct SyntheticEnvironment
+{
+  /** \brief Unique human readable name, used to label benchmark results */
+  std::string name_;
+
+  base::StateSpacePtr space_;
+  base::SpaceInformationPtr si_;
+  HyperBoxValidityCheckerPtr checker_;
+
+  /** \brief Fraction of the space that is covered by obstacles, estimated by sampling */
+  double obstacleDensity_ = 0;
+};
+
+/**
+ * \brief Create a unit-less box world of the requested dimension, bounded by [0, 10] on every axis
+ * \param dim - number of dimensions of the RealVector space
+ * \param numObstacles - number of randomly placed hyper-box obstacles
+ * \param obstacleWidth - edge length of each obstacle as a fraction of the space width
+ * \param seed - random seed, so that the same world is generated every run
+ */
+SyntheticEnvironment createHyperBoxEnvironment(std::size_t dim, std::size_t numObstacles, double obstacleWidth,
+                                               unsigned int seed);
+
+}  // namespace bolt
+}  // namespace tools
+}  // namespace ompl
+
+#endif  // OMPL_TOOLS_BOLT_SYNTHETIC_ENVIRONMENT_
@@ -47,9 +47,16 @@
 
 // Bolt
 #include <ompl/tools/bolt/SparseGraph.h>
+#include <ompl/tools/bolt/BidirectionalAstar.h>
 #include <ompl/tools/bolt/BoostGraphHeaders.h>
+#include <ompl/tools/bolt/CompactGraph.h>
+#include <ompl/tools/bolt/ContractionHierarchy.h>
 #include <ompl/tools/bolt/Debug.h>
+#include <ompl/tools/bolt/DistanceKernels.h>
+#include <ompl/tools/bolt/MemoryReport.h>
+#include <ompl/tools/bolt/NearestNeighborsRealVector.h>
 #include <ompl/tools/bolt/VertexDiscretizer.h>
+#include <ompl/tools/bolt/WorkspaceIndex.h>
 #include <ompl/tools/bolt/SparseStorage.h>
 #include <ompl/tools/debug/Visualizer.h>
 
@@ -127,6 +134,30 @@ public:
   /** \brief Free all the memory allocated by the database */
   void freeMemory();
 
+  /** \brief Move the edges into a compressed sparse row layout for planning only. Searches, neighbor iteration and
+   *         lazy collision checks then run on the compact arrays, and adding or removing vertices and edges throws.
+   *         clear() makes the graph mutable again */
+  void freeze(std::size_t indent = 0);
+
+  bool isFrozen() const
+  {
+    return !frozen_.empty();
+  }
+
+  const CompactGraph& getCompactGraph() const
+  {
+    return frozen_;
+  }
+
+  /** \brief Contract the frozen graph so that A* first answers from the hierarchy, and only searches the compact
+   *         graph when the path found crosses an edge that has since been found in collision */
+  void buildHierarchy(std::size_t indent = 0);
+
+  const ContractionHierarchy& getHierarchy() const
+  {
+    return hierarchy_;
+  }
+
   /* ---------------------------------------------------------------------------------
    * Astar search
    * --------------------------------------------------------------------------------- */
@@ -144,15 +175,34 @@ public:
   bool astarSearch(const TaskVertex start, const TaskVertex goal, std::vector<TaskVertex>& vertexPath, double& distance,
                    std::size_t indent);
 
+  /** \brief astarSearch() from both ends, on the compact arrays once frozen. See BidirectionalAstar */
+  bool astarSearchBidirectional(const TaskVertex start, const TaskVertex goal, std::vector<TaskVertex>& vertexPath,
+                                double& distance, std::size_t indent);
+
+  /** \brief Nodes discovered and examined by the most recent call to astarSearch() */
+  std::size_t getNumNodesOpened() const
+  {
+    return numNodesOpened_;
+  }
+
+  std::size_t getNumNodesClosed() const
+  {
+    return numNodesClosed_;
+  }
+
   /** \brief Distance between two states with special bias using popularity */
   double astarHeuristic(const TaskVertex a, const TaskVertex b) const;
 
   /** \brief Compute distance between two milestones (this is simply distance between the states of the milestones) */
   double distanceFunction(const TaskVertex a, const TaskVertex b) const;
 
-  /** \brief Distance between two vertices in a task space */
+  /** \brief Lower bound on the distance between two vertices in a task space, consistent across level changes */
   double astarTaskHeuristic(const TaskVertex a, const TaskVertex b) const;
 
+  /** \brief Straight line distance, raised to the landmark bound of the sparse graph when both vertices are on the
+   *         same level and were copied from it */
+  double levelDistance(const TaskVertex a, const TaskVertex b) const;
+
   /** \brief Custom A* visitor statistics */
   void recordNodeOpened()  // discovered
   {
@@ -182,9 +232,13 @@ public:
   /** \brief Get the number of edges in the task roadmap. */
   unsigned int getNumEdges() const
   {
-    return boost::num_edges(g_);
+    return isFrozen() ? frozen_.getNumEdges() : boost::num_edges(g_);
   }
 
+  /** \brief Lazy collision checking status of the edge between two adjacent vertices */
+  EdgeCollisionState getEdgeCollisionState(TaskVertex v1, TaskVertex v2) const;
+  void setEdgeCollisionState(TaskVertex v1, TaskVertex v2, EdgeCollisionState state);
+
   VertexType getVertexTypeProperty(TaskVertex v) const
   {
     return vertexTypeProperty_[v];
@@ -286,6 +340,20 @@ public:
   /** \brief Clear all past edge state information about in collision or not */
   void clearEdgeCollisionStates();
 
+  /** \brief Index every edge by the workspace its motion sweeps through, in cubic cells of \e cellSize. Edges added
+   *         later are indexed as they are added, and the index is rebuilt when vertices are renumbered */
+  void buildWorkspaceIndex(const SweptVolumeFunction& sweptVolume, double cellSize, std::size_t indent = 0);
+
+  /** \brief Reset to NOT_CHECKED every edge whose swept volume overlaps \e region, such as the union of the old and
+   *         new bounds of an obstacle that moved, instead of every edge as clearEdgeCollisionStates() does
+   *  \return number of edges that had been checked and were reset */
+  std::size_t invalidateWorkspace(const WorkspaceBox& region, std::size_t indent = 0);
+
+  const WorkspaceIndex& getWorkspaceIndex() const
+  {
+    return workspaceIndex_;
+  }
+
   /** \brief Part of super debugging */
   void errorCheckDuplicateStates(std::size_t indent);
 
@@ -335,6 +403,9 @@ public:
   base::State*& getStateNonConst(TaskVertex v);
   const base::State* getState(TaskVertex v) const;
 
+  /** \brief Coordinates of a vertex in a RealVectorStateSpace, including query vertices */
+  const double* getCoordinates(TaskVertex v) const;
+
   /* ---------------------------------------------------------------------------------
    * Visualizations
    * --------------------------------------------------------------------------------- */
@@ -362,10 +433,31 @@ public:
   /** \brief Print nearest neighbor info to console */
   void debugNN();
 
+  /** \brief Replace the nearest neighbor structure with one of a different type. Vertices already in the graph are
+   *         moved over. The RealVector types fall back to GNAT for other state spaces */
+  void setNearestNeighborsType(NearestNeighborsType type);
+
+  NearestNeighborsType getNearestNeighborsType() const
+  {
+    return nnType_;
+  }
+
   /** \brief Information about the loaded graph */
   void printGraphStats();
 
+  /** \brief Memory used by the graph, broken down by component. Every vertex holds its own copy of a state */
+  MemoryReport getMemoryReport() const;
+
 protected:
+  /** \brief Index all edges again, after the vertices were renumbered */
+  void indexWorkspace();
+
+  /** \brief Add the edge between \e v1 and \e v2 to the workspace index */
+  void indexEdgeWorkspace(TaskVertex v1, TaskVertex v2);
+
+  /** \brief Set every edge between \e v1 and \e v2 back to NOT_CHECKED and count those that were checked */
+  std::size_t resetEdgeCollisionStates(TaskVertex v1, TaskVertex v2);
+
   /** \brief Short name of this class */
   const std::string name_ = "TaskGraph";
 
@@ -380,6 +472,12 @@ protected:
 
   /** \brief Nearest neighbors data structure */
   std::shared_ptr<NearestNeighbors<TaskVertex> > nn_;
+  NearestNeighborsType nnType_ = NN_GNAT;
+
+  /** \brief Dimension of the space when distances are plain Euclidean, so distanceFunction() can skip the virtual
+   *         call into the state space. Zero otherwise */
+  std::size_t euclideanDimension_ = 0;
+  const DistanceKernels &distanceKernels_ = getDistanceKernels();
 
   /** \brief Connectivity graph */
   TaskAdjList g_;
@@ -406,6 +504,20 @@ protected:
   /** \brief Data structure that maintains the connected components */
   TaskDisjointSetType disjointSets_;
 
+  /** \brief Edges and connected components once the graph is frozen, empty otherwise */
+  CompactGraph frozen_;
+
+  /** \brief Shortcuts over frozen_ when buildHierarchy() was called, empty otherwise */
+  ContractionHierarchy hierarchy_;
+
+  /** \brief Scratch space of astarSearchBidirectional(), reused between searches */
+  BidirectionalAstar bidirectional_;
+
+  /** \brief Edges by the cells of the workspace they sweep through, once buildWorkspaceIndex() was called */
+  WorkspaceIndex workspaceIndex_;
+  SweptVolumeFunction sweptVolume_;
+  std::vector<WorkspaceBox> sweptBoxes_;
+
   /** \brief A path simplifier used to simplify dense paths added to S */
   geometric::PathSimplifierPtr pathSimplifier_;
 
@@ -426,16 +538,29 @@ protected:
   double startConnectorMinCost_ = std::numeric_limits<double>::infinity();
   double goalConnectorMinCost_ = std::numeric_limits<double>::infinity();
 
+  /** \brief Ends of the cartesian path on level 1, the only vertices connected to levels 0 and 2 */
+  TaskVertex cartStartVertex_ = 0;
+  TaskVertex cartGoalVertex_ = 0;
+
   /** \brief Remeber the distances to used for the task distance heuristic */
   double shortestDistAcrossCartGraph_;
 
   /** \brief Flag if we are in task planning mode or not. If false, just plan in free space mode */
   bool taskPlanningEnabled_ = false;
 
+  /** \brief Sparse vertex each level 0 and level 2 vertex was copied from, for its landmark distances.
+   *         NO_SPARSE_VERTEX for the query vertices, vertices added later are past the end */
+  std::vector<SparseVertex> sparseVertices_;
+  static const SparseVertex NO_SPARSE_VERTEX = std::numeric_limits<SparseVertex>::max();
+
 public:  // user settings from other applications
   /** \brief How many neighbors to a Cartesian start or goal point to attempt to connect to in the free space graph */
   std::size_t numNeighborsConnectToCart_ = 10;
 
+  /** \brief Search from the start and the goal at once in astarSearch(), in free space and task planning alike.
+   *         Relies on astarTaskHeuristic() being consistent across level changes */
+  bool bidirectionalSearch_ = false;
+
   /** \brief Visualization speed of astar search, num of seconds to show each vertex */
   bool visualizeAstar_ = false;
   double visualizeAstarSpeed_ = 0.1;
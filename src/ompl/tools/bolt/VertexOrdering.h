@@ -0,0 +1,94 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2016, University of Colorado, Boulder
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the Univ of CO, Boulder nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+/* Author: Dave Coleman <dave@dav.ee>
+   Desc:   Renumbering of roadmap vertices so that nearby vertices are nearby in memory
+*/
+
+#ifndef OMPL_TOOLS_BOLT_VERTEX_ORDERING_
+#define OMPL_TOOLS_BOLT_VERTEX_ORDERING_
+
+// OMPL
+#include <ompl/base/SpaceInformation.h>
+
+// Bolt
+#include <ompl/tools/bolt/BoostGraphHeaders.h>
+
+// C++
+#include <string>
+#include <vector>
+
+namespace ompl
+{
+namespace tools
+{
+namespace bolt
+{
+/** \brief Order in which the vertices of a roadmap are numbered. Insertion order scatters vertices that are close in
+ *         space through memory, the others keep neighbors and their edges together */
+enum VertexOrder
+{
+  ORDER_INSERTION,  // as they were added, i.e. the discretized grid followed by random samples
+  ORDER_HILBERT,    // along a Hilbert curve through the bounding box of the states
+  ORDER_BFS         // breadth first from the lowest degree vertex of each component, i.e. Cuthill-McKee
+};
+
+std::string getVertexOrderName(VertexOrder order);
+
+/** \brief Parse a name returned by getVertexOrderName(), returns false if it is unknown */
+bool parseVertexOrder(const std::string &name, VertexOrder &order);
+
+/**
+ * \brief Positions of points along a Hilbert curve through their bounding box
+ * \param points - the coordinates of each point, all of the same dimension
+ * \return the index of each point, in the order the curve passes them
+ *
+ * Every coordinate is quantized to 64 / dimension bits, at most 16, so that the key of a point fits in 64 bits.
+ * Points in the same cell keep their relative order. Only the first 64 coordinates are used.
+ */
+std::vector<std::size_t> getHilbertOrder(const std::vector<std::vector<double> > &points);
+
+/**
+ * \brief New index of each vertex of the sparse graph in the given order
+ *
+ * Query vertices keep their indices. Deleted vertices, which have no state, are moved to the end.
+ */
+std::vector<SparseVertex> computeVertexOrder(const SparseAdjList &g, const base::SpaceInformationPtr &si,
+                                             std::size_t numQueryVertices, VertexOrder order);
+
+}  // namespace bolt
+}  // namespace tools
+}  // namespace ompl
+
+#endif  // OMPL_TOOLS_BOLT_VERTEX_ORDERING_
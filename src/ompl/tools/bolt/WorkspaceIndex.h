@@ -0,0 +1,145 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2016, University of Colorado, Boulder
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the Univ of CO, Boulder nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+/* Author: Dave Coleman <dave@dav.ee>
+   Desc:   Spatial hash from regions of the workspace to the roadmap edges whose motions sweep through them
+*/
+
+#ifndef OMPL_TOOLS_BOLT_WORKSPACE_INDEX_
+#define OMPL_TOOLS_BOLT_WORKSPACE_INDEX_
+
+// OMPL
+#include <ompl/base/State.h>
+
+// Bolt
+#include <ompl/tools/bolt/MemoryReport.h>
+
+// Boost
+#include <boost/function.hpp>
+#include <boost/unordered_map.hpp>
+
+// C++
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace ompl
+{
+namespace tools
+{
+namespace bolt
+{
+/** \brief Axis aligned box in the three dimensional workspace of the robot */
+struct WorkspaceBox
+{
+  double low_[3];
+  double high_[3];
+};
+
+/** \brief Append boxes that together cover the workspace the robot sweeps through when moving from the first state
+ *         to the second, for example the links placed by forward kinematics at a few interpolated states */
+typedef boost::function<void(const base::State *, const base::State *, std::vector<WorkspaceBox> &)>
+    SweptVolumeFunction;
+
+/**
+ * \brief Maps cubic cells of the workspace to the edges whose swept volume overlaps them.
+ *
+ * Edges are kept as pairs of vertices so that the index survives freezing. Only the non-empty cells are stored, in a
+ * hash map, so a sparse obstacle field costs memory in proportion to the volume the roadmap sweeps. Finding the
+ * edges near a change takes time proportional to the cells the change covers and the edges listed in them, never to
+ * the size of the roadmap. Edges removed from the graph stay listed, which only makes lookups conservative.
+ * Vertices need no entry of their own, because checking an edge checks its endpoints.
+ */
+class WorkspaceIndex
+{
+public:
+  typedef std::uint32_t Index;
+  typedef std::pair<std::size_t, std::size_t> VertexPair;
+
+  /** \brief Remove every edge and set the edge length of the cells */
+  void clear(double cellSize);
+
+  bool empty() const
+  {
+    return edges_.empty();
+  }
+
+  std::size_t getNumEdges() const
+  {
+    return edges_.size();
+  }
+
+  std::size_t getNumCells() const
+  {
+    return cells_.size();
+  }
+
+  double getCellSize() const
+  {
+    return cellSize_;
+  }
+
+  /** \brief List the edge between \e v1 and \e v2 in every cell that one of \e boxes overlaps */
+  void addEdge(std::size_t v1, std::size_t v2, const std::vector<WorkspaceBox> &boxes);
+
+  /** \brief Edges listed in any cell that \e region overlaps, each once. Cleared first */
+  void getEdges(const WorkspaceBox &region, std::vector<VertexPair> &edges);
+
+  void addToMemoryReport(MemoryReport &report) const;
+
+private:
+  /** \brief Pack the integer coordinates of a cell into one key, 21 bits per axis */
+  std::uint64_t getKey(long x, long y, long z) const;
+
+  /** \brief Range of cells that \e box overlaps along each axis. False if the box is empty */
+  bool getCellRange(const WorkspaceBox &box, long low[3], long high[3]) const;
+
+  double cellSize_ = 0.05;
+
+  std::vector<VertexPair> edges_;
+
+  /** \brief Edges listed in each cell that at least one overlaps */
+  boost::unordered_map<std::uint64_t, std::vector<Index> > cells_;
+
+  /** \brief Reused between lookups to list each edge only once. An edge has been listed by the current lookup when
+   *         its visit equals lookupID_ */
+  std::vector<std::uint32_t> visits_;
+  std::uint32_t lookupID_ = 0;
+};
+
+}  // namespace bolt
+}  // namespace tools
+}  // namespace ompl
+
+#endif  // OMPL_TOOLS_BOLT_WORKSPACE_INDEX_
@@ -0,0 +1,199 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2016, University of Colorado, Boulder
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the Univ of CO, Boulder nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+/* Author: Dave Coleman <dave@dav.ee>
+   Desc:   Collects benchmark measurements and writes them in machine readable form for regression tracking
+*/
+
+// OMPL
+#include <ompl/tools/bolt/BenchmarkLog.h>
+#include <ompl/util/Console.h>
+#include <ompl/util/Time.h>
+
+// C++
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <numeric>
+
+namespace ompl
+{
+namespace tools
+{
+namespace bolt
+{
+namespace
+{
+/** \brief Nearest-rank percentile of already sorted samples */
+double percentile(const std::vector<double> &sorted, double fraction)
+{
+  if (sorted.empty())
+    return 0;
+  std::size_t rank = static_cast<std::size_t>(ceil(fraction * sorted.size()));
+  rank = std::max(std::size_t(1), std::min(rank, sorted.size()));
+  return sorted[rank - 1];
+}
+
+/** \brief Minimal escaping for the strings we emit */
+std::string escapeJSON(const std::string &input)
+{
+  std::string output;
+  for (char c : input)
+  {
+    if (c == '"' || c == '\\')
+      output += '\\';
+    output += c;
+  }
+  return output;
+}
+}  // namespace
+
+BenchmarkLog::BenchmarkLog(const std::string &suite) : suite_(suite)
+{
+  setParameter("date", time::as_string(time::now()));
+}
+
+void BenchmarkLog::setParameter(const std::string &key, const std::string &value)
+{
+  parameters_[key] = value;
+}
+
+void BenchmarkLog::addSamples(const std::string &environment, const std::string &metric, std::vector<double> samples,
+                              const std::string &unit)
+{
+  BenchmarkRecord record;
+  record.environment_ = environment;
+  record.metric_ = metric;
+  record.unit_ = unit;
+  record.count_ = samples.size();
+
+  if (!samples.empty())
+  {
+    std::sort(samples.begin(), samples.end());
+    record.total_ = std::accumulate(samples.begin(), samples.end(), 0.0);
+    record.mean_ = record.total_ / samples.size();
+    record.min_ = samples.front();
+    record.p50_ = percentile(samples, 0.50);
+    record.p90_ = percentile(samples, 0.90);
+    record.p99_ = percentile(samples, 0.99);
+    record.max_ = samples.back();
+  }
+
+  records_.push_back(record);
+}
+
+void BenchmarkLog::addValue(const std::string &environment, const std::string &metric, double value,
+                            const std::string &unit)
+{
+  addSamples(environment, metric, std::vector<double>(1, value), unit);
+}
+
+bool BenchmarkLog::writeJSON(const std::string &filePath) const
+{
+  std::ofstream out(filePath.c_str(), std::ios::out);
+  if (!out.is_open())
+  {
+    OMPL_ERROR("Unable to open benchmark output file %s", filePath.c_str());
+    return false;
+  }
+
+  out << std::setprecision(10);
+  out << "{\n";
+  out << "  \"suite\": \"" << escapeJSON(suite_) << "\",\n";
+  out << "  \"parameters\": {";
+  bool first = true;
+  for (const auto &param : parameters_)
+  {
+    out << (first ? "\n" : ",\n") << "    \"" << escapeJSON(param.first) << "\": \"" << escapeJSON(param.second)
+        << "\"";
+    first = false;
+  }
+  out << "\n  },\n";
+  out << "  \"records\": [";
+  for (std::size_t i = 0; i < records_.size(); ++i)
+  {
+    const BenchmarkRecord &r = records_[i];
+    out << (i == 0 ? "\n" : ",\n");
+    out << "    {\"environment\": \"" << escapeJSON(r.environment_) << "\", \"metric\": \"" << escapeJSON(r.metric_)
+        << "\", \"unit\": \"" << escapeJSON(r.unit_) << "\", \"count\": " << r.count_ << ", \"total\": " << r.total_
+        << ", \"mean\": " << r.mean_ << ", \"min\": " << r.min_ << ", \"p50\": " << r.p50_ << ", \"p90\": " << r.p90_
+        << ", \"p99\": " << r.p99_ << ", \"max\": " << r.max_ << "}";
+  }
+  out << "\n  ]\n";
+  out << "}\n";
+
+  return true;
+}
+
+bool BenchmarkLog::writeCSV(const std::string &filePath) const
+{
+  std::ofstream out(filePath.c_str(), std::ios::out);
+  if (!out.is_open())
+  {
+    OMPL_ERROR("Unable to open benchmark output file %s", filePath.c_str());
+    return false;
+  }
+
+  out << std::setprecision(10);
+  out << "suite,environment,metric,unit,count,total,mean,min,p50,p90,p99,max\n";
+  for (const BenchmarkRecord &r : records_)
+  {
+    out << suite_ << "," << r.environment_ << "," << r.metric_ << "," << r.unit_ << "," << r.count_ << "," << r.total_
+        << "," << r.mean_ << "," << r.min_ << "," << r.p50_ << "," << r.p90_ << "," << r.p99_ << "," << r.max_
+        << "\n";
+  }
+
+  return true;
+}
+
+void BenchmarkLog::print(std::ostream &out) const
+{
+  out << "------------------------------------------------------------------------------------------" << std::endl;
+  out << "Benchmark suite: " << suite_ << std::endl;
+  for (const auto &param : parameters_)
+    out << "  " << param.first << ": " << param.second << std::endl;
+  out << std::left << std::setw(22) << "environment" << std::setw(28) << "metric" << std::setw(10) << "count"
+      << std::setw(14) << "mean" << std::setw(14) << "p50" << std::setw(14) << "p99" << "unit" << std::endl;
+  for (const BenchmarkRecord &r : records_)
+  {
+    out << std::left << std::setw(22) << r.environment_ << std::setw(28) << r.metric_ << std::setw(10) << r.count_
+        << std::setw(14) << r.mean_ << std::setw(14) << r.p50_ << std::setw(14) << r.p99_ << r.unit_ << std::endl;
+  }
+  out << "------------------------------------------------------------------------------------------" << std::endl;
+}
+
+}  // namespace bolt
+}  // namespace tools
+}  // namespace ompl
@@ -0,0 +1,102 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2016, University of Colorado, Boulder
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the Univ of CO, Boulder nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+/* Author: Dave Coleman <dave@dav.ee>
+   Desc:   A* search from both ends of a query, for the mutable and the frozen graphs alike
+*/
+
+// OMPL
+#include <ompl/tools/bolt/BidirectionalAstar.h>
+
+namespace ompl
+{
+namespace tools
+{
+namespace bolt
+{
+void getFreeNeighbors(const CompactGraph &g, std::size_t v, std::vector<std::pair<std::size_t, double> > &neighbors)
+{
+  neighbors.clear();
+  for (CompactGraph::Index i = g.beginNeighbors(v); i < g.endNeighbors(v); ++i)
+  {
+    const CompactGraph::Index e = g.getNeighborEdge(i);
+    if (g.getCollisionState(e) == IN_COLLISION)
+      continue;
+    neighbors.push_back(std::make_pair(g.getNeighbor(i), g.getWeight(e)));
+  }
+}
+
+void BidirectionalAstar::clear()
+{
+  for (std::size_t d = 0; d < 2; ++d)
+  {
+    costs_[d].clear();
+    predecessors_[d].clear();
+    visits_[d].clear();
+  }
+  potentials_.clear();
+  potentialVisits_.clear();
+  searchID_ = 0;
+}
+
+void BidirectionalAstar::prepare(std::size_t numVertices)
+{
+  // Tag the vertices of this search instead of clearing the arrays of the previous one
+  if (potentialVisits_.size() != numVertices || searchID_ >= std::numeric_limits<std::uint32_t>::max() - 2)
+  {
+    for (std::size_t d = 0; d < 2; ++d)
+    {
+      costs_[d].resize(numVertices);
+      predecessors_[d].resize(numVertices);
+      visits_[d].assign(numVertices, 0);
+    }
+    potentials_.resize(numVertices);
+    potentialVisits_.assign(numVertices, 0);
+    searchID_ = 0;
+  }
+  searchID_ += 2;
+}
+
+void BidirectionalAstar::addToMemoryReport(MemoryReport &report) const
+{
+  std::size_t bytes = potentials_.capacity() * sizeof(double) + potentialVisits_.capacity() * sizeof(std::uint32_t);
+  for (std::size_t d = 0; d < 2; ++d)
+    bytes += costs_[d].capacity() * sizeof(double) + predecessors_[d].capacity() * sizeof(std::size_t) +
+             visits_[d].capacity() * sizeof(std::uint32_t);
+  report.add(MEMORY_ADJACENCY, bytes);
+}
+
+}  // namespace bolt
+}  // namespace tools
+}  // namespace ompl
@@ -96,8 +96,11 @@ void Bolt::initialize()
   // Load the Retrieve repair database. We do it here so that setRepairPlanner() works
   boltPlanner_ = BoltPlannerPtr(new BoltPlanner(si_, taskGraph_, visual_));
 
+  // Per-query records and latency histograms
+  queryLog_.reset(new QueryLog());
+
   std::size_t numThreads = boost::thread::hardware_concurrency();
-  OMPL_INFORM("Bolt Framework initialized using %u threads", numThreads);
+  OMPL_INFORM("Bolt Framework initialized using %u threads", static_cast<unsigned int>(numThreads));
 }
 
 void Bolt::setup()
@@ -149,16 +152,18 @@ base::PlannerStatus Bolt::solve(const base::PlannerTerminationCondition &ptc)
 
   lastStatus_ = base::PlannerStatus::UNKNOWN;
   time::point start = time::now();
+  const CollisionCheckSnapshot checksBefore = sparseGraph_->getCollisionCheckCounter()->getSnapshot();
 
   // Warn if there are queued paths that have not been added to the experience database
   OMPL_INFORM("Num solved paths uninserted into the experience database in the post-proccessing queue: %u",
-              queuedSolutionPaths_.size());
+              static_cast<unsigned int>(queuedSolutionPaths_.size()));
 
   // SOLVE
   lastStatus_ = boltPlanner_->solve(ptc);
 
   // Task time
   planTime_ = time::seconds(time::now() - start);
+  lastQueryChecks_ = sparseGraph_->getCollisionCheckCounter()->getSnapshot() - checksBefore;
 
   // Do logging
   logResults();
@@ -168,6 +173,9 @@ base::PlannerStatus Bolt::solve(const base::PlannerTerminationCondition &ptc)
 
 void Bolt::visualize()
 {
+#ifdef BOLT_HEADLESS
+  return;
+#endif
   // Optionally visualize raw trajectory
   if (visualizeRawTrajectory_)
   {
@@ -246,6 +254,11 @@ void Bolt::logResults()
   ExperienceLog log;
   log.planningTime = planTime_;
 
+  // Phase breakdown of this query, filled in by the BoltPlanner
+  QueryRecord record = boltPlanner_->getQueryRecord();
+  record.phaseTimes_[QUERY_TOTAL] = planTime_;
+  record.status_ = lastStatus_.asString();
+
   // Record stats
   stats_.totalPlanningTime_ += planTime_;  // used for averaging
   stats_.numProblems_++;                   // used for averaging
@@ -294,6 +307,9 @@ void Bolt::logResults()
 
       // Stats
       stats_.numSolutionsFromRecall_++;
+      solvedQueryChecks_ += lastQueryChecks_;
+      record.solved_ = true;
+      record.solutionStates_ = solutionPath.getStateCount();
 
       // Make sure solution has at least 2 states
       if (solutionPath.getStateCount() < 2)
@@ -313,7 +329,8 @@ void Bolt::logResults()
     }
     break;
     default:
-      OMPL_ERROR("Unknown status type: %u", lastStatus_);
+      OMPL_ERROR("Unknown status type: %u",
+                 static_cast<unsigned int>(static_cast<base::PlannerStatus::StatusType>(lastStatus_)));
       stats_.numSolutionsFailed_++;
       // Logging
       log.planner = "neither_planner";
@@ -321,6 +338,9 @@ void Bolt::logResults()
       log.isSaved = "not_saved";
   }
 
+  OMPL_INFORM("Bolt::solve(): %lu state checks and %lu motion checks", lastQueryChecks_.getStateChecks(),
+              lastQueryChecks_.getMotionChecks());
+
   // Final log data
   // log.insertion_time = insertionTime; TODO fix this
   log.numVertices = sparseGraph_->getNumVertices();
@@ -329,6 +349,24 @@ void Bolt::logResults()
 
   // Flush the log to buffer
   convertLogToString(log);
+
+  // Structured log
+  record.stateChecks_ = lastQueryChecks_.getStateChecks();
+  record.motionChecks_ = lastQueryChecks_.getMotionChecks();
+  record.graphVertices_ = log.numVertices;
+  record.graphEdges_ = log.numEdges;
+  queryLog_->addRecord(record);
+
+  OMPL_INFORM("Bolt::solve(): %f s neighbor search, %f s visibility, %lu A* searches in %f s, %f s lazy checking, "
+              "%f s simplification",
+              record.phaseTimes_[QUERY_NEIGHBOR_SEARCH], record.phaseTimes_[QUERY_VISIBILITY], record.astarSearches_,
+              record.phaseTimes_[QUERY_ASTAR], record.phaseTimes_[QUERY_LAZY_CHECK],
+              record.phaseTimes_[QUERY_SIMPLIFICATION]);
+
+  // Periodically dump the log so that tail latencies can be watched while running
+  if (!queryLogFilePath_.empty() && queryLogDumpInterval_ > 0 &&
+      queryLog_->getNumQueries() % queryLogDumpInterval_ == 0)
+    dumpQueryLog(queryLogFilePath_);
 }
 
 bool Bolt::checkRepeatedStates(const og::PathGeometric &path)
@@ -337,7 +375,8 @@ bool Bolt::checkRepeatedStates(const og::PathGeometric &path)
   {
     if (si_->getStateSpace()->equalStates(path.getState(i - 1), path.getState(i)))
     {
-      OMPL_ERROR("Duplicate state found on trajectory at %u out of %u", i, path.getStateCount());
+      OMPL_ERROR("Duplicate state found on trajectory at %u out of %u", static_cast<unsigned int>(i),
+                 static_cast<unsigned int>(path.getStateCount()));
 
       visual_->viz6()->state(path.getState(i), tools::ROBOT, tools::RED, 0);
       return false;
@@ -403,6 +442,26 @@ bool Bolt::load()
   return true;
 }
 
+void Bolt::freeze()
+{
+  std::size_t indent = 0;
+  if (taskGraph_->isEmpty())
+  {
+    std::vector<SparseVertex> newIndex;
+    sparseGraph_->reorderVertices(freezeOrder_, newIndex, indent);
+    taskGraph_->generateTaskSpace(indent);
+  }
+
+  taskGraph_->freeze(indent);
+  sparseGraph_->freeze(indent);
+
+  if (buildHierarchy_)
+  {
+    taskGraph_->buildHierarchy(indent);
+    sparseGraph_->buildHierarchy(indent);
+  }
+}
+
 void Bolt::print(std::ostream &out) const
 {
   if (si_)
@@ -441,15 +500,23 @@ void Bolt::printLogs(std::ostream &out) const
   out << "    Sparse Delta:                " << sparseCriteria_->getSparseDelta() << std::endl;
   out << "  Average planning time:         " << stats_.getAveragePlanningTime() << " seconds" << std::endl;
   out << "  Average insertion time:        " << stats_.getAverageInsertionTime() << " seconds" << std::endl;
+  out << "  Collision checks of solved queries:" << std::endl;
+  CollisionCheckCounter::print(solvedQueryChecks_, stats_.numSolutionsFromRecall_, "solved query", out);
+  queryLog_->print(out);
   out << std::endl;
 }
 
+bool Bolt::dumpQueryLog(const std::string &filePath) const
+{
+  return queryLog_->writeJSON(filePath + ".json") && queryLog_->writeCSV(filePath + ".csv");
+}
+
 std::size_t Bolt::getExperiencesCount() const
 {
   return sparseGraph_->getNumVertices();
 }
 
-void Bolt::getAllPlannerDatas(std::vector<ob::PlannerDataPtr> &plannerDatas) const
+void Bolt::getAllPlannerDatas(std::vector<ob::PlannerDataPtr> & /*plannerDatas*/) const
 {
   // sparseGraph_->getAllPlannerDatas(plannerDatas);
 }
@@ -478,7 +545,8 @@ SparseCriteriaPtr Bolt::getSparseCriteria()
 
 bool Bolt::doPostProcessing()
 {
-  OMPL_INFORM("Performing post-processing for %i queued solution paths", queuedSolutionPaths_.size());
+  OMPL_INFORM("Performing post-processing for %u queued solution paths",
+              static_cast<unsigned int>(queuedSolutionPaths_.size()));
   OMPL_INFORM("TODO post-processing");
 
   return true;
@@ -66,6 +66,7 @@ BoltPlanner::BoltPlanner(const base::SpaceInformationPtr &si, const TaskGraphPtr
   specs_.directed = false;
 
   path_simplifier_.reset(new geometric::PathSimplifier(si_));
+  statePool_.reset(new StatePool(si_, 1));
 }
 
 BoltPlanner::~BoltPlanner(void)
@@ -91,6 +92,8 @@ base::PlannerStatus BoltPlanner::solve(Termination &ptc)
 {
   std::size_t indent = 0;
   BOLT_FUNC(indent, verbose_, "BoltPlanner::solve()");
+  ScopedCheckSite site(SITE_PLANNER);
+  queryRecord_.reset();
 
   bool solved = false;
 
@@ -159,6 +162,7 @@ base::PlannerStatus BoltPlanner::solve(Termination &ptc)
   // Smooth the result
   if (smoothingEnabled_)
   {
+    ScopedQueryTimer timer(queryRecord_, QUERY_SIMPLIFICATION);
     if (taskGraph_->taskPlanningEnabled())
       simplifyTaskPath(geometricSolution, ptc, indent);
     else
@@ -282,6 +286,7 @@ bool BoltPlanner::getPathOnGraph(const std::vector<TaskVertex> &candidateStarts,
                                  bool debug, bool &feedbackStartFailed, std::size_t indent)
 {
   BOLT_FUNC(indent, verbose_, "BoltPlanner::getPathOnGraph()");
+  ScopedCheckSite site(SITE_GET_PATH_ON_GRAPH);
 
   bool foundValidStart = false;
   bool foundValidGoal = false;
@@ -297,7 +302,11 @@ bool BoltPlanner::getPathOnGraph(const std::vector<TaskVertex> &candidateStarts,
     }
 
     // Check if this start is visible from the actual start
-    if (!si_->checkMotion(actualStart, taskGraph_->getState(start)))
+    ScopedQueryTimer startTimer(queryRecord_, QUERY_VISIBILITY);
+    queryRecord_.visibilityChecks_++;
+    const bool startVisible = si_->checkMotion(actualStart, taskGraph_->getState(start));
+    startTimer.stop();
+    if (!startVisible)
     {
       if (verbose_)
       {
@@ -332,7 +341,11 @@ bool BoltPlanner::getPathOnGraph(const std::vector<TaskVertex> &candidateStarts,
       }
 
       // Check if this goal is visible from the actual goal
-      if (!si_->checkMotion(actualGoal, taskGraph_->getState(goal)))
+      ScopedQueryTimer goalTimer(queryRecord_, QUERY_VISIBILITY);
+      queryRecord_.visibilityChecks_++;
+      const bool goalVisible = si_->checkMotion(actualGoal, taskGraph_->getState(goal));
+      goalTimer.stop();
+      if (!goalVisible)
       {
         if (verbose_)
         {
@@ -460,7 +473,13 @@ bool BoltPlanner::lazyCollisionSearch(const TaskVertex &start, const TaskVertex
     }
 
     // Attempt to find a solution from start to goal
-    if (!taskGraph_->astarSearch(start, goal, vertexPath, distance, indent))
+    ScopedQueryTimer astarTimer(queryRecord_, QUERY_ASTAR);
+    const bool found = taskGraph_->astarSearch(start, goal, vertexPath, distance, indent);
+    astarTimer.stop();
+    queryRecord_.astarSearches_++;
+    queryRecord_.nodesOpened_ += taskGraph_->getNumNodesOpened();
+    queryRecord_.nodesClosed_ += taskGraph_->getNumNodesClosed();
+    if (!found)
     {
       BOLT_DEBUG(indent, verbose_, "unable to construct solution between start and goal using astar");
 
@@ -490,6 +509,9 @@ bool BoltPlanner::lazyCollisionSearch(const TaskVertex &start, const TaskVertex
 bool BoltPlanner::lazyCollisionCheck(std::vector<TaskVertex> &vertexPath, Termination &ptc, std::size_t indent)
 {
   BOLT_FUNC(indent, verbose_, "BoltPlanner::lazyCollisionCheck()");
+  ScopedCheckSite site(SITE_LAZY_COLLISION_CHECK);
+  ScopedQueryTimer timer(queryRecord_, QUERY_LAZY_CHECK);
+  queryRecord_.lazyCheckRounds_++;
 
   bool hasInvalidEdges = false;
 
@@ -510,10 +532,9 @@ bool BoltPlanner::lazyCollisionCheck(std::vector<TaskVertex> &vertexPath, Termin
       return false;
     }
 
-    TaskEdge thisEdge = boost::edge(fromVertex, toVertex, taskGraph_->g_).first;
-
     // Has this edge already been checked before?
-    if (taskGraph_->edgeCollisionStatePropertyTask_[thisEdge] == NOT_CHECKED)
+    EdgeCollisionState collisionState = taskGraph_->getEdgeCollisionState(fromVertex, toVertex);
+    if (collisionState == NOT_CHECKED)
     {
       // Check path between states
       if (!si_->checkMotion(taskGraph_->getState(fromVertex), taskGraph_->getState(toVertex)))
@@ -523,17 +544,18 @@ bool BoltPlanner::lazyCollisionCheck(std::vector<TaskVertex> &vertexPath, Termin
         // << toVertex);
 
         // Disable edge
-        taskGraph_->edgeCollisionStatePropertyTask_[thisEdge] = IN_COLLISION;
+        collisionState = IN_COLLISION;
       }
       else
       {
         // Mark edge as free so we no longer need to check for collision
-        taskGraph_->edgeCollisionStatePropertyTask_[thisEdge] = FREE;
+        collisionState = FREE;
       }
+      taskGraph_->setEdgeCollisionState(fromVertex, toVertex, collisionState);
     }
 
     // Check final result
-    if (taskGraph_->edgeCollisionStatePropertyTask_[thisEdge] == IN_COLLISION)
+    if (collisionState == IN_COLLISION)
     {
       // Remember that this path is no longer valid, but keep checking remainder of path edges
       hasInvalidEdges = true;
@@ -568,12 +590,14 @@ bool BoltPlanner::findGraphNeighbors(const base::State *state, std::vector<TaskV
 
   // Setup search by getting a non-const version of the focused state
   const std::size_t threadID = 0;
-  base::State *stateCopy = si_->cloneState(state);
+  base::State *stateCopy = statePool_->cloneState(state);
 
   // Search
+  ScopedQueryTimer timer(queryRecord_, QUERY_NEIGHBOR_SEARCH);
   taskGraph_->getQueryStateNonConst(taskGraph_->queryVertices_[threadID]) = stateCopy;
   taskGraph_->nn_->nearestK(taskGraph_->queryVertices_[threadID], findNearestKNeighbors, neighbors);
   taskGraph_->getQueryStateNonConst(taskGraph_->queryVertices_[threadID]) = nullptr;
+  timer.stop();
 
   // Convert our list of neighbors to the proper level
   if (requiredLevel == 2)
@@ -593,7 +617,7 @@ bool BoltPlanner::findGraphNeighbors(const base::State *state, std::vector<TaskV
   }
 
   // Free memory
-  si_->getStateSpace()->freeState(stateCopy);
+  statePool_->freeState(stateCopy);
 
   return neighbors.size();
 }
@@ -630,18 +654,19 @@ bool BoltPlanner::convertVertexPathToStatePath(std::vector<TaskVertex> &vertexPa
       // Error check that no consequtive verticies are the same
       if (vertexPath[i - 1] == vertexPath[i - 2])
       {
-        OMPL_ERROR("Found repeated vertices %u to %u on index %u", vertexPath[i - 1], vertexPath[i - 2], i);
+        OMPL_ERROR("Found repeated vertices %u to %u on index %u", static_cast<unsigned int>(vertexPath[i - 1]),
+                   static_cast<unsigned int>(vertexPath[i - 2]), static_cast<unsigned int>(i));
         exit(-1);
       }
 
-      TaskEdge edge = boost::edge(vertexPath[i - 1], vertexPath[i - 2], taskGraph_->g_).first;
+      const EdgeCollisionState collisionState = taskGraph_->getEdgeCollisionState(vertexPath[i - 1], vertexPath[i - 2]);
 
       // Check if any edges in path are not free (then it an approximate path)
-      if (taskGraph_->edgeCollisionStatePropertyTask_[edge] == IN_COLLISION)
+      if (collisionState == IN_COLLISION)
       {
         OMPL_ERROR("Found invalid edge / approximate solution - how did this happen?");
       }
-      else if (taskGraph_->edgeCollisionStatePropertyTask_[edge] == NOT_CHECKED)
+      else if (collisionState == NOT_CHECKED)
       {
         OMPL_ERROR("A chosen path has an edge that has not been checked for collision. This should not happen");
       }
@@ -660,6 +685,7 @@ bool BoltPlanner::convertVertexPathToStatePath(std::vector<TaskVertex> &vertexPa
 bool BoltPlanner::simplifyPath(og::PathGeometric &path, Termination &ptc, std::size_t indent)
 {
   BOLT_FUNC(indent, verbose_, "BoltPlanner: simplifyPath()");
+  ScopedCheckSite site(SITE_SIMPLIFICATION);
   BOLT_ERROR(indent, true, "BoltPlanner: simplifyPath() - why no task??");
 
   time::point simplifyStart = time::now();
@@ -675,9 +701,10 @@ bool BoltPlanner::simplifyPath(og::PathGeometric &path, Termination &ptc, std::s
   return true;
 }
 
-bool BoltPlanner::simplifyTaskPath(og::PathGeometric &path, Termination &ptc, std::size_t indent)
+bool BoltPlanner::simplifyTaskPath(og::PathGeometric &path, Termination & /*ptc*/, std::size_t indent)
 {
   BOLT_FUNC(indent, verbose_, "BoltPlanner: simplifyTaskPath()");
+  ScopedCheckSite site(SITE_SIMPLIFICATION);
 
   time::point simplifyStart = time::now();
   std::size_t origNumStates = path.getStateCount();
@@ -735,7 +762,8 @@ bool BoltPlanner::simplifyTaskPath(og::PathGeometric &path, Termination &ptc, st
   }
   else
   {
-    OMPL_WARN("The Cartesian path segement 1 has only %u states", pathSegment[1].getStateCount());
+    OMPL_WARN("The Cartesian path segement 1 has only %u states",
+              static_cast<unsigned int>(pathSegment[1].getStateCount()));
   }
 
   // Smooth the freespace paths
@@ -795,7 +823,7 @@ bool BoltPlanner::canConnect(const base::State *randomState, Termination &ptc, s
     // Check if this nearState is visible from the random state
     if (!si_->checkMotion(s1, s2))
     {
-      OMPL_WARN("NEIGHBOR %u NOT VISIBLE ", count++);
+      OMPL_WARN("NEIGHBOR %u NOT VISIBLE ", static_cast<unsigned int>(count++));
 
       if (false)
       {
@@ -0,0 +1,121 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2016, University of Colorado, Boulder
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the Univ of CO, Boulder nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+/* Author: Dave Coleman <dave@dav.ee>
+   Desc:   Samples near obstacle boundaries, mixed with uniform samples by which criteria currently add vertices
+*/
+
+// OMPL
+#include <ompl/tools/bolt/BoundarySampler.h>
+
+// C++
+#include <algorithm>
+
+namespace ompl
+{
+namespace tools
+{
+namespace bolt
+{
+BoundarySampler::BoundarySampler(const base::SpaceInformation *si, BoundarySampling method, double stdDev)
+  : base::MinimumClearanceValidStateSampler(si), method_(method), stdDev_(stdDev), pairState_(si->allocState())
+{
+  name_ = method == BOUNDARY_SAMPLING_BRIDGE ? "bridge_clearance" : "gaussian_clearance";
+}
+
+BoundarySampler::~BoundarySampler()
+{
+  si_->freeState(pairState_);
+}
+
+bool BoundarySampler::sample(base::State *state)
+{
+  for (unsigned int attempts = 0; attempts < attempts_; ++attempts)
+  {
+    sampler_->sampleUniform(state);
+    const bool firstValid = hasClearance(state);
+
+    // Bridges start inside an obstacle
+    if (method_ == BOUNDARY_SAMPLING_BRIDGE && firstValid)
+      continue;
+
+    sampler_->sampleGaussian(pairState_, state, stdDev_);
+    const bool secondValid = hasClearance(pairState_);
+
+    if (method_ == BOUNDARY_SAMPLING_GAUSSIAN)
+    {
+      if (firstValid == secondValid)
+        continue;
+      if (secondValid)
+        si_->copyState(state, pairState_);
+      return true;
+    }
+
+    // Both ends are blocked, so a valid midpoint lies between two obstacles
+    if (secondValid)
+      continue;
+    si_->getStateSpace()->interpolate(state, pairState_, 0.5, state);
+    if (hasClearance(state))
+      return true;
+  }
+  return false;
+}
+
+bool BoundarySampler::hasClearance(const base::State *state) const
+{
+  double dist = 0.0;
+  return si_->getStateValidityChecker()->isValid(state, dist) && dist >= clearance_;
+}
+
+SampleMixer::SampleMixer(BoundarySampling method, double stdDev) : method_(method), stdDev_(stdDev)
+{
+  reset();
+}
+
+void SampleMixer::recordAddition(VertexType reason)
+{
+  const double boundary = (reason == CONNECTIVITY || reason == INTERFACE) ? 1.0 : 0.0;
+  boundaryShare_ += (boundary - boundaryShare_) / std::max(1.0, window_);
+  fraction_ = minFraction_ + (maxFraction_ - minFraction_) * boundaryShare_;
+}
+
+void SampleMixer::reset()
+{
+  boundaryShare_ = 0.0;
+  fraction_ = minFraction_;
+}
+
+}  // namespace bolt
+}  // namespace tools
+}  // namespace ompl
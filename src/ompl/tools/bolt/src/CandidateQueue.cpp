@@ -40,6 +40,7 @@
 #include <ompl/tools/bolt/CandidateQueue.h>
 #include <ompl/tools/bolt/SparseCriteria.h>
 #include <ompl/tools/bolt/SparseGenerator.h>
+#include <ompl/tools/bolt/SeededRandom.h>
 
 // C++
 #include <queue>
@@ -65,9 +66,11 @@ CandidateQueue::~CandidateQueue()
 {
   while (!queue_.empty())
   {
-    si_->freeState(queue_.front().state_);
+    sg_->getStatePool()->freeState(queue_.front().state_);
     queue_.pop();
   }
+  for (std::map<std::size_t, CandidateData>::iterator it = pending_.begin(); it != pending_.end(); ++it)
+    sg_->getStatePool()->freeState(it->second.state_);
 }
 
 void CandidateQueue::startGenerating(std::size_t indent)
@@ -83,6 +86,9 @@ void CandidateQueue::startGenerating(std::size_t indent)
   // Stats
   totalMisses_ = 0;
 
+  deterministic_ = sparseGenerator_->deterministic_;
+  nextSequence_ = 0;
+
   // Set number threads - should be at least less than 1 from total number of threads on system
   // 1 thread is for parent, 1 is for sampler, 1 is for GUIs, etc, remainder are for this
   numThreads_ = std::max(1, int(sg_->getNumQueryVertices() - 3));
@@ -101,6 +107,36 @@ void CandidateQueue::startGenerating(std::size_t indent)
   // Create threads
   generatorThreads_.resize(numThreads_);
 
+  if (deterministic_)
+  {
+    const std::size_t numStreams = std::max(std::size_t(1), sparseGenerator_->numDeterministicStreams_);
+    BOLT_DEBUG(indent, true, "Deterministic mode with seed " << sparseGenerator_->seed_ << " and " << numStreams
+                                                             << " sample streams");
+    if (numStreams < numThreads_)
+      BOLT_WARN(indent, true, "Fewer sample streams than threads, " << numThreads_ - numStreams << " threads idle");
+
+    // The streams only depend on the seed, so every thread count draws the same candidates
+    std::vector<std::vector<ClearanceSamplerPtr> > streamSamplers(numThreads_);
+    for (std::size_t stream = 0; stream < numStreams; ++stream)
+    {
+      base::StateSamplerPtr stateSampler = allocSequenceStateSampler(
+          sparseGenerator_->sampleSequence_, si_.get(), stream, numStreams, sparseGenerator_->seed_);
+      if (!stateSampler)
+        stateSampler = allocSeededStateSampler(si_.get(), deriveSeed(sparseGenerator_->seed_, SEED_CANDIDATES, stream));
+      ClearanceSamplerPtr sampler =
+          allocClearanceSampler(si_.get(), sg_->getObstacleClearance(), CoverageGridPtr(), stateSampler);
+      streamSamplers[stream % numThreads_].push_back(sampler);
+    }
+
+    for (std::size_t i = 0; i < generatorThreads_.size(); ++i)
+    {
+      std::size_t threadID = i + 1;  // the first thread (0) is reserved for the parent process
+      generatorThreads_[i] = new boost::thread(
+          boost::bind(&CandidateQueue::deterministicThread, this, threadID, streamSamplers[i], indent));
+    }
+    return;
+  }
+
   // Starts on thread 1 because thread 0 is reserved for parent process
   for (std::size_t i = 0; i < generatorThreads_.size(); ++i)
   {
@@ -110,9 +146,10 @@ void CandidateQueue::startGenerating(std::size_t indent)
     si->setMotionValidator(si_->getMotionValidator());
 
     // Load minimum clearance state sampler
-    ob::MinimumClearanceValidStateSamplerPtr clearanceSampler =
-        ob::MinimumClearanceValidStateSamplerPtr(new ob::MinimumClearanceValidStateSampler(si.get()));
-    clearanceSampler->setMinimumObstacleClearance(sg_->getObstacleClearance());
+    ob::MinimumClearanceValidStateSamplerPtr clearanceSampler = allocClearanceSampler(
+        si.get(), sg_->getObstacleClearance(), sparseGenerator_->getCoverageGrid(),
+        allocSequenceStateSampler(sparseGenerator_->sampleSequence_, si.get(), i + 1, sg_->getNumQueryVertices(),
+                                  sparseGenerator_->seed_));
     si->getStateValidityChecker()->setClearanceSearchDistance(sg_->getObstacleClearance());
 
     std::size_t threadID = i + 1;  // the first thread (0) is reserved for the parent process for use of samplingQuery
@@ -140,17 +177,24 @@ void CandidateQueue::stopGenerating(std::size_t indent)
     delete generatorThreads_[i];
   }
 
+  // Free candidates that were never taken
+  for (std::map<std::size_t, CandidateData>::iterator it = pending_.begin(); it != pending_.end(); ++it)
+    sg_->getStatePool()->freeState(it->second.state_);
+  pending_.clear();
+
   BOLT_FUNC(indent, true, "CandidateQueue.stopGenerating() Generating threads have stopped");
 }
 
-void CandidateQueue::generatingThread(std::size_t threadID, base::SpaceInformationPtr si,
+void CandidateQueue::generatingThread(std::size_t threadID, base::SpaceInformationPtr /*si*/,
                                       ClearanceSamplerPtr clearanceSampler, std::size_t indent)
 {
   BOLT_FUNC(indent, verbose_, "generatingThread() " << threadID);
+  GenerationProfiler::setThreadID(threadID);
+  ScopedCheckSite site(SITE_CANDIDATE_QUEUE);
 
   base::State *candidateState;
 
-  while (threadsRunning_ && !visual_->viz1()->shutdownRequested())
+  while (threadsRunning_ && !sg_->shutdownRequested())
   {
     BOLT_DEBUG(indent + 2, vThread_, "generatingThread: Running while loop on thread " << threadID);
 
@@ -193,6 +237,57 @@ void CandidateQueue::generatingThread(std::size_t threadID, base::SpaceInformati
   }
 }
 
+void CandidateQueue::deterministicThread(std::size_t threadID, std::vector<ClearanceSamplerPtr> streamSamplers,
+                                         std::size_t indent)
+{
+  BOLT_FUNC(indent, verbose_, "deterministicThread() " << threadID << " with " << streamSamplers.size() << " streams");
+  GenerationProfiler::setThreadID(threadID);
+  ScopedCheckSite site(SITE_CANDIDATE_QUEUE);
+
+  if (streamSamplers.empty())
+    return;
+
+  const std::size_t numStreams = std::max(std::size_t(1), sparseGenerator_->numDeterministicStreams_);
+  const std::size_t firstStream = threadID - 1;
+  const std::size_t window = targetQueueSize_ * numThreads_;
+
+  // Work through the sequence numbers of our streams in increasing order, so each stream is drawn in order
+  for (std::size_t round = 0; threadsRunning_; ++round)
+  {
+    for (std::size_t i = 0; i < streamSamplers.size() && threadsRunning_; ++i)
+    {
+      const std::size_t sequence = round * numStreams + firstStream + i * numThreads_;
+
+      // Do not get too far ahead of the parent. The thread owning nextSequence_ is never held back here
+      if (sequence >= nextSequence_ + window)
+      {
+        ScopedPhaseTimer timer(sg_->getProfiler(), PHASE_QUEUE_WAIT);
+        while (sequence >= nextSequence_ + window && threadsRunning_)
+          usleep(100);
+      }
+
+      base::State *candidateState = sg_->getStatePool()->allocState();
+      {
+        ScopedPhaseTimer timer(sg_->getProfiler(), PHASE_SAMPLING);
+        ScopedCheckSite site(SITE_SAMPLING);
+        if (!streamSamplers[i]->sample(candidateState))
+        {
+          OMPL_ERROR("Unable to find valid sample");
+          exit(-1);  // this should never happen
+        }
+      }
+      sg_->getProfiler()->increment(COUNT_SAMPLES);
+
+      // Neighbors may be left incomplete if the graph changes, the parent then finds them again
+      CandidateData candidateD(candidateState);
+      findGraphNeighbors(candidateD, threadID, indent + 2);
+
+      boost::lock_guard<boost::shared_mutex> lock(candidateQueueMutex_);
+      pending_.insert(std::make_pair(sequence, candidateD));
+    }
+  }
+}
+
 void CandidateQueue::getNextState(base::State *&candidateState, ClearanceSamplerPtr clearanceSampler,
                                   std::size_t indent)
 {
@@ -200,14 +295,17 @@ void CandidateQueue::getNextState(base::State *&candidateState, ClearanceSampler
   if (!samplingQueue_->getNextState(candidateState, indent + 2))
   {
     // Create new state ourselves
-    candidateState = si_->allocState();
+    candidateState = sg_->getStatePool()->allocState();
 
     // Sample randomly
+    ScopedPhaseTimer timer(sg_->getProfiler(), PHASE_SAMPLING);
+    ScopedCheckSite site(SITE_SAMPLING);
     if (!clearanceSampler->sample(candidateState))
     {
       OMPL_ERROR("Unable to find valid sample");
       exit(-1);  // this should never happen
     }
+    sg_->getProfiler()->increment(COUNT_SAMPLES);
   }
 }
 
@@ -217,6 +315,8 @@ CandidateData &CandidateQueue::getNextCandidate(std::size_t indent)
                                      << queue_.size()
                                      << " num samples added: " << sparseGenerator_->getNumRandSamplesAdded());
   // This function is run in the parent thread
+  if (deterministic_)
+    return getNextDeterministicCandidate(indent);
 
   // Keep looping until a non-expired candidate exists or the thread ends
   while (threadsRunning_)
@@ -230,11 +330,12 @@ CandidateData &CandidateQueue::getNextCandidate(std::size_t indent)
              threadsRunning_)
       {
         // Next Candidate state is expired, delete
-        si_->freeState(queue_.front().state_);
+        sg_->getStatePool()->freeState(queue_.front().state_);
         queue_.pop();
         numCleared++;
       }
       BOLT_ERROR(indent, vClear_ && numCleared > 0, "Cleared " << numCleared << " states from CandidateQueue");
+      sg_->getProfiler()->increment(COUNT_STALE_CANDIDATES, numCleared);
 
       // Return the first non-expired candidate if one exists
       if (!queue_.empty() && queue_.front().graphVersion_ == sparseGenerator_->getNumRandSamplesAdded())
@@ -248,6 +349,8 @@ CandidateData &CandidateQueue::getNextCandidate(std::size_t indent)
     // Wait for queue to not be empty
     bool oneTimeFlag = true;
     totalMisses_++;
+    sg_->getProfiler()->increment(COUNT_QUEUE_MISSES);
+    ScopedPhaseTimer timer(sg_->getProfiler(), PHASE_QUEUE_WAIT);
     while (queue_.empty() && threadsRunning_)
     {
       if (oneTimeFlag)
@@ -265,12 +368,58 @@ CandidateData &CandidateQueue::getNextCandidate(std::size_t indent)
   return queue_.front();
 }
 
-void CandidateQueue::setCandidateUsed(bool wasUsed, std::size_t indent)
+CandidateData &CandidateQueue::getNextDeterministicCandidate(std::size_t indent)
+{
+  // This function is run in the parent thread
+  std::map<std::size_t, CandidateData>::iterator it;
+  while (true)
+  {
+    {
+      boost::lock_guard<boost::shared_mutex> lock(candidateQueueMutex_);
+      it = pending_.find(nextSequence_);
+      if (it != pending_.end())
+        break;
+    }
+
+    // Wait for the thread that owns the next candidate
+    totalMisses_++;
+    sg_->getProfiler()->increment(COUNT_QUEUE_MISSES);
+    ScopedPhaseTimer timer(sg_->getProfiler(), PHASE_QUEUE_WAIT);
+    BOLT_WARN(indent, vQueueEmpty_, "CandidateQueue: Waiting for candidate " << nextSequence_);
+    usleep(100);
+  }
+
+  // Only the parent modifies the graph, so the check cannot race with a change
+  CandidateData &candidateD = it->second;
+  if (isExpired(candidateD))
+  {
+    BOLT_DEBUG(indent, vClear_, "Finding neighbors of stale candidate " << nextSequence_ << " again");
+    sg_->getProfiler()->increment(COUNT_STALE_CANDIDATES);
+    sg_->getProfiler()->increment(COUNT_RECOMPUTED_CANDIDATES);
+    candidateD.graphNeighborhood_.clear();
+    candidateD.visibleNeighborhood_.clear();
+    sparseGenerator_->findGraphNeighbors(candidateD, 0, indent);
+  }
+
+  return candidateD;
+}
+
+void CandidateQueue::setCandidateUsed(bool wasUsed, std::size_t /*indent*/)
 {
   // This function is run in the parent thread
+  if (deterministic_)
+  {
+    boost::lock_guard<boost::shared_mutex> lock(candidateQueueMutex_);
+    std::map<std::size_t, CandidateData>::iterator it = pending_.find(nextSequence_);
+    if (!wasUsed)
+      sg_->getStatePool()->freeState(it->second.state_);
+    pending_.erase(it);
+    nextSequence_++;
+    return;
+  }
 
   if (!wasUsed)  // if was used the state is now in use elsewhere
-    si_->freeState(queue_.front().state_);
+    sg_->getStatePool()->freeState(queue_.front().state_);
 
   // std::cout << "setCandidateUsed: waiting for lock ------------------------" << std::endl;
   boost::lock_guard<boost::shared_mutex> lock(candidateQueueMutex_);
@@ -280,6 +429,7 @@ void CandidateQueue::setCandidateUsed(bool wasUsed, std::size_t indent)
 
 void CandidateQueue::waitForQueueNotFull(std::size_t indent)
 {
+  ScopedPhaseTimer timer(sg_->getProfiler(), PHASE_QUEUE_WAIT);
   bool oneTimeFlag = true;
   while (queue_.size() >= targetQueueSize_ && threadsRunning_)
   {
@@ -307,8 +457,11 @@ bool CandidateQueue::findGraphNeighbors(CandidateData &candidateD, std::size_t t
   // Note that the main thread could be modifying the NN, so we have to lock it
   sg_->getQueryStateNonConst(threadID) = candidateD.state_;
   {
+    // Includes time spent waiting for the lock
+    ScopedPhaseTimer timer(sg_->getProfiler(), PHASE_NEAREST_NEIGHBOR);
     // std::cout << "getting nn lock " << std::endl;
     std::lock_guard<std::mutex> lock(sg_->getNNGuard());
+    candidateD.neighborhoodVersion_ = sg_->getNeighborhoodVersion();
     sg_->getNN()->nearestR(sg_->getQueryVertices(threadID), sparseCriteria_->getSparseDelta(),
                            candidateD.graphNeighborhood_);
   }
@@ -316,12 +469,13 @@ bool CandidateQueue::findGraphNeighbors(CandidateData &candidateD, std::size_t t
   sg_->getQueryStateNonConst(threadID) = nullptr;
 
   // Now that we got the neighbors from the NN, we must remove any we can't see
+  ScopedPhaseTimer timer(sg_->getProfiler(), PHASE_VISIBILITY);
   for (std::size_t i = 0; i < candidateD.graphNeighborhood_.size(); ++i)
   {
     SparseVertex v2 = candidateD.graphNeighborhood_[i];
 
     // Check for termination condition
-    if (candidateD.graphVersion_ != sparseGenerator_->getNumRandSamplesAdded() || !threadsRunning_)
+    if (isExpired(candidateD) || !threadsRunning_)
     {
       BOLT_WARN(indent, vNeighbor_, "findGraphNeighbors aborted b/c term cond");
       return false;
@@ -330,6 +484,7 @@ bool CandidateQueue::findGraphNeighbors(CandidateData &candidateD, std::size_t t
     // Don't collision check if they are the same state
     if (candidateD.state_ != sg_->getState(v2))
     {
+      sg_->getProfiler()->increment(COUNT_MOTION_CHECKS);
       if (!si_->checkMotion(candidateD.state_, sg_->getState(v2)))
       {
         continue;
@@ -337,7 +492,7 @@ bool CandidateQueue::findGraphNeighbors(CandidateData &candidateD, std::size_t t
     }
 
     // Check for termination condition
-    if (candidateD.graphVersion_ != sparseGenerator_->getNumRandSamplesAdded() || !threadsRunning_)
+    if (isExpired(candidateD) || !threadsRunning_)
     {
       BOLT_WARN(indent, vNeighbor_, "findGraphNeighbors aborted b/c term cond");
       return false;
@@ -354,6 +509,13 @@ bool CandidateQueue::findGraphNeighbors(CandidateData &candidateD, std::size_t t
   return true;
 }
 
+bool CandidateQueue::isExpired(const CandidateData &candidateD)
+{
+  if (deterministic_)
+    return candidateD.neighborhoodVersion_ != sg_->getNeighborhoodVersion();
+  return candidateD.graphVersion_ != sparseGenerator_->getNumRandSamplesAdded();
+}
+
 }  // namespace bolt
 }  // namespace tools
 }  // namespace ompl
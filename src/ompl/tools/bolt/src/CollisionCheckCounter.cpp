@@ -0,0 +1,363 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2016, University of Colorado, Boulder
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the Univ of CO, Boulder nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+/* Author: Dave Coleman <dave@dav.ee>
+   Desc:   Counts and times every state validity and motion check, attributed to the part of Bolt that asked for it
+*/
+
+// OMPL
+#include <ompl/tools/bolt/CollisionCheckCounter.h>
+#include <ompl/util/Time.h>
+
+// C++
+#include <iomanip>
+
+namespace ompl
+{
+namespace tools
+{
+namespace bolt
+{
+namespace
+{
+/** \brief Label of the checks made by the calling thread */
+thread_local CollisionCheckSite currentSite = SITE_OTHER;
+
+std::uint64_t toNanoseconds(double seconds)
+{
+  return static_cast<std::uint64_t>(seconds * 1e9);
+}
+}  // namespace
+
+// -------------------------------------------------------------------------------------------------
+// CollisionCheckSnapshot
+// -------------------------------------------------------------------------------------------------
+
+std::uint64_t CollisionCheckSnapshot::getStateChecks() const
+{
+  std::uint64_t total = 0;
+  for (std::size_t i = 0; i < NUM_COLLISION_CHECK_SITES; ++i)
+    total += stateChecks_[i];
+  return total;
+}
+
+std::uint64_t CollisionCheckSnapshot::getMotionChecks() const
+{
+  std::uint64_t total = 0;
+  for (std::size_t i = 0; i < NUM_COLLISION_CHECK_SITES; ++i)
+    total += motionChecks_[i];
+  return total;
+}
+
+CollisionCheckSnapshot CollisionCheckSnapshot::operator-(const CollisionCheckSnapshot &earlier) const
+{
+  CollisionCheckSnapshot result;
+  for (std::size_t i = 0; i < NUM_COLLISION_CHECK_SITES; ++i)
+  {
+    result.stateChecks_[i] = stateChecks_[i] - earlier.stateChecks_[i];
+    result.motionChecks_[i] = motionChecks_[i] - earlier.motionChecks_[i];
+    result.stateTime_[i] = stateTime_[i] - earlier.stateTime_[i];
+    result.motionTime_[i] = motionTime_[i] - earlier.motionTime_[i];
+  }
+  return result;
+}
+
+CollisionCheckSnapshot &CollisionCheckSnapshot::operator+=(const CollisionCheckSnapshot &other)
+{
+  for (std::size_t i = 0; i < NUM_COLLISION_CHECK_SITES; ++i)
+  {
+    stateChecks_[i] += other.stateChecks_[i];
+    motionChecks_[i] += other.motionChecks_[i];
+    stateTime_[i] += other.stateTime_[i];
+    motionTime_[i] += other.motionTime_[i];
+  }
+  return *this;
+}
+
+// -------------------------------------------------------------------------------------------------
+// CollisionCheckCounter
+// -------------------------------------------------------------------------------------------------
+
+CollisionCheckCounter::CollisionCheckCounter()
+{
+  reset();
+}
+
+void CollisionCheckCounter::install(const base::SpaceInformationPtr &si)
+{
+  // Create the default motion validator first, so that it is wrapped too
+  if (!si->isSetup())
+    si->setup();
+
+  // Only wrap once, even if setup() is called repeatedly
+  if (!std::dynamic_pointer_cast<CountingValidityChecker>(si->getStateValidityChecker()))
+  {
+    si->setStateValidityChecker(base::StateValidityCheckerPtr(
+        new CountingValidityChecker(si, si->getStateValidityChecker(), shared_from_this())));
+  }
+
+  if (si->getMotionValidator() && !std::dynamic_pointer_cast<CountingMotionValidator>(si->getMotionValidator()))
+  {
+    si->setMotionValidator(base::MotionValidatorPtr(
+        new CountingMotionValidator(si, si->getMotionValidatorNonConst(), shared_from_this())));
+  }
+
+  // Changing the checkers marks si as not setup
+  si->setup();
+}
+
+void CollisionCheckCounter::recordStateCheck(double seconds)
+{
+  stateChecks_[currentSite].fetch_add(1, std::memory_order_relaxed);
+  stateTime_[currentSite].fetch_add(toNanoseconds(seconds), std::memory_order_relaxed);
+}
+
+void CollisionCheckCounter::recordMotionCheck(double seconds)
+{
+  motionChecks_[currentSite].fetch_add(1, std::memory_order_relaxed);
+  motionTime_[currentSite].fetch_add(toNanoseconds(seconds), std::memory_order_relaxed);
+}
+
+CollisionCheckSnapshot CollisionCheckCounter::getSnapshot() const
+{
+  CollisionCheckSnapshot snapshot;
+  for (std::size_t i = 0; i < NUM_COLLISION_CHECK_SITES; ++i)
+  {
+    snapshot.stateChecks_[i] = stateChecks_[i].load(std::memory_order_relaxed);
+    snapshot.motionChecks_[i] = motionChecks_[i].load(std::memory_order_relaxed);
+    snapshot.stateTime_[i] = stateTime_[i].load(std::memory_order_relaxed) / 1e9;
+    snapshot.motionTime_[i] = motionTime_[i].load(std::memory_order_relaxed) / 1e9;
+  }
+  return snapshot;
+}
+
+void CollisionCheckCounter::reset()
+{
+  for (std::size_t i = 0; i < NUM_COLLISION_CHECK_SITES; ++i)
+  {
+    stateChecks_[i] = 0;
+    motionChecks_[i] = 0;
+    stateTime_[i] = 0;
+    motionTime_[i] = 0;
+  }
+}
+
+CollisionCheckSite CollisionCheckCounter::setSite(CollisionCheckSite site)
+{
+  CollisionCheckSite previous = currentSite;
+  currentSite = site;
+  return previous;
+}
+
+CollisionCheckSite CollisionCheckCounter::getSite()
+{
+  return currentSite;
+}
+
+std::string CollisionCheckCounter::getSiteName(CollisionCheckSite site)
+{
+  switch (site)
+  {
+    case SITE_OTHER:
+      return "other";
+    case SITE_SAMPLING:
+      return "sampling";
+    case SITE_DISCRETIZATION:
+      return "discretization";
+    case SITE_CANDIDATE_QUEUE:
+      return "candidate_queue";
+    case SITE_SPARSE_CRITERIA:
+      return "sparse_criteria";
+    case SITE_GRAPH_VERIFICATION:
+      return "graph_verification";
+    case SITE_TASK_GRAPH:
+      return "task_graph";
+    case SITE_GET_PATH_ON_GRAPH:
+      return "get_path_on_graph";
+    case SITE_LAZY_COLLISION_CHECK:
+      return "lazy_collision_check";
+    case SITE_SIMPLIFICATION:
+      return "simplification";
+    case SITE_PLANNER:
+      return "planner";
+    default:
+      return "unknown";
+  }
+}
+
+void CollisionCheckCounter::print(const CollisionCheckSnapshot &snapshot, std::size_t normalizer,
+                                  const std::string &normalizerName, std::ostream &out)
+{
+  out << std::left << std::setw(24) << "  site" << std::setw(14) << "state checks" << std::setw(14)
+      << "motion checks" << std::setw(14) << "state (s)" << std::setw(14) << "motion (s)";
+  if (normalizer)
+    out << "checks per " << normalizerName;
+  out << std::endl;
+
+  for (std::size_t i = 0; i < NUM_COLLISION_CHECK_SITES; ++i)
+  {
+    if (!snapshot.stateChecks_[i] && !snapshot.motionChecks_[i])
+      continue;
+
+    out << std::left << "  " << std::setw(22) << getSiteName(static_cast<CollisionCheckSite>(i)) << std::setw(14)
+        << snapshot.stateChecks_[i] << std::setw(14) << snapshot.motionChecks_[i] << std::setw(14)
+        << snapshot.stateTime_[i] << std::setw(14) << snapshot.motionTime_[i];
+    if (normalizer)
+      out << (snapshot.stateChecks_[i] + snapshot.motionChecks_[i]) / double(normalizer);
+    out << std::endl;
+  }
+
+  out << std::left << "  " << std::setw(22) << "total" << std::setw(14) << snapshot.getStateChecks() << std::setw(14)
+      << snapshot.getMotionChecks() << std::setw(28) << "";
+  if (normalizer)
+    out << (snapshot.getStateChecks() + snapshot.getMotionChecks()) / double(normalizer);
+  out << std::endl;
+}
+
+base::DiscreteMotionValidator *CollisionCheckCounter::getDiscreteMotionValidator(const base::SpaceInformationPtr &si)
+{
+  base::MotionValidator *validator = si->getMotionValidatorNonConst().get();
+
+  CountingMotionValidator *counting = dynamic_cast<CountingMotionValidator *>(validator);
+  if (counting)
+    validator = counting->getWrappedValidator().get();
+
+  return dynamic_cast<base::DiscreteMotionValidator *>(validator);
+}
+
+// -------------------------------------------------------------------------------------------------
+// CountingValidityChecker
+// -------------------------------------------------------------------------------------------------
+
+CountingValidityChecker::CountingValidityChecker(const base::SpaceInformationPtr &si,
+                                                 const base::StateValidityCheckerPtr &checker,
+                                                 const CollisionCheckCounterPtr &counter)
+  : base::StateValidityChecker(si), checker_(checker), counter_(counter)
+{
+  specs_ = checker_->getSpecs();
+  setClearanceSearchDistance(checker_->getClearanceSearchDistance());
+}
+
+bool CountingValidityChecker::isValid(const base::State *state) const
+{
+  syncClearanceSearchDistance();
+
+  time::point startTime;
+  if (counter_->getTiming())
+    startTime = time::now();
+
+  bool valid = checker_->isValid(state);
+  counter_->recordStateCheck(counter_->getTiming() ? time::seconds(time::now() - startTime) : 0);
+  return valid;
+}
+
+bool CountingValidityChecker::isValid(const base::State *state, double &dist) const
+{
+  syncClearanceSearchDistance();
+
+  time::point startTime;
+  if (counter_->getTiming())
+    startTime = time::now();
+
+  bool valid = checker_->isValid(state, dist);
+  counter_->recordStateCheck(counter_->getTiming() ? time::seconds(time::now() - startTime) : 0);
+  return valid;
+}
+
+double CountingValidityChecker::clearance(const base::State *state) const
+{
+  syncClearanceSearchDistance();
+
+  time::point startTime;
+  if (counter_->getTiming())
+    startTime = time::now();
+
+  double dist = checker_->clearance(state);
+  counter_->recordStateCheck(counter_->getTiming() ? time::seconds(time::now() - startTime) : 0);
+  return dist;
+}
+
+void CountingValidityChecker::syncClearanceSearchDistance() const
+{
+  if (checker_->getClearanceSearchDistance() != getClearanceSearchDistance())
+    checker_->setClearanceSearchDistance(getClearanceSearchDistance());
+}
+
+// -------------------------------------------------------------------------------------------------
+// CountingMotionValidator
+// -------------------------------------------------------------------------------------------------
+
+CountingMotionValidator::CountingMotionValidator(const base::SpaceInformationPtr &si,
+                                                 const base::MotionValidatorPtr &validator,
+                                                 const CollisionCheckCounterPtr &counter)
+  : base::MotionValidator(si), validator_(validator), counter_(counter)
+{
+}
+
+bool CountingMotionValidator::checkMotion(const base::State *s1, const base::State *s2) const
+{
+  time::point startTime;
+  if (counter_->getTiming())
+    startTime = time::now();
+
+  bool valid = validator_->checkMotion(s1, s2);
+  counter_->recordMotionCheck(counter_->getTiming() ? time::seconds(time::now() - startTime) : 0);
+
+  if (valid)
+    valid_++;
+  else
+    invalid_++;
+  return valid;
+}
+
+bool CountingMotionValidator::checkMotion(const base::State *s1, const base::State *s2,
+                                          std::pair<base::State *, double> &lastValid) const
+{
+  time::point startTime;
+  if (counter_->getTiming())
+    startTime = time::now();
+
+  bool valid = validator_->checkMotion(s1, s2, lastValid);
+  counter_->recordMotionCheck(counter_->getTiming() ? time::seconds(time::now() - startTime) : 0);
+
+  if (valid)
+    valid_++;
+  else
+    invalid_++;
+  return valid;
+}
+
+}  // namespace bolt
+}  // namespace tools
+}  // namespace ompl
@@ -0,0 +1,249 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2016, University of Colorado, Boulder
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the Univ of CO, Boulder nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+/* Author: Dave Coleman <dave@dav.ee>
+   Desc:   Read-only roadmap in compressed sparse row layout
+*/
+
+// OMPL
+#include <ompl/tools/bolt/CompactGraph.h>
+
+// C++
+#include <functional>
+#include <queue>
+
+namespace ompl
+{
+namespace tools
+{
+namespace bolt
+{
+const CompactGraph::Index CompactGraph::NO_EDGE;
+
+void CompactGraph::clear()
+{
+  offsets_.clear();
+  targets_.clear();
+  edges_.clear();
+  weights_.clear();
+  collisionStates_.clear();
+  components_.clear();
+  costs_.clear();
+  predecessors_.clear();
+  visits_.clear();
+  searchID_ = 0;
+}
+
+void CompactGraph::fill(const std::vector<std::pair<Index, Index> > &endpoints)
+{
+  targets_.resize(offsets_.back());
+  edges_.resize(offsets_.back());
+
+  std::vector<Index> next(offsets_.begin(), offsets_.end() - 1);
+  for (Index e = 0; e < endpoints.size(); ++e)
+  {
+    const Index v1 = endpoints[e].first;
+    const Index v2 = endpoints[e].second;
+    targets_[next[v1]] = v2;
+    edges_[next[v1]++] = e;
+    targets_[next[v2]] = v1;
+    edges_[next[v2]++] = e;
+  }
+
+  // Sort each row by neighbor so that findEdge() can binary search
+  std::vector<std::pair<Index, Index> > row;
+  for (std::size_t v = 0; v + 1 < offsets_.size(); ++v)
+  {
+    row.clear();
+    for (Index i = offsets_[v]; i < offsets_[v + 1]; ++i)
+      row.push_back(std::make_pair(targets_[i], edges_[i]));
+    std::sort(row.begin(), row.end());
+    for (std::size_t i = 0; i < row.size(); ++i)
+    {
+      targets_[offsets_[v] + i] = row[i].first;
+      edges_[offsets_[v] + i] = row[i].second;
+    }
+  }
+}
+
+void CompactGraph::labelComponents()
+{
+  const Index UNLABELED = NO_EDGE;
+  components_.assign(getNumVertices(), UNLABELED);
+
+  Index numComponents = 0;
+  std::vector<Index> stack;
+  for (Index start = 0; start < components_.size(); ++start)
+  {
+    if (components_[start] != UNLABELED)
+      continue;
+
+    components_[start] = numComponents;
+    stack.push_back(start);
+    while (!stack.empty())
+    {
+      const Index v = stack.back();
+      stack.pop_back();
+      for (Index i = offsets_[v]; i < offsets_[v + 1]; ++i)
+      {
+        if (components_[targets_[i]] != UNLABELED)
+          continue;
+        components_[targets_[i]] = numComponents;
+        stack.push_back(targets_[i]);
+      }
+    }
+    numComponents++;
+  }
+}
+
+CompactGraph::Index CompactGraph::findEdge(Index v1, Index v2) const
+{
+  const std::vector<Index>::const_iterator begin = targets_.begin() + offsets_[v1];
+  const std::vector<Index>::const_iterator end = targets_.begin() + offsets_[v1 + 1];
+  const std::vector<Index>::const_iterator found = std::lower_bound(begin, end, v2);
+  if (found == end || *found != v2)
+    return NO_EDGE;
+  return edges_[found - targets_.begin()];
+}
+
+void CompactGraph::clearCollisionStates()
+{
+  std::fill(collisionStates_.begin(), collisionStates_.end(), NOT_CHECKED);
+}
+
+bool CompactGraph::astarSearch(Index start, Index goal, const HeuristicFunction &heuristic,
+                               std::vector<Index> &vertexPath, double &distance, std::size_t &nodesOpened,
+                               std::size_t &nodesClosed)
+{
+  nodesOpened = 0;
+  nodesClosed = 0;
+
+  // Tag the vertices of this search instead of clearing the arrays of the previous one
+  if (visits_.size() != getNumVertices() || searchID_ >= std::numeric_limits<std::uint32_t>::max() - 2)
+  {
+    costs_.resize(getNumVertices());
+    predecessors_.resize(getNumVertices());
+    visits_.assign(getNumVertices(), 0);
+    searchID_ = 0;
+  }
+  searchID_ += 2;
+  const std::uint32_t REACHED = searchID_;
+  const std::uint32_t CLOSED = searchID_ + 1;
+
+  // Estimated total cost and vertex. Entries made stale by a cheaper path are skipped when popped
+  typedef std::pair<double, Index> QueueEntry;
+  std::priority_queue<QueueEntry, std::vector<QueueEntry>, std::greater<QueueEntry> > open;
+
+  costs_[start] = 0;
+  predecessors_[start] = start;
+  visits_[start] = REACHED;
+  nodesOpened++;
+  open.push(std::make_pair(heuristic(start), start));
+
+  while (!open.empty())
+  {
+    const Index v = open.top().second;
+    open.pop();
+    if (visits_[v] == CLOSED)  // a cheaper entry for the vertex was popped before
+      continue;
+
+    visits_[v] = CLOSED;
+    nodesClosed++;
+    if (v == goal)
+      break;
+
+    for (Index i = offsets_[v]; i < offsets_[v + 1]; ++i)
+    {
+      const Index e = edges_[i];
+      if (collisionStates_[e] == IN_COLLISION)
+        continue;
+
+      const Index u = targets_[i];
+      const double cost = costs_[v] + weights_[e];
+      if (visits_[u] == REACHED || visits_[u] == CLOSED)
+      {
+        // Closed vertices are reopened, as boost::astar_search does, in case the heuristic is inconsistent
+        if (cost >= costs_[u])
+          continue;
+      }
+      else
+        nodesOpened++;
+
+      visits_[u] = REACHED;
+      costs_[u] = cost;
+      predecessors_[u] = v;
+      open.push(std::make_pair(cost + heuristic(u), u));
+    }
+  }
+
+  if (visits_[goal] != CLOSED)
+    return false;
+
+  // Trace back the shortest path in reverse, without the start if the path is just one vertex long
+  vertexPath.clear();
+  Index v;
+  for (v = goal; v != predecessors_[v]; v = predecessors_[v])
+    vertexPath.push_back(v);
+  if (v != goal)
+    vertexPath.push_back(v);
+
+  distance = costs_[goal];
+  return true;
+}
+
+bool CompactGraph::isPathFree(const std::vector<Index> &vertexPath) const
+{
+  for (std::size_t i = 1; i < vertexPath.size(); ++i)
+  {
+    const Index e = findEdge(vertexPath[i - 1], vertexPath[i]);
+    if (e == NO_EDGE || collisionStates_[e] == IN_COLLISION)
+      return false;
+  }
+  return true;
+}
+
+void CompactGraph::addToMemoryReport(MemoryReport &report) const
+{
+  report.add(MEMORY_ADJACENCY, (offsets_.capacity() + targets_.capacity() + edges_.capacity()) * sizeof(Index));
+  report.add(MEMORY_EDGE_PROPERTIES, weights_.capacity() * sizeof(double) + collisionStates_.capacity());
+  report.add(MEMORY_DISJOINT_SETS, components_.capacity() * sizeof(Index));
+
+  // Scratch space of the search
+  report.add(MEMORY_ADJACENCY, costs_.capacity() * sizeof(double) +
+                                   (predecessors_.capacity() + visits_.capacity()) * sizeof(Index));
+}
+
+}  // namespace bolt
+}  // namespace tools
+}  // namespace ompl
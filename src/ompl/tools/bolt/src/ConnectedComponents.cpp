@@ -0,0 +1,279 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2016, University of Colorado, Boulder
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the Univ of CO, Boulder nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+/* Author: Dave Coleman <dave@dav.ee>
+   Desc:   Connected components of the sparse graph that stay exact when edges and vertices are removed
+*/
+
+// OMPL
+#include <ompl/tools/bolt/ConnectedComponents.h>
+
+// Boost
+#include <boost/unordered_map.hpp>
+
+// C++
+#include <deque>
+#include <utility>
+
+namespace ompl
+{
+namespace tools
+{
+namespace bolt
+{
+const std::size_t ConnectedComponents::NO_COMPONENT;
+
+ConnectedComponents::ConnectedComponents(const SparseAdjList &graph) : graph_(graph)
+{
+}
+
+void ConnectedComponents::clear()
+{
+  component_.clear();
+  sizes_.clear();
+  freeLabels_.clear();
+  numRelabeled_ = 0;
+}
+
+void ConnectedComponents::rebuild()
+{
+  clear();
+  component_.assign(boost::num_vertices(graph_), NO_COMPONENT);
+  for (std::size_t v = 0; v < component_.size(); ++v)
+    if (component_[v] == NO_COMPONENT)
+      relabel(v, NO_COMPONENT, newLabel(0));
+  numRelabeled_ = 0;
+}
+
+void ConnectedComponents::addVertex(SparseVertex v)
+{
+  if (v >= component_.size())
+    component_.resize(v + 1, NO_COMPONENT);
+  component_[v] = newLabel(1);
+}
+
+void ConnectedComponents::addEdge(SparseVertex v1, SparseVertex v2)
+{
+  const std::size_t label1 = component_[v1];
+  const std::size_t label2 = component_[v2];
+  if (label1 == label2 || label1 == NO_COMPONENT || label2 == NO_COMPONENT)
+    return;
+
+  // Relabel the smaller component, through the new edge it is now reachable from the larger one
+  if (sizes_[label1] < sizes_[label2])
+  {
+    relabel(v1, label1, label2);
+    freeLabel(label1);
+  }
+  else
+  {
+    relabel(v2, label2, label1);
+    freeLabel(label2);
+  }
+}
+
+void ConnectedComponents::removeEdges(const std::vector<SparseVertex> &endpoints)
+{
+  // Endpoints of the same edge were in the same component before it was removed
+  boost::unordered_map<std::size_t, std::vector<SparseVertex> > byLabel;
+  for (std::size_t i = 0; i < endpoints.size(); ++i)
+    if (component_[endpoints[i]] != NO_COMPONENT)
+      byLabel[component_[endpoints[i]]].push_back(endpoints[i]);
+
+  for (boost::unordered_map<std::size_t, std::vector<SparseVertex> >::const_iterator it = byLabel.begin();
+       it != byLabel.end(); ++it)
+    if (it->second.size() > 1)
+      split(it->first, it->second);
+}
+
+void ConnectedComponents::removeVertex(SparseVertex v)
+{
+  const std::size_t label = component_[v];
+  if (label == NO_COMPONENT)
+    return;
+
+  component_[v] = NO_COMPONENT;
+  if (--sizes_[label] == 0)
+    freeLabel(label);
+}
+
+std::size_t ConnectedComponents::getMemoryBytes() const
+{
+  return sizeof(*this) + (component_.capacity() + sizes_.capacity() + freeLabels_.capacity()) * sizeof(std::size_t);
+}
+
+std::size_t ConnectedComponents::newLabel(std::size_t size)
+{
+  if (freeLabels_.empty())
+  {
+    sizes_.push_back(size);
+    return sizes_.size() - 1;
+  }
+
+  const std::size_t label = freeLabels_.back();
+  freeLabels_.pop_back();
+  sizes_[label] = size;
+  return label;
+}
+
+void ConnectedComponents::freeLabel(std::size_t label)
+{
+  sizes_[label] = 0;
+  freeLabels_.push_back(label);
+}
+
+void ConnectedComponents::relabel(SparseVertex start, std::size_t from, std::size_t to)
+{
+  std::vector<SparseVertex> stack(1, start);
+  component_[start] = to;
+  while (!stack.empty())
+  {
+    const SparseVertex v = stack.back();
+    stack.pop_back();
+    sizes_[to]++;
+    numRelabeled_++;
+
+    SparseAdjList::adjacency_iterator neighbor, end;
+    for (boost::tie(neighbor, end) = boost::adjacent_vertices(v, graph_); neighbor != end; ++neighbor)
+    {
+      if (component_[*neighbor] != from)
+        continue;
+      component_[*neighbor] = to;
+      stack.push_back(*neighbor);
+    }
+  }
+}
+
+void ConnectedComponents::split(std::size_t label, const std::vector<SparseVertex> &endpoints)
+{
+  // One search per endpoint. Searches that meet are merged into the one with the larger frontier
+  struct Search
+  {
+    std::deque<SparseVertex> frontier_;
+    std::vector<SparseVertex> visited_;
+    std::size_t mergedInto_;
+    bool active_;
+  };
+  std::vector<Search> searches;
+  boost::unordered_map<SparseVertex, std::size_t> owner;  // search that reached each vertex first
+
+  for (std::size_t i = 0; i < endpoints.size(); ++i)
+  {
+    if (owner.count(endpoints[i]))
+      continue;
+    owner[endpoints[i]] = searches.size();
+    searches.push_back(Search());
+    searches.back().frontier_.push_back(endpoints[i]);
+    searches.back().visited_.push_back(endpoints[i]);
+    searches.back().mergedInto_ = searches.size() - 1;
+    searches.back().active_ = true;
+  }
+
+  std::size_t numActive = searches.size();
+  while (numActive > 1)
+  {
+    for (std::size_t i = 0; i < searches.size() && numActive > 1; ++i)
+    {
+      if (!searches[i].active_)
+        continue;
+
+      // Expand one vertex
+      const SparseVertex v = searches[i].frontier_.front();
+      searches[i].frontier_.pop_front();
+
+      SparseAdjList::adjacency_iterator neighbor, end;
+      for (boost::tie(neighbor, end) = boost::adjacent_vertices(v, graph_); neighbor != end; ++neighbor)
+      {
+        // Search i may have been merged into another one while expanding v
+        std::size_t current = i;
+        while (searches[current].mergedInto_ != current)
+          current = searches[current].mergedInto_;
+
+        boost::unordered_map<SparseVertex, std::size_t>::iterator found = owner.find(*neighbor);
+        if (found == owner.end())
+        {
+          owner[*neighbor] = current;
+          searches[current].frontier_.push_back(*neighbor);
+          searches[current].visited_.push_back(*neighbor);
+          continue;
+        }
+
+        // Follow merges to the search that now owns the vertex
+        std::size_t other = found->second;
+        while (searches[other].mergedInto_ != other)
+          other = searches[other].mergedInto_;
+        found->second = other;
+        if (other == current)
+          continue;
+
+        // Still connected, continue as one search
+        std::size_t into = current;
+        if (searches[other].frontier_.size() > searches[current].frontier_.size())
+          std::swap(into, other);
+        Search &from = searches[other];
+        searches[into].frontier_.insert(searches[into].frontier_.end(), from.frontier_.begin(), from.frontier_.end());
+        searches[into].visited_.insert(searches[into].visited_.end(), from.visited_.begin(), from.visited_.end());
+        std::deque<SparseVertex>().swap(from.frontier_);
+        std::vector<SparseVertex>().swap(from.visited_);
+        from.mergedInto_ = into;
+        from.active_ = false;
+        numActive--;
+      }
+
+      // Nothing left to expand, this search holds a complete component
+      std::size_t current = i;
+      while (searches[current].mergedInto_ != current)
+        current = searches[current].mergedInto_;
+      Search &search = searches[current];
+      if (search.frontier_.empty() && search.active_)
+      {
+        const std::size_t newComponent = newLabel(search.visited_.size());
+        for (std::size_t j = 0; j < search.visited_.size(); ++j)
+          component_[search.visited_[j]] = newComponent;
+        sizes_[label] -= search.visited_.size();
+        numRelabeled_ += search.visited_.size();
+        search.active_ = false;
+        numActive--;
+      }
+    }
+  }
+
+  // The last search keeps the old label, unless every part was relabeled
+  if (sizes_[label] == 0)
+    freeLabel(label);
+}
+
+}  // namespace bolt
+}  // namespace tools
+}  // namespace ompl
@@ -0,0 +1,445 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2016, University of Colorado, Boulder
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the Univ of CO, Boulder nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+/* Author: Dave Coleman <dave@dav.ee>
+   Desc:   Contraction hierarchy over a frozen roadmap for fast exact shortest path queries
+*/
+
+// OMPL
+#include <ompl/tools/bolt/ContractionHierarchy.h>
+
+// C++
+#include <algorithm>
+#include <functional>
+#include <queue>
+#include <utility>
+
+namespace ompl
+{
+namespace tools
+{
+namespace bolt
+{
+namespace
+{
+typedef ContractionHierarchy::Index Index;
+typedef std::pair<double, Index> QueueEntry;
+typedef std::priority_queue<QueueEntry, std::vector<QueueEntry>, std::greater<QueueEntry> > MinQueue;
+
+/** \brief Edge or shortcut between a vertex and a neighbor that has not been contracted yet */
+struct Arc
+{
+  Index target;
+  double weight;
+  Index middle;
+};
+
+bool arcTargetLess(const Arc &a, const Arc &b)
+{
+  return a.target < b.target;
+}
+
+/** \brief Add an arc to \e target, or lower the one that exists. Parallel edges collapse into the cheapest */
+void relaxArc(std::vector<Arc> &arcs, Index target, double weight, Index middle)
+{
+  for (std::size_t i = 0; i < arcs.size(); ++i)
+  {
+    if (arcs[i].target != target)
+      continue;
+    if (weight < arcs[i].weight)
+    {
+      arcs[i].weight = weight;
+      arcs[i].middle = middle;
+    }
+    return;
+  }
+  Arc arc = {target, weight, middle};
+  arcs.push_back(arc);
+}
+
+void removeArc(std::vector<Arc> &arcs, Index target)
+{
+  for (std::size_t i = 0; i < arcs.size(); ++i)
+  {
+    if (arcs[i].target == target)
+    {
+      arcs[i] = arcs.back();
+      arcs.pop_back();
+      return;
+    }
+  }
+}
+
+/** \brief Graph that remains during preprocessing, with the witness searches that decide on shortcuts */
+class Contraction
+{
+public:
+  Contraction(const CompactGraph &graph, std::size_t witnessLimit)
+    : arcs_(graph.getNumVertices())
+    , witnessLimit_(witnessLimit)
+    , costs_(graph.getNumVertices())
+    , visits_(graph.getNumVertices(), 0)
+  {
+    for (Index v = 0; v < arcs_.size(); ++v)
+      for (Index i = graph.beginNeighbors(v); i < graph.endNeighbors(v); ++i)
+        if (graph.getNeighbor(i) != v)
+          relaxArc(arcs_[v], graph.getNeighbor(i), graph.getWeight(graph.getNeighborEdge(i)),
+                   ContractionHierarchy::NO_VERTEX);
+  }
+
+  /** \brief Number of shortcuts that contracting \e v would add, adding them unless \e simulate */
+  std::size_t contract(Index v, bool simulate)
+  {
+    const std::vector<Arc> &arcs = arcs_[v];
+    double maxWeight = 0;
+    for (std::size_t i = 0; i < arcs.size(); ++i)
+      maxWeight = std::max(maxWeight, arcs[i].weight);
+
+    // Shortcuts only change the arcs of the neighbors, so the arcs of v stay in place
+    std::size_t numShortcuts = 0;
+    for (std::size_t i = 0; i + 1 < arcs.size(); ++i)
+    {
+      witnessSearch(arcs[i].target, v, arcs[i].weight + maxWeight);
+      for (std::size_t j = i + 1; j < arcs.size(); ++j)
+      {
+        const Index u = arcs[i].target;
+        const Index x = arcs[j].target;
+        const double viaV = arcs[i].weight + arcs[j].weight;
+        if (visits_[x] >= searchID_ && costs_[x] <= viaV)
+          continue;  // witness path that avoids v
+
+        numShortcuts++;
+        if (!simulate)
+        {
+          relaxArc(arcs_[u], x, viaV, v);
+          relaxArc(arcs_[x], u, viaV, v);
+        }
+      }
+    }
+    return numShortcuts;
+  }
+
+  /** \brief Remove \e v from the remaining graph and return the arcs it had, which all lead to higher ranks */
+  void remove(Index v, std::vector<Arc> &upward)
+  {
+    upward.swap(arcs_[v]);
+    std::vector<Arc>().swap(arcs_[v]);
+    for (std::size_t i = 0; i < upward.size(); ++i)
+      removeArc(arcs_[upward[i].target], v);
+  }
+
+  std::size_t getDegree(Index v) const
+  {
+    return arcs_[v].size();
+  }
+
+private:
+  /** \brief Bounded Dijkstra from \e source that does not pass through \e excluded. Every vertex it reaches has a
+   *         visit of at least searchID_ and the cost of some path that avoids \e excluded */
+  void witnessSearch(Index source, Index excluded, double maxCost)
+  {
+    if (searchID_ >= std::numeric_limits<std::uint32_t>::max() - 2)
+    {
+      visits_.assign(visits_.size(), 0);
+      searchID_ = 0;
+    }
+    searchID_ += 2;
+    const std::uint32_t REACHED = searchID_;
+    const std::uint32_t SETTLED = searchID_ + 1;
+
+    MinQueue open;
+    costs_[source] = 0;
+    visits_[source] = REACHED;
+    open.push(std::make_pair(0.0, source));
+
+    std::size_t numSettled = 0;
+    while (!open.empty() && numSettled < witnessLimit_)
+    {
+      const QueueEntry entry = open.top();
+      open.pop();
+      const Index v = entry.second;
+      if (visits_[v] == SETTLED)
+        continue;
+      if (entry.first > maxCost)
+        break;
+
+      visits_[v] = SETTLED;
+      numSettled++;
+      for (std::size_t i = 0; i < arcs_[v].size(); ++i)
+      {
+        const Index u = arcs_[v][i].target;
+        const double cost = costs_[v] + arcs_[v][i].weight;
+        if (u == excluded || visits_[u] == SETTLED || (visits_[u] == REACHED && cost >= costs_[u]))
+          continue;
+        visits_[u] = REACHED;
+        costs_[u] = cost;
+        open.push(std::make_pair(cost, u));
+      }
+    }
+  }
+
+  std::vector<std::vector<Arc> > arcs_;
+  std::size_t witnessLimit_;
+
+  std::vector<double> costs_;
+  std::vector<std::uint32_t> visits_;
+  std::uint32_t searchID_ = 0;
+};
+}  // namespace
+
+const ContractionHierarchy::Index ContractionHierarchy::NO_VERTEX;
+
+void ContractionHierarchy::clear()
+{
+  rank_.clear();
+  offsets_.clear();
+  targets_.clear();
+  weights_.clear();
+  middles_.clear();
+  numShortcuts_ = 0;
+  for (std::size_t i = 0; i < 2; ++i)
+  {
+    costs_[i].clear();
+    predecessors_[i].clear();
+    visits_[i].clear();
+  }
+  searchID_ = 0;
+}
+
+void ContractionHierarchy::build(const CompactGraph &graph, std::size_t witnessLimit)
+{
+  clear();
+  const Index numVertices = graph.getNumVertices();
+  Contraction contraction(graph, witnessLimit);
+
+  // Contract the vertex that adds the fewest shortcuts for the arcs it removes first, and spread contractions out
+  // by counting the neighbors already contracted. Priorities only grow stale, so they are recomputed when popped
+  std::vector<Index> contractedNeighbors(numVertices, 0);
+  typedef std::pair<long, Index> PriorityEntry;
+  std::priority_queue<PriorityEntry, std::vector<PriorityEntry>, std::greater<PriorityEntry> > queue;
+  for (Index v = 0; v < numVertices; ++v)
+    queue.push(std::make_pair(static_cast<long>(contraction.contract(v, true)) -
+                                  static_cast<long>(contraction.getDegree(v)),
+                              v));
+
+  rank_.assign(numVertices, NO_VERTEX);
+  std::vector<std::vector<Arc> > upward(numVertices);
+  Index nextRank = 0;
+  while (!queue.empty())
+  {
+    const Index v = queue.top().second;
+    queue.pop();
+    if (rank_[v] != NO_VERTEX)
+      continue;
+
+    const long priority = static_cast<long>(contraction.contract(v, true)) -
+                          static_cast<long>(contraction.getDegree(v)) + contractedNeighbors[v];
+    if (!queue.empty() && priority > queue.top().first)
+    {
+      queue.push(std::make_pair(priority, v));
+      continue;
+    }
+
+    contraction.contract(v, false);
+    contraction.remove(v, upward[v]);
+    rank_[v] = nextRank++;
+    for (std::size_t i = 0; i < upward[v].size(); ++i)
+      contractedNeighbors[upward[v][i].target]++;
+  }
+
+  // Compressed sparse row layout of the upward arcs
+  offsets_.assign(numVertices + 1, 0);
+  for (Index v = 0; v < numVertices; ++v)
+    offsets_[v + 1] = offsets_[v] + upward[v].size();
+  targets_.reserve(offsets_.back());
+  weights_.reserve(offsets_.back());
+  middles_.reserve(offsets_.back());
+  for (Index v = 0; v < numVertices; ++v)
+  {
+    std::sort(upward[v].begin(), upward[v].end(), arcTargetLess);
+    for (std::size_t i = 0; i < upward[v].size(); ++i)
+    {
+      targets_.push_back(upward[v][i].target);
+      weights_.push_back(upward[v][i].weight);
+      middles_.push_back(upward[v][i].middle);
+      if (upward[v][i].middle != NO_VERTEX)
+        numShortcuts_++;
+    }
+    std::vector<Arc>().swap(upward[v]);
+  }
+}
+
+bool ContractionHierarchy::search(Index start, Index goal, std::vector<Index> &vertexPath, double &distance,
+                                  std::size_t &nodesSettled)
+{
+  nodesSettled = 0;
+  const std::size_t numVertices = rank_.size();
+  if (visits_[0].size() != numVertices || searchID_ >= std::numeric_limits<std::uint32_t>::max() - 2)
+  {
+    for (std::size_t i = 0; i < 2; ++i)
+    {
+      costs_[i].resize(numVertices);
+      predecessors_[i].resize(numVertices);
+      visits_[i].assign(numVertices, 0);
+    }
+    searchID_ = 0;
+  }
+  searchID_ += 2;
+  const std::uint32_t REACHED = searchID_;
+  const std::uint32_t SETTLED = searchID_ + 1;
+
+  // Forward search from the start and backward search from the goal, both only going up in rank
+  MinQueue open[2];
+  const Index roots[2] = {start, goal};
+  for (std::size_t d = 0; d < 2; ++d)
+  {
+    costs_[d][roots[d]] = 0;
+    predecessors_[d][roots[d]] = roots[d];
+    visits_[d][roots[d]] = REACHED;
+    open[d].push(std::make_pair(0.0, roots[d]));
+  }
+
+  double best = std::numeric_limits<double>::infinity();
+  Index meeting = NO_VERTEX;
+  while (true)
+  {
+    // Advance the direction with the cheaper frontier, until neither can improve on the best meeting
+    std::size_t d = 2;
+    for (std::size_t i = 0; i < 2; ++i)
+      if (!open[i].empty() && open[i].top().first < best && (d == 2 || open[i].top().first < open[d].top().first))
+        d = i;
+    if (d == 2)
+      break;
+
+    const Index v = open[d].top().second;
+    open[d].pop();
+    if (visits_[d][v] == SETTLED)
+      continue;
+    visits_[d][v] = SETTLED;
+    nodesSettled++;
+
+    const std::size_t other = 1 - d;
+    if (visits_[other][v] == REACHED || visits_[other][v] == SETTLED)
+    {
+      const double cost = costs_[d][v] + costs_[other][v];
+      if (cost < best)
+      {
+        best = cost;
+        meeting = v;
+      }
+    }
+
+    for (Index i = offsets_[v]; i < offsets_[v + 1]; ++i)
+    {
+      const Index u = targets_[i];
+      const double cost = costs_[d][v] + weights_[i];
+      if (visits_[d][u] == SETTLED || (visits_[d][u] == REACHED && cost >= costs_[d][u]))
+        continue;
+      visits_[d][u] = REACHED;
+      costs_[d][u] = cost;
+      predecessors_[d][u] = v;
+      open[d].push(std::make_pair(cost, u));
+    }
+  }
+
+  if (meeting == NO_VERTEX)
+    return false;
+
+  // Hierarchy path from the start up to the meeting vertex and down to the goal
+  std::vector<Index> hierarchyPath;
+  for (Index v = meeting; v != start; v = predecessors_[0][v])
+    hierarchyPath.push_back(v);
+  hierarchyPath.push_back(start);
+  std::reverse(hierarchyPath.begin(), hierarchyPath.end());
+  for (Index v = meeting; v != goal; v = predecessors_[1][v])
+    hierarchyPath.push_back(predecessors_[1][v]);
+
+  // Expand the shortcuts, then reverse to match CompactGraph::astarSearch(), which also leaves the path empty when
+  // the start is the goal
+  vertexPath.clear();
+  if (start != goal)
+  {
+    vertexPath.push_back(start);
+    for (std::size_t i = 0; i + 1 < hierarchyPath.size(); ++i)
+      unpack(hierarchyPath[i], hierarchyPath[i + 1], vertexPath);
+    std::reverse(vertexPath.begin(), vertexPath.end());
+  }
+
+  distance = best;
+  return true;
+}
+
+ContractionHierarchy::Index ContractionHierarchy::findArc(Index v1, Index v2) const
+{
+  if (rank_[v1] > rank_[v2])
+    std::swap(v1, v2);
+  const std::vector<Index>::const_iterator begin = targets_.begin() + offsets_[v1];
+  const std::vector<Index>::const_iterator end = targets_.begin() + offsets_[v1 + 1];
+  return std::lower_bound(begin, end, v2) - targets_.begin();
+}
+
+void ContractionHierarchy::unpack(Index from, Index to, std::vector<Index> &path) const
+{
+  // Arcs still to expand, the next one on top
+  std::vector<std::pair<Index, Index> > stack(1, std::make_pair(from, to));
+  while (!stack.empty())
+  {
+    const std::pair<Index, Index> arc = stack.back();
+    stack.pop_back();
+    const Index middle = middles_[findArc(arc.first, arc.second)];
+    if (middle == NO_VERTEX)
+    {
+      path.push_back(arc.second);
+      continue;
+    }
+    stack.push_back(std::make_pair(middle, arc.second));
+    stack.push_back(std::make_pair(arc.first, middle));
+  }
+}
+
+void ContractionHierarchy::addToMemoryReport(MemoryReport &report) const
+{
+  report.add(MEMORY_HIERARCHY, (rank_.capacity() + offsets_.capacity() + targets_.capacity() +
+                                middles_.capacity()) * sizeof(Index) +
+                                   weights_.capacity() * sizeof(double));
+
+  // Scratch space of the search
+  for (std::size_t i = 0; i < 2; ++i)
+    report.add(MEMORY_HIERARCHY, costs_[i].capacity() * sizeof(double) +
+                                     (predecessors_[i].capacity() + visits_[i].capacity()) * sizeof(Index));
+}
+
+}  // namespace bolt
+}  // namespace tools
+}  // namespace ompl
@@ -0,0 +1,172 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2016, University of Colorado, Boulder
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the Univ of CO, Boulder nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+/* Author: Dave Coleman <dave@dav.ee>
+   Desc:   Coarse grid over a projection that steers sampling toward regions still producing roadmap vertices
+*/
+
+// OMPL
+#include <ompl/tools/bolt/CoverageGrid.h>
+#include <ompl/tools/bolt/SeededRandom.h>
+
+// C++
+#include <algorithm>
+#include <cmath>
+
+namespace ompl
+{
+namespace tools
+{
+namespace bolt
+{
+CoverageGrid::CoverageGrid(const base::SpaceInformationPtr &si, const base::ProjectionEvaluatorPtr &projection)
+  : si_(si), projection_(projection), recordProjection_(projection->getDimension()), numSkipped_(0)
+{
+}
+
+void CoverageGrid::clear()
+{
+  boost::unique_lock<boost::shared_mutex> lock(cellsMutex_);
+  cells_.clear();
+  epoch_ = 0;
+  numSinceDecay_ = 0;
+  numSkipped_ = 0;
+}
+
+void CoverageGrid::computeCell(const base::State *state, base::EuclideanProjection &projection,
+                               base::ProjectionCoordinates &cell) const
+{
+  projection_->project(state, projection);
+  projection_->computeCoordinates(projection, cell);
+}
+
+double CoverageGrid::getWeight(const base::ProjectionCoordinates &cell) const
+{
+  boost::shared_lock<boost::shared_mutex> lock(cellsMutex_);
+  boost::unordered_map<base::ProjectionCoordinates, Cell, boost::hash<base::ProjectionCoordinates> >::const_iterator
+      it = cells_.find(cell);
+  if (it == cells_.end())
+    return 1.0;
+
+  // Decay without writing, readers share the lock
+  const double factor = std::pow(decay_, double(epoch_ - it->second.epoch_));
+  const double fraction = (it->second.added_ * factor + 1.0) / (it->second.candidates_ * factor + 1.0);
+  return std::max(minWeight_, std::min(1.0, fraction));
+}
+
+void CoverageGrid::recordCandidate(const base::State *state, bool added)
+{
+  computeCell(state, recordProjection_, recordCell_);
+
+  boost::unique_lock<boost::shared_mutex> lock(cellsMutex_);
+  Cell &cell = cells_[recordCell_];
+  decayCell(cell);
+  cell.candidates_ += 1.0;
+  if (added)
+    cell.added_ += 1.0;
+
+  if (decayInterval_ && ++numSinceDecay_ >= decayInterval_)
+  {
+    epoch_++;
+    numSinceDecay_ = 0;
+  }
+}
+
+std::size_t CoverageGrid::getNumCells() const
+{
+  boost::shared_lock<boost::shared_mutex> lock(cellsMutex_);
+  return cells_.size();
+}
+
+void CoverageGrid::decayCell(Cell &cell) const
+{
+  if (cell.epoch_ == epoch_)
+    return;
+
+  const double factor = std::pow(decay_, double(epoch_ - cell.epoch_));
+  cell.candidates_ *= factor;
+  cell.added_ *= factor;
+  cell.epoch_ = epoch_;
+}
+
+CoverageSampler::CoverageSampler(const base::SpaceInformation *si, const CoverageGridPtr &grid,
+                                 const base::StateSamplerPtr &stateSampler)
+  : base::MinimumClearanceValidStateSampler(si), grid_(grid), projection_(grid->getProjection()->getDimension())
+{
+  name_ = "coverage_clearance";
+  if (stateSampler)
+    sampler_ = stateSampler;
+}
+
+bool CoverageSampler::sample(base::State *state)
+{
+  unsigned int attempts = 0;
+  double dist = 0.0;
+  while (attempts < attempts_)
+  {
+    sampler_->sampleUniform(state);
+
+    // Most draws in covered regions would be rejected by the criteria anyway, so skip them before the expensive check
+    grid_->computeCell(state, projection_, cell_);
+    if (rng_.uniform01() >= grid_->getWeight(cell_))
+    {
+      grid_->recordSkipped();
+      continue;
+    }
+
+    ++attempts;
+    if (si_->getStateValidityChecker()->isValid(state, dist) && dist >= clearance_)
+      return true;
+  }
+  return false;
+}
+
+base::MinimumClearanceValidStateSamplerPtr allocClearanceSampler(const base::SpaceInformation *si, double clearance,
+                                                                 const CoverageGridPtr &grid,
+                                                                 const base::StateSamplerPtr &stateSampler)
+{
+  base::MinimumClearanceValidStateSamplerPtr sampler;
+  if (grid)
+    sampler.reset(new CoverageSampler(si, grid, stateSampler));
+  else if (stateSampler)
+    sampler.reset(new SeededClearanceSampler(si, stateSampler));
+  else
+    sampler.reset(new base::MinimumClearanceValidStateSampler(si));
+  sampler->setMinimumObstacleClearance(clearance);
+  return sampler;
+}
+
+}  // namespace bolt
+}  // namespace tools
+}  // namespace ompl
@@ -0,0 +1,412 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2016, University of Colorado, Boulder
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the Univ of CO, Boulder nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+/* Author: Dave Coleman <dave@dav.ee>
+   Desc:   Euclidean distance kernels for RealVector state spaces, selected for the CPU at runtime
+*/
+
+// OMPL
+#include <ompl/tools/bolt/DistanceKernels.h>
+#include <ompl/base/spaces/RealVectorStateSpace.h>
+
+// C++
+#include <typeinfo>
+
+// The SIMD kernels are compiled with function level target attributes, so the rest of the library keeps the
+// default instruction set and the choice between them is made at runtime
+#if defined(__x86_64__) && (defined(__clang__) || (defined(__GNUC__) && __GNUC__ >= 5))
+#define BOLT_DISTANCE_AVX2
+#endif
+#if defined(__x86_64__) && (defined(__clang__) || (defined(__GNUC__) && __GNUC__ >= 7))
+#define BOLT_DISTANCE_AVX512
+#endif
+
+#if defined(BOLT_DISTANCE_AVX2) || defined(BOLT_DISTANCE_AVX512)
+#include <immintrin.h>
+#endif
+
+namespace ompl
+{
+namespace tools
+{
+namespace bolt
+{
+namespace
+{
+// -------------------------------------------------------------------------------------------------------------------
+// Generic
+// -------------------------------------------------------------------------------------------------------------------
+
+double distanceSquaredGeneric(const double *a, const double *b, std::size_t dimension)
+{
+  double sum = 0;
+  for (std::size_t i = 0; i < dimension; ++i)
+  {
+    const double diff = a[i] - b[i];
+    sum += diff * diff;
+  }
+  return sum;
+}
+
+void distanceSquaredBatchGeneric(const double *query, const double *points, std::size_t count, std::size_t dimension,
+                                 double *distances)
+{
+  for (std::size_t i = 0; i < count; ++i, points += dimension)
+    distances[i] = distanceSquaredGeneric(query, points, dimension);
+}
+
+float distanceSquaredFloatGeneric(const float *a, const float *b, std::size_t dimension)
+{
+  float sum = 0;
+  for (std::size_t i = 0; i < dimension; ++i)
+  {
+    const float diff = a[i] - b[i];
+    sum += diff * diff;
+  }
+  return sum;
+}
+
+void distanceSquaredBatchFloatGeneric(const float *query, const float *points, std::size_t count,
+                                      std::size_t dimension, double *distances)
+{
+  for (std::size_t i = 0; i < count; ++i, points += dimension)
+    distances[i] = distanceSquaredFloatGeneric(query, points, dimension);
+}
+
+// -------------------------------------------------------------------------------------------------------------------
+// AVX2
+// -------------------------------------------------------------------------------------------------------------------
+
+#ifdef BOLT_DISTANCE_AVX2
+__attribute__((target("avx2,fma"))) double distanceSquaredAVX2(const double *a, const double *b,
+                                                                std::size_t dimension)
+{
+  __m256d sum = _mm256_setzero_pd();
+  std::size_t i = 0;
+  for (; i + 4 <= dimension; i += 4)
+  {
+    const __m256d diff = _mm256_sub_pd(_mm256_loadu_pd(a + i), _mm256_loadu_pd(b + i));
+    sum = _mm256_fmadd_pd(diff, diff, sum);
+  }
+  __m128d pair = _mm_add_pd(_mm256_castpd256_pd128(sum), _mm256_extractf128_pd(sum, 1));
+  double result = _mm_cvtsd_f64(_mm_add_sd(pair, _mm_unpackhi_pd(pair, pair)));
+
+  for (; i < dimension; ++i)
+  {
+    const double diff = a[i] - b[i];
+    result += diff * diff;
+  }
+  return result;
+}
+
+__attribute__((target("avx2,fma"))) void distanceSquaredBatchAVX2(const double *query, const double *points,
+                                                                   std::size_t count, std::size_t dimension,
+                                                                   double *distances)
+{
+  // Wide points fill the vector on their own
+  if (dimension >= 4)
+  {
+    for (std::size_t i = 0; i < count; ++i, points += dimension)
+      distances[i] = distanceSquaredAVX2(query, points, dimension);
+    return;
+  }
+
+  // Narrow points are processed 4 at a time, gathering one coordinate of each per instruction
+  const int stride = static_cast<int>(dimension);
+  const __m128i offsets = _mm_setr_epi32(0, stride, 2 * stride, 3 * stride);
+  const __m256d all = _mm256_castsi256_pd(_mm256_set1_epi64x(-1));
+  std::size_t i = 0;
+  for (; i + 4 <= count; i += 4, points += 4 * dimension)
+  {
+    __m256d sum = _mm256_setzero_pd();
+    for (std::size_t d = 0; d < dimension; ++d)
+    {
+      // The masked form gathers the same lanes, but starts from a defined register
+      const __m256d coordinates = _mm256_mask_i32gather_pd(_mm256_setzero_pd(), points + d, offsets, all, 8);
+      const __m256d diff = _mm256_sub_pd(coordinates, _mm256_set1_pd(query[d]));
+      sum = _mm256_fmadd_pd(diff, diff, sum);
+    }
+    _mm256_storeu_pd(distances + i, sum);
+  }
+  for (; i < count; ++i, points += dimension)
+    distances[i] = distanceSquaredGeneric(query, points, dimension);
+}
+
+__attribute__((target("avx2,fma"))) float distanceSquaredFloatAVX2(const float *a, const float *b,
+                                                                    std::size_t dimension)
+{
+  __m256 sum = _mm256_setzero_ps();
+  std::size_t i = 0;
+  for (; i + 8 <= dimension; i += 8)
+  {
+    const __m256 diff = _mm256_sub_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i));
+    sum = _mm256_fmadd_ps(diff, diff, sum);
+  }
+  float lanes[8];
+  _mm256_storeu_ps(lanes, sum);
+  float result = ((lanes[0] + lanes[1]) + (lanes[2] + lanes[3])) + ((lanes[4] + lanes[5]) + (lanes[6] + lanes[7]));
+
+  for (; i < dimension; ++i)
+  {
+    const float diff = a[i] - b[i];
+    result += diff * diff;
+  }
+  return result;
+}
+
+__attribute__((target("avx2,fma"))) void distanceSquaredBatchFloatAVX2(const float *query, const float *points,
+                                                                        std::size_t count, std::size_t dimension,
+                                                                        double *distances)
+{
+  if (dimension >= 8)
+  {
+    for (std::size_t i = 0; i < count; ++i, points += dimension)
+      distances[i] = distanceSquaredFloatAVX2(query, points, dimension);
+    return;
+  }
+
+  // 8 narrow points at a time, widened to double on the way out
+  const int stride = static_cast<int>(dimension);
+  const __m256i offsets =
+      _mm256_setr_epi32(0, stride, 2 * stride, 3 * stride, 4 * stride, 5 * stride, 6 * stride, 7 * stride);
+  const __m256 all = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+  std::size_t i = 0;
+  for (; i + 8 <= count; i += 8, points += 8 * dimension)
+  {
+    __m256 sum = _mm256_setzero_ps();
+    for (std::size_t d = 0; d < dimension; ++d)
+    {
+      const __m256 coordinates = _mm256_mask_i32gather_ps(_mm256_setzero_ps(), points + d, offsets, all, 4);
+      const __m256 diff = _mm256_sub_ps(coordinates, _mm256_set1_ps(query[d]));
+      sum = _mm256_fmadd_ps(diff, diff, sum);
+    }
+    _mm256_storeu_pd(distances + i, _mm256_cvtps_pd(_mm256_castps256_ps128(sum)));
+    _mm256_storeu_pd(distances + i + 4, _mm256_cvtps_pd(_mm256_extractf128_ps(sum, 1)));
+  }
+  for (; i < count; ++i, points += dimension)
+    distances[i] = distanceSquaredFloatGeneric(query, points, dimension);
+}
+#endif
+
+// -------------------------------------------------------------------------------------------------------------------
+// AVX-512
+// -------------------------------------------------------------------------------------------------------------------
+
+#ifdef BOLT_DISTANCE_AVX512
+__attribute__((target("avx512f"))) double distanceSquaredAVX512(const double *a, const double *b,
+                                                                 std::size_t dimension)
+{
+  __m512d sum = _mm512_setzero_pd();
+  std::size_t i = 0;
+  for (; i + 8 <= dimension; i += 8)
+  {
+    const __m512d diff = _mm512_sub_pd(_mm512_loadu_pd(a + i), _mm512_loadu_pd(b + i));
+    sum = _mm512_fmadd_pd(diff, diff, sum);
+  }
+  if (i < dimension)
+  {
+    // Masked loads read only the remaining coordinates, and zero the rest of the lanes
+    const __mmask8 mask = static_cast<__mmask8>((1u << (dimension - i)) - 1);
+    const __m512d diff = _mm512_sub_pd(_mm512_maskz_loadu_pd(mask, a + i), _mm512_maskz_loadu_pd(mask, b + i));
+    sum = _mm512_fmadd_pd(diff, diff, sum);
+  }
+  // Sum the lanes through memory, _mm512_reduce_add_pd is not available in every compiler that has AVX-512
+  double lanes[8];
+  _mm512_storeu_pd(lanes, sum);
+  return ((lanes[0] + lanes[1]) + (lanes[2] + lanes[3])) + ((lanes[4] + lanes[5]) + (lanes[6] + lanes[7]));
+}
+
+__attribute__((target("avx512f"))) void distanceSquaredBatchAVX512(const double *query, const double *points,
+                                                                    std::size_t count, std::size_t dimension,
+                                                                    double *distances)
+{
+  if (dimension >= 8)
+  {
+    for (std::size_t i = 0; i < count; ++i, points += dimension)
+      distances[i] = distanceSquaredAVX512(query, points, dimension);
+    return;
+  }
+
+  const int stride = static_cast<int>(dimension);
+  const __m256i offsets =
+      _mm256_setr_epi32(0, stride, 2 * stride, 3 * stride, 4 * stride, 5 * stride, 6 * stride, 7 * stride);
+  std::size_t i = 0;
+  for (; i + 8 <= count; i += 8, points += 8 * dimension)
+  {
+    __m512d sum = _mm512_setzero_pd();
+    for (std::size_t d = 0; d < dimension; ++d)
+    {
+      const __m512d coordinates = _mm512_mask_i32gather_pd(_mm512_setzero_pd(), 0xFF, offsets, points + d, 8);
+      const __m512d diff = _mm512_sub_pd(coordinates, _mm512_set1_pd(query[d]));
+      sum = _mm512_fmadd_pd(diff, diff, sum);
+    }
+    _mm512_storeu_pd(distances + i, sum);
+  }
+  for (; i < count; ++i, points += dimension)
+    distances[i] = distanceSquaredAVX512(query, points, dimension);
+}
+
+__attribute__((target("avx512f"))) float distanceSquaredFloatAVX512(const float *a, const float *b,
+                                                                     std::size_t dimension)
+{
+  __m512 sum = _mm512_setzero_ps();
+  std::size_t i = 0;
+  for (; i + 16 <= dimension; i += 16)
+  {
+    const __m512 diff = _mm512_sub_ps(_mm512_loadu_ps(a + i), _mm512_loadu_ps(b + i));
+    sum = _mm512_fmadd_ps(diff, diff, sum);
+  }
+  if (i < dimension)
+  {
+    const __mmask16 mask = static_cast<__mmask16>((1u << (dimension - i)) - 1);
+    const __m512 diff = _mm512_sub_ps(_mm512_maskz_loadu_ps(mask, a + i), _mm512_maskz_loadu_ps(mask, b + i));
+    sum = _mm512_fmadd_ps(diff, diff, sum);
+  }
+  float lanes[16];
+  _mm512_storeu_ps(lanes, sum);
+  float result = 0;
+  for (std::size_t lane = 0; lane < 16; ++lane)
+    result += lanes[lane];
+  return result;
+}
+
+__attribute__((target("avx512f"))) void distanceSquaredBatchFloatAVX512(const float *query, const float *points,
+                                                                         std::size_t count, std::size_t dimension,
+                                                                         double *distances)
+{
+  if (dimension >= 16)
+  {
+    for (std::size_t i = 0; i < count; ++i, points += dimension)
+      distances[i] = distanceSquaredFloatAVX512(query, points, dimension);
+    return;
+  }
+
+  const __m512i lanes = _mm512_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+  const __m512i offsets = _mm512_mullo_epi32(lanes, _mm512_set1_epi32(static_cast<int>(dimension)));
+  std::size_t i = 0;
+  for (; i + 16 <= count; i += 16, points += 16 * dimension)
+  {
+    __m512 sum = _mm512_setzero_ps();
+    for (std::size_t d = 0; d < dimension; ++d)
+    {
+      const __m512 coordinates = _mm512_mask_i32gather_ps(_mm512_setzero_ps(), 0xFFFF, offsets, points + d, 4);
+      const __m512 diff = _mm512_sub_ps(coordinates, _mm512_set1_ps(query[d]));
+      sum = _mm512_fmadd_ps(diff, diff, sum);
+    }
+    float sums[16];
+    _mm512_storeu_ps(sums, sum);
+    for (std::size_t lane = 0; lane < 16; ++lane)
+      distances[i + lane] = sums[lane];
+  }
+  for (; i < count; ++i, points += dimension)
+    distances[i] = distanceSquaredFloatGeneric(query, points, dimension);
+}
+#endif
+
+const DistanceKernels GENERIC_KERNELS = {KERNEL_GENERIC, "generic", &distanceSquaredGeneric,
+                                         &distanceSquaredBatchGeneric, &distanceSquaredBatchFloatGeneric};
+#ifdef BOLT_DISTANCE_AVX2
+const DistanceKernels AVX2_KERNELS = {KERNEL_AVX2, "avx2", &distanceSquaredAVX2, &distanceSquaredBatchAVX2,
+                                      &distanceSquaredBatchFloatAVX2};
+#endif
+#ifdef BOLT_DISTANCE_AVX512
+const DistanceKernels AVX512_KERNELS = {KERNEL_AVX512, "avx512", &distanceSquaredAVX512, &distanceSquaredBatchAVX512,
+                                        &distanceSquaredBatchFloatAVX512};
+#endif
+
+bool cpuSupports(DistanceKernelLevel level)
+{
+  switch (level)
+  {
+#ifdef BOLT_DISTANCE_AVX2
+    case KERNEL_AVX2:
+      return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+#endif
+#ifdef BOLT_DISTANCE_AVX512
+    case KERNEL_AVX512:
+      return __builtin_cpu_supports("avx512f");
+#endif
+    case KERNEL_GENERIC:
+      return true;
+    default:
+      return false;
+  }
+}
+
+const DistanceKernels &selectKernels(DistanceKernelLevel level)
+{
+  if (!cpuSupports(level))
+    return GENERIC_KERNELS;
+
+  switch (level)
+  {
+#ifdef BOLT_DISTANCE_AVX2
+    case KERNEL_AVX2:
+      return AVX2_KERNELS;
+#endif
+#ifdef BOLT_DISTANCE_AVX512
+    case KERNEL_AVX512:
+      return AVX512_KERNELS;
+#endif
+    default:
+      return GENERIC_KERNELS;
+  }
+}
+
+const DistanceKernels &selectBestKernels()
+{
+  if (cpuSupports(KERNEL_AVX512))
+    return selectKernels(KERNEL_AVX512);
+  return selectKernels(KERNEL_AVX2);
+}
+}  // namespace
+
+const DistanceKernels &getDistanceKernels(DistanceKernelLevel level)
+{
+  if (level != KERNEL_BEST)
+    return selectKernels(level);
+
+  // Function local statics are initialized once, even with concurrent callers
+  static const DistanceKernels &best = selectBestKernels();
+  return best;
+}
+
+bool isEuclideanSpace(const base::StateSpacePtr &space)
+{
+  return space && typeid(*space) == typeid(base::RealVectorStateSpace);
+}
+
+}  // namespace bolt
+}  // namespace tools
+}  // namespace ompl
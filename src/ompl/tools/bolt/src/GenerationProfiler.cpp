@@ -0,0 +1,312 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2016, University of Colorado, Boulder
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the Univ of CO, Boulder nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+/* Author: Dave Coleman <dave@dav.ee>
+   Desc:   Low overhead per-thread timers and counters for the phases of sparse graph generation
+*/
+
+// OMPL
+#include <ompl/tools/bolt/GenerationProfiler.h>
+#include <ompl/util/Console.h>
+
+// C++
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+
+namespace ompl
+{
+namespace tools
+{
+namespace bolt
+{
+namespace
+{
+/** \brief Slot of the calling thread, shared by all profilers */
+thread_local std::size_t profilerThreadID = 0;
+}  // namespace
+
+GenerationProfiler::GenerationProfiler(std::size_t numThreads) : threads_(std::max(std::size_t(1), numThreads))
+{
+  reset();
+}
+
+void GenerationProfiler::reset()
+{
+  for (ThreadProfile &thread : threads_)
+  {
+    std::fill(thread.phases_, thread.phases_ + NUM_PROFILE_PHASES, PhaseStatistics());
+    std::fill(thread.counters_, thread.counters_ + NUM_PROFILE_COUNTERS, 0);
+  }
+  startTime_ = time::now();
+}
+
+void GenerationProfiler::setThreadID(std::size_t threadID)
+{
+  profilerThreadID = threadID;
+}
+
+std::size_t GenerationProfiler::getThreadID()
+{
+  return profilerThreadID;
+}
+
+GenerationProfiler::ThreadProfile &GenerationProfiler::getThreadProfile()
+{
+  return threads_[std::min(profilerThreadID, threads_.size() - 1)];
+}
+
+void GenerationProfiler::addTime(ProfilePhase phase, double seconds)
+{
+  if (!enabled_)
+    return;
+
+  PhaseStatistics &stats = getThreadProfile().phases_[phase];
+  stats.calls_++;
+  stats.total_ += seconds;
+  stats.max_ = std::max(stats.max_, seconds);
+}
+
+void GenerationProfiler::increment(ProfileCounter counter, std::size_t amount)
+{
+  if (enabled_)
+    getThreadProfile().counters_[counter] += amount;
+}
+
+PhaseStatistics GenerationProfiler::getPhase(ProfilePhase phase) const
+{
+  PhaseStatistics result;
+  for (std::size_t threadID = 0; threadID < threads_.size(); ++threadID)
+  {
+    const PhaseStatistics &stats = threads_[threadID].phases_[phase];
+    result.calls_ += stats.calls_;
+    result.total_ += stats.total_;
+    result.max_ = std::max(result.max_, stats.max_);
+  }
+  return result;
+}
+
+PhaseStatistics GenerationProfiler::getPhase(ProfilePhase phase, std::size_t threadID) const
+{
+  if (threadID >= threads_.size())
+    return PhaseStatistics();
+  return threads_[threadID].phases_[phase];
+}
+
+std::size_t GenerationProfiler::getCounter(ProfileCounter counter) const
+{
+  std::size_t result = 0;
+  for (const ThreadProfile &thread : threads_)
+    result += thread.counters_[counter];
+  return result;
+}
+
+std::size_t GenerationProfiler::getCounter(ProfileCounter counter, std::size_t threadID) const
+{
+  if (threadID >= threads_.size())
+    return 0;
+  return threads_[threadID].counters_[counter];
+}
+
+double GenerationProfiler::getWallTime() const
+{
+  return time::seconds(time::now() - startTime_);
+}
+
+std::string GenerationProfiler::getPhaseName(ProfilePhase phase)
+{
+  switch (phase)
+  {
+    case PHASE_SAMPLING:
+      return "sampling";
+    case PHASE_NEAREST_NEIGHBOR:
+      return "nearest_neighbor";
+    case PHASE_VISIBILITY:
+      return "visibility";
+    case PHASE_COVERAGE:
+      return "coverage";
+    case PHASE_CONNECTIVITY:
+      return "connectivity";
+    case PHASE_INTERFACE:
+      return "interface";
+    case PHASE_QUALITY:
+      return "quality";
+    case PHASE_ASTAR:
+      return "astar";
+    case PHASE_GRAPH_MUTATION:
+      return "graph_mutation";
+    case PHASE_SAVE:
+      return "save";
+    case PHASE_QUEUE_WAIT:
+      return "queue_wait";
+    case PHASE_DISCRETIZATION:
+      return "discretization";
+    default:
+      return "unknown";
+  }
+}
+
+std::string GenerationProfiler::getCounterName(ProfileCounter counter)
+{
+  switch (counter)
+  {
+    case COUNT_SAMPLES:
+      return "samples";
+    case COUNT_CANDIDATES:
+      return "candidates";
+    case COUNT_STALE_CANDIDATES:
+      return "stale_candidates";
+    case COUNT_RECOMPUTED_CANDIDATES:
+      return "recomputed_candidates";
+    case COUNT_QUEUE_MISSES:
+      return "queue_misses";
+    case COUNT_MOTION_CHECKS:
+      return "motion_checks";
+    case COUNT_MOTION_CACHE_HITS:
+      return "motion_cache_hits";
+    case COUNT_BOUNDARY_SAMPLES:
+      return "boundary_samples";
+    case COUNT_VERTICES_ADDED:
+      return "vertices_added";
+    case COUNT_EDGES_ADDED:
+      return "edges_added";
+    default:
+      return "unknown";
+  }
+}
+
+void GenerationProfiler::print(std::ostream &out) const
+{
+  const double wallTime = getWallTime();
+
+  out << "-----------------------------------------" << std::endl;
+  out << "Generation profile (" << threads_.size() << " thread slots, " << wallTime << " s wall time)" << std::endl;
+  out << std::left << std::setw(20) << "  phase" << std::setw(12) << "calls" << std::setw(14) << "total (s)"
+      << std::setw(14) << "mean (ms)" << std::setw(14) << "max (ms)" << "threads busy" << std::endl;
+  for (std::size_t i = 0; i < NUM_PROFILE_PHASES; ++i)
+  {
+    const PhaseStatistics stats = getPhase(static_cast<ProfilePhase>(i));
+    if (!stats.calls_)
+      continue;
+
+    // Average number of threads inside this phase over the whole run
+    const double busy = wallTime > 0 ? stats.total_ / wallTime : 0;
+    out << std::left << "  " << std::setw(18) << getPhaseName(static_cast<ProfilePhase>(i)) << std::setw(12)
+        << stats.calls_ << std::setw(14) << stats.total_ << std::setw(14) << stats.total_ / stats.calls_ * 1000.0
+        << std::setw(14) << stats.max_ * 1000.0 << busy << std::endl;
+  }
+  out << "  counters:" << std::endl;
+  for (std::size_t i = 0; i < NUM_PROFILE_COUNTERS; ++i)
+    out << "    " << std::left << std::setw(18) << getCounterName(static_cast<ProfileCounter>(i))
+        << getCounter(static_cast<ProfileCounter>(i)) << std::endl;
+  out << "-----------------------------------------" << std::endl;
+}
+
+bool GenerationProfiler::writeJSON(const std::string &filePath) const
+{
+  std::ofstream out(filePath.c_str(), std::ios::out);
+  if (!out.is_open())
+  {
+    OMPL_ERROR("%s: Unable to open profile output file %s", name_.c_str(), filePath.c_str());
+    return false;
+  }
+
+  out << std::setprecision(10);
+  out << "{\n";
+  out << "  \"wall_time\": " << getWallTime() << ",\n";
+  out << "  \"phases\": {";
+  for (std::size_t i = 0; i < NUM_PROFILE_PHASES; ++i)
+  {
+    const ProfilePhase phase = static_cast<ProfilePhase>(i);
+    const PhaseStatistics total = getPhase(phase);
+    out << (i == 0 ? "\n" : ",\n") << "    \"" << getPhaseName(phase) << "\": {\"calls\": " << total.calls_
+        << ", \"total\": " << total.total_ << ", \"max\": " << total.max_ << ", \"threads\": [";
+    for (std::size_t threadID = 0; threadID < threads_.size(); ++threadID)
+    {
+      const PhaseStatistics &stats = threads_[threadID].phases_[phase];
+      out << (threadID == 0 ? "" : ", ") << "{\"calls\": " << stats.calls_ << ", \"total\": " << stats.total_ << "}";
+    }
+    out << "]}";
+  }
+  out << "\n  },\n";
+  out << "  \"counters\": {";
+  for (std::size_t i = 0; i < NUM_PROFILE_COUNTERS; ++i)
+  {
+    const ProfileCounter counter = static_cast<ProfileCounter>(i);
+    out << (i == 0 ? "\n" : ",\n") << "    \"" << getCounterName(counter) << "\": " << getCounter(counter);
+  }
+  out << "\n  }\n";
+  out << "}\n";
+
+  return true;
+}
+
+bool GenerationProfiler::writeCSV(const std::string &filePath) const
+{
+  std::ofstream out(filePath.c_str(), std::ios::out);
+  if (!out.is_open())
+  {
+    OMPL_ERROR("%s: Unable to open profile output file %s", name_.c_str(), filePath.c_str());
+    return false;
+  }
+
+  // One row per thread and phase or counter, plus an "all" row with the aggregate
+  out << std::setprecision(10);
+  out << "kind,name,thread,calls,total,max\n";
+  for (std::size_t i = 0; i < NUM_PROFILE_PHASES; ++i)
+  {
+    const ProfilePhase phase = static_cast<ProfilePhase>(i);
+    const PhaseStatistics total = getPhase(phase);
+    out << "phase," << getPhaseName(phase) << ",all," << total.calls_ << "," << total.total_ << "," << total.max_
+        << "\n";
+    for (std::size_t threadID = 0; threadID < threads_.size(); ++threadID)
+    {
+      const PhaseStatistics &stats = threads_[threadID].phases_[phase];
+      if (stats.calls_)
+        out << "phase," << getPhaseName(phase) << "," << threadID << "," << stats.calls_ << "," << stats.total_ << ","
+            << stats.max_ << "\n";
+    }
+  }
+  for (std::size_t i = 0; i < NUM_PROFILE_COUNTERS; ++i)
+  {
+    const ProfileCounter counter = static_cast<ProfileCounter>(i);
+    out << "counter," << getCounterName(counter) << ",all," << getCounter(counter) << ",,\n";
+  }
+
+  return true;
+}
+
+}  // namespace bolt
+}  // namespace tools
+}  // namespace ompl
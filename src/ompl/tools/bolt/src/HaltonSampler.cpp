@@ -0,0 +1,164 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2016, University of Colorado, Boulder
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the Univ of CO, Boulder nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+/* Author: Dave Coleman <dave@dav.ee>
+   Desc:   Low discrepancy samples for roadmap generation, split into streams for the generation threads
+*/
+
+// OMPL
+#include <ompl/tools/bolt/HaltonSampler.h>
+#include <ompl/tools/bolt/SeededRandom.h>
+#include <ompl/base/spaces/RealVectorStateSpace.h>
+#include <ompl/util/Exception.h>
+
+// C++
+#include <algorithm>
+
+namespace ompl
+{
+namespace tools
+{
+namespace bolt
+{
+namespace
+{
+bool isPrime(unsigned int n)
+{
+  if (n < 2)
+    return false;
+  for (unsigned int d = 2; d * d <= n; ++d)
+    if (n % d == 0)
+      return false;
+  return true;
+}
+}  // namespace
+
+HaltonStateSampler::HaltonStateSampler(const base::StateSpace *space, std::size_t stream, std::size_t numStreams,
+                                       std::uint_fast32_t seed)
+  : base::StateSampler(space), index_(stream), stride_(1)
+  , randomSampler_(new SeededStateSampler(space, deriveSeed(seed, SEED_HALTON, stream + 1)))
+{
+  const base::RealVectorStateSpace *realSpace = dynamic_cast<const base::RealVectorStateSpace *>(space);
+  if (!realSpace)
+    throw Exception("HaltonStateSampler", "Halton samples require a RealVectorStateSpace");
+  if (stream >= std::max<std::size_t>(1, numStreams))
+    throw Exception("HaltonStateSampler", "Stream out of range");
+
+  const base::RealVectorBounds bounds = realSpace->getBounds();
+  const std::size_t dim = bounds.low.size();
+  for (unsigned int n = 2; bases_.size() < dim; ++n)
+    if (isPrime(n))
+      bases_.push_back(n);
+
+  // The stride must share no factor with any base, or a stream would only ever see part of a coordinate. With
+  // numStreams itself the streams interleave into one sequence, otherwise each stream is a leaped sequence of its own
+  if (numStreams > 1)
+  {
+    bool coprime = true;
+    for (std::size_t j = 0; j < bases_.size() && coprime; ++j)
+      coprime = numStreams % bases_[j] != 0;
+
+    unsigned int stride = numStreams;
+    if (!coprime)
+    {
+      stride = std::max<unsigned int>(numStreams, bases_.back() + 1);
+      while (!isPrime(stride))
+        ++stride;
+    }
+    stride_ = stride;
+  }
+
+  // Same shift in every stream
+  RNG rng(deriveSeed(seed, SEED_HALTON));
+  shift_.resize(dim);
+  low_.resize(dim);
+  extent_.resize(dim);
+  for (std::size_t j = 0; j < dim; ++j)
+  {
+    shift_[j] = rng.uniform01();
+    low_[j] = bounds.low[j];
+    extent_[j] = bounds.high[j] - bounds.low[j];
+  }
+}
+
+void HaltonStateSampler::sampleUniform(base::State *state)
+{
+  double *values = state->as<base::RealVectorStateSpace::StateType>()->values;
+  for (std::size_t j = 0; j < bases_.size(); ++j)
+  {
+    double u = radicalInverse(index_, bases_[j]) + shift_[j];
+    if (u >= 1.0)
+      u -= 1.0;
+    values[j] = low_[j] + u * extent_[j];
+  }
+  index_ += stride_;
+}
+
+void HaltonStateSampler::sampleUniformNear(base::State *state, const base::State *near, double distance)
+{
+  randomSampler_->sampleUniformNear(state, near, distance);
+}
+
+void HaltonStateSampler::sampleGaussian(base::State *state, const base::State *mean, double stdDev)
+{
+  randomSampler_->sampleGaussian(state, mean, stdDev);
+}
+
+double HaltonStateSampler::radicalInverse(std::uint64_t index, unsigned int base)
+{
+  const double invBase = 1.0 / base;
+  double factor = invBase;
+  double result = 0.0;
+  while (index > 0)
+  {
+    result += (index % base) * factor;
+    index /= base;
+    factor *= invBase;
+  }
+  return result;
+}
+
+base::StateSamplerPtr allocSequenceStateSampler(SampleSequence sequence, const base::SpaceInformation *si,
+                                                std::size_t stream, std::size_t numStreams, std::uint_fast32_t seed)
+{
+  const base::StateSpace *space = si->getStateSpace().get();
+  if (sequence != SAMPLE_SEQUENCE_HALTON || !dynamic_cast<const base::RealVectorStateSpace *>(space))
+    return base::StateSamplerPtr();
+
+  return base::StateSamplerPtr(new HaltonStateSampler(space, stream, numStreams, seed));
+}
+
+}  // namespace bolt
+}  // namespace tools
+}  // namespace ompl
@@ -0,0 +1,254 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2016, University of Colorado, Boulder
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the Univ of CO, Boulder nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+/* Author: Dave Coleman <dave@dav.ee>
+   Desc:   Landmark lower bounds on graph distance (ALT) for the A* heuristic
+*/
+
+// OMPL
+#include <ompl/tools/bolt/LandmarkHeuristic.h>
+
+// C++
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <queue>
+#include <utility>
+
+namespace ompl
+{
+namespace tools
+{
+namespace bolt
+{
+namespace
+{
+typedef std::pair<double, SparseVertex> QueueEntry;
+typedef std::priority_queue<QueueEntry, std::vector<QueueEntry>, std::greater<QueueEntry> > DijkstraQueue;
+
+/** \brief Graph distance from source to every vertex */
+void dijkstra(const SparseAdjList &g, SparseVertex source, std::vector<double> &distance)
+{
+  distance.assign(boost::num_vertices(g), LandmarkHeuristic::UNREACHED);
+  distance[source] = 0;
+  DijkstraQueue queue;
+  queue.push(QueueEntry(0, source));
+  while (!queue.empty())
+  {
+    const QueueEntry entry = queue.top();
+    queue.pop();
+    if (entry.first > distance[entry.second])  // already reached more cheaply
+      continue;
+
+    SparseAdjList::out_edge_iterator edge, end;
+    for (boost::tie(edge, end) = boost::out_edges(entry.second, g); edge != end; ++edge)
+    {
+      const SparseVertex target = boost::target(*edge, g);
+      const double targetDistance = entry.first + boost::get(boost::edge_weight, g, *edge);
+      if (targetDistance < distance[target])
+      {
+        distance[target] = targetDistance;
+        queue.push(QueueEntry(targetDistance, target));
+      }
+    }
+  }
+}
+}  // namespace
+
+const double LandmarkHeuristic::UNREACHED = std::numeric_limits<double>::infinity();
+
+LandmarkHeuristic::LandmarkHeuristic(const SparseAdjList &graph) : graph_(graph)
+{
+}
+
+void LandmarkHeuristic::clear()
+{
+  landmarks_.clear();
+  distances_.clear();
+  numUpdated_ = 0;
+}
+
+void LandmarkHeuristic::compute(std::size_t numLandmarks, SparseVertex firstVertex)
+{
+  clear();
+  const std::size_t numVertices = boost::num_vertices(graph_);
+
+  // Only vertices with edges are worth a landmark, which also skips deleted vertices
+  std::vector<SparseVertex> candidates;
+  for (SparseVertex v = firstVertex; v < numVertices; ++v)
+    if (boost::out_degree(v, graph_) > 0)
+      candidates.push_back(v);
+  if (candidates.empty() || numLandmarks == 0)
+    return;
+
+  // Farthest first selection, starting from the vertex farthest from an arbitrary one
+  std::vector<std::vector<double> > columns;
+  std::vector<double> closest;
+  dijkstra(graph_, candidates.front(), closest);
+  while (landmarks_.size() < numLandmarks)
+  {
+    SparseVertex farthest = candidates.front();
+    double farthestDistance = -1;
+    for (std::size_t i = 0; i < candidates.size(); ++i)
+    {
+      if (closest[candidates[i]] > farthestDistance)
+      {
+        farthest = candidates[i];
+        farthestDistance = closest[farthest];
+      }
+    }
+    if (farthestDistance <= 0)  // every candidate is a landmark
+      break;
+
+    landmarks_.push_back(farthest);
+    columns.push_back(std::vector<double>());
+    dijkstra(graph_, farthest, columns.back());
+
+    // The arbitrary start vertex is only used to pick the first landmark
+    if (landmarks_.size() == 1)
+      closest = columns.back();
+    else
+      for (std::size_t v = 0; v < numVertices; ++v)
+        closest[v] = std::min(closest[v], columns.back()[v]);
+  }
+
+  distances_.resize(numVertices * landmarks_.size());
+  for (std::size_t v = 0; v < numVertices; ++v)
+    for (std::size_t i = 0; i < landmarks_.size(); ++i)
+      distances_[v * landmarks_.size() + i] = columns[i][v];
+}
+
+void LandmarkHeuristic::setTables(const std::vector<SparseVertex> &landmarks, const std::vector<double> &distances)
+{
+  clear();
+  landmarks_ = landmarks;
+  distances_ = distances;
+}
+
+void LandmarkHeuristic::addVertex(SparseVertex v)
+{
+  if (landmarks_.empty())
+    return;
+  if ((v + 1) * landmarks_.size() > distances_.size())
+    distances_.resize((v + 1) * landmarks_.size(), UNREACHED);
+}
+
+void LandmarkHeuristic::addEdge(SparseVertex v1, SparseVertex v2, double weight)
+{
+  if (landmarks_.empty())
+    return;
+  addVertex(std::max(v1, v2));
+
+  for (std::size_t i = 0; i < landmarks_.size(); ++i)
+  {
+    const double distance1 = distances_[v1 * landmarks_.size() + i];
+    const double distance2 = distances_[v2 * landmarks_.size() + i];
+    if (distance1 + weight < distance2)
+      propagate(i, v2, distance1 + weight);
+    else if (distance2 + weight < distance1)
+      propagate(i, v1, distance2 + weight);
+  }
+}
+
+void LandmarkHeuristic::propagate(std::size_t i, SparseVertex v, double distance)
+{
+  const std::size_t stride = landmarks_.size();
+  distances_[v * stride + i] = distance;
+  numUpdated_++;
+
+  DijkstraQueue queue;
+  queue.push(QueueEntry(distance, v));
+  while (!queue.empty())
+  {
+    const QueueEntry entry = queue.top();
+    queue.pop();
+    if (entry.first > distances_[entry.second * stride + i])
+      continue;
+
+    SparseAdjList::out_edge_iterator edge, end;
+    for (boost::tie(edge, end) = boost::out_edges(entry.second, graph_); edge != end; ++edge)
+    {
+      const SparseVertex target = boost::target(*edge, graph_);
+      const double targetDistance = entry.first + boost::get(boost::edge_weight, graph_, *edge);
+      double &current = distances_[target * stride + i];
+      if (targetDistance < current)
+      {
+        current = targetDistance;
+        numUpdated_++;
+        queue.push(QueueEntry(targetDistance, target));
+      }
+    }
+  }
+}
+
+void LandmarkHeuristic::permute(const std::vector<SparseVertex> &newIndex)
+{
+  if (landmarks_.empty())
+    return;
+
+  const std::size_t stride = landmarks_.size();
+  std::vector<double> distances(distances_.size(), UNREACHED);
+  for (std::size_t v = 0; v < newIndex.size() && (v + 1) * stride <= distances_.size(); ++v)
+    std::copy(distances_.begin() + v * stride, distances_.begin() + (v + 1) * stride,
+              distances.begin() + newIndex[v] * stride);
+  distances_.swap(distances);
+
+  for (std::size_t i = 0; i < landmarks_.size(); ++i)
+    landmarks_[i] = newIndex[landmarks_[i]];
+}
+
+double LandmarkHeuristic::getLowerBound(SparseVertex a, SparseVertex b) const
+{
+  const std::size_t stride = landmarks_.size();
+  if (stride == 0 || (std::max(a, b) + 1) * stride > distances_.size())
+    return 0;
+
+  // A landmark that reaches only one of the two gives no finite bound
+  const double *distancesA = &distances_[a * stride];
+  const double *distancesB = &distances_[b * stride];
+  double bound = 0;
+  for (std::size_t i = 0; i < stride; ++i)
+    if (distancesA[i] != UNREACHED && distancesB[i] != UNREACHED)
+      bound = std::max(bound, std::fabs(distancesA[i] - distancesB[i]));
+  return bound;
+}
+
+std::size_t LandmarkHeuristic::getMemoryBytes() const
+{
+  return sizeof(*this) + landmarks_.capacity() * sizeof(SparseVertex) + distances_.capacity() * sizeof(double);
+}
+
+}  // namespace bolt
+}  // namespace tools
+}  // namespace ompl
@@ -0,0 +1,231 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2016, University of Colorado, Boulder
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the Univ of CO, Boulder nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+/* Author: Dave Coleman <dave@dav.ee>
+   Desc:   Estimate the memory used by the components of a roadmap
+*/
+
+// OMPL
+#include <ompl/tools/bolt/MemoryReport.h>
+#include <ompl/util/Console.h>
+
+// C++
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+
+namespace ompl
+{
+namespace tools
+{
+namespace bolt
+{
+namespace
+{
+/** \brief Default parameters of NearestNeighborsGNAT */
+const std::size_t GNAT_DEGREE = 8;
+const std::size_t GNAT_MAX_POINTS_PER_LEAF = 50;
+
+/** \brief Fixed members of a GNAT node plus its range arrays and child pointers */
+const std::size_t GNAT_NODE_BYTES = 128 + GNAT_DEGREE * (2 * sizeof(double) + sizeof(void *)) +
+                                    4 * MemoryReport::ALLOCATION_OVERHEAD;
+}  // namespace
+
+const std::size_t MemoryReport::ALLOCATION_OVERHEAD;
+
+MemoryReport::MemoryReport()
+{
+  std::fill(bytes_, bytes_ + NUM_MEMORY_COMPONENTS, 0);
+}
+
+std::size_t MemoryReport::getTotal() const
+{
+  std::size_t total = 0;
+  for (std::size_t i = 0; i < NUM_MEMORY_COMPONENTS; ++i)
+    total += bytes_[i];
+  return total;
+}
+
+MemoryReport &MemoryReport::operator+=(const MemoryReport &other)
+{
+  for (std::size_t i = 0; i < NUM_MEMORY_COMPONENTS; ++i)
+    bytes_[i] += other.bytes_[i];
+  numVertices_ += other.numVertices_;
+  numEdges_ += other.numEdges_;
+  return *this;
+}
+
+std::string MemoryReport::getComponentName(MemoryComponent component)
+{
+  switch (component)
+  {
+    case MEMORY_STATES:
+      return "states";
+    case MEMORY_VERTICES:
+      return "vertices";
+    case MEMORY_ADJACENCY:
+      return "adjacency";
+    case MEMORY_EDGE_PROPERTIES:
+      return "edge_properties";
+    case MEMORY_INTERFACE_DATA:
+      return "interface_data";
+    case MEMORY_NEAREST_NEIGHBORS:
+      return "nearest_neighbors";
+    case MEMORY_DISJOINT_SETS:
+      return "disjoint_sets";
+    case MEMORY_LANDMARKS:
+      return "landmarks";
+    case MEMORY_HIERARCHY:
+      return "hierarchy";
+    case MEMORY_WORKSPACE_INDEX:
+      return "workspace_index";
+    case MEMORY_MOTION_CACHE:
+      return "motion_cache";
+    case MEMORY_STATE_POOL:
+      return "state_pool";
+    default:
+      return "unknown";
+  }
+}
+
+std::string MemoryReport::formatBytes(double bytes)
+{
+  const char *units[] = {"B", "KB", "MB", "GB", "TB"};
+  std::size_t unit = 0;
+  bool negative = bytes < 0;
+  bytes = std::abs(bytes);
+  while (bytes >= 1024.0 && unit < 4)
+  {
+    bytes /= 1024.0;
+    ++unit;
+  }
+
+  std::stringstream stream;
+  stream << (negative ? "-" : "") << std::fixed << std::setprecision(unit == 0 ? 0 : 1) << bytes << " "
+         << units[unit];
+  return stream.str();
+}
+
+void MemoryReport::print(const std::string &title, std::ostream &out) const
+{
+  const std::size_t total = getTotal();
+  out << title << " memory: " << formatBytes(total) << " for " << numVertices_ << " vertices and " << numEdges_
+      << " edges" << std::endl;
+  for (std::size_t i = 0; i < NUM_MEMORY_COMPONENTS; ++i)
+  {
+    const double percent = total ? bytes_[i] / double(total) * 100.0 : 0.0;
+    const double perVertex = numVertices_ ? bytes_[i] / double(numVertices_) : 0.0;
+    out << "  " << std::left << std::setw(20) << getComponentName(static_cast<MemoryComponent>(i)) << std::right
+        << std::setw(12) << formatBytes(bytes_[i]) << std::setw(8) << std::fixed << std::setprecision(1) << percent
+        << "%" << std::setw(12) << formatBytes(perVertex) << " per vertex" << std::endl;
+  }
+  out.unsetf(std::ios::floatfield);
+}
+
+std::size_t MemoryReport::estimateStateBytes(const base::SpaceInformationPtr &si)
+{
+  // The state struct and its values are separate allocations for most spaces
+  return si->getStateSpace()->getSerializationLength() + sizeof(void *) + 2 * ALLOCATION_OVERHEAD;
+}
+
+std::size_t MemoryReport::estimateNearestNeighborsBytes(std::size_t size, std::size_t elementBytes)
+{
+  if (size == 0)
+    return 0;
+
+  // Leaves are on average half full. Elements are stored in the leaves, and again as the pivot of each node
+  const std::size_t numNodes = size / (GNAT_MAX_POINTS_PER_LEAF / 2) + 1;
+  return size * elementBytes + numNodes * (GNAT_NODE_BYTES + elementBytes);
+}
+
+void MemoryTracker::printGrowth(std::ostream &out) const
+{
+  if (history_.size() < 2)
+    return;
+
+  const MemoryReport &first = history_.front();
+  const MemoryReport &last = history_.back();
+  const double verticesAdded = std::max(1.0, double(last.numVertices_) - double(first.numVertices_));
+
+  // Sort components by how much they grew
+  std::vector<std::pair<double, MemoryComponent> > growth;
+  for (std::size_t i = 0; i < NUM_MEMORY_COMPONENTS; ++i)
+  {
+    const MemoryComponent component = static_cast<MemoryComponent>(i);
+    growth.push_back(std::make_pair(double(last.get(component)) - double(first.get(component)), component));
+  }
+  std::sort(growth.rbegin(), growth.rend());
+
+  out << "Memory growth over " << history_.size() << " reports, from " << first.numVertices_ << " to "
+      << last.numVertices_ << " vertices:" << std::endl;
+  for (std::size_t i = 0; i < growth.size(); ++i)
+  {
+    out << "  " << std::left << std::setw(20) << MemoryReport::getComponentName(growth[i].second) << std::right
+        << std::setw(12) << MemoryReport::formatBytes(growth[i].first) << std::setw(12)
+        << MemoryReport::formatBytes(growth[i].first / verticesAdded) << " per vertex added" << std::endl;
+  }
+  out << "  " << std::left << std::setw(20) << "total" << std::right << std::setw(12)
+      << MemoryReport::formatBytes(double(last.getTotal()) - double(first.getTotal())) << std::endl;
+}
+
+bool MemoryTracker::writeCSV(const std::string &filePath) const
+{
+  std::ofstream out(filePath.c_str(), std::ios::out);
+  if (!out.is_open())
+  {
+    OMPL_ERROR("MemoryTracker: Unable to open memory output file %s", filePath.c_str());
+    return false;
+  }
+
+  out << "vertices,edges";
+  for (std::size_t i = 0; i < NUM_MEMORY_COMPONENTS; ++i)
+    out << "," << MemoryReport::getComponentName(static_cast<MemoryComponent>(i));
+  out << ",total\n";
+
+  for (const MemoryReport &report : history_)
+  {
+    out << report.numVertices_ << "," << report.numEdges_;
+    for (std::size_t i = 0; i < NUM_MEMORY_COMPONENTS; ++i)
+      out << "," << report.get(static_cast<MemoryComponent>(i));
+    out << "," << report.getTotal() << "\n";
+  }
+
+  return true;
+}
+
+}  // namespace bolt
+}  // namespace tools
+}  // namespace ompl
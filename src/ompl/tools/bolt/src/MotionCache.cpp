@@ -0,0 +1,197 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2016, University of Colorado, Boulder
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the Univ of CO, Boulder nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+/* Author: Dave Coleman <dave@dav.ee>
+   Desc:   Thread safe cache of the validity of motions between roadmap vertices
+*/
+
+// OMPL
+#include <ompl/tools/bolt/MotionCache.h>
+
+// Boost
+#include <boost/thread/locks.hpp>
+
+// C++
+#include <algorithm>
+
+namespace ompl
+{
+namespace tools
+{
+namespace bolt
+{
+namespace
+{
+std::size_t roundUpToPowerOfTwo(std::size_t n)
+{
+  std::size_t power = 1;
+  while (power < n)
+    power <<= 1;
+  return power;
+}
+}  // namespace
+
+MotionCache::MotionCache(std::size_t numShards) : shards_(roundUpToPowerOfTwo(std::max<std::size_t>(1, numShards)))
+{
+}
+
+void MotionCache::clear()
+{
+  for (std::size_t i = 0; i < shards_.size(); ++i)
+    shards_[i].results_.clear();
+}
+
+std::size_t MotionCache::size() const
+{
+  std::size_t total = 0;
+  for (std::size_t i = 0; i < shards_.size(); ++i)
+  {
+    boost::shared_lock<boost::shared_mutex> lock(shards_[i].mutex_);
+    total += shards_[i].results_.size();
+  }
+  return total;
+}
+
+bool MotionCache::lookup(std::size_t v1, std::size_t v2, bool &valid) const
+{
+  const std::uint64_t key = getKey(v1, v2);
+  const Shard &shard = shards_[getShardIndex(key)];
+  shard.lookups_.fetch_add(1, std::memory_order_relaxed);
+
+  boost::shared_lock<boost::shared_mutex> lock(shard.mutex_);
+  boost::unordered_map<std::uint64_t, bool>::const_iterator it = shard.results_.find(key);
+  if (it == shard.results_.end())
+    return false;
+
+  shard.hits_.fetch_add(1, std::memory_order_relaxed);
+  valid = it->second;
+  return true;
+}
+
+void MotionCache::insert(std::size_t v1, std::size_t v2, bool valid)
+{
+  const std::uint64_t key = getKey(v1, v2);
+  Shard &shard = shards_[getShardIndex(key)];
+
+  boost::lock_guard<boost::shared_mutex> lock(shard.mutex_);
+  shard.results_[key] = valid;
+}
+
+void MotionCache::permute(const std::vector<std::size_t> &newIndex)
+{
+  std::vector<VertexPair> validMotions;
+  std::vector<VertexPair> invalidMotions;
+  getResults(validMotions, invalidMotions);
+  clear();
+
+  for (std::size_t i = 0; i < validMotions.size(); ++i)
+    insert(newIndex[validMotions[i].first], newIndex[validMotions[i].second], true);
+  for (std::size_t i = 0; i < invalidMotions.size(); ++i)
+    insert(newIndex[invalidMotions[i].first], newIndex[invalidMotions[i].second], false);
+}
+
+void MotionCache::getResults(std::vector<VertexPair> &validMotions, std::vector<VertexPair> &invalidMotions) const
+{
+  validMotions.clear();
+  invalidMotions.clear();
+  for (std::size_t i = 0; i < shards_.size(); ++i)
+  {
+    boost::shared_lock<boost::shared_mutex> lock(shards_[i].mutex_);
+    typedef boost::unordered_map<std::uint64_t, bool>::const_iterator Iterator;
+    for (Iterator it = shards_[i].results_.begin(); it != shards_[i].results_.end(); ++it)
+    {
+      const VertexPair motion(it->first >> 32, it->first & 0xFFFFFFFF);
+      if (it->second)
+        validMotions.push_back(motion);
+      else
+        invalidMotions.push_back(motion);
+    }
+  }
+}
+
+std::size_t MotionCache::getNumLookups() const
+{
+  std::size_t total = 0;
+  for (std::size_t i = 0; i < shards_.size(); ++i)
+    total += shards_[i].lookups_.load(std::memory_order_relaxed);
+  return total;
+}
+
+std::size_t MotionCache::getNumHits() const
+{
+  std::size_t total = 0;
+  for (std::size_t i = 0; i < shards_.size(); ++i)
+    total += shards_[i].hits_.load(std::memory_order_relaxed);
+  return total;
+}
+
+double MotionCache::getHitRate() const
+{
+  const std::size_t lookups = getNumLookups();
+  return lookups ? getNumHits() / static_cast<double>(lookups) : 0.0;
+}
+
+void MotionCache::resetCounters()
+{
+  for (std::size_t i = 0; i < shards_.size(); ++i)
+  {
+    shards_[i].lookups_ = 0;
+    shards_[i].hits_ = 0;
+  }
+}
+
+void MotionCache::addToMemoryReport(MemoryReport &report) const
+{
+  std::size_t bytes = shards_.capacity() * sizeof(Shard);
+  for (std::size_t i = 0; i < shards_.size(); ++i)
+    bytes += MemoryReport::estimateHashMapBytes(shards_[i].results_);
+  report.add(MEMORY_MOTION_CACHE, bytes);
+}
+
+std::uint64_t MotionCache::getKey(std::size_t v1, std::size_t v2)
+{
+  if (v1 > v2)
+    std::swap(v1, v2);
+  return static_cast<std::uint64_t>(v1) << 32 | static_cast<std::uint32_t>(v2);
+}
+
+std::size_t MotionCache::getShardIndex(std::uint64_t key) const
+{
+  // Consecutive keys differ in their low bits only, so mix them before choosing the shard
+  return ((key * 0x9E3779B97F4A7C15ULL) >> 40) & (shards_.size() - 1);
+}
+
+}  // namespace bolt
+}  // namespace tools
+}  // namespace ompl
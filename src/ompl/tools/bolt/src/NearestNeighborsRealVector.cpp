@@ -0,0 +1,593 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2016, University of Colorado, Boulder
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the Univ of CO, Boulder nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+/* Author: Dave Coleman <dave@dav.ee>
+   Desc:   Nearest neighbor structures specialized for RealVector state spaces
+*/
+
+// OMPL
+#include <ompl/tools/bolt/NearestNeighborsRealVector.h>
+#include <ompl/datastructures/NearestNeighborsGNAT.h>
+#include <ompl/util/Console.h>
+
+// C++
+#include <algorithm>
+#include <limits>
+
+namespace ompl
+{
+namespace tools
+{
+namespace bolt
+{
+// -------------------------------------------------------------------------------------------------------------------
+// NearestNeighborsRealVector
+// -------------------------------------------------------------------------------------------------------------------
+
+NearestNeighborsRealVector::NearestNeighborsRealVector(std::size_t dimension, const CoordinateFunction &coordinates)
+  : dimension_(dimension), coordinates_(coordinates), kernels_(getDistanceKernels())
+{
+}
+
+const float *NearestNeighborsRealVector::getQuery(std::size_t data, const float *) const
+{
+  static thread_local std::vector<float> query;
+  const double *coordinates = coordinates_(data);
+  query.assign(coordinates, coordinates + dimension_);
+  return &query[0];
+}
+
+template <typename Scalar>
+void NearestNeighborsRealVector::scan(const Scalar *query, const Scalar *points, const std::size_t *ids,
+                                      std::size_t count, ResultSet &results) const
+{
+  const std::size_t CHUNK_SIZE = 64;
+  double distances[CHUNK_SIZE];
+  for (std::size_t begin = 0; begin < count; begin += CHUNK_SIZE)
+  {
+    const std::size_t chunk = std::min(CHUNK_SIZE, count - begin);
+    distanceSquaredBatch(query, points + begin * dimension_, chunk, distances);
+    for (std::size_t i = 0; i < chunk; ++i)
+      results.insert(distances[i], ids[begin + i]);
+  }
+}
+
+NearestNeighborsRealVector::ResultSet::ResultSet(std::size_t k, double radiusSquared)
+  : k_(k), radiusSquared_(radiusSquared)
+{
+}
+
+void NearestNeighborsRealVector::ResultSet::insert(double distanceSquared, std::size_t id)
+{
+  if (distanceSquared > getBound())
+    return;
+
+  // Radius searches keep everything within the radius
+  if (k_ == std::numeric_limits<std::size_t>::max())
+  {
+    results_.push_back(std::make_pair(distanceSquared, id));
+    return;
+  }
+
+  if (results_.size() == k_)
+  {
+    std::pop_heap(results_.begin(), results_.end());
+    results_.back() = std::make_pair(distanceSquared, id);
+  }
+  else
+    results_.push_back(std::make_pair(distanceSquared, id));
+  std::push_heap(results_.begin(), results_.end());
+}
+
+void NearestNeighborsRealVector::ResultSet::getSorted(std::vector<std::size_t> &ids)
+{
+  std::sort(results_.begin(), results_.end());
+  ids.resize(results_.size());
+  for (std::size_t i = 0; i < results_.size(); ++i)
+    ids[i] = results_[i].second;
+}
+
+// -------------------------------------------------------------------------------------------------------------------
+// NearestNeighborsLinearRV
+// -------------------------------------------------------------------------------------------------------------------
+
+template <typename Scalar>
+NearestNeighborsLinearRV<Scalar>::NearestNeighborsLinearRV(std::size_t dimension,
+                                                           const CoordinateFunction &coordinates)
+  : NearestNeighborsRealVector(dimension, coordinates)
+{
+}
+
+template <typename Scalar>
+void NearestNeighborsLinearRV<Scalar>::clear()
+{
+  points_.clear();
+  ids_.clear();
+  slots_.clear();
+}
+
+template <typename Scalar>
+void NearestNeighborsLinearRV<Scalar>::add(const std::size_t &data)
+{
+  const double *coordinates = coordinates_(data);
+  slots_[data] = ids_.size();
+  ids_.push_back(data);
+  points_.insert(points_.end(), coordinates, coordinates + dimension_);
+}
+
+template <typename Scalar>
+void NearestNeighborsLinearRV<Scalar>::add(const std::vector<std::size_t> &data)
+{
+  ids_.reserve(ids_.size() + data.size());
+  points_.reserve(points_.size() + data.size() * dimension_);
+  for (std::size_t i = 0; i < data.size(); ++i)
+    add(data[i]);
+}
+
+template <typename Scalar>
+bool NearestNeighborsLinearRV<Scalar>::remove(const std::size_t &data)
+{
+  boost::unordered_map<std::size_t, std::size_t>::iterator it = slots_.find(data);
+  if (it == slots_.end())
+    return false;
+
+  // Move the last element into the hole
+  const std::size_t slot = it->second;
+  const std::size_t last = ids_.size() - 1;
+  if (slot != last)
+  {
+    ids_[slot] = ids_[last];
+    std::copy(points_.begin() + last * dimension_, points_.begin() + (last + 1) * dimension_,
+              points_.begin() + slot * dimension_);
+    slots_[ids_[slot]] = slot;
+  }
+  ids_.pop_back();
+  points_.resize(last * dimension_);
+  slots_.erase(it);
+  return true;
+}
+
+template <typename Scalar>
+std::size_t NearestNeighborsLinearRV<Scalar>::nearest(const std::size_t &data) const
+{
+  ResultSet results(1, std::numeric_limits<double>::infinity());
+  search(getQuery(data, static_cast<const Scalar *>(nullptr)), results);
+
+  std::vector<std::size_t> nbh;
+  results.getSorted(nbh);
+  if (nbh.empty())
+    throw Exception("No elements found in nearest neighbors data structure");
+  return nbh.front();
+}
+
+template <typename Scalar>
+void NearestNeighborsLinearRV<Scalar>::nearestK(const std::size_t &data, std::size_t k,
+                                                std::vector<std::size_t> &nbh) const
+{
+  nbh.clear();
+  if (k == 0)
+    return;
+  ResultSet results(k, std::numeric_limits<double>::infinity());
+  search(getQuery(data, static_cast<const Scalar *>(nullptr)), results);
+  results.getSorted(nbh);
+}
+
+template <typename Scalar>
+void NearestNeighborsLinearRV<Scalar>::nearestR(const std::size_t &data, double radius,
+                                                std::vector<std::size_t> &nbh) const
+{
+  ResultSet results(std::numeric_limits<std::size_t>::max(), radius * radius);
+  search(getQuery(data, static_cast<const Scalar *>(nullptr)), results);
+  results.getSorted(nbh);
+}
+
+template <typename Scalar>
+std::size_t NearestNeighborsLinearRV<Scalar>::size() const
+{
+  return ids_.size();
+}
+
+template <typename Scalar>
+void NearestNeighborsLinearRV<Scalar>::list(std::vector<std::size_t> &data) const
+{
+  data = ids_;
+}
+
+template <typename Scalar>
+std::size_t NearestNeighborsLinearRV<Scalar>::getMemoryBytes() const
+{
+  return sizeof(*this) + points_.capacity() * sizeof(Scalar) + ids_.capacity() * sizeof(std::size_t) +
+         slots_.bucket_count() * sizeof(void *) + slots_.size() * (2 * sizeof(std::size_t) + sizeof(void *));
+}
+
+template <typename Scalar>
+void NearestNeighborsLinearRV<Scalar>::search(const Scalar *query, ResultSet &results) const
+{
+  if (!ids_.empty())
+    scan(query, &points_[0], &ids_[0], ids_.size(), results);
+}
+
+// -------------------------------------------------------------------------------------------------------------------
+// NearestNeighborsKDTreeRV
+// -------------------------------------------------------------------------------------------------------------------
+
+template <typename Scalar>
+const std::size_t NearestNeighborsKDTreeRV<Scalar>::LEAF_SIZE;
+template <typename Scalar>
+const std::size_t NearestNeighborsKDTreeRV<Scalar>::BUFFER_FLAG;
+
+template <typename Scalar>
+NearestNeighborsKDTreeRV<Scalar>::NearestNeighborsKDTreeRV(std::size_t dimension,
+                                                           const CoordinateFunction &coordinates)
+  : NearestNeighborsRealVector(dimension, coordinates)
+{
+}
+
+template <typename Scalar>
+void NearestNeighborsKDTreeRV<Scalar>::clear()
+{
+  nodes_.clear();
+  treePoints_.clear();
+  treeIds_.clear();
+  alive_.clear();
+  numDead_ = 0;
+  bufferPoints_.clear();
+  bufferIds_.clear();
+  locations_.clear();
+}
+
+template <typename Scalar>
+void NearestNeighborsKDTreeRV<Scalar>::add(const std::size_t &data)
+{
+  const double *coordinates = coordinates_(data);
+  locations_[data] = bufferIds_.size() | BUFFER_FLAG;
+  bufferIds_.push_back(data);
+  bufferPoints_.insert(bufferPoints_.end(), coordinates, coordinates + dimension_);
+  maintain();
+}
+
+template <typename Scalar>
+void NearestNeighborsKDTreeRV<Scalar>::add(const std::vector<std::size_t> &data)
+{
+  // Rebuild once at the end rather than every time the buffer fills up
+  for (std::size_t i = 0; i < data.size(); ++i)
+  {
+    const double *coordinates = coordinates_(data[i]);
+    locations_[data[i]] = bufferIds_.size() | BUFFER_FLAG;
+    bufferIds_.push_back(data[i]);
+    bufferPoints_.insert(bufferPoints_.end(), coordinates, coordinates + dimension_);
+  }
+  maintain();
+}
+
+template <typename Scalar>
+bool NearestNeighborsKDTreeRV<Scalar>::remove(const std::size_t &data)
+{
+  boost::unordered_map<std::size_t, std::size_t>::iterator it = locations_.find(data);
+  if (it == locations_.end())
+    return false;
+
+  const std::size_t location = it->second;
+  locations_.erase(it);
+
+  if (location & BUFFER_FLAG)
+  {
+    // Move the last buffered element into the hole
+    const std::size_t slot = location & ~BUFFER_FLAG;
+    const std::size_t last = bufferIds_.size() - 1;
+    if (slot != last)
+    {
+      bufferIds_[slot] = bufferIds_[last];
+      std::copy(bufferPoints_.begin() + last * dimension_, bufferPoints_.begin() + (last + 1) * dimension_,
+                bufferPoints_.begin() + slot * dimension_);
+      locations_[bufferIds_[slot]] = slot | BUFFER_FLAG;
+    }
+    bufferIds_.pop_back();
+    bufferPoints_.resize(last * dimension_);
+  }
+  else
+  {
+    alive_[location] = 0;
+    numDead_++;
+  }
+
+  maintain();
+  return true;
+}
+
+template <typename Scalar>
+std::size_t NearestNeighborsKDTreeRV<Scalar>::nearest(const std::size_t &data) const
+{
+  ResultSet results(1, std::numeric_limits<double>::infinity());
+  search(getQuery(data, static_cast<const Scalar *>(nullptr)), results);
+
+  std::vector<std::size_t> nbh;
+  results.getSorted(nbh);
+  if (nbh.empty())
+    throw Exception("No elements found in nearest neighbors data structure");
+  return nbh.front();
+}
+
+template <typename Scalar>
+void NearestNeighborsKDTreeRV<Scalar>::nearestK(const std::size_t &data, std::size_t k,
+                                                std::vector<std::size_t> &nbh) const
+{
+  nbh.clear();
+  if (k == 0)
+    return;
+  ResultSet results(k, std::numeric_limits<double>::infinity());
+  search(getQuery(data, static_cast<const Scalar *>(nullptr)), results);
+  results.getSorted(nbh);
+}
+
+template <typename Scalar>
+void NearestNeighborsKDTreeRV<Scalar>::nearestR(const std::size_t &data, double radius,
+                                                std::vector<std::size_t> &nbh) const
+{
+  ResultSet results(std::numeric_limits<std::size_t>::max(), radius * radius);
+  search(getQuery(data, static_cast<const Scalar *>(nullptr)), results);
+  results.getSorted(nbh);
+}
+
+template <typename Scalar>
+std::size_t NearestNeighborsKDTreeRV<Scalar>::size() const
+{
+  return treeIds_.size() - numDead_ + bufferIds_.size();
+}
+
+template <typename Scalar>
+void NearestNeighborsKDTreeRV<Scalar>::list(std::vector<std::size_t> &data) const
+{
+  data.clear();
+  data.reserve(size());
+  for (std::size_t i = 0; i < treeIds_.size(); ++i)
+    if (alive_[i])
+      data.push_back(treeIds_[i]);
+  data.insert(data.end(), bufferIds_.begin(), bufferIds_.end());
+}
+
+template <typename Scalar>
+std::size_t NearestNeighborsKDTreeRV<Scalar>::getMemoryBytes() const
+{
+  return sizeof(*this) + nodes_.capacity() * sizeof(Node) +
+         (treePoints_.capacity() + bufferPoints_.capacity()) * sizeof(Scalar) +
+         (treeIds_.capacity() + bufferIds_.capacity()) * sizeof(std::size_t) + alive_.capacity() +
+         locations_.bucket_count() * sizeof(void *) + locations_.size() * (2 * sizeof(std::size_t) + sizeof(void *));
+}
+
+template <typename Scalar>
+void NearestNeighborsKDTreeRV<Scalar>::search(const Scalar *query, ResultSet &results) const
+{
+  // Recently added elements
+  if (!bufferIds_.empty())
+    scan(query, &bufferPoints_[0], &bufferIds_[0], bufferIds_.size(), results);
+
+  if (nodes_.empty())
+    return;
+
+  // Depth first, nearer child first, pruning by the distance to the splitting plane
+  std::vector<std::pair<std::size_t, double> > stack;  // node and lower bound on the distance to it
+  stack.reserve(64);
+  stack.push_back(std::make_pair(std::size_t(0), 0.0));
+  while (!stack.empty())
+  {
+    const std::size_t nodeID = stack.back().first;
+    const double lowerBound = stack.back().second;
+    stack.pop_back();
+    if (lowerBound > results.getBound())
+      continue;
+
+    const Node &node = nodes_[nodeID];
+    if (node.left_ == 0)  // leaf
+    {
+      double distances[LEAF_SIZE];
+      distanceSquaredBatch(query, &treePoints_[node.begin_ * dimension_], node.end_ - node.begin_, distances);
+      for (std::size_t i = node.begin_; i < node.end_; ++i)
+        if (alive_[i])
+          results.insert(distances[i - node.begin_], treeIds_[i]);
+      continue;
+    }
+
+    const double diff = query[node.splitDimension_] - node.splitValue_;
+    const std::size_t nearChild = diff < 0 ? node.left_ : node.right_;
+    const std::size_t farChild = diff < 0 ? node.right_ : node.left_;
+    stack.push_back(std::make_pair(farChild, std::max(lowerBound, diff * diff)));
+    stack.push_back(std::make_pair(nearChild, lowerBound));
+  }
+}
+
+template <typename Scalar>
+void NearestNeighborsKDTreeRV<Scalar>::maintain()
+{
+  const std::size_t treeSize = treeIds_.size();
+  if (bufferIds_.size() > std::max(LEAF_SIZE * 2, treeSize / 4) || (numDead_ > LEAF_SIZE && numDead_ > treeSize / 4))
+    rebuild();
+}
+
+template <typename Scalar>
+void NearestNeighborsKDTreeRV<Scalar>::rebuild()
+{
+  // Gather everything that is still present
+  std::vector<Scalar> points;
+  std::vector<std::size_t> ids;
+  points.reserve((treeIds_.size() - numDead_ + bufferIds_.size()) * dimension_);
+  ids.reserve(treeIds_.size() - numDead_ + bufferIds_.size());
+  for (std::size_t i = 0; i < treeIds_.size(); ++i)
+  {
+    if (!alive_[i])
+      continue;
+    ids.push_back(treeIds_[i]);
+    points.insert(points.end(), treePoints_.begin() + i * dimension_, treePoints_.begin() + (i + 1) * dimension_);
+  }
+  ids.insert(ids.end(), bufferIds_.begin(), bufferIds_.end());
+  points.insert(points.end(), bufferPoints_.begin(), bufferPoints_.end());
+
+  bufferIds_.clear();
+  bufferPoints_.clear();
+  nodes_.clear();
+  numDead_ = 0;
+
+  std::vector<std::size_t> order(ids.size());
+  for (std::size_t i = 0; i < order.size(); ++i)
+    order[i] = i;
+  if (!order.empty())
+  {
+    nodes_.reserve(2 * order.size() / LEAF_SIZE + 1);
+    build(order, 0, order.size(), points);
+  }
+
+  // Store the elements in tree order, so leaves are contiguous in memory
+  treeIds_.resize(ids.size());
+  treePoints_.resize(points.size());
+  alive_.assign(ids.size(), 1);
+  for (std::size_t i = 0; i < order.size(); ++i)
+  {
+    treeIds_[i] = ids[order[i]];
+    std::copy(points.begin() + order[i] * dimension_, points.begin() + (order[i] + 1) * dimension_,
+              treePoints_.begin() + i * dimension_);
+    locations_[treeIds_[i]] = i;
+  }
+}
+
+template <typename Scalar>
+std::size_t NearestNeighborsKDTreeRV<Scalar>::build(std::vector<std::size_t> &order, std::size_t begin, std::size_t end,
+                                                    const std::vector<Scalar> &points)
+{
+  const std::size_t nodeID = nodes_.size();
+  nodes_.push_back(Node());
+  nodes_[nodeID].begin_ = begin;
+  nodes_[nodeID].end_ = end;
+  nodes_[nodeID].left_ = 0;
+  nodes_[nodeID].right_ = 0;
+  nodes_[nodeID].splitDimension_ = 0;
+  nodes_[nodeID].splitValue_ = 0;
+
+  if (end - begin <= LEAF_SIZE)
+    return nodeID;
+
+  // Split the dimension with the largest spread at the median
+  std::size_t splitDimension = 0;
+  double maxSpread = -1;
+  for (std::size_t d = 0; d < dimension_; ++d)
+  {
+    double low = std::numeric_limits<double>::infinity();
+    double high = -std::numeric_limits<double>::infinity();
+    for (std::size_t i = begin; i < end; ++i)
+    {
+      const double value = points[order[i] * dimension_ + d];
+      low = std::min(low, value);
+      high = std::max(high, value);
+    }
+    if (high - low > maxSpread)
+    {
+      maxSpread = high - low;
+      splitDimension = d;
+    }
+  }
+
+  const std::size_t middle = begin + (end - begin) / 2;
+  std::nth_element(order.begin() + begin, order.begin() + middle, order.begin() + end,
+                   [&](std::size_t a, std::size_t b)
+                   {
+                     return points[a * dimension_ + splitDimension] < points[b * dimension_ + splitDimension];
+                   });
+
+  nodes_[nodeID].splitDimension_ = splitDimension;
+  nodes_[nodeID].splitValue_ = points[order[middle] * dimension_ + splitDimension];
+
+  // Elements left of middle are <= split value, the rest >=, so either side of a tie may hold equal values
+  const std::size_t left = build(order, begin, middle, points);
+  const std::size_t right = build(order, middle, end, points);
+  nodes_[nodeID].left_ = left;
+  nodes_[nodeID].right_ = right;
+  return nodeID;
+}
+
+template class NearestNeighborsLinearRV<double>;
+template class NearestNeighborsLinearRV<float>;
+template class NearestNeighborsKDTreeRV<double>;
+template class NearestNeighborsKDTreeRV<float>;
+
+// -------------------------------------------------------------------------------------------------------------------
+// Factory
+// -------------------------------------------------------------------------------------------------------------------
+
+NearestNeighbors<std::size_t> *allocNearestNeighbors(NearestNeighborsType type, const base::StateSpacePtr &space,
+                                                     const CoordinateFunction &coordinates)
+{
+  if (type != NN_GNAT && !isEuclideanSpace(space))
+  {
+    OMPL_WARN("Nearest neighbors type %s requires a plain RealVectorStateSpace, using GNAT instead",
+              getNearestNeighborsName(type).c_str());
+    type = NN_GNAT;
+  }
+
+  switch (type)
+  {
+    case NN_KDTREE:
+      return new NearestNeighborsKDTreeRV<double>(space->getDimension(), coordinates);
+    case NN_LINEAR:
+      return new NearestNeighborsLinearRV<double>(space->getDimension(), coordinates);
+    case NN_KDTREE_FLOAT:
+      return new NearestNeighborsKDTreeRV<float>(space->getDimension(), coordinates);
+    case NN_LINEAR_FLOAT:
+      return new NearestNeighborsLinearRV<float>(space->getDimension(), coordinates);
+    case NN_GNAT:
+    default:
+      return new NearestNeighborsGNAT<std::size_t>();
+  }
+}
+
+std::string getNearestNeighborsName(NearestNeighborsType type)
+{
+  switch (type)
+  {
+    case NN_GNAT:
+      return "gnat";
+    case NN_KDTREE:
+      return "kdtree";
+    case NN_LINEAR:
+      return "linear";
+    case NN_KDTREE_FLOAT:
+      return "kdtree_f32";
+    case NN_LINEAR_FLOAT:
+      return "linear_f32";
+    default:
+      return "unknown";
+  }
+}
+
+}  // namespace bolt
+}  // namespace tools
+}  // namespace ompl
@@ -0,0 +1,365 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2016, University of Colorado, Boulder
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the Univ of CO, Boulder nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+/* Author: Dave Coleman <dave@dav.ee>
+   Desc:   Per-query records and latency histograms of experience planning
+*/
+
+// OMPL
+#include <ompl/tools/bolt/QueryLog.h>
+#include <ompl/util/Console.h>
+
+// C++
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <limits>
+
+namespace ompl
+{
+namespace tools
+{
+namespace bolt
+{
+namespace
+{
+/** \brief Values below this many microseconds get their own bucket */
+const std::size_t LINEAR_BUCKETS = 128;
+
+/** \brief Number of buckets each following power of two is divided into */
+const std::size_t SUB_BUCKETS = LINEAR_BUCKETS / 2;
+
+/** \brief Largest value kept apart, about 19 hours. Larger values are counted in the last bucket */
+const std::uint64_t MAX_MICROS = (std::uint64_t(1) << 36) - 1;
+
+/** \brief Percentiles shown in the reports */
+const double PERCENTILES[] = {0.5, 0.9, 0.99, 0.999};
+const char *PERCENTILE_NAMES[] = {"p50", "p90", "p99", "p999"};
+const std::size_t NUM_PERCENTILES = 4;
+
+std::size_t getHighestBit(std::uint64_t value)
+{
+  std::size_t bit = 0;
+  while (value >>= 1)
+    ++bit;
+  return bit;
+}
+}  // namespace
+
+// -------------------------------------------------------------------------------------------------
+// LatencyHistogram
+// -------------------------------------------------------------------------------------------------
+
+LatencyHistogram::LatencyHistogram() : counts_(getBucket(MAX_MICROS) + 1, 0)
+{
+  reset();
+}
+
+void LatencyHistogram::reset()
+{
+  std::fill(counts_.begin(), counts_.end(), 0);
+  count_ = 0;
+  min_ = std::numeric_limits<std::uint64_t>::max();
+  max_ = 0;
+  total_ = 0;
+}
+
+void LatencyHistogram::record(double seconds)
+{
+  const double micros = std::max(0.0, seconds * 1e6);
+  const std::uint64_t value = micros >= MAX_MICROS ? MAX_MICROS : static_cast<std::uint64_t>(std::llround(micros));
+
+  counts_[getBucket(value)]++;
+  count_++;
+  min_ = std::min(min_, value);
+  max_ = std::max(max_, value);
+  total_ += micros;
+}
+
+void LatencyHistogram::merge(const LatencyHistogram &other)
+{
+  for (std::size_t i = 0; i < counts_.size(); ++i)
+    counts_[i] += other.counts_[i];
+  count_ += other.count_;
+  min_ = std::min(min_, other.min_);
+  max_ = std::max(max_, other.max_);
+  total_ += other.total_;
+}
+
+double LatencyHistogram::getMin() const
+{
+  return count_ ? min_ * 1e-6 : 0.0;
+}
+
+double LatencyHistogram::getMax() const
+{
+  return max_ * 1e-6;
+}
+
+double LatencyHistogram::getMean() const
+{
+  return count_ ? total_ / count_ * 1e-6 : 0.0;
+}
+
+double LatencyHistogram::getPercentile(double fraction) const
+{
+  if (!count_)
+    return 0.0;
+  if (fraction <= 0.0)
+    return getMin();
+
+  // Rank of the value that the percentile refers to, starting at 1
+  const std::size_t rank =
+      std::max<std::size_t>(1, static_cast<std::size_t>(std::ceil(std::min(fraction, 1.0) * count_)));
+
+  std::size_t seen = 0;
+  for (std::size_t bucket = 0; bucket < counts_.size(); ++bucket)
+  {
+    seen += counts_[bucket];
+    if (seen >= rank)
+      return std::min(getBucketUpperBound(bucket), max_) * 1e-6;
+  }
+  return getMax();
+}
+
+std::size_t LatencyHistogram::getBucket(std::uint64_t micros)
+{
+  if (micros < LINEAR_BUCKETS)
+    return micros;
+
+  // Keep the 7 most significant bits, the highest of which is implied by the power of two
+  const std::size_t shift = getHighestBit(micros) - getHighestBit(LINEAR_BUCKETS) + 1;
+  return (shift + 1) * SUB_BUCKETS + (micros >> shift) - SUB_BUCKETS;
+}
+
+std::uint64_t LatencyHistogram::getBucketUpperBound(std::size_t bucket)
+{
+  if (bucket < LINEAR_BUCKETS)
+    return bucket;
+
+  const std::size_t shift = bucket / SUB_BUCKETS - 1;
+  const std::uint64_t lowerBound = static_cast<std::uint64_t>(bucket % SUB_BUCKETS + SUB_BUCKETS) << shift;
+  return lowerBound + (std::uint64_t(1) << shift) - 1;
+}
+
+// -------------------------------------------------------------------------------------------------
+// QueryLog
+// -------------------------------------------------------------------------------------------------
+
+QueryLog::QueryLog(std::size_t maxRecords) : maxRecords_(maxRecords)
+{
+}
+
+void QueryLog::reset()
+{
+  boost::lock_guard<boost::mutex> lock(mutex_);
+  numQueries_ = 0;
+  records_.clear();
+  for (std::size_t i = 0; i < NUM_QUERY_PHASES; ++i)
+  {
+    histograms_[i].reset();
+    solvedHistograms_[i].reset();
+  }
+}
+
+void QueryLog::addRecord(QueryRecord record)
+{
+  boost::lock_guard<boost::mutex> lock(mutex_);
+  record.id_ = numQueries_++;
+
+  for (std::size_t i = 0; i < NUM_QUERY_PHASES; ++i)
+  {
+    histograms_[i].record(record.phaseTimes_[i]);
+    if (record.solved_)
+      solvedHistograms_[i].record(record.phaseTimes_[i]);
+  }
+
+  if (maxRecords_ == 0)
+    return;
+  if (records_.size() >= maxRecords_)
+    records_.pop_front();
+  records_.push_back(record);
+}
+
+std::size_t QueryLog::getNumQueries() const
+{
+  boost::lock_guard<boost::mutex> lock(mutex_);
+  return numQueries_;
+}
+
+std::vector<QueryRecord> QueryLog::getRecords() const
+{
+  boost::lock_guard<boost::mutex> lock(mutex_);
+  return std::vector<QueryRecord>(records_.begin(), records_.end());
+}
+
+LatencyHistogram QueryLog::getHistogram(QueryPhase phase, bool solvedOnly) const
+{
+  boost::lock_guard<boost::mutex> lock(mutex_);
+  return solvedOnly ? solvedHistograms_[phase] : histograms_[phase];
+}
+
+std::string QueryLog::getPhaseName(QueryPhase phase)
+{
+  switch (phase)
+  {
+    case QUERY_TOTAL:
+      return "total";
+    case QUERY_NEIGHBOR_SEARCH:
+      return "neighbor_search";
+    case QUERY_VISIBILITY:
+      return "visibility";
+    case QUERY_ASTAR:
+      return "astar";
+    case QUERY_LAZY_CHECK:
+      return "lazy_check";
+    case QUERY_SIMPLIFICATION:
+      return "simplification";
+    default:
+      return "unknown";
+  }
+}
+
+void QueryLog::print(std::ostream &out) const
+{
+  boost::lock_guard<boost::mutex> lock(mutex_);
+
+  const std::size_t numSolved = solvedHistograms_[QUERY_TOTAL].getCount();
+  out << "Query latency over " << numQueries_ << " queries (" << numSolved << " solved), in milliseconds:"
+      << std::endl;
+  out << "  " << std::left << std::setw(18) << "phase" << std::right;
+  for (std::size_t i = 0; i < NUM_PERCENTILES; ++i)
+    out << std::setw(10) << PERCENTILE_NAMES[i];
+  out << std::setw(10) << "max" << std::setw(10) << "mean" << std::endl;
+
+  out << std::fixed << std::setprecision(3);
+  for (std::size_t i = 0; i < NUM_QUERY_PHASES; ++i)
+  {
+    const LatencyHistogram &histogram = histograms_[i];
+    out << "  " << std::left << std::setw(18) << getPhaseName(static_cast<QueryPhase>(i)) << std::right;
+    for (std::size_t j = 0; j < NUM_PERCENTILES; ++j)
+      out << std::setw(10) << histogram.getPercentile(PERCENTILES[j]) * 1000.0;
+    out << std::setw(10) << histogram.getMax() * 1000.0 << std::setw(10) << histogram.getMean() * 1000.0
+        << std::endl;
+  }
+  out.unsetf(std::ios::floatfield);
+}
+
+void QueryLog::writeHistogramJSON(std::ostream &out, const LatencyHistogram &histogram) const
+{
+  out << "{\"count\": " << histogram.getCount() << ", \"min\": " << histogram.getMin()
+      << ", \"mean\": " << histogram.getMean() << ", \"max\": " << histogram.getMax();
+  for (std::size_t i = 0; i < NUM_PERCENTILES; ++i)
+    out << ", \"" << PERCENTILE_NAMES[i] << "\": " << histogram.getPercentile(PERCENTILES[i]);
+  out << "}";
+}
+
+bool QueryLog::writeJSON(const std::string &filePath) const
+{
+  std::ofstream out(filePath.c_str(), std::ios::out);
+  if (!out.is_open())
+  {
+    OMPL_ERROR("%s: Unable to open query log output file %s", name_.c_str(), filePath.c_str());
+    return false;
+  }
+
+  boost::lock_guard<boost::mutex> lock(mutex_);
+  out << std::setprecision(10);
+  out << "{\n";
+  out << "  \"num_queries\": " << numQueries_ << ",\n";
+  out << "  \"latency\": {";
+  for (std::size_t i = 0; i < NUM_QUERY_PHASES; ++i)
+  {
+    out << (i == 0 ? "\n" : ",\n") << "    \"" << getPhaseName(static_cast<QueryPhase>(i)) << "\": {\"all\": ";
+    writeHistogramJSON(out, histograms_[i]);
+    out << ", \"solved\": ";
+    writeHistogramJSON(out, solvedHistograms_[i]);
+    out << "}";
+  }
+  out << "\n  },\n";
+  out << "  \"queries\": [";
+  for (std::size_t i = 0; i < records_.size(); ++i)
+  {
+    const QueryRecord &record = records_[i];
+    out << (i == 0 ? "\n" : ",\n") << "    {\"id\": " << record.id_ << ", \"status\": \"" << record.status_
+        << "\", \"solved\": " << (record.solved_ ? "true" : "false");
+    for (std::size_t j = 0; j < NUM_QUERY_PHASES; ++j)
+      out << ", \"" << getPhaseName(static_cast<QueryPhase>(j)) << "\": " << record.phaseTimes_[j];
+    out << ", \"astar_searches\": " << record.astarSearches_ << ", \"lazy_check_rounds\": " << record.lazyCheckRounds_
+        << ", \"visibility_checks\": " << record.visibilityChecks_ << ", \"nodes_opened\": " << record.nodesOpened_
+        << ", \"nodes_closed\": " << record.nodesClosed_ << ", \"state_checks\": " << record.stateChecks_
+        << ", \"motion_checks\": " << record.motionChecks_ << ", \"solution_states\": " << record.solutionStates_
+        << ", \"graph_vertices\": " << record.graphVertices_ << ", \"graph_edges\": " << record.graphEdges_ << "}";
+  }
+  out << "\n  ]\n";
+  out << "}\n";
+
+  return true;
+}
+
+bool QueryLog::writeCSV(const std::string &filePath) const
+{
+  std::ofstream out(filePath.c_str(), std::ios::out);
+  if (!out.is_open())
+  {
+    OMPL_ERROR("%s: Unable to open query log output file %s", name_.c_str(), filePath.c_str());
+    return false;
+  }
+
+  boost::lock_guard<boost::mutex> lock(mutex_);
+  out << std::setprecision(10);
+  out << "id,status,solved";
+  for (std::size_t i = 0; i < NUM_QUERY_PHASES; ++i)
+    out << "," << getPhaseName(static_cast<QueryPhase>(i));
+  out << ",astar_searches,lazy_check_rounds,visibility_checks,nodes_opened,nodes_closed,state_checks,motion_checks,"
+         "solution_states,graph_vertices,graph_edges\n";
+
+  for (const QueryRecord &record : records_)
+  {
+    out << record.id_ << "," << record.status_ << "," << record.solved_;
+    for (std::size_t i = 0; i < NUM_QUERY_PHASES; ++i)
+      out << "," << record.phaseTimes_[i];
+    out << "," << record.astarSearches_ << "," << record.lazyCheckRounds_ << "," << record.visibilityChecks_ << ","
+        << record.nodesOpened_ << "," << record.nodesClosed_ << "," << record.stateChecks_ << ","
+        << record.motionChecks_ << "," << record.solutionStates_ << "," << record.graphVertices_ << ","
+        << record.graphEdges_ << "\n";
+  }
+
+  return true;
+}
+
+}  // namespace bolt
+}  // namespace tools
+}  // namespace ompl
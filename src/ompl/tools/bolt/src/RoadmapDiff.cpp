@@ -0,0 +1,323 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2016, University of Colorado, Boulder
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the Univ of CO, Boulder nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+/* Author: Dave Coleman <dave@dav.ee>
+   Desc:   Structural difference between two saved roadmaps, which can be stored and applied as a delta
+*/
+
+// OMPL
+#include <ompl/tools/bolt/RoadmapDiff.h>
+#include <ompl/tools/bolt/Debug.h>
+#include <ompl/datastructures/NearestNeighborsGNAT.h>
+#include <ompl/util/Console.h>
+
+// Boost
+#include <boost/bind.hpp>
+
+// C++
+#include <algorithm>
+#include <limits>
+#include <set>
+
+namespace ompl
+{
+namespace tools
+{
+namespace bolt
+{
+namespace
+{
+/** \brief Index of the query state in the nearest neighbor structure */
+const std::size_t QUERY_INDEX = std::numeric_limits<std::size_t>::max();
+
+/** \brief Marker at the start of a delta file */
+const boost::uint32_t ROADMAP_DELTA_MARKER = 0x5244454C;  // spells RDEL
+
+typedef std::pair<std::size_t, std::size_t> EdgeKey;
+
+EdgeKey makeEdgeKey(std::size_t v1, std::size_t v2)
+{
+  return v1 < v2 ? EdgeKey(v1, v2) : EdgeKey(v2, v1);
+}
+}  // namespace
+
+RoadmapDiff::RoadmapDiff(base::SpaceInformationPtr si) : si_(si), storage_(si, nullptr)
+{
+}
+
+bool RoadmapDiff::compute(const std::string &oldFilePath, const std::string &newFilePath, std::size_t indent)
+{
+  BOLT_FUNC(indent, true, "compute() from " << oldFilePath << " to " << newFilePath);
+
+  std::vector<SparseStorage::BoltVertexData> oldVertices, newVertices;
+  std::vector<SparseStorage::BoltEdgeData> oldEdges, newEdges;
+  if (!storage_.read(oldFilePath, oldVertices, oldEdges, indent + 2) ||
+      !storage_.read(newFilePath, newVertices, newEdges, indent + 2))
+    return false;
+
+  delta_ = RoadmapDelta();
+  delta_.marker_ = ROADMAP_DELTA_MARKER;
+  si_->getStateSpace()->computeSignature(delta_.signature_);
+  delta_.numOldVertices_ = oldVertices.size();
+
+  // Index the old vertices
+  const base::StateSpacePtr &space = si_->getStateSpace();
+  clearStates();
+  oldStates_.resize(oldVertices.size());
+  std::vector<std::size_t> indices(oldVertices.size());
+  for (std::size_t i = 0; i < oldVertices.size(); ++i)
+  {
+    oldStates_[i] = space->allocState();
+    space->deserialize(oldStates_[i], &oldVertices[i].stateSerialized_[0]);
+    indices[i] = i;
+  }
+  NearestNeighborsGNAT<std::size_t> nn;
+  nn.setDistanceFunction(boost::bind(&RoadmapDiff::distanceFunction, this, _1, _2));
+  nn.add(indices);
+
+  // Match every new vertex to the closest old vertex within tolerance that is not matched yet
+  std::vector<bool> matched(oldVertices.size(), false);
+  std::vector<std::size_t> newToDelta(newVertices.size());
+  std::vector<std::size_t> neighbors;
+  queryState_ = space->allocState();
+  for (std::size_t i = 0; i < newVertices.size(); ++i)
+  {
+    space->deserialize(queryState_, &newVertices[i].stateSerialized_[0]);
+    nn.nearestR(QUERY_INDEX, tolerance_, neighbors);
+
+    std::vector<std::size_t>::const_iterator match = neighbors.begin();
+    while (match != neighbors.end() && matched[*match])
+      ++match;
+
+    if (match != neighbors.end())
+    {
+      matched[*match] = true;
+      newToDelta[i] = *match;
+    }
+    else
+    {
+      newToDelta[i] = oldVertices.size() + delta_.addedVertices_.size();
+      delta_.addedVertices_.push_back(newVertices[i]);
+    }
+  }
+  clearStates();
+
+  for (std::size_t i = 0; i < matched.size(); ++i)
+    if (!matched[i])
+      delta_.removedVertices_.push_back(i);
+
+  // Compare edges in the numbering of the delta
+  std::set<EdgeKey> oldEdgeSet;
+  for (std::size_t i = 0; i < oldEdges.size(); ++i)
+    oldEdgeSet.insert(makeEdgeKey(oldEdges[i].endpoints_.first, oldEdges[i].endpoints_.second));
+
+  std::set<EdgeKey> newEdgeSet;
+  for (std::size_t i = 0; i < newEdges.size(); ++i)
+  {
+    const EdgeKey key =
+        makeEdgeKey(newToDelta[newEdges[i].endpoints_.first], newToDelta[newEdges[i].endpoints_.second]);
+    newEdgeSet.insert(key);
+    if (oldEdgeSet.count(key))
+      continue;
+
+    SparseStorage::BoltEdgeData edgeData = newEdges[i];
+    edgeData.endpoints_ = std::make_pair(key.first, key.second);
+    delta_.addedEdges_.push_back(edgeData);
+  }
+
+  // Edges of removed vertices are implied
+  for (std::set<EdgeKey>::const_iterator it = oldEdgeSet.begin(); it != oldEdgeSet.end(); ++it)
+    if (matched[it->first] && matched[it->second] && !newEdgeSet.count(*it))
+      delta_.removedEdges_.push_back(std::make_pair(it->first, it->second));
+
+  return true;
+}
+
+bool RoadmapDiff::apply(const std::string &oldFilePath, const std::string &newFilePath, std::size_t indent)
+{
+  BOLT_FUNC(indent, true, "apply() to " << oldFilePath << " writing " << newFilePath);
+
+  std::vector<SparseStorage::BoltVertexData> oldVertices;
+  std::vector<SparseStorage::BoltEdgeData> oldEdges;
+  if (!storage_.read(oldFilePath, oldVertices, oldEdges, indent + 2))
+    return false;
+
+  if (oldVertices.size() != delta_.numOldVertices_)
+  {
+    OMPL_ERROR("%s: Delta expects %u vertices in the old roadmap but found %u", name_.c_str(),
+               static_cast<unsigned int>(delta_.numOldVertices_), static_cast<unsigned int>(oldVertices.size()));
+    return false;
+  }
+
+  // Renumber: kept old vertices first, then the added ones
+  const std::size_t removed = std::numeric_limits<std::size_t>::max();
+  std::vector<std::size_t> deltaToNew(oldVertices.size() + delta_.addedVertices_.size(), 0);
+  for (std::size_t i = 0; i < delta_.removedVertices_.size(); ++i)
+    deltaToNew[delta_.removedVertices_[i]] = removed;
+
+  std::vector<SparseStorage::BoltVertexData> newVertices;
+  newVertices.reserve(deltaToNew.size() - delta_.removedVertices_.size());
+  for (std::size_t i = 0; i < oldVertices.size(); ++i)
+  {
+    if (deltaToNew[i] == removed)
+      continue;
+    deltaToNew[i] = newVertices.size();
+    newVertices.push_back(oldVertices[i]);
+  }
+  for (std::size_t i = 0; i < delta_.addedVertices_.size(); ++i)
+  {
+    deltaToNew[oldVertices.size() + i] = newVertices.size();
+    newVertices.push_back(delta_.addedVertices_[i]);
+  }
+
+  std::set<EdgeKey> removedEdgeSet;
+  for (std::size_t i = 0; i < delta_.removedEdges_.size(); ++i)
+    removedEdgeSet.insert(makeEdgeKey(delta_.removedEdges_[i].first, delta_.removedEdges_[i].second));
+
+  std::vector<SparseStorage::BoltEdgeData> newEdges;
+  newEdges.reserve(oldEdges.size() + delta_.addedEdges_.size());
+  for (std::size_t i = 0; i < oldEdges.size(); ++i)
+  {
+    const std::size_t v1 = oldEdges[i].endpoints_.first;
+    const std::size_t v2 = oldEdges[i].endpoints_.second;
+    if (deltaToNew[v1] == removed || deltaToNew[v2] == removed || removedEdgeSet.count(makeEdgeKey(v1, v2)))
+      continue;
+
+    SparseStorage::BoltEdgeData edgeData = oldEdges[i];
+    edgeData.endpoints_ = std::make_pair(deltaToNew[v1], deltaToNew[v2]);
+    newEdges.push_back(edgeData);
+  }
+  for (std::size_t i = 0; i < delta_.addedEdges_.size(); ++i)
+  {
+    SparseStorage::BoltEdgeData edgeData = delta_.addedEdges_[i];
+    edgeData.endpoints_ = std::make_pair(deltaToNew[edgeData.endpoints_.first], deltaToNew[edgeData.endpoints_.second]);
+    newEdges.push_back(edgeData);
+  }
+
+  return storage_.write(newFilePath, newVertices, newEdges, indent + 2);
+}
+
+bool RoadmapDiff::save(const std::string &filePath)
+{
+  std::ofstream out(filePath.c_str(), std::ios::binary);
+  if (!out.good())
+  {
+    OMPL_ERROR("%s: Unable to open %s", name_.c_str(), filePath.c_str());
+    return false;
+  }
+
+  try
+  {
+    boost::archive::binary_oarchive oa(out);
+    oa << delta_;
+  }
+  catch (boost::archive::archive_exception &ae)
+  {
+    OMPL_ERROR("%s: Failed to save delta: %s", name_.c_str(), ae.what());
+    return false;
+  }
+  return true;
+}
+
+bool RoadmapDiff::load(const std::string &filePath)
+{
+  std::ifstream in(filePath.c_str(), std::ios::binary);
+  if (!in.good())
+  {
+    OMPL_ERROR("%s: Unable to open %s", name_.c_str(), filePath.c_str());
+    return false;
+  }
+
+  RoadmapDelta delta;
+  try
+  {
+    boost::archive::binary_iarchive ia(in);
+    ia >> delta;
+  }
+  catch (boost::archive::archive_exception &ae)
+  {
+    OMPL_ERROR("%s: Failed to load delta: %s", name_.c_str(), ae.what());
+    return false;
+  }
+
+  if (delta.marker_ != ROADMAP_DELTA_MARKER)
+  {
+    OMPL_ERROR("%s: Roadmap delta marker not found in %s", name_.c_str(), filePath.c_str());
+    return false;
+  }
+
+  std::vector<int> signature;
+  si_->getStateSpace()->computeSignature(signature);
+  if (delta.signature_ != signature)
+  {
+    OMPL_ERROR("%s: StateSpace signature mismatch", name_.c_str());
+    return false;
+  }
+
+  delta_ = delta;
+  return true;
+}
+
+void RoadmapDiff::print(std::ostream &out) const
+{
+  out << "Roadmap delta" << std::endl;
+  out << "  Old vertices:     " << delta_.numOldVertices_ << std::endl;
+  out << "  Vertices added:   " << delta_.addedVertices_.size() << std::endl;
+  out << "  Vertices removed: " << delta_.removedVertices_.size() << std::endl;
+  out << "  Edges added:      " << delta_.addedEdges_.size() << std::endl;
+  out << "  Edges removed:    " << delta_.removedEdges_.size()
+      << " (plus the edges of removed vertices)" << std::endl;
+}
+
+double RoadmapDiff::distanceFunction(const std::size_t a, const std::size_t b) const
+{
+  const base::State *stateA = a == QUERY_INDEX ? queryState_ : oldStates_[a];
+  const base::State *stateB = b == QUERY_INDEX ? queryState_ : oldStates_[b];
+  return si_->distance(stateA, stateB);
+}
+
+void RoadmapDiff::clearStates()
+{
+  for (std::size_t i = 0; i < oldStates_.size(); ++i)
+    si_->freeState(oldStates_[i]);
+  oldStates_.clear();
+
+  if (queryState_)
+    si_->freeState(queryState_);
+  queryState_ = nullptr;
+}
+
+}  // namespace bolt
+}  // namespace tools
+}  // namespace ompl
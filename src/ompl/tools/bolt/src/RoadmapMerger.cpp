@@ -0,0 +1,328 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2016, University of Colorado, Boulder
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the Univ of CO, Boulder nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+/* Author: Dave Coleman <dave@dav.ee>
+   Desc:   Stitch the roadmaps of independently generated regions into one sparse graph
+*/
+
+// OMPL
+#include <ompl/tools/bolt/RoadmapMerger.h>
+#include <ompl/tools/bolt/SparseCriteria.h>
+
+// C++
+#include <limits>
+
+namespace ompl
+{
+namespace tools
+{
+namespace bolt
+{
+RoadmapMerger::RoadmapMerger(SparseGraphPtr sg, SparseGeneratorPtr sparseGenerator, RoadmapPartitionPtr partition)
+  : sg_(sg)
+  , sparseCriteria_(sg_->getSparseCriteria())
+  , sparseGenerator_(sparseGenerator)
+  , partition_(partition)
+  , si_(sg_->getSpaceInformation())
+{
+}
+
+bool RoadmapMerger::merge(const std::vector<std::string> &regionFilePaths, const std::string &filePath,
+                          std::size_t indent)
+{
+  BOLT_FUNC(indent, verbose_, "merge() " << regionFilePaths.size() << " regions into " << filePath);
+
+  // Error check
+  if (!partition_)
+  {
+    OMPL_ERROR("%s: A partition is needed to merge regions", name_.c_str());
+    return false;
+  }
+  if (regionFilePaths.size() != partition_->getNumRegions())
+  {
+    OMPL_ERROR("%s: Expected %u region files but got %u", name_.c_str(),
+               static_cast<unsigned int>(partition_->getNumRegions()),
+               static_cast<unsigned int>(regionFilePaths.size()));
+    return false;
+  }
+  if (sg_->getNumRealVertices() > 0)
+  {
+    OMPL_ERROR("%s: The sparse graph must be empty before merging", name_.c_str());
+    return false;
+  }
+
+  time::point startTime = time::now();
+  numCandidates_ = 0;
+  numStitched_ = 0;
+
+  // Copy the cores
+  std::vector<base::State *> candidates;
+  for (std::size_t id = 0; id < regionFilePaths.size(); ++id)
+  {
+    if (!addRegion(id, regionFilePaths[id], candidates, indent + 2))
+    {
+      for (std::size_t i = 0; i < candidates.size(); ++i)
+        si_->freeState(candidates[i]);
+      return false;
+    }
+  }
+  numCandidates_ = candidates.size();
+
+  // Repair the seams. The quality criterion looks at the whole graph, so it is left to later generation
+  const bool useFourthCriteria = sparseCriteria_->getUseFourthCriteria();
+  sparseCriteria_->setUseFourthCriteria(false);
+  numStitched_ = stitch(candidates, indent + 2);
+  sparseCriteria_->setUseFourthCriteria(useFourthCriteria);
+
+  BOLT_INFO(indent, verbose_, "------------------------------------------------------");
+  BOLT_INFO(indent, verbose_, "Roadmap merge stats:");
+  BOLT_INFO(indent, verbose_, "   Regions:                " << regionFilePaths.size());
+  BOLT_INFO(indent, verbose_, "   Overlap candidates:     " << numCandidates_);
+  BOLT_INFO(indent, verbose_, "   Seam vertices added:    " << numStitched_);
+  BOLT_INFO(indent, verbose_, "   Total vertices:         " << sg_->getNumRealVertices());
+  BOLT_INFO(indent, verbose_, "   Total edges:            " << sg_->getNumEdges());
+  BOLT_INFO(indent, verbose_, "   Merge time:             " << time::seconds(time::now() - startTime));
+  BOLT_INFO(indent, verbose_, "------------------------------------------------------");
+
+  sg_->setFilePath(filePath);
+  return sg_->save(indent);
+}
+
+bool RoadmapMerger::mergeFile(const std::string &filePath, std::size_t indent)
+{
+  BOLT_FUNC(indent, verbose_, "mergeFile() " << filePath);
+
+  std::vector<SparseStorage::BoltVertexData> vertices;
+  std::vector<SparseStorage::BoltEdgeData> edges;
+  if (!sg_->getSparseStorage()->read(filePath, vertices, edges, indent))
+    return false;
+
+  time::point startTime = time::now();
+  numCandidates_ = 0;
+  numStitched_ = 0;
+  numDeduplicated_ = 0;
+
+  // Classify against the graph as it was before the merge, so the order of the file does not matter
+  const base::StateSpacePtr &space = si_->getStateSpace();
+  const SparseVertex noVertex = std::numeric_limits<SparseVertex>::max();
+  const double sparseDelta = sparseCriteria_->getSparseDelta();
+  std::vector<SparseVertex> fileToGraph(vertices.size(), noVertex);
+  std::vector<bool> deduplicated(vertices.size(), false);
+  std::vector<base::State *> states(vertices.size(), nullptr);
+  std::vector<base::State *> candidates;
+  for (std::size_t i = 0; i < vertices.size(); ++i)
+  {
+    base::State *state = space->allocState();
+    space->deserialize(state, &vertices[i].stateSerialized_[0]);
+
+    double distance = std::numeric_limits<double>::infinity();
+    SparseVertex nearest = findNearestVertex(state, distance);
+    if (distance <= dedupTolerance_)
+    {
+      fileToGraph[i] = nearest;
+      deduplicated[i] = true;
+      numDeduplicated_++;
+      si_->freeState(state);
+    }
+    else if (distance <= sparseDelta)
+      candidates.push_back(state);
+    else
+      states[i] = state;
+  }
+  numCandidates_ = candidates.size();
+
+  // Copy the parts the graph did not cover
+  std::size_t numCopied = 0;
+  for (std::size_t i = 0; i < states.size(); ++i)
+  {
+    if (!states[i])
+      continue;
+    fileToGraph[i] = sg_->addVertex(states[i], static_cast<VertexType>(vertices[i].type_), indent);
+    numCopied++;
+  }
+
+  std::size_t numEdges = 0;
+  std::size_t numEdgesInvalid = 0;
+  for (std::size_t i = 0; i < edges.size(); ++i)
+  {
+    const SparseVertex v1 = fileToGraph[edges[i].endpoints_.first];
+    const SparseVertex v2 = fileToGraph[edges[i].endpoints_.second];
+    if (v1 == noVertex || v2 == noVertex || v1 == v2 || sg_->hasEdge(v1, v2))
+      continue;
+
+    // A merged endpoint is only within dedupTolerance_ of the saved one, so the saved check no longer applies
+    const bool endpointMoved = deduplicated[edges[i].endpoints_.first] || deduplicated[edges[i].endpoints_.second];
+    if (endpointMoved && !si_->checkMotion(sg_->getState(v1), sg_->getState(v2)))
+    {
+      numEdgesInvalid++;
+      continue;
+    }
+
+    sg_->addEdge(v1, v2, static_cast<EdgeType>(edges[i].type_), indent);
+    numEdges++;
+  }
+
+  const bool useFourthCriteria = sparseCriteria_->getUseFourthCriteria();
+  sparseCriteria_->setUseFourthCriteria(false);
+  numStitched_ = stitch(candidates, indent + 2);
+  sparseCriteria_->setUseFourthCriteria(useFourthCriteria);
+
+  BOLT_INFO(indent, verbose_, "------------------------------------------------------");
+  BOLT_INFO(indent, verbose_, "Roadmap merge stats:");
+  BOLT_INFO(indent, verbose_, "   Incoming vertices:      " << vertices.size());
+  BOLT_INFO(indent, verbose_, "   Deduplicated:           " << numDeduplicated_);
+  BOLT_INFO(indent, verbose_, "   Copied:                 " << numCopied);
+  BOLT_INFO(indent, verbose_, "   Edges copied:           " << numEdges << " of " << edges.size());
+  BOLT_INFO(indent, verbose_, "   Edges in collision:     " << numEdgesInvalid);
+  BOLT_INFO(indent, verbose_, "   Overlap candidates:     " << numCandidates_);
+  BOLT_INFO(indent, verbose_, "   Seam vertices added:    " << numStitched_);
+  BOLT_INFO(indent, verbose_, "   Merge time:             " << time::seconds(time::now() - startTime));
+  BOLT_INFO(indent, verbose_, "------------------------------------------------------");
+
+  return true;
+}
+
+bool RoadmapMerger::addRegion(std::size_t id, const std::string &filePath, std::vector<base::State *> &candidates,
+                              std::size_t indent)
+{
+  BOLT_FUNC(indent, verbose_, "addRegion() " << id);
+
+  std::vector<SparseStorage::BoltVertexData> vertices;
+  std::vector<SparseStorage::BoltEdgeData> edges;
+  if (!sg_->getSparseStorage()->read(filePath, vertices, edges, indent))
+    return false;
+
+  // Vertices outside of this region's core are owned by a neighbor, or are candidates if in the overlap
+  const base::StateSpacePtr &space = si_->getStateSpace();
+  const SparseVertex noVertex = std::numeric_limits<SparseVertex>::max();
+  std::vector<SparseVertex> fileToGraph(vertices.size(), noVertex);
+  std::size_t numOwned = 0;
+  for (std::size_t i = 0; i < vertices.size(); ++i)
+  {
+    base::State *state = space->allocState();
+    space->deserialize(state, &vertices[i].stateSerialized_[0]);
+
+    if (partition_->getOwner(state) == id)
+    {
+      // Copied as loaded, like SparseStorage::loadVertices(), so the stats and interface data are left alone
+      const SparseVertex v = sg_->addVertexFromFile(state, static_cast<VertexType>(vertices[i].type_), indent);
+      {
+        std::lock_guard<std::mutex> lock(sg_->getNNGuard());
+        sg_->getNN()->add(v);
+      }
+      fileToGraph[i] = v;
+      numOwned++;
+    }
+    else if (partition_->inOverlap(state))
+      candidates.push_back(state);
+    else
+      si_->freeState(state);
+  }
+
+  // Edges within the core are kept as they are
+  std::size_t numEdges = 0;
+  for (std::size_t i = 0; i < edges.size(); ++i)
+  {
+    const SparseVertex v1 = fileToGraph[edges[i].endpoints_.first];
+    const SparseVertex v2 = fileToGraph[edges[i].endpoints_.second];
+    if (v1 == noVertex || v2 == noVertex)
+      continue;
+
+    sg_->addEdge(v1, v2, static_cast<EdgeType>(edges[i].type_), indent);
+    numEdges++;
+  }
+
+  BOLT_DEBUG(indent, verbose_, "Region " << id << ": kept " << numOwned << " of " << vertices.size() << " vertices and "
+                                         << numEdges << " of " << edges.size() << " edges");
+  return true;
+}
+
+SparseVertex RoadmapMerger::findNearestVertex(const base::State *state, double &distance)
+{
+  const std::size_t threadID = 0;
+  const SparseVertex queryVertex = sg_->getQueryVertices(threadID);
+  if (sg_->getNN()->size() == 0)
+    return queryVertex;
+
+  sg_->getQueryStateNonConst(threadID) = const_cast<base::State *>(state);
+  SparseVertex nearest;
+  {
+    std::lock_guard<std::mutex> lock(sg_->getNNGuard());
+    nearest = sg_->getNN()->nearest(queryVertex);
+  }
+  sg_->getQueryStateNonConst(threadID) = nullptr;
+
+  distance = si_->distance(state, sg_->getState(nearest));
+  return nearest;
+}
+
+std::size_t RoadmapMerger::stitch(std::vector<base::State *> &candidates, std::size_t indent)
+{
+  BOLT_FUNC(indent, verbose_, "stitch() " << candidates.size() << " candidates");
+
+  const std::size_t threadID = 0;
+  std::size_t numAdded = 0;
+  for (std::size_t pass = 0; pass < maxStitchPasses_; ++pass)
+  {
+    std::size_t numAddedThisPass = 0;
+    std::vector<base::State *> remaining;
+    for (std::size_t i = 0; i < candidates.size(); ++i)
+    {
+      CandidateData candidateD(candidates[i]);
+      sparseGenerator_->findGraphNeighbors(candidateD, threadID, indent);
+
+      VertexType addReason;
+      if (sparseCriteria_->addStateToRoadmap(candidateD, addReason, threadID, indent))
+        numAddedThisPass++;  // the graph owns the state now
+      else
+        remaining.push_back(candidates[i]);
+    }
+    candidates.swap(remaining);
+    numAdded += numAddedThisPass;
+
+    BOLT_DEBUG(indent, verbose_, "Pass " << pass << " added " << numAddedThisPass << " vertices");
+    if (numAddedThisPass == 0)
+      break;
+  }
+
+  for (std::size_t i = 0; i < candidates.size(); ++i)
+    si_->freeState(candidates[i]);
+  candidates.clear();
+
+  return numAdded;
+}
+
+}  // namespace bolt
+}  // namespace tools
+}  // namespace ompl
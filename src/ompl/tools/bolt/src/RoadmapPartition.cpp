@@ -0,0 +1,147 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2016, University of Colorado, Boulder
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the Univ of CO, Boulder nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+/* Author: Dave Coleman <dave@dav.ee>
+   Desc:   Split the state space into overlapping regions that are generated independently
+*/
+
+// OMPL
+#include <ompl/tools/bolt/RoadmapPartition.h>
+#include <ompl/base/spaces/RealVectorStateSpace.h>
+#include <ompl/util/Console.h>
+
+// C++
+#include <algorithm>
+#include <cmath>
+#include <sstream>
+
+namespace ompl
+{
+namespace tools
+{
+namespace bolt
+{
+RoadmapPartition::RoadmapPartition(base::SpaceInformationPtr si) : si_(si)
+{
+}
+
+bool RoadmapPartition::split(std::size_t numRegions, double overlap, std::size_t axis)
+{
+  if (numRegions == 0)
+  {
+    OMPL_ERROR("%s: Need at least one region", name_.c_str());
+    return false;
+  }
+  if (axis >= si_->getStateSpace()->getDimension())
+  {
+    OMPL_ERROR("%s: Split axis %u is out of range", name_.c_str(), static_cast<unsigned int>(axis));
+    return false;
+  }
+
+  base::RealVectorBounds bounds = si_->getStateSpace()->getBounds();
+  const double low = bounds.low[axis];
+  const double width = (bounds.high[axis] - low) / numRegions;
+
+  axis_ = axis;
+  overlap_ = overlap;
+  regions_.resize(numRegions);
+  for (std::size_t i = 0; i < numRegions; ++i)
+  {
+    PartitionRegion &region = regions_[i];
+    region.coreLow_ = low + i * width;
+    region.coreHigh_ = (i + 1 == numRegions) ? bounds.high[axis] : low + (i + 1) * width;
+    region.low_ = std::max(bounds.low[axis], region.coreLow_ - overlap);
+    region.high_ = std::min(bounds.high[axis], region.coreHigh_ + overlap);
+  }
+
+  return true;
+}
+
+double RoadmapPartition::getCoordinate(const base::State *state) const
+{
+  return *si_->getStateSpace()->getValueAddressAtIndex(state, axis_);
+}
+
+std::size_t RoadmapPartition::getOwner(const base::State *state) const
+{
+  const double value = getCoordinate(state);
+  for (std::size_t i = 0; i + 1 < regions_.size(); ++i)
+    if (value < regions_[i].coreHigh_)
+      return i;
+  return regions_.size() - 1;
+}
+
+bool RoadmapPartition::inRegion(const base::State *state, std::size_t id) const
+{
+  const double value = getCoordinate(state);
+  return value >= regions_[id].low_ && value <= regions_[id].high_;
+}
+
+bool RoadmapPartition::inOverlap(const base::State *state) const
+{
+  const double value = getCoordinate(state);
+
+  // Distance to the closest boundary between two cores
+  for (std::size_t i = 0; i + 1 < regions_.size(); ++i)
+    if (std::abs(value - regions_[i].coreHigh_) <= overlap_)
+      return true;
+  return false;
+}
+
+bool RoadmapPartition::restrictBounds(std::size_t id) const
+{
+  base::RealVectorStateSpace *space = dynamic_cast<base::RealVectorStateSpace *>(si_->getStateSpace().get());
+  if (!space)
+  {
+    OMPL_WARN("%s: Unable to restrict the bounds of a state space that is not a RealVectorStateSpace", name_.c_str());
+    return false;
+  }
+
+  base::RealVectorBounds bounds = space->getBounds();
+  bounds.low[axis_] = regions_[id].low_;
+  bounds.high[axis_] = regions_[id].high_;
+  space->setBounds(bounds);
+  return true;
+}
+
+std::string RoadmapPartition::getRegionFilePath(const std::string &filePath, std::size_t id)
+{
+  std::stringstream ss;
+  ss << filePath << ".region" << id;
+  return ss.str();
+}
+
+}  // namespace bolt
+}  // namespace tools
+}  // namespace ompl
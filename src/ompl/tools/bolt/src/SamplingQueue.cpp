@@ -61,7 +61,7 @@ SamplingQueue::~SamplingQueue()
   // Clear all left over states that weren't used
   while (!statesQueue_.empty())
   {
-    si_->freeState(statesQueue_.front());
+    sg_->getStatePool()->freeState(statesQueue_.front());
     statesQueue_.pop();
   }
 }
@@ -82,13 +82,22 @@ void SamplingQueue::startSampling(std::size_t indent)
   si->setMotionValidator(si_->getMotionValidator());
 
   // Load minimum clearance state sampler
-  ob::MinimumClearanceValidStateSamplerPtr clearanceSampler =
-      ob::MinimumClearanceValidStateSamplerPtr(new ob::MinimumClearanceValidStateSampler(si.get()));
-  clearanceSampler->setMinimumObstacleClearance(sg_->getObstacleClearance());
+  ob::MinimumClearanceValidStateSamplerPtr clearanceSampler = allocClearanceSampler(
+      si.get(), sg_->getObstacleClearance(), coverageGrid_,
+      allocSequenceStateSampler(sampleSequence_, si.get(), 0, sg_->getNumQueryVertices(), seed_));
   si->getStateValidityChecker()->setClearanceSearchDistance(sg_->getObstacleClearance());
 
+  // Second stream of samples near obstacles
+  ClearanceSamplerPtr boundarySampler;
+  if (sampleMixer_ && sampleMixer_->getMethod() != BOUNDARY_SAMPLING_NONE)
+  {
+    boundarySampler.reset(new BoundarySampler(si.get(), sampleMixer_->getMethod(), sampleMixer_->getStdDev()));
+    boundarySampler->setMinimumObstacleClearance(sg_->getObstacleClearance());
+  }
+
   // Create thread
-  samplingThread_ = new boost::thread(boost::bind(&SamplingQueue::samplingThread, this, si, clearanceSampler, indent));
+  samplingThread_ = new boost::thread(
+      boost::bind(&SamplingQueue::samplingThread, this, si, clearanceSampler, boundarySampler, indent));
 
   // Wait for first sample to be found
   BOLT_DEBUG(indent, verbose_, "SamplingQueue: Waiting for first sample to be found");
@@ -141,12 +150,17 @@ bool SamplingQueue::getNextState(base::State *&state, std::size_t indent)
   }
 }
 
-void SamplingQueue::samplingThread(base::SpaceInformationPtr si, ClearanceSamplerPtr clearanceSampler,
-                                   std::size_t indent)
+void SamplingQueue::samplingThread(base::SpaceInformationPtr /*si*/, ClearanceSamplerPtr clearanceSampler,
+                                   ClearanceSamplerPtr boundarySampler, std::size_t indent)
 {
   BOLT_FUNC(indent, verbose_, "samplingThread()");
 
-  while (threadRunning_ && !visual_->viz1()->shutdownRequested())
+  // Record into the profiler slot after the query vertices
+  GenerationProfiler::setThreadID(sg_->getNumQueryVertices());
+  ScopedCheckSite site(SITE_SAMPLING);
+  RNG rng;
+
+  while (threadRunning_ && !sg_->shutdownRequested())
   {
     // Do not add more states if queue is full
     waitForQueueNotFull(indent);
@@ -154,14 +168,21 @@ void SamplingQueue::samplingThread(base::SpaceInformationPtr si, ClearanceSample
     // time::point startTime = time::now(); // Benchmark
 
     // Create new state
-    base::State *candidateState = si_->allocState();
+    base::State *candidateState = sg_->getStatePool()->allocState();
 
-    // Sample randomly
-    if (!clearanceSampler->sample(candidateState))
+    // Sample near an obstacle, or uniformly if none was found
     {
-      OMPL_ERROR("Unable to find valid sample");
-      exit(-1);  // this should never happen
+      ScopedPhaseTimer timer(sg_->getProfiler(), PHASE_SAMPLING);
+      if (boundarySampler && rng.uniform01() < sampleMixer_->getBoundaryFraction() &&
+          boundarySampler->sample(candidateState))
+        sg_->getProfiler()->increment(COUNT_BOUNDARY_SAMPLES);
+      else if (!clearanceSampler->sample(candidateState))
+      {
+        OMPL_ERROR("Unable to find valid sample");
+        exit(-1);  // this should never happen
+      }
     }
+    sg_->getProfiler()->increment(COUNT_SAMPLES);
     // BOLT_CYAN_DEBUG(0, true, time::seconds(time::now() - startTime) << " SamplingQueue, total queue: " <<
     // statesQueue_.size()); // Benchmark
 
@@ -175,6 +196,10 @@ void SamplingQueue::samplingThread(base::SpaceInformationPtr si, ClearanceSample
 /** \brief Do not add more states if queue is full */
 void SamplingQueue::waitForQueueNotFull(std::size_t indent)
 {
+  if (statesQueue_.size() < targetQueueSize_)
+    return;
+
+  ScopedPhaseTimer timer(sg_->getProfiler(), PHASE_QUEUE_WAIT);
   bool oneTimeFlag = true;
   while (statesQueue_.size() >= targetQueueSize_ && threadRunning_)
   {
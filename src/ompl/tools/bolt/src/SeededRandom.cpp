@@ -0,0 +1,95 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2016, University of Colorado, Boulder
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the Univ of CO, Boulder nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+/* Author: Dave Coleman <dave@dav.ee>
+   Desc:   Seeding of the random number generators used during sparse graph generation
+*/
+
+// OMPL
+#include <ompl/tools/bolt/SeededRandom.h>
+
+namespace ompl
+{
+namespace tools
+{
+namespace bolt
+{
+std::uint_fast32_t deriveSeed(std::uint_fast32_t seed, SeedPurpose purpose, std::size_t stream)
+{
+  // splitmix64 finalizer
+  std::uint64_t z = (std::uint64_t(seed) << 32) ^ (std::uint64_t(purpose) << 24) ^ std::uint64_t(stream);
+  z += 0x9E3779B97F4A7C15ULL;
+  z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+  z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+  z ^= z >> 31;
+  return std::uint_fast32_t(z & 0xFFFFFFFFULL);
+}
+
+SeededStateSampler::SeededStateSampler(const base::StateSpace *space, std::uint_fast32_t seed)
+  : base::RealVectorStateSampler(space)
+{
+  rng_.setLocalSeed(seed);
+}
+
+base::StateSamplerPtr allocSeededStateSampler(const base::SpaceInformation *si, std::uint_fast32_t seed)
+{
+  const base::StateSpacePtr &space = si->getStateSpace();
+  if (!dynamic_cast<base::RealVectorStateSpace *>(space.get()))
+    return si->allocStateSampler();
+
+  return base::StateSamplerPtr(new SeededStateSampler(space.get(), seed));
+}
+
+SeededPathSimplifier::SeededPathSimplifier(const base::SpaceInformationPtr &si, std::uint_fast32_t seed)
+  : geometric::PathSimplifier(si)
+{
+  rng_.setLocalSeed(seed);
+}
+
+SeededClearanceSampler::SeededClearanceSampler(const base::SpaceInformation *si, std::uint_fast32_t seed)
+  : base::MinimumClearanceValidStateSampler(si)
+{
+  sampler_ = allocSeededStateSampler(si, seed);
+}
+
+SeededClearanceSampler::SeededClearanceSampler(const base::SpaceInformation *si,
+                                               const base::StateSamplerPtr &stateSampler)
+  : base::MinimumClearanceValidStateSampler(si)
+{
+  sampler_ = stateSampler;
+}
+
+}  // namespace bolt
+}  // namespace tools
+}  // namespace ompl
@@ -38,6 +38,7 @@
 
 // OMPL
 #include <ompl/tools/bolt/SparseCriteria.h>
+#include <ompl/tools/bolt/SeededRandom.h>
 
 // Boost
 #include <boost/foreach.hpp>
@@ -189,12 +190,19 @@ bool SparseCriteria::setup(std::size_t indent)
   return true;
 }
 
+void SparseCriteria::seedRandom(std::uint_fast32_t seed)
+{
+  clearanceSampler_.reset(new SeededClearanceSampler(si_.get(), deriveSeed(seed, SEED_CRITERIA)));
+  clearanceSampler_->setMinimumObstacleClearance(sg_->getObstacleClearance());
+}
+
 bool SparseCriteria::addStateToRoadmap(CandidateData &candidateD, VertexType &addReason, std::size_t threadID,
                                        std::size_t indent)
 {
   BOLT_FUNC(indent, vCriteria_, "addStateToRoadmap() Adding candidate state ID " << candidateD.state_);
+  ScopedCheckSite site(SITE_SPARSE_CRITERIA);
 
-  if (visualizeAttemptedStates_)
+  if (BOLT_VISUALIZE(visualizeAttemptedStates_))
   {
     visual_->viz2()->deleteAllMarkers();
     visual_->viz2()->state(candidateD.state_, tools::LARGE, tools::GREEN, 0);
@@ -243,6 +251,7 @@ bool SparseCriteria::addStateToRoadmap(CandidateData &candidateD, VertexType &ad
 bool SparseCriteria::checkAddCoverage(CandidateData &candidateD, std::size_t indent)
 {
   BOLT_FUNC(indent, vCriteria_, "checkAddCoverage() Are other nodes around it visible?");
+  ScopedPhaseTimer timer(sg_->getProfiler(), PHASE_COVERAGE);
 
   // Only add a node for coverage if it has no neighbors
   if (candidateD.visibleNeighborhood_.size() > 0)
@@ -255,6 +264,7 @@ bool SparseCriteria::checkAddCoverage(CandidateData &candidateD, std::size_t ind
   BOLT_DEBUG(indent, vCriteria_, "Adding node for COVERAGE ");
 
   candidateD.newVertex_ = sg_->addVertex(candidateD.state_, COVERAGE, indent + 4);
+  sg_->cacheVisibility(candidateD);
 
   // Note: we do not connect this node with any edges because we have already determined
   // it is too far away from any nearby nodes
@@ -266,6 +276,7 @@ bool SparseCriteria::checkAddConnectivity(CandidateData &candidateD, std::size_t
 {
   BOLT_FUNC(indent, vCriteria_, "checkAddConnectivity() Does this node connect "
                                 "two disconnected components?");
+  ScopedPhaseTimer timer(sg_->getProfiler(), PHASE_CONNECTIVITY);
   BOLT_DEBUG(indent, vCriteria_, "NOT adding node for connectivity - disabled ");
   return false;
 
@@ -294,7 +305,7 @@ bool SparseCriteria::checkAddConnectivity(CandidateData &candidateD, std::size_t
         BOLT_DEBUG(indent, vCriteria_, "Different connected component: " << candidateD.visibleNeighborhood_[i] << ", "
                                                                          << candidateD.visibleNeighborhood_[j]);
 
-        if (visualizeConnectivity_)
+        if (BOLT_VISUALIZE(visualizeConnectivity_))
         {
           visual_->viz2()->state(sg_->getState(candidateD.visibleNeighborhood_[i]), tools::MEDIUM, tools::BLUE, 0);
           visual_->viz2()->state(sg_->getState(candidateD.visibleNeighborhood_[j]), tools::MEDIUM, tools::BLUE, 0);
@@ -319,6 +330,7 @@ bool SparseCriteria::checkAddConnectivity(CandidateData &candidateD, std::size_t
 
   // Add the node
   candidateD.newVertex_ = sg_->addVertex(candidateD.state_, CONNECTIVITY, indent + 2);
+  sg_->cacheVisibility(candidateD);
 
   // Check if there are really close vertices nearby which should be merged
   checkRemoveCloseVertices(candidateD.newVertex_, indent);
@@ -374,6 +386,7 @@ bool SparseCriteria::checkAddInterface(CandidateData &candidateD, std::size_t in
 {
   BOLT_FUNC(indent, vCriteria_, "checkAddInterface() Does this node's "
                                 "neighbor's need it to better connect them?");
+  ScopedPhaseTimer timer(sg_->getProfiler(), PHASE_INTERFACE);
 
   // If there are less than two neighbors the interface property is not
   // applicable, because requires
@@ -394,7 +407,7 @@ bool SparseCriteria::checkAddInterface(CandidateData &candidateD, std::size_t in
     if (!sg_->hasEdge(v1, v2))
     {
       // If they can be directly connected
-      if (si_->checkMotion(sg_->getState(v1), sg_->getState(v2)))
+      if (sg_->checkMotion(v1, v2))
       {
         BOLT_DEBUG(indent, vCriteria_, "INTERFACE: directly connected nodes");
 
@@ -421,6 +434,7 @@ bool SparseCriteria::checkAddInterface(CandidateData &candidateD, std::size_t in
         BOLT_DEBUG(indent, vCriteria_, "Adding node for INTERFACE");
 
         candidateD.newVertex_ = sg_->addVertex(candidateD.state_, INTERFACE, indent);
+        sg_->cacheVisibility(candidateD);
 
         // Check if there are really close vertices nearby which should be
         // merged
@@ -473,6 +487,7 @@ bool SparseCriteria::checkAddQuality(CandidateData &candidateD, std::size_t thre
     return false;
 
   BOLT_FUNC(indent, vQuality_, "checkAddQuality() Ensure SPARS asymptotic optimality");
+  ScopedPhaseTimer timer(sg_->getProfiler(), PHASE_QUALITY);
 
   if (candidateD.visibleNeighborhood_.empty())
   {
@@ -501,7 +516,7 @@ bool SparseCriteria::checkAddQuality(CandidateData &candidateD, std::size_t thre
     base::State *nearSampledState = it->second;  // paper: q'
     SparseVertex nearSampledRep = it->first;     // paper: v'
 
-    if (visualizeQualityCriteriaCloseReps_)  // Visualization
+    if (BOLT_VISUALIZE(visualizeQualityCriteriaCloseReps_))  // Visualization
     {
       visual_->viz3()->edge(sg_->getState(nearSampledRep), nearSampledState, tools::MEDIUM, tools::RED);
 
@@ -544,6 +559,11 @@ bool SparseCriteria::checkAddQuality(CandidateData &candidateD, std::size_t thre
   if (!updated)
   {
     BOLT_DEBUG(indent, vQuality_, "No representatives were updated, so not calling checkAddPath()");
+
+    // Return the states sampled by findCloseRepresentatives()
+    for (std::map<SparseVertex, base::State *>::iterator it = closeRepresentatives.begin();
+         it != closeRepresentatives.end(); ++it)
+      sg_->getStatePool()->freeState(it->second);
     return false;
   }
 
@@ -569,7 +589,7 @@ bool SparseCriteria::checkAddQuality(CandidateData &candidateD, std::size_t thre
     }
 
     // Delete state that was allocated and sampled within this function
-    si_->freeState(nearSampledState);
+    sg_->getStatePool()->freeState(nearSampledState);
   }
 
   return added;
@@ -757,11 +777,11 @@ bool SparseCriteria::addQualityPath(SparseVertex v, SparseVertex vp, SparseVerte
 {
   BOLT_FUNC(indent, vQuality_, "addQualityPath()");
 
-  if (visualizeQualityCriteria_)
+  if (BOLT_VISUALIZE(visualizeQualityCriteria_))
     visualizeCheckAddPath(v, vp, vpp, iData, indent + 4);
 
   // Can we connect these two vertices directly?
-  if (si_->checkMotion(sg_->getState(vp), sg_->getState(vpp)))
+  if (sg_->checkMotion(vp, vpp))
   {
     BOLT_DEBUG(indent, vQuality_, "Adding edge between vp and vpp");
 
@@ -833,7 +853,7 @@ bool SparseCriteria::addQualityPath(SparseVertex v, SparseVertex vp, SparseVerte
     {
       BOLT_ERROR(indent + 2, vQuality_, "Add path state is too similar to v!");
 
-      if (visualizeQualityCriteria_ && false)
+      if (BOLT_VISUALIZE(visualizeQualityCriteria_) && false)
       {
         visual_->viz2()->deleteAllMarkers();
         visual_->viz2()->path(path, tools::SMALL, tools::RED);
@@ -939,7 +959,7 @@ bool SparseCriteria::spannerTestOriginal(SparseVertex v, SparseVertex vp, Sparse
       // visual_->viz6()->state(sg_->getState(vpp), tools::MEDIUM, tools::BLACK, 0);
       // visual_->viz6()->trigger();
 
-      if (visualizeQualityCriteria_)                           // TEMP
+      if (BOLT_VISUALIZE(visualizeQualityCriteria_))  // TEMP
         visualizeCheckAddPath(v, vp, vpp, iData, indent + 4);  // TEMP
 
       if (newEdgeDistance > shortestPathVpVpp - SMALL_EPSILON)
@@ -955,7 +975,8 @@ bool SparseCriteria::spannerTestOriginal(SparseVertex v, SparseVertex vp, Sparse
   return false;  // spanner property was NOT violated
 }
 
-double SparseCriteria::qualityEdgeAstarTest(SparseVertex vp, SparseVertex vpp, InterfaceData &iData, std::size_t indent)
+double SparseCriteria::qualityEdgeAstarTest(SparseVertex vp, SparseVertex vpp, InterfaceData & /*iData*/,
+                                           std::size_t indent)
 {
   BOLT_FUNC(indent, vQuality_, "qualityEdgeAstarTest()");
 
@@ -969,7 +990,7 @@ double SparseCriteria::qualityEdgeAstarTest(SparseVertex vp, SparseVertex vpp, I
     return std::numeric_limits<double>::infinity();
   }
 
-  if (visualizeQualityCriteriaAstar_)
+  if (BOLT_VISUALIZE(visualizeQualityCriteriaAstar_))
   {
     visual_->viz6()->deleteAllMarkers();
     assert(vertexPath.size() > 1);
@@ -991,9 +1012,12 @@ SparseVertex SparseCriteria::findGraphRepresentative(base::State *state, std::si
   std::vector<SparseVertex> graphNeighbors;
 
   // Search
-  sg_->getQueryStateNonConst(threadID) = state;
-  sg_->getNN()->nearestR(sg_->getQueryVertices(threadID), sparseDelta_, graphNeighbors);
-  sg_->getQueryStateNonConst(threadID) = nullptr;
+  {
+    ScopedPhaseTimer timer(sg_->getProfiler(), PHASE_NEAREST_NEIGHBOR);
+    sg_->getQueryStateNonConst(threadID) = state;
+    sg_->getNN()->nearestR(sg_->getQueryVertices(threadID), sparseDelta_, graphNeighbors);
+    sg_->getQueryStateNonConst(threadID) = nullptr;
+  }
 
   BOLT_DEBUG(indent, vQuality_, "Found " << graphNeighbors.size() << " nearest neighbors (graph rep) within "
                                                                      "SparseDelta " << sparseDelta_);
@@ -1041,7 +1065,7 @@ void SparseCriteria::findCloseRepresentatives(const base::State *candidateState,
       {
         BOLT_DEBUG(indent + 4, vQuality_ && false, "Sample attempt " << attempt << " notValid ");
 
-        if (visualizeQualityCriteriaSampler_)
+        if (BOLT_VISUALIZE(visualizeQualityCriteriaSampler_))
           visual_->viz3()->state(sampledState, tools::SMALL, tools::RED, 0);
 
         continue;
@@ -1052,7 +1076,7 @@ void SparseCriteria::findCloseRepresentatives(const base::State *candidateState,
                                                                      << si_->distance(candidateState, sampledState)
                                                                      << " needs to be less than " << denseDelta_);
 
-        if (visualizeQualityCriteriaSampler_)
+        if (BOLT_VISUALIZE(visualizeQualityCriteriaSampler_))
           visual_->viz3()->state(sampledState, tools::SMALL, tools::RED, 0);
         continue;
       }
@@ -1060,12 +1084,12 @@ void SparseCriteria::findCloseRepresentatives(const base::State *candidateState,
       {
         BOLT_DEBUG(indent + 4, vQuality_ && false, "Sample attempt " << attempt << " motion invalid ");
 
-        if (visualizeQualityCriteriaSampler_)
+        if (BOLT_VISUALIZE(visualizeQualityCriteriaSampler_))
           visual_->viz3()->state(sampledState, tools::SMALL, tools::RED, 0);
         continue;
       }
 
-      if (visualizeQualityCriteriaSampler_)
+      if (BOLT_VISUALIZE(visualizeQualityCriteriaSampler_))
         visual_->viz3()->state(sampledState, tools::SMALL, tools::GREEN, 0);
 
       BOLT_DEBUG(indent + 4, vQuality_ && false, "Sample attempt " << attempt << " valid ");
@@ -1074,7 +1098,7 @@ void SparseCriteria::findCloseRepresentatives(const base::State *candidateState,
       break;
     }  // for each attempt
 
-    if (visualizeQualityCriteriaSampler_)
+    if (BOLT_VISUALIZE(visualizeQualityCriteriaSampler_))
     {
       visual_->viz3()->trigger();
       usleep(0.001 * 1000000);
@@ -1110,7 +1134,7 @@ void SparseCriteria::findCloseRepresentatives(const base::State *candidateState,
       // We should also stop our efforts to add a dense path
       for (std::map<SparseVertex, base::State *>::iterator it = closeRepresentatives.begin();
            it != closeRepresentatives.end(); ++it)
-        si_->freeState(it->second);
+        sg_->getStatePool()->freeState(it->second);
       closeRepresentatives.clear();
       break;
     }
@@ -1128,7 +1152,7 @@ void SparseCriteria::findCloseRepresentatives(const base::State *candidateState,
         BOLT_DEBUG(indent + 2, vQuality_, "Track the representative");
 
         // Track the representative
-        closeRepresentatives[sampledStateRep] = si_->cloneState(sampledState);
+        closeRepresentatives[sampledStateRep] = sg_->getStatePool()->cloneState(sampledState);
       }
       else
       {
@@ -1209,7 +1233,7 @@ double SparseCriteria::maxSpannerPath(SparseVertex v, SparseVertex vp, SparseVer
         // This is a possible alternative path to v''
         qualifiedVertices.push_back(x);
 
-        if (visualizeQualityCriteria_ && false)
+        if (BOLT_VISUALIZE(visualizeQualityCriteria_) && false)
         {
           visual_->viz5()->state(sg_->getState(x), tools::LARGE, tools::BLACK, 0);
         }
@@ -1226,7 +1250,7 @@ double SparseCriteria::maxSpannerPath(SparseVertex v, SparseVertex vp, SparseVer
   double maxDist = 0.0;
   foreach (SparseVertex qualifiedVertex, qualifiedVertices)
   {
-    if (visualizeQualityCriteria_ && false)
+    if (BOLT_VISUALIZE(visualizeQualityCriteria_) && false)
       visual_->viz5()->state(sg_->getState(qualifiedVertex), tools::SMALL, tools::PINK, 0);
 
     // Divide by 2 because of the midpoint path 'M'
@@ -1385,7 +1409,7 @@ bool SparseCriteria::checkRemoveCloseVertices(SparseVertex v1, std::size_t inden
   // moved
   if (sg_->getVertexTypeProperty(v2) == QUALITY)
   {
-    if (visualizeRemoveCloseVertices_)
+    if (BOLT_VISUALIZE(visualizeRemoveCloseVertices_))
     {
       visualizeRemoveCloseVertices(v1, v2);
       visual_->waitForUserFeedback("Skipping this vertex because is QUALITY");
@@ -1403,7 +1427,7 @@ bool SparseCriteria::checkRemoveCloseVertices(SparseVertex v1, std::size_t inden
   }
 
   // Check if nearest neighbor is collision free
-  if (!si_->checkMotion(sg_->getState(v1), sg_->getState(v2)))
+  if (!sg_->checkMotion(v1, v2))
   {
     BOLT_ERROR(indent, vRemoveClose_, "checkRemoveCloseVertices: not collision free v1=" << v1 << ", v2=" << v2);
     return false;
@@ -1426,7 +1450,7 @@ bool SparseCriteria::checkRemoveCloseVertices(SparseVertex v1, std::size_t inden
     }
 
     // Check if collision free path to connected vertex
-    if (!si_->checkMotion(sg_->getState(v1), sg_->getState(v3)))
+    if (!sg_->checkMotion(v1, v3))
     {
       BOLT_ERROR(indent + 2, vRemoveClose_,
                  "checkRemoveCloseVertices: not collision free path from new vertex to potential neighbor " << v3);
@@ -1436,7 +1460,7 @@ bool SparseCriteria::checkRemoveCloseVertices(SparseVertex v1, std::size_t inden
 
   BOLT_DEBUG(indent, vRemoveClose_, "Found qualified node to replace with nearby");
 
-  if (visualizeRemoveCloseVertices_)
+  if (BOLT_VISUALIZE(visualizeRemoveCloseVertices_))
   {
     visualizeRemoveCloseVertices(v1, v2);
     visual_->waitForUserFeedback("found qualified node to replace with nearby");
@@ -1461,13 +1485,14 @@ bool SparseCriteria::checkRemoveCloseVertices(SparseVertex v1, std::size_t inden
   numVerticesMoved_++;
 
   // Only display database if enabled
-  if (sg_->visualizeSparseGraph_ && sg_->visualizeSparseGraphSpeed_ > std::numeric_limits<double>::epsilon())
+  if (BOLT_VISUALIZE(sg_->visualizeSparseGraph_) &&
+      sg_->visualizeSparseGraphSpeed_ > std::numeric_limits<double>::epsilon())
     sg_->displayDatabase(true, indent + 2);
 
   // if (visualizeRemoveCloseVertices_)
   // visual_->waitForUserFeedback("finished moving vertex");
 
-  if (visualizeRemoveCloseVertices_)
+  if (BOLT_VISUALIZE(visualizeRemoveCloseVertices_))
   {
     visual_->viz6()->deleteAllMarkers();
     visual_->viz6()->trigger();
@@ -39,6 +39,8 @@
 // OMPL
 #include <ompl/tools/bolt/SparseGenerator.h>
 #include <ompl/tools/bolt/SparseCriteria.h>
+#include <ompl/tools/bolt/SeededRandom.h>
+#include <ompl/base/spaces/RealVectorStateSpace.h>
 
 // Boost
 #include <boost/foreach.hpp>
@@ -74,12 +76,11 @@ SparseGenerator::~SparseGenerator(void)
   clearanceSampler_.reset();
 }
 
-bool SparseGenerator::setup(std::size_t indent)
+bool SparseGenerator::setup(std::size_t /*indent*/)
 {
   // Load minimum clearance state sampler
   // TODO: remove this if we stick to samplingQueue
-  clearanceSampler_ = ob::MinimumClearanceValidStateSamplerPtr(new ob::MinimumClearanceValidStateSampler(si_.get()));
-  clearanceSampler_->setMinimumObstacleClearance(sg_->getObstacleClearance());
+  clearanceSampler_ = allocClearanceSampler(si_.get(), sg_->getObstacleClearance(), coverageGrid_);
   si_->getStateValidityChecker()->setClearanceSearchDistance(sg_->getObstacleClearance());
 
   // Speed up random sampling with these threads
@@ -110,8 +111,52 @@ void SparseGenerator::createSPARS()
   numConsecutiveFailures_ = 0;
   sparseCriteria_->setUseFourthCriteria(false);  // initially we do not do this step
 
+  // Bias random samples toward regions that still produce vertices
+  coverageGrid_.reset();
+  if (useCoverageGrid_ && !deterministic_)
+  {
+    if (si_->getStateSpace()->hasDefaultProjection())
+      coverageGrid_.reset(new CoverageGrid(si_, si_->getStateSpace()->getDefaultProjection()));
+    else
+      BOLT_WARN(indent, true, "State space has no default projection, sampling uniformly");
+  }
+  samplingQueue_->setCoverageGrid(coverageGrid_);
+
+  // Spread random samples evenly instead. The queues take their own streams of the same sequence
+  base::StateSamplerPtr sequenceSampler = allocSequenceStateSampler(sampleSequence_, si_.get(), 0, 1, seed_);
+  if (sampleSequence_ != SAMPLE_SEQUENCE_RANDOM && !sequenceSampler)
+    BOLT_WARN(indent, true, "Halton samples require a RealVectorStateSpace, sampling randomly");
+  if (deterministic_ && !sequenceSampler)
+    sequenceSampler = allocSeededStateSampler(si_.get(), deriveSeed(seed_, SEED_SAMPLES));
+  clearanceSampler_ = allocClearanceSampler(si_.get(), sg_->getObstacleClearance(), coverageGrid_, sequenceSampler);
+  samplingQueue_->setSampleSequence(sampleSequence_, seed_);
+
+  // Mix in samples near obstacles for the connectivity and interface criteria
+  sampleMixer_.reset();
+  if (boundarySampling_ != BOUNDARY_SAMPLING_NONE && !deterministic_)
+  {
+    const double stdDev = boundaryStdDev_ > 0 ? boundaryStdDev_ : sparseCriteria_->getSparseDelta() / 2.0;
+    sampleMixer_.reset(new SampleMixer(boundarySampling_, stdDev));
+  }
+  samplingQueue_->setSampleMixer(sampleMixer_);
+
+  // Seed every random choice made while adding samples, whichever of the addRandomSamples functions runs
+  if (deterministic_)
+  {
+    if (!dynamic_cast<base::RealVectorStateSpace *>(si_->getStateSpace().get()))
+      BOLT_WARN(indent, true, "Deterministic generation requires a RealVectorStateSpace, samples are not reproducible");
+    sg_->seedRandom(seed_);
+    sparseCriteria_->seedRandom(seed_);
+  }
+
   // Benchmark runtime
   timeDiscretizeAndRandomStarted_ = time::now();
+  sg_->getProfiler()->reset();
+  sg_->getMotionCacheNonConst().resetCounters();
+  const CollisionCheckSnapshot checksBefore = sg_->getCollisionCheckCounter()->getSnapshot();
+  const std::size_t verticesBefore = sg_->getNumRealVertices();
+  memoryTracker_.reset();
+  memoryTracker_.record(sg_->getMemoryReport());
 
   // Profiler
   CALLGRIND_TOGGLE_COLLECT;
@@ -143,8 +188,17 @@ void SparseGenerator::createSPARS()
   // Cleanup removed vertices
   sg_->removeDeletedVertices(indent);
 
+  // Landmarks for the A* heuristic, kept exact from here on as edges are added
+  if (sg_->getLandmarks().isEmpty())
+    sg_->computeLandmarks(indent);
+
   // Benchmark runtime
   double duration = time::seconds(time::now() - timeDiscretizeAndRandomStarted_);
+  const CollisionCheckSnapshot checks = sg_->getCollisionCheckCounter()->getSnapshot() - checksBefore;
+  const std::size_t verticesAfter = sg_->getNumRealVertices();
+  const std::size_t verticesAdded = verticesAfter > verticesBefore ? verticesAfter - verticesBefore : 0;
+  const double checksPerVertex =
+      (checks.getStateChecks() + checks.getMotionChecks()) / double(std::max<std::size_t>(1, verticesAdded));
 
   // Check how many connected components exist
   std::size_t numSets = sg_->getDisjointSetsCount();
@@ -193,7 +247,44 @@ void SparseGenerator::createSPARS()
   BOLT_INFO(indent, 1, "  InterfaceData:             ");
   BOLT_INFO(indent, 1, "    States stored:           " << interfaceStats.first);
   BOLT_INFO(indent, 1, "    Missing interfaces:      " << interfaceStats.second);
+  BOLT_INFO(indent, 1, "  Collision checks:          ");
+  BOLT_INFO(indent, 1, "    State checks:            " << checks.getStateChecks());
+  BOLT_INFO(indent, 1, "    Motion checks:           " << checks.getMotionChecks());
+  BOLT_INFO(indent, 1, "    Per vertex added:        " << checksPerVertex);
+  if (sg_->useMotionCache_)
+  {
+    BOLT_INFO(indent, 1, "    Motion cache size:       " << sg_->getMotionCache().size());
+    BOLT_INFO(indent, 1, "    Motion cache hit rate:   " << sg_->getMotionCache().getHitRate() * 100.0 << "%");
+  }
+  if (coverageGrid_)
+  {
+    BOLT_INFO(indent, 1, "  Coverage grid:             ");
+    BOLT_INFO(indent, 1, "    Cells:                   " << coverageGrid_->getNumCells());
+    BOLT_INFO(indent, 1, "    Skipped samples:         " << coverageGrid_->getNumSkipped());
+  }
+  if (sampleMixer_)
+  {
+    BOLT_INFO(indent, 1, "  Boundary sampling:         ");
+    BOLT_INFO(indent, 1, "    Samples:                 " << sg_->getProfiler()->getCounter(COUNT_BOUNDARY_SAMPLES));
+    BOLT_INFO(indent, 1, "    Final fraction:          " << sampleMixer_->getBoundaryFraction());
+  }
   BOLT_INFO(indent, 1, "-----------------------------------------");
+  CollisionCheckCounter::print(checks, verticesAdded, "vertex");
+
+  // Where the memory went
+  const MemoryReport memoryReport = sg_->getMemoryReport();
+  memoryTracker_.record(memoryReport);
+  memoryReport.print("SparseGraph");
+  memoryTracker_.printGrowth();
+
+  // Breakdown of where the time went
+  sg_->getProfiler()->print();
+  if (!profileFilePath_.empty())
+  {
+    sg_->getProfiler()->writeJSON(profileFilePath_ + ".json");
+    sg_->getProfiler()->writeCSV(profileFilePath_ + ".csv");
+    memoryTracker_.writeCSV(profileFilePath_ + "_memory.csv");
+  }
 
   // Copy-paste data
   copyPasteState(numSets);
@@ -203,7 +294,7 @@ void SparseGenerator::createSPARS()
     OMPL_ERROR("Sparse graph did not pass test");
   }
 
-  if (!sg_->visualizeSparseGraph_)
+  if (BOLT_VISUALIZE(!sg_->visualizeSparseGraph_ && sg_->visualizeGraphAfterGeneration_))
     sg_->displayDatabase(true, indent);
 
   OMPL_INFORM("Finished creating sparse database");
@@ -250,7 +341,11 @@ void SparseGenerator::addDiscretizedStates(std::size_t indent)
   }
 
   // Generate discretization
-  vertexDiscretizer_->generateGrid(indent);
+  {
+    ScopedPhaseTimer timer(sg_->getProfiler(), PHASE_DISCRETIZATION);
+    ScopedCheckSite site(SITE_DISCRETIZATION);
+    vertexDiscretizer_->generateGrid(indent);
+  }
 
   // Make sure discretization doesn't have any bugs
   if (sg_->superDebug_)
@@ -269,17 +364,22 @@ bool SparseGenerator::addRandomSamples(std::size_t indent)
   maxConsecutiveFailures_ = 0;
   maxPercentComplete_ = 0;
 
-  base::State *candidateState = si_->allocState();
+  base::State *candidateState = sg_->getStatePool()->allocState();
   const std::size_t threadID = 0;
 
   while (true)
   {
     // Sample randomly
-    if (!clearanceSampler_->sample(candidateState))
     {
-      OMPL_ERROR("Unable to find valid sample");
-      exit(-1);  // this should never happen
+      ScopedPhaseTimer timer(sg_->getProfiler(), PHASE_SAMPLING);
+      ScopedCheckSite site(SITE_SAMPLING);
+      if (!clearanceSampler_->sample(candidateState))
+      {
+        OMPL_ERROR("Unable to find valid sample");
+        exit(-1);  // this should never happen
+      }
     }
+    sg_->getProfiler()->increment(COUNT_SAMPLES);
 
     // Debug
     if (false)
@@ -301,7 +401,7 @@ bool SparseGenerator::addRandomSamples(std::size_t indent)
     if (usedState)
     {
       // State was used, so allocate new state
-      candidateState = si_->allocState();
+      candidateState = sg_->getStatePool()->allocState();
     }
   }  // while(true) create random sample
 
@@ -355,13 +455,21 @@ bool SparseGenerator::addRandomSamplesTwoThread(std::size_t indent)
   maxConsecutiveFailures_ = 0;
   maxPercentComplete_ = 0;
 
-  samplingQueue_->startSampling(indent);
+  // The SamplingQueue hands out states in whatever order its thread finds them, so it is bypassed in deterministic
+  // mode. Candidates are drawn from seeded streams instead
+  if (!deterministic_)
+    samplingQueue_->startSampling(indent);
 
   candidateQueue_->startGenerating(indent);
 
   const std::size_t threadID = 0;
-  while (!visual_->viz1()->shutdownRequested())
+  std::size_t iteration = 0;
+  while (!sg_->shutdownRequested())
   {
+    // Checking the visualizer is expensive, so only do it occasionally
+    if (shutdownPollInterval_ && ++iteration % shutdownPollInterval_ == 0)
+      sg_->pollVisualShutdown();
+
     // time::point startTime2 = time::now(); // Benchmark
 
     // Find nearby nodes
@@ -374,12 +482,7 @@ bool SparseGenerator::addRandomSamplesTwoThread(std::size_t indent)
     // BOLT_GREEN_DEBUG(0, 1, time::seconds(time::now() - startTime) << " add sample"); // Benchmark
 
     if (!result)
-    {
-      samplingQueue_->stopSampling(indent);
-      candidateQueue_->stopGenerating(indent);
-
-      return true;  // no more states needed
-    }
+      break;  // no more states needed
 
     // BOLT_DEBUG(indent, true, "SparseGenerator: used: " << usedState << " numRandSamplesAdded: " <<
     // numRandSamplesAdded_);
@@ -390,19 +493,36 @@ bool SparseGenerator::addRandomSamplesTwoThread(std::size_t indent)
     // BOLT_DEBUG(0, 1, time::seconds(time::now() - startTime2) << " whole sampling loop"); // Benchmark
   }  // while(true) create random sample
 
-  return true;  // program should never reach here
+  // Finished, or a shutdown was requested
+  if (!deterministic_)
+    samplingQueue_->stopSampling(indent);
+  candidateQueue_->stopGenerating(indent);
+
+  return true;
 }
 
 bool SparseGenerator::addSample(CandidateData &candidateD, std::size_t threadID, bool &usedState, std::size_t indent)
 {
   BOLT_FUNC(indent, false, "addSample() threadID: " << threadID);
 
+  // Belongs to another region. Not counted as a failure, it says nothing about the coverage of this one
+  if (partition_ && !partition_->inRegion(candidateD.state_, regionID_))
+    return true;
+
+  sg_->getProfiler()->increment(COUNT_CANDIDATES);
+
   // Run SPARS checks
   VertexType addReason;  // returns why the state was added
-  if (sparseCriteria_->addStateToRoadmap(candidateD, addReason, threadID, indent))
+  const bool added = sparseCriteria_->addStateToRoadmap(candidateD, addReason, threadID, indent);
+  if (coverageGrid_)
+    coverageGrid_->recordCandidate(candidateD.state_, added);
+
+  if (added)
   {
     // State was added
     numConsecutiveFailures_ = 0;
+    if (sampleMixer_)
+      sampleMixer_->recordAddition(addReason);
 
     // Save on interval of new state addition
     if ((numRandSamplesAdded_ + 1) % saveInterval_ == 0)
@@ -416,10 +536,14 @@ bool SparseGenerator::addSample(CandidateData &candidateD, std::size_t threadID,
     // Increment statistics
     numRandSamplesAdded_++;
 
+    // Track memory growth
+    if (memoryTrackingInterval_ && numRandSamplesAdded_ % memoryTrackingInterval_ == 0)
+      memoryTracker_.record(sg_->getMemoryReport());
+
     usedState = true;
 
     // Check if shutdown requested
-    if (visual_->viz1()->shutdownRequested())
+    if (sg_->shutdownRequested())
     {
       BOLT_INFO(indent, true, "Shutdown requested");
       sg_->saveIfChanged(indent);
@@ -479,7 +603,7 @@ bool SparseGenerator::addSample(CandidateData &candidateD, std::size_t threadID,
     maxConsecutiveFailures_ = 0;  // reset for new criteria
 
     // Show it just once if it has not already been animated
-    if (!sg_->visualizeVoronoiDiagramAnimated_ && sg_->visualizeVoronoiDiagram_)
+    if (BOLT_VISUALIZE(!sg_->visualizeVoronoiDiagramAnimated_ && sg_->visualizeVoronoiDiagram_))
       visual_->vizVoronoiDiagram();
   }
 
@@ -501,12 +625,19 @@ void SparseGenerator::findGraphNeighbors(CandidateData &candidateD, std::size_t
 
   // Search in thread-safe manner
   // Note that the main thread could be modifying the NN, so we have to lock it
-  sg_->getQueryStateNonConst(threadID) = candidateD.state_;
-  sg_->getNN()->nearestR(sg_->getQueryVertices(threadID), sparseCriteria_->getSparseDelta(),
-                         candidateD.graphNeighborhood_);
-  sg_->getQueryStateNonConst(threadID) = nullptr;
+  {
+    ScopedPhaseTimer timer(sg_->getProfiler(), PHASE_NEAREST_NEIGHBOR);
+    std::lock_guard<std::mutex> lock(sg_->getNNGuard());
+    candidateD.neighborhoodVersion_ = sg_->getNeighborhoodVersion();
+    sg_->getQueryStateNonConst(threadID) = candidateD.state_;
+    sg_->getNN()->nearestR(sg_->getQueryVertices(threadID), sparseCriteria_->getSparseDelta(),
+                           candidateD.graphNeighborhood_);
+    sg_->getQueryStateNonConst(threadID) = nullptr;
+  }
 
   // Now that we got the neighbors from the NN, we must remove any we can't see
+  ScopedPhaseTimer timer(sg_->getProfiler(), PHASE_VISIBILITY);
+  ScopedCheckSite site(SITE_CANDIDATE_QUEUE);
   for (std::size_t i = 0; i < candidateD.graphNeighborhood_.size(); ++i)
   {
     SparseVertex v2 = candidateD.graphNeighborhood_[i];
@@ -514,6 +645,7 @@ void SparseGenerator::findGraphNeighbors(CandidateData &candidateD, std::size_t
     // Don't collision check if they are the same state
     if (candidateD.state_ != sg_->getState(v2))
     {
+      sg_->getProfiler()->increment(COUNT_MOTION_CHECKS);
       if (!si_->checkMotion(candidateD.state_, sg_->getState(v2)))
       {
         continue;
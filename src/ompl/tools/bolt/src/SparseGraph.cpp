@@ -39,13 +39,15 @@
 // OMPL
 #include <ompl/tools/bolt/SparseGraph.h>
 #include <ompl/tools/bolt/SparseCriteria.h>
+#include <ompl/tools/bolt/SeededRandom.h>
 #include <ompl/util/Console.h>
 #include <ompl/datastructures/NearestNeighborsGNAT.h>
 #include <ompl/datastructures/NearestNeighborsGNATNoThreadSafety.h>
 #include <ompl/base/DiscreteMotionValidator.h>
+#include <ompl/base/spaces/RealVectorStateSpace.h>
 
 // Boost
-#include <boost/graph/incremental_components.hpp>
+#include <boost/unordered_map.hpp>
 #include <boost/foreach.hpp>
 #include <boost/unordered_set.hpp>
 #include <boost/assert.hpp>
@@ -54,6 +56,7 @@
 #include <boost/thread.hpp>
 
 // C++
+#include <cmath>
 #include <limits>
 #include <queue>
 #include <algorithm>  // std::random_shuffle
@@ -86,15 +89,24 @@ SparseGraph::SparseGraph(base::SpaceInformationPtr si, VisualizerPtr visual)
   , vertexTypeProperty_(boost::get(vertex_type_t(), g_))
   , vertexInterfaceProperty_(boost::get(vertex_interface_data_t(), g_))
   , vertexPopularity_(boost::get(vertex_popularity_t(), g_))
-  // Disjoint set accessors
-  , disjointSets_(boost::get(boost::vertex_rank, g_), boost::get(boost::vertex_predecessor, g_))
+  // Connected components
+  , components_(g_)
+  , landmarks_(g_)
 {
   // Save number of threads available
   numThreads_ = boost::thread::hardware_concurrency();
 
+  if (isEuclideanSpace(si_->getStateSpace()))
+    euclideanDimension_ = si_->getStateDimension();
+
   // Add search state
   initializeQueryState();
 
+  // One profiler slot per query vertex plus one for the SamplingQueue thread
+  profiler_.reset(new GenerationProfiler(numThreads_ + 1));
+  collisionCheckCounter_.reset(new CollisionCheckCounter());
+  statePool_.reset(new StatePool(si_, numThreads_ + 1));
+
   // Saving and loading from file
   sparseStorage_.reset(new SparseStorage(si_, this));
 
@@ -121,13 +133,53 @@ void SparseGraph::freeMemory()
   }
 
   g_.clear();
+  components_.clear();
+  landmarks_.clear();
+  frozen_.clear();
+  hierarchy_.clear();
+  bidirectional_.clear();
+  workspaceIndex_.clear(workspaceIndex_.getCellSize());
+  motionCache_.clear();
+  if (statePool_)
+    statePool_->clear();
 
   if (nn_)
     nn_->clear();
 }
 
+void SparseGraph::freeze(std::size_t indent)
+{
+  BOLT_FUNC(indent, true, "freeze()");
+  if (isFrozen())
+    return;
+
+  time::point startTime = time::now();  // Benchmark
+  const std::size_t bytesBefore = getMemoryReport().getTotal();
+  frozen_.build(g_);
+
+  // Keep the vertices with their states, but none of the edges, their per-vertex lists or the interface data
+  SparseAdjList vertices(boost::num_vertices(g_));
+  foreach (SparseVertex v, boost::vertices(g_))
+  {
+    foreach (InterfaceData &iData, vertexInterfaceProperty_[v] | boost::adaptors::map_values)
+      iData.clear(si_);
+
+    boost::put(vertex_state_t(), vertices, v, vertexStateProperty_[v]);
+    boost::put(vertex_type_t(), vertices, v, vertexTypeProperty_[v]);
+    boost::put(vertex_popularity_t(), vertices, v, vertexPopularity_[v]);
+  }
+  g_.swap(vertices);
+
+  BOLT_DEBUG(indent, true, "Froze " << getNumEdges() << " edges in " << time::seconds(time::now() - startTime)
+                                    << " seconds, memory went from " << MemoryReport::formatBytes(bytesBefore)
+                                    << " to " << MemoryReport::formatBytes(getMemoryReport().getTotal()));
+}
+
 bool SparseGraph::setup()
 {
+  // Count all collision checks
+  collisionCheckCounter_->install(si_);
+
   // Initialize path simplifier
   if (!pathSimplifier_)
   {
@@ -147,11 +199,26 @@ void SparseGraph::clearStatistics()
   numSamplesAddedForQuality_ = 0;
 }
 
+void SparseGraph::pollVisualShutdown()
+{
+#ifndef BOLT_HEADLESS
+  if (visual_ && visual_->viz1() && visual_->viz1()->shutdownRequested())
+    requestShutdown();
+#endif
+}
+
+void SparseGraph::seedRandom(std::uint_fast32_t seed)
+{
+  pathSimplifier_.reset(new SeededPathSimplifier(si_, deriveSeed(seed, SEED_SIMPLIFIER)));
+  pathSimplifier_->freeStates(false);
+}
+
 void SparseGraph::initializeQueryState()
 {
   if (boost::num_vertices(g_) > 0)
   {
-    OMPL_WARN("Not initializing query state because already is of size %u", boost::num_vertices(g_));
+    OMPL_WARN("Not initializing query state because already is of size %u",
+              static_cast<unsigned int>(boost::num_vertices(g_)));
     return;  // assume its already been setup
   }
 
@@ -186,13 +253,17 @@ bool SparseGraph::load()
     return false;
   }
 
+  // Files written before the landmarks were stored
+  if (landmarks_.isEmpty())
+    computeLandmarks(0);
+
   // Show more data
   printGraphStats();
 
   // Nothing to save because was just loaded from file
   graphUnsaved_ = false;
 
-  if (visualizeGraphAfterLoading_)
+  if (BOLT_VISUALIZE(visualizeGraphAfterLoading_))
     displayDatabase();
 
   return true;
@@ -223,6 +294,13 @@ bool SparseGraph::save(std::size_t indent)
     return false;
   }
 
+  // The interface data is gone and the storage only writes the boost graph
+  if (isFrozen())
+  {
+    OMPL_WARN("Not saving because the graph is frozen");
+    return false;
+  }
+
   // Error checking
   if (filePath_.empty())
   {
@@ -235,6 +313,7 @@ bool SparseGraph::save(std::size_t indent)
 
   // Save
   {
+    ScopedPhaseTimer timer(profiler_, PHASE_SAVE);
     // std::lock_guard<std::mutex> guard(modifyGraphMutex_);
     sparseStorage_->save(filePath_.c_str());
     graphUnsaved_ = false;
@@ -251,6 +330,42 @@ bool SparseGraph::astarSearch(const SparseVertex start, const SparseVertex goal,
                               double &distance, std::size_t indent)
 {
   BOLT_FUNC(indent, vSearch_, "astarSearch()");
+  ScopedPhaseTimer timer(profiler_, PHASE_ASTAR);
+
+  if (isFrozen())
+  {
+    std::vector<CompactGraph::Index> compactPath;
+    if (!hierarchy_.empty())
+    {
+      std::size_t nodesSettled;
+      if (!hierarchy_.search(start, goal, compactPath, distance, nodesSettled))
+      {
+        BOLT_WARN(indent, vSearch_, "Did not find goal");
+        return false;
+      }
+      numNodesOpened_ = numNodesClosed_ = nodesSettled;
+      if (frozen_.isPathFree(compactPath))
+      {
+        vertexPath.assign(compactPath.begin(), compactPath.end());
+        return true;
+      }
+      BOLT_DEBUG(indent, vSearch_, "Hierarchy path crosses an edge in collision, falling back to A*");
+    }
+
+    if (bidirectionalSearch_)
+      return astarSearchBidirectional(start, goal, vertexPath, distance, indent);
+
+    const bool found = frozen_.astarSearch(start, goal, boost::bind(&otb::SparseGraph::astarHeuristic, this, _1, goal),
+                                           compactPath, distance, numNodesOpened_, numNodesClosed_);
+    if (found)
+      vertexPath.assign(compactPath.begin(), compactPath.end());
+    else
+      BOLT_WARN(indent, vSearch_, "Did not find goal");
+    return found;
+  }
+
+  if (bidirectionalSearch_)
+    return astarSearchBidirectional(start, goal, vertexPath, distance, indent);
 
   // Hold a list of the shortest path parent to each vertex
   SparseVertex *vertexPredecessors = new SparseVertex[getNumVertices()];
@@ -263,7 +378,7 @@ bool SparseGraph::astarSearch(const SparseVertex start, const SparseVertex goal,
   numNodesOpened_ = 0;
   numNodesClosed_ = 0;
 
-  if (visualizeAstar_)
+  if (BOLT_VISUALIZE(visualizeAstar_))
   {
     visual_->viz4()->deleteAllMarkers();
   }
@@ -291,7 +406,7 @@ bool SparseGraph::astarSearch(const SparseVertex start, const SparseVertex goal,
     BOLT_DEBUG(indent, vSearch_, "Number nodes opened: " << numNodesOpened_
                                                          << ", Number nodes closed: " << numNodesClosed_);
 
-    if (isinf(vertexDistances[goal]))  // TODO(davetcoleman): test that this works
+    if (std::isinf(vertexDistances[goal]))  // TODO(davetcoleman): test that this works
     {
       throw Exception(name_, "Distance to goal is infinity");
       foundGoal = false;
@@ -331,7 +446,7 @@ bool SparseGraph::astarSearch(const SparseVertex start, const SparseVertex goal,
     BOLT_WARN(indent, vSearch_, "Did not find goal");
 
   // Show all predecessors
-  if (visualizeAstar_)
+  if (BOLT_VISUALIZE(visualizeAstar_))
   {
     BOLT_DEBUG(indent, vSearch_, "Show all predecessors");
     for (std::size_t i = getNumQueryVertices(); i < getNumVertices(); ++i)  // skip query vertices
@@ -355,12 +470,27 @@ bool SparseGraph::astarSearch(const SparseVertex start, const SparseVertex goal,
   return foundGoal;
 }
 
+bool SparseGraph::astarSearchBidirectional(const SparseVertex start, const SparseVertex goal,
+                                           std::vector<SparseVertex> &vertexPath, double &distance, std::size_t indent)
+{
+  const BidirectionalAstar::HeuristicFunction toGoal = boost::bind(&otb::SparseGraph::astarHeuristic, this, _1, goal);
+  const BidirectionalAstar::HeuristicFunction toStart = boost::bind(&otb::SparseGraph::astarHeuristic, this, _1, start);
+  const bool found =
+      isFrozen() ? bidirectional_.search(frozen_, getNumVertices(), start, goal, toGoal, toStart, vertexPath, distance,
+                                         numNodesOpened_, numNodesClosed_) :
+                   bidirectional_.search(g_, getNumVertices(), start, goal, toGoal, toStart, vertexPath, distance,
+                                         numNodesOpened_, numNodesClosed_);
+  if (!found)
+    BOLT_WARN(indent, vSearch_, "Did not find goal");
+  return found;
+}
+
 double SparseGraph::astarHeuristic(const SparseVertex a, const SparseVertex b) const
 {
   // Assume vertex 'a' is the one we care about its populariy
 
   // Get the classic distance
-  double dist = si_->distance(getState(a), getState(b));
+  double dist = distanceFunction(a, b);
 
   // if (false)  // method 1
   // {
@@ -405,11 +535,16 @@ double SparseGraph::astarHeuristic(const SparseVertex a, const SparseVertex b) c
 
   // std::cout << ", new distance: " << dist << std::endl;
 
-  return dist;
+  // The landmarks bound the graph distance, which in clutter is much longer than the straight line
+  return std::max(dist, landmarks_.getLowerBound(a, b));
 }
 
 double SparseGraph::distanceFunction(const SparseVertex a, const SparseVertex b) const
 {
+  // Euclidean spaces skip the virtual call, query vertices are handled by getCoordinates()
+  if (euclideanDimension_)
+    return std::sqrt(distanceKernels_.distanceSquared_(getCoordinates(a), getCoordinates(b), euclideanDimension_));
+
   // std::cout << "sg.distancefunction() " << a << ", " << b << std::endl;
   // Special case: query vertices store their states elsewhere
   if (a < numThreads_)
@@ -431,6 +566,40 @@ double SparseGraph::distanceFunction(const SparseVertex a, const SparseVertex b)
   return si_->distance(getState(a), getState(b));
 }
 
+bool SparseGraph::checkMotion(SparseVertex v1, SparseVertex v2)
+{
+  if (!useMotionCache_)
+    return si_->checkMotion(getState(v1), getState(v2));
+
+  bool valid;
+  if (motionCache_.lookup(v1, v2, valid))
+  {
+    profiler_->increment(COUNT_MOTION_CACHE_HITS);
+    return valid;
+  }
+
+  valid = si_->checkMotion(getState(v1), getState(v2));
+  motionCache_.insert(v1, v2, valid);
+  return valid;
+}
+
+void SparseGraph::cacheVisibility(const CandidateData &candidateD)
+{
+  if (!useMotionCache_)
+    return;
+
+  // The visible neighborhood keeps the order of the graph neighborhood, every other neighbor was found in collision
+  std::size_t visible = 0;
+  foreach (SparseVertex v, candidateD.graphNeighborhood_)
+  {
+    const bool valid =
+        visible < candidateD.visibleNeighborhood_.size() && candidateD.visibleNeighborhood_[visible] == v;
+    if (valid)
+      visible++;
+    motionCache_.insert(candidateD.newVertex_, v, valid);
+  }
+}
+
 bool SparseGraph::isEmpty() const
 {
   assert(!(getNumVertices() < getNumQueryVertices()));
@@ -439,10 +608,107 @@ bool SparseGraph::isEmpty() const
 
 void SparseGraph::clearEdgeCollisionStates()
 {
+  motionCache_.clear();
+  if (isFrozen())
+  {
+    frozen_.clearCollisionStates();
+    return;
+  }
+
   foreach (const SparseEdge e, boost::edges(g_))
     edgeCollisionStatePropertySparse_[e] = NOT_CHECKED;  // each edge has an unknown state
 }
 
+void SparseGraph::buildWorkspaceIndex(const SweptVolumeFunction &sweptVolume, double cellSize, std::size_t indent)
+{
+  BOLT_FUNC(indent, true, "buildWorkspaceIndex()");
+
+  time::point startTime = time::now();  // Benchmark
+  sweptVolume_ = sweptVolume;
+  workspaceIndex_.clear(cellSize);
+  indexWorkspace();
+  BOLT_DEBUG(indent, true, "Indexed " << workspaceIndex_.getNumEdges() << " edges in "
+                                      << workspaceIndex_.getNumCells() << " cells in "
+                                      << time::seconds(time::now() - startTime) << " seconds");
+}
+
+void SparseGraph::indexWorkspace()
+{
+  workspaceIndex_.clear(workspaceIndex_.getCellSize());
+  if (isFrozen())
+  {
+    // Each edge once, from its lower endpoint, and parallel edges once for both
+    for (CompactGraph::Index v = 0; v < frozen_.getNumVertices(); ++v)
+    {
+      CompactGraph::Index previous = v;
+      for (CompactGraph::Index i = frozen_.beginNeighbors(v); i < frozen_.endNeighbors(v); ++i)
+      {
+        const CompactGraph::Index u = frozen_.getNeighbor(i);
+        if (v < u && u != previous)
+          indexEdgeWorkspace(v, u);
+        previous = u;
+      }
+    }
+    return;
+  }
+
+  foreach (const SparseEdge e, boost::edges(g_))
+    indexEdgeWorkspace(boost::source(e, g_), boost::target(e, g_));
+}
+
+void SparseGraph::indexEdgeWorkspace(SparseVertex v1, SparseVertex v2)
+{
+  sweptBoxes_.clear();
+  sweptVolume_(getState(v1), getState(v2), sweptBoxes_);
+  workspaceIndex_.addEdge(v1, v2, sweptBoxes_);
+}
+
+std::size_t SparseGraph::invalidateWorkspace(const WorkspaceBox &region, std::size_t indent)
+{
+  BOLT_FUNC(indent, vSearch_, "invalidateWorkspace()");
+  if (!sweptVolume_)
+    throw Exception(name_, "buildWorkspaceIndex() must be called before invalidateWorkspace()");
+
+  motionCache_.clear();
+  std::vector<WorkspaceIndex::VertexPair> edges;
+  workspaceIndex_.getEdges(region, edges);
+  std::size_t numReset = 0;
+  for (std::size_t i = 0; i < edges.size(); ++i)
+    numReset += resetEdgeCollisionStates(edges[i].first, edges[i].second);
+
+  BOLT_DEBUG(indent, vSearch_, "Reset " << numReset << " of " << edges.size() << " edges near the change");
+  return numReset;
+}
+
+std::size_t SparseGraph::resetEdgeCollisionStates(SparseVertex v1, SparseVertex v2)
+{
+  // The index may still list edges that were removed since, and their vertices may be gone too
+  std::size_t numReset = 0;
+  if (isFrozen())
+  {
+    for (CompactGraph::Index i = frozen_.beginNeighbors(v1); i < frozen_.endNeighbors(v1); ++i)
+    {
+      const CompactGraph::Index e = frozen_.getNeighborEdge(i);
+      if (frozen_.getNeighbor(i) != v2 || frozen_.getCollisionState(e) == NOT_CHECKED)
+        continue;
+      frozen_.setCollisionState(e, NOT_CHECKED);
+      numReset++;
+    }
+    return numReset;
+  }
+
+  if (v1 >= boost::num_vertices(g_) || v2 >= boost::num_vertices(g_))
+    return 0;
+  foreach (const SparseEdge e, boost::out_edges(v1, g_))
+  {
+    if (boost::target(e, g_) != v2 || edgeCollisionStatePropertySparse_[e] == NOT_CHECKED)
+      continue;
+    edgeCollisionStatePropertySparse_[e] = NOT_CHECKED;
+    numReset++;
+  }
+  return numReset;
+}
+
 void SparseGraph::errorCheckDuplicateStates(std::size_t indent)
 {
   BOLT_ERROR(indent, true, "errorCheckDuplicateStates() - part of super debug - NOT IMPLEMENTED");
@@ -468,9 +734,10 @@ void SparseGraph::errorCheckDuplicateStates(std::size_t indent)
 bool SparseGraph::smoothQualityPathOriginal(geometric::PathGeometric *path, std::size_t indent)
 {
   BOLT_ERROR(indent, visualizeQualityPathSimp_, "smoothQualityPathOriginal()");
+  ScopedCheckSite site(SITE_SIMPLIFICATION);
 
   // Visualize path
-  if (visualizeQualityPathSimp_)
+  if (BOLT_VISUALIZE(visualizeQualityPathSimp_))
   {
     visual_->viz2()->deleteAllMarkers();
     visual_->viz2()->path(path, tools::SMALL, tools::BLUE);
@@ -480,7 +747,7 @@ bool SparseGraph::smoothQualityPathOriginal(geometric::PathGeometric *path, std:
 
   BOLT_DEBUG(indent, visualizeQualityPathSimp_, "Created 'quality path' candidate with " << path->getStateCount()
                                                                                          << " states");
-  if (visualizeQualityPathSimp_)
+  if (BOLT_VISUALIZE(visualizeQualityPathSimp_))
     visual_->waitForUserFeedback("path simplification");
 
   OMPL_ERROR("The results of this comparison may be wrong");
@@ -496,16 +763,18 @@ bool SparseGraph::smoothQualityPathOriginal(geometric::PathGeometric *path, std:
   return true;
 }
 
-bool SparseGraph::smoothQualityPath(geometric::PathGeometric *path, double clearance, bool debug, std::size_t indent)
+bool SparseGraph::smoothQualityPath(geometric::PathGeometric *path, double clearance, bool /*debug*/,
+                                    std::size_t indent)
 {
   BOLT_FUNC(indent, visualizeQualityPathSimp_, "smoothQualityPath()");
+  ScopedCheckSite site(SITE_SIMPLIFICATION);
 
   // TODO: only for testing
   base::State* startCopy = si_->cloneState(path->getState(0));
   base::State* goalCopy = si_->cloneState(path->getState(path->getStateCount() - 1));
 
   // Visualize path
-  if (visualizeQualityPathSimp_)
+  if (BOLT_VISUALIZE(visualizeQualityPathSimp_))
   {
     visual_->viz2()->deleteAllMarkers();
     visual_->viz3()->deleteAllMarkers();
@@ -525,8 +794,7 @@ bool SparseGraph::smoothQualityPath(geometric::PathGeometric *path, double clear
   //   visual_->waitForUserFeedback("path simplification");
 
   // Set the motion validator to use clearance, this way isValid() checks clearance before confirming valid
-  base::DiscreteMotionValidator *dmv =
-      dynamic_cast<base::DiscreteMotionValidator *>(si_->getMotionValidatorNonConst().get());
+  base::DiscreteMotionValidator *dmv = CollisionCheckCounter::getDiscreteMotionValidator(si_);
   dmv->setRequiredStateClearance(clearance);
 
   for (std::size_t i = 0; i < 3; ++i)
@@ -537,7 +805,7 @@ bool SparseGraph::smoothQualityPath(geometric::PathGeometric *path, double clear
 
     //std::cout << "path->getStateCount(): " << path->getStateCount() << std::endl;
 
-    if (visualizeQualityPathSimp_)
+    if (BOLT_VISUALIZE(visualizeQualityPathSimp_))
     {
       //visual_->viz3()->deleteAllMarkers();
       visual_->viz3()->path(path, tools::SMALL, tools::ORANGE);
@@ -552,7 +820,7 @@ bool SparseGraph::smoothQualityPath(geometric::PathGeometric *path, double clear
     if (minStatesFound > path->getStateCount())
       minStatesFound = path->getStateCount();
 
-    if (visualizeQualityPathSimp_)
+    if (BOLT_VISUALIZE(visualizeQualityPathSimp_))
     {
       //visual_->viz4()->deleteAllMarkers();
       visual_->viz4()->path(path, tools::SMALL, tools::BLUE);
@@ -569,7 +837,7 @@ bool SparseGraph::smoothQualityPath(geometric::PathGeometric *path, double clear
   pathSimplifier_->reduceVertices(*path, 1000, path->getStateCount() * 4); //, /*rangeRatio*/ 0.33, indent);
   //std::cout << "path->getStateCount(): " << path->getStateCount() << std::endl;
 
-  if (visualizeQualityPathSimp_)
+  if (BOLT_VISUALIZE(visualizeQualityPathSimp_))
   {
     visual_->viz6()->deleteAllMarkers();
     visual_->viz6()->path(path, tools::SMALL, tools::GREEN);
@@ -597,40 +865,38 @@ bool SparseGraph::smoothQualityPath(geometric::PathGeometric *path, double clear
 
 std::size_t SparseGraph::getDisjointSetsCount(bool verbose) const
 {
-  std::size_t numSets = 0;
+  if (!verbose)
+    return components_.getNumComponents();
+
+  // Report each set by its first vertex
+  boost::unordered_set<std::size_t> seen;
   foreach (SparseVertex v, boost::vertices(g_))
   {
-    // Do not count the search vertex within the sets
-    if (v <= queryVertices_.back())
+    const std::size_t component = components_.getComponent(v);
+    if (component == ConnectedComponents::NO_COMPONENT || !seen.insert(component).second)
       continue;
 
-    if (boost::get(boost::get(boost::vertex_predecessor, g_), v) == v)
-    {
-      if (verbose)
-        OMPL_INFORM("Disjoint set: %u", v);
-      ++numSets;
-    }
+    OMPL_INFORM("Disjoint set: %u", static_cast<unsigned int>(v));
   }
 
-  return numSets;
+  return seen.size();
 }
 
 void SparseGraph::getDisjointSets(SparseDisjointSetsMap &disjointSets)
 {
   disjointSets.clear();
 
-  // Flatten the parents tree so that the parent of every element is its representative.
-  disjointSets_.compress_sets(boost::vertices(g_).first, boost::vertices(g_).second);
-
-  // Count size of each disjoint set and group its containing vertices
+  // Count size of each disjoint set and group its containing vertices, keyed by the first vertex of the set
+  boost::unordered_map<std::size_t, SparseVertex> firstVertex;
   typedef boost::graph_traits<SparseAdjList>::vertex_iterator VertexIterator;
   for (VertexIterator v = boost::vertices(g_).first; v != boost::vertices(g_).second; ++v)
   {
-    // Do not count the search vertex within the sets
-    if (*v <= queryVertices_.back())
+    // Do not count the search vertex or deleted vertices within the sets
+    const std::size_t component = components_.getComponent(*v);
+    if (component == ConnectedComponents::NO_COMPONENT)
       continue;
 
-    disjointSets[boost::get(boost::get(boost::vertex_predecessor, g_), *v)].push_back(*v);
+    disjointSets[firstVertex.insert(std::make_pair(component, *v)).first->second].push_back(*v);
   }
 }
 
@@ -665,7 +931,8 @@ void SparseGraph::visualizeDisjointSets(SparseDisjointSetsMap &disjointSets)
       maxDisjointSetParent = v;
     }
   }
-  OMPL_INFORM("The largest disjoint set is of size %u and parent vertex %u", maxDisjointSetSize, maxDisjointSetParent);
+  OMPL_INFORM("The largest disjoint set is of size %u and parent vertex %u",
+              static_cast<unsigned int>(maxDisjointSetSize), static_cast<unsigned int>(maxDisjointSetParent));
 
   // Display size of disjoint sets and visualize small ones
   for (SparseDisjointSetsMap::const_iterator iterator = disjointSets.begin(); iterator != disjointSets.end();
@@ -699,7 +966,7 @@ void SparseGraph::visualizeDisjointSets(SparseDisjointSetsMap &disjointSets)
       typedef boost::graph_traits<SparseAdjList>::vertex_iterator VertexIterator;
       for (VertexIterator v2 = boost::vertices(g_).first; v2 != boost::vertices(g_).second; ++v2)
       {
-        if (boost::get(boost::get(boost::vertex_predecessor, g_), *v2) == v1)
+        if (components_.getComponent(*v2) == components_.getComponent(v1))
         {
           visual_->viz4()->state(getState(*v2), tools::LARGE, tools::RED, 0);
 
@@ -740,11 +1007,43 @@ std::size_t SparseGraph::checkConnectedComponents()
 
 bool SparseGraph::sameComponent(SparseVertex v1, SparseVertex v2)
 {
-  return boost::same_component(v1, v2, disjointSets_);
+  return components_.sameComponent(v1, v2);
+}
+
+void SparseGraph::buildHierarchy(std::size_t indent)
+{
+  BOLT_FUNC(indent, true, "buildHierarchy()");
+  if (!isFrozen())
+    throw Exception(name_, "Only a frozen graph can be contracted");
+
+  time::point startTime = time::now();  // Benchmark
+  hierarchy_.build(frozen_);
+  BOLT_DEBUG(indent, true, "Contracted " << getNumVertices() << " vertices with " << hierarchy_.getNumShortcuts()
+                                         << " shortcuts in " << time::seconds(time::now() - startTime) << " seconds");
+}
+
+void SparseGraph::computeLandmarks(std::size_t indent)
+{
+  BOLT_FUNC(indent, true, "computeLandmarks()");
+  if (isFrozen())
+    throw Exception(name_, "Cannot compute landmarks of a frozen graph");
+  if (numLandmarks_ == 0)
+    return;
+
+  time::point startTime = time::now();  // Benchmark
+  landmarks_.compute(numLandmarks_, queryVertices_.size());
+  BOLT_DEBUG(indent, true, "Computed distances from " << landmarks_.getNumLandmarks() << " landmarks in "
+                                                      << time::seconds(time::now() - startTime) << " seconds");
 }
 
 SparseVertex SparseGraph::addVertex(base::State *state, const VertexType &type, std::size_t indent)
 {
+  if (isFrozen())
+    throw Exception(name_, "Cannot add a vertex to a frozen graph");
+
+  ScopedPhaseTimer timer(profiler_, PHASE_GRAPH_MUTATION);
+  profiler_->increment(COUNT_VERTICES_ADDED);
+
   // Create vertex
   SparseVertex v = boost::add_vertex(g_);
 
@@ -761,12 +1060,14 @@ SparseVertex SparseGraph::addVertex(base::State *state, const VertexType &type,
     clearInterfaceData(state);
 
   // Connected component tracking
-  disjointSets_.make_set(v);
+  components_.addVertex(v);
+  landmarks_.addVertex(v);
 
   // Add vertex to nearest neighbor structure
   {
     std::lock_guard<std::mutex> guard(nearestNeighborMutex_);
     nn_->add(v);
+    neighborhoodVersion_++;
   }
 
   // Book keeping for what was added
@@ -789,9 +1090,10 @@ SparseVertex SparseGraph::addVertex(base::State *state, const VertexType &type,
     default:
       OMPL_ERROR("Unknown VertexType type %u", type);
   }
+  timer.stop();  // do not count visualization
 
   // Visualize
-  if (visualizeSparseGraph_)
+  if (BOLT_VISUALIZE(visualizeSparseGraph_))
   {
     visualizeVertex(v, type);
 
@@ -807,7 +1109,8 @@ SparseVertex SparseGraph::addVertex(base::State *state, const VertexType &type,
   }
 
   // Optional Voronoi Diagram
-  if (visualizeVoronoiDiagramAnimated_ || (visualizeVoronoiDiagram_ && sparseCriteria_->getUseFourthCriteria()))
+  if (BOLT_VISUALIZE(visualizeVoronoiDiagramAnimated_ ||
+                     (visualizeVoronoiDiagram_ && sparseCriteria_->getUseFourthCriteria())))
     visual_->vizVoronoiDiagram();
 
   // Enable saving
@@ -821,8 +1124,11 @@ SparseVertex SparseGraph::addVertex(base::State *state, const VertexType &type,
   return v;
 }
 
-SparseVertex SparseGraph::addVertexFromFile(base::State *state, const VertexType &type, std::size_t indent)
+SparseVertex SparseGraph::addVertexFromFile(base::State *state, const VertexType &type, std::size_t /*indent*/)
 {
+  if (isFrozen())
+    throw Exception(name_, "Cannot add a vertex to a frozen graph");
+
   // Create vertex
   SparseVertex v = boost::add_vertex(g_);
 
@@ -832,7 +1138,8 @@ SparseVertex SparseGraph::addVertexFromFile(base::State *state, const VertexType
   vertexPopularity_[v] = MAX_POPULARITY_WEIGHT;  // 100 means the vertex is very unpopular
 
   // Connected component tracking
-  disjointSets_.make_set(v);
+  components_.addVertex(v);
+  landmarks_.addVertex(v);
 
   return v;
 }
@@ -840,25 +1147,31 @@ SparseVertex SparseGraph::addVertexFromFile(base::State *state, const VertexType
 void SparseGraph::removeVertex(SparseVertex v, std::size_t indent)
 {
   BOLT_FUNC(indent, true, "removeVertex = " << v);
+  if (isFrozen())
+    throw Exception(name_, "Cannot remove a vertex from a frozen graph");
+  ScopedPhaseTimer timer(profiler_, PHASE_GRAPH_MUTATION);
 
   // Remove from nearest neighbor
   {
     std::lock_guard<std::mutex> guard(nearestNeighborMutex_);
     nn_->remove(v);
+    neighborhoodVersion_++;
   }
 
   // Delete state
   si_->freeState(vertexStateProperty_[v]);
   vertexStateProperty_[v] = NULL;
 
-  // TODO: disjointSets is now inaccurate
-  // Our checkAddConnectivity() criteria is broken
-  // because we frequntly delete edges and nodes..
-  // disjointSets_.remove_set(v);
-
   // Remove all edges to and from vertex
+  std::vector<SparseVertex> neighbors;
+  foreach (SparseVertex neighbor, boost::adjacent_vertices(v, g_))
+    neighbors.push_back(neighbor);
   boost::clear_vertex(v, g_);
 
+  // The former neighbors may no longer be connected to each other
+  components_.removeVertex(v);
+  components_.removeEdges(neighbors);
+
   // We do not actually remove the vertex from the graph
   // because that would invalidate the nearest neighbor tree
 }
@@ -867,6 +1180,8 @@ void SparseGraph::removeDeletedVertices(std::size_t indent)
 {
   bool verbose = true;
   BOLT_FUNC(indent, verbose || true, "removeDeletedVertices()");
+  if (isFrozen())
+    throw Exception(name_, "Cannot remove vertices from a frozen graph");
 
   // Remove all vertices that are set to 0
   std::size_t numRemoved = 0;
@@ -904,32 +1219,133 @@ void SparseGraph::removeDeletedVertices(std::size_t indent)
 
   // Reset the nearest neighbor tree
   nn_->clear();
+  neighborhoodVersion_++;
 
-  // Reset disjoint sets
-  disjointSets_ = SparseDisjointSetType(boost::get(boost::vertex_rank, g_), boost::get(boost::vertex_predecessor, g_));
+  // Vertices were renumbered, relabel the connected components
+  components_.rebuild();
 
   // Reinsert vertices into nearest neighbor
   foreach (SparseVertex v, boost::vertices(g_))
   {
     if (v <= queryVertices_.back()) // Ignore query vertices
+    {
+      components_.removeVertex(v);
       continue;
+    }
 
     nn_->add(v);
-    disjointSets_.make_set(v);
   }
 
-  // Reinsert edges into disjoint sets
-  foreach (SparseEdge e, boost::edges(g_))
+  // The distances, the workspace index and the motion cache were stored by the old vertex ids
+  if (!landmarks_.isEmpty())
+    computeLandmarks(indent);
+  if (sweptVolume_)
+    indexWorkspace();
+  motionCache_.clear();
+}
+
+void SparseGraph::reorderVertices(VertexOrder order, std::vector<SparseVertex> &newIndex, std::size_t indent)
+{
+  BOLT_FUNC(indent, true, "reorderVertices(): " << getVertexOrderName(order));
+  if (isFrozen())
+    throw Exception(name_, "Cannot reorder the vertices of a frozen graph");
+
+  time::point startTime = time::now();  // Benchmark
+  const std::size_t numVertices = boost::num_vertices(g_);
+  newIndex = computeVertexOrder(g_, si_, queryVertices_.size(), order);
+  std::vector<SparseVertex> oldIndex(numVertices);
+  for (std::size_t v = 0; v < numVertices; ++v)
+    oldIndex[newIndex[v]] = v;
+
+  // Copy the vertex properties in their new order. The interface data only moves its pointers
+  SparseAdjList reordered(numVertices);
+  for (std::size_t v = 0; v < numVertices; ++v)
   {
-    SparseVertex v1 = boost::source(e, g_);
-    SparseVertex v2 = boost::target(e, g_);
-    disjointSets_.union_set(v1, v2);
+    const SparseVertex old = oldIndex[v];
+    boost::put(vertex_state_t(), reordered, v, vertexStateProperty_[old]);
+    boost::put(vertex_type_t(), reordered, v, vertexTypeProperty_[old]);
+    boost::put(vertex_popularity_t(), reordered, v, vertexPopularity_[old]);
+
+    InterfaceHash &interfaces = boost::get(vertex_interface_data_t(), reordered, v);
+    foreach (InterfaceHash::value_type &entry, vertexInterfaceProperty_[old])
+    {
+      SparseVertex vp = newIndex[entry.first.first];
+      SparseVertex vpp = newIndex[entry.first.second];
+      if (vp > vpp)  // interface1 always belongs to the neighbor with the lower index
+      {
+        std::swap(vp, vpp);
+        entry.second.swapInterfaces();
+      }
+      interfaces[VertexPair(vp, vpp)] = entry.second;
+    }
+  }
+
+  // Add the edges sorted by their new endpoints, so the edges of neighboring vertices are also allocated together
+  struct ReorderedEdge
+  {
+    SparseVertex v1;
+    SparseVertex v2;
+    double weight;
+    EdgeType type;
+    int collisionState;
+
+    bool operator<(const ReorderedEdge &other) const
+    {
+      return v1 < other.v1 || (v1 == other.v1 && v2 < other.v2);
+    }
+  };
+  std::vector<ReorderedEdge> edges;
+  edges.reserve(boost::num_edges(g_));
+  foreach (const SparseEdge e, boost::edges(g_))
+  {
+    const SparseVertex v1 = newIndex[boost::source(e, g_)];
+    const SparseVertex v2 = newIndex[boost::target(e, g_)];
+    ReorderedEdge edge = { std::min(v1, v2), std::max(v1, v2), edgeWeightProperty_[e], edgeTypeProperty_[e],
+                           edgeCollisionStatePropertySparse_[e] };
+    edges.push_back(edge);
+  }
+  std::sort(edges.begin(), edges.end());
+  foreach (const ReorderedEdge &edge, edges)
+  {
+    SparseEdge e = boost::add_edge(edge.v1, edge.v2, reordered).first;
+    boost::put(boost::edge_weight_t(), reordered, e, edge.weight);
+    boost::put(edge_type_t(), reordered, e, edge.type);
+    boost::put(edge_collision_state_t(), reordered, e, edge.collisionState);
+  }
+  g_.swap(reordered);
+
+  // The nearest neighbor tree holds vertex ids
+  {
+    std::lock_guard<std::mutex> guard(nearestNeighborMutex_);
+    nn_->clear();
+    neighborhoodVersion_++;
+    foreach (SparseVertex v, boost::vertices(g_))
+      if (v >= queryVertices_.size() && !stateDeleted(v))
+        nn_->add(v);
   }
+
+  // Relabel the connected components
+  components_.rebuild();
+  foreach (SparseVertex v, boost::vertices(g_))
+    if (v < queryVertices_.size() || stateDeleted(v))
+      components_.removeVertex(v);
+  landmarks_.permute(newIndex);
+  motionCache_.permute(newIndex);
+  if (sweptVolume_)
+    indexWorkspace();
+
+  graphUnsaved_ = true;
+  BOLT_DEBUG(indent, true, "Reordered " << numVertices << " vertices and " << edges.size() << " edges in "
+                                        << time::seconds(time::now() - startTime) << " seconds");
 }
 
 SparseEdge SparseGraph::addEdge(SparseVertex v1, SparseVertex v2, EdgeType type, std::size_t indent)
 {
   BOLT_FUNC(indent, vAdd_ && false, "addEdge(): from vertex " << v1 << " to " << v2 << " type " << type);
+  if (isFrozen())
+    throw Exception(name_, "Cannot add an edge to a frozen graph");
+  ScopedPhaseTimer timer(profiler_, PHASE_GRAPH_MUTATION);
+  profiler_->increment(COUNT_EDGES_ADDED);
 
   if (superDebug_)  // Extra checks
   {
@@ -956,12 +1372,16 @@ SparseEdge SparseGraph::addEdge(SparseVertex v1, SparseVertex v2, EdgeType type,
 
   // Collision properties
   edgeCollisionStatePropertySparse_[e] = NOT_CHECKED;
+  if (sweptVolume_)
+    indexEdgeWorkspace(v1, v2);
 
   // Add the edge to the incrementeal connected components datastructure
-  disjointSets_.union_set(v1, v2);
+  components_.addEdge(v1, v2);
+  landmarks_.addEdge(v1, v2, edgeWeightProperty_[e]);
+  timer.stop();  // do not count visualization
 
   // Visualize
-  if (visualizeSparseGraph_)
+  if (BOLT_VISUALIZE(visualizeSparseGraph_))
   {
     visualizeEdge(e, type, /*windowID*/ 1);
     visualizeEdge(e, type, /*windowID*/ 7);  // projection to 2D space
@@ -1009,6 +1429,8 @@ SparseEdge SparseGraph::addEdge(SparseVertex v1, SparseVertex v2, EdgeType type,
 
 bool SparseGraph::hasEdge(SparseVertex v1, SparseVertex v2)
 {
+  if (isFrozen())
+    return frozen_.findEdge(v1, v2) != CompactGraph::NO_EDGE;
   return boost::edge(v1, v2, g_).second;
 }
 
@@ -1062,6 +1484,12 @@ const base::State *SparseGraph::getState(SparseVertex v) const
   return vertexStateProperty_[v];
 }
 
+const double *SparseGraph::getCoordinates(SparseVertex v) const
+{
+  const base::State *state = v < queryStates_.size() ? queryStates_[v] : vertexStateProperty_[v];
+  return state->as<base::RealVectorStateSpace::StateType>()->values;
+}
+
 bool SparseGraph::stateDeleted(SparseVertex v) const
 {
   return vertexStateProperty_[v] == NULL;
@@ -1112,6 +1540,8 @@ void SparseGraph::clearEdgesNearVertex(SparseVertex vertex, std::size_t indent)
   // Optionally disable this feature
   if (!sparseCriteria_->useClearEdgesNearVertex_)
     return;
+  if (isFrozen())
+    throw Exception(name_, "Cannot remove edges from a frozen graph");
 
   // TODO(davetcoleman): combine this with clearInterfaceData and ensure that all interface data is equally cleared
   // but do not clear out nearby edges if a non-quality-path vertex is added
@@ -1121,17 +1551,26 @@ void SparseGraph::clearEdgesNearVertex(SparseVertex vertex, std::size_t indent)
   nn_->nearestR(vertex, sparseCriteria_->getSparseDelta(), graphNeighbors);
 
   std::size_t origNumEdges = getNumEdges();
+  std::vector<SparseVertex> endpoints;
   // For each of the vertices
   foreach (SparseVertex v, graphNeighbors)
   {
     // Remove all edges to and from vertex
+    foreach (SparseVertex neighbor, boost::adjacent_vertices(v, g_))
+    {
+      endpoints.push_back(v);
+      endpoints.push_back(neighbor);
+    }
     boost::clear_vertex(v, g_);
   }
 
+  // The cleared vertices may have split their components
+  components_.removeEdges(endpoints);
+
   BOLT_DEBUG(indent, false, "clearEdgesNearVertex() removed " << origNumEdges - getNumEdges());
 
   // Only display database if enabled
-  if (visualizeSparseGraph_ && visualizeSparseGraphSpeed_ > std::numeric_limits<double>::epsilon())
+  if (BOLT_VISUALIZE(visualizeSparseGraph_) && visualizeSparseGraphSpeed_ > std::numeric_limits<double>::epsilon())
   {
     // visual_->waitForUserFeedback("before clear edge near vertex");
     displayDatabase(true, indent);
@@ -1141,6 +1580,9 @@ void SparseGraph::clearEdgesNearVertex(SparseVertex vertex, std::size_t indent)
 
 void SparseGraph::displayDatabase(bool showVertices, bool showEdges, std::size_t windowID, std::size_t indent)
 {
+#ifdef BOLT_HEADLESS
+  return;
+#endif
   BOLT_FUNC(indent, vVisualize_, "displayDatabase() - Display Sparse Database");
 
   // Error check
@@ -1296,7 +1738,7 @@ VertexPair SparseGraph::interfaceDataIndex(SparseVertex vp, SparseVertex vpp)
   return VertexPair(0, 0);  // prevent compiler warnings
 }
 
-InterfaceData &SparseGraph::getInterfaceData(SparseVertex v, SparseVertex vp, SparseVertex vpp, std::size_t indent)
+InterfaceData &SparseGraph::getInterfaceData(SparseVertex v, SparseVertex vp, SparseVertex vpp, std::size_t /*indent*/)
 {
   // BOLT_FUNC(indent, sparseCriteria_->vQuality_, "getInterfaceData() " << v << ", " << vp << ", " << vpp);
   return vertexInterfaceProperty_[v][interfaceDataIndex(vp, vpp)];
@@ -1317,13 +1759,34 @@ void SparseGraph::debugVertex(const SparseVertex v)
   debugState(getState(v));
 }
 
+void SparseGraph::setNearestNeighborsType(NearestNeighborsType type)
+{
+  std::lock_guard<std::mutex> lock(nearestNeighborMutex_);
+
+  std::vector<SparseVertex> vertices;
+  nn_->list(vertices);
+
+  nn_.reset(allocNearestNeighbors(type, si_->getStateSpace(),
+                                  boost::bind(&otb::SparseGraph::getCoordinates, this, _1)));
+  nn_->setDistanceFunction(boost::bind(&otb::SparseGraph::distanceFunction, this, _1, _2));
+  nn_->add(vertices);
+  neighborhoodVersion_++;
+
+  // The factory falls back to GNAT for spaces other than RealVector
+  nnType_ = dynamic_cast<NearestNeighborsRealVector *>(nn_.get()) ? type : NN_GNAT;
+}
+
 void SparseGraph::debugNN()
 {
   // Show contents of GNAT
   std::cout << std::endl;
   std::cout << "-------------------------------------------------------" << std::endl;
   NearestNeighborsGNAT<SparseVertex> *gnat = dynamic_cast<NearestNeighborsGNAT<SparseVertex> *>(nn_.get());
-  std::cout << "GNAT: " << *gnat << std::endl;
+  if (gnat)
+    std::cout << "GNAT: " << *gnat << std::endl;
+  else
+    std::cout << "Nearest neighbors: " << getNearestNeighborsName(nnType_) << ", " << nn_->size() << " elements"
+              << std::endl;
   std::cout << std::endl;
 }
 
@@ -1339,9 +1802,15 @@ void SparseGraph::printGraphStats()
   double totalEdgeLength = 0;
   double maxEdgeLength = -1 * std::numeric_limits<double>::infinity();
   double minEdgeLength = std::numeric_limits<double>::infinity();
-  foreach (const SparseEdge e, boost::edges(g_))
+  std::vector<double> lengths;
+  if (isFrozen())
+    for (std::size_t i = 0; i < frozen_.getNumEdges(); ++i)
+      lengths.push_back(frozen_.getWeight(i));
+  else
+    foreach (const SparseEdge e, boost::edges(g_))
+      lengths.push_back(edgeWeightProperty_[e]);
+  foreach (const double length, lengths)
   {
-    const double length = edgeWeightProperty_[e];
     totalEdgeLength += length;
     if (maxEdgeLength < length)
       maxEdgeLength = length;
@@ -1365,11 +1834,62 @@ void SparseGraph::printGraphStats()
   BOLT_DEBUG(indent, 1, "      Difference:          " << averageEdgeLength - sparseCriteria_->getSparseDelta());
   BOLT_DEBUG(indent, 1, "      Penetration:         " << sparseCriteria_->getDiscretizePenetrationDist());
   BOLT_DEBUG(indent, 1, "------------------------------------------------------");
+  getMemoryReport().print("SparseGraph");
+}
+
+MemoryReport SparseGraph::getMemoryReport() const
+{
+  MemoryReport report;
+  report.numVertices_ = getNumRealVertices();
+  report.numEdges_ = getNumEdges();
+
+  const std::size_t stateBytes = MemoryReport::estimateStateBytes(si_);
+  std::size_t numStates = 0;
+  std::size_t numInterfaceStates = 0;
+  std::size_t interfaceBytes = 0;
+  foreach (const SparseVertex v, boost::vertices(g_))
+  {
+    // Query vertices only point to a state while a search is running
+    if (v >= queryVertices_.size() && vertexStateProperty_[v])
+      numStates++;
+
+    const InterfaceHash &hash = vertexInterfaceProperty_[v];
+    interfaceBytes += MemoryReport::estimateHashMapBytes(hash);
+    for (InterfaceHash::const_iterator it = hash.begin(); it != hash.end(); ++it)
+    {
+      if (it->second.hasInterface1())
+        numInterfaceStates += 2;
+      if (it->second.hasInterface2())
+        numInterfaceStates += 2;
+    }
+  }
+  report.add(MEMORY_STATES, numStates * stateBytes);
+  report.add(MEMORY_INTERFACE_DATA, interfaceBytes + numInterfaceStates * stateBytes);
+
+  report.addAdjacencyList(g_);
+  report.add(MEMORY_DISJOINT_SETS, components_.getMemoryBytes());
+  report.add(MEMORY_LANDMARKS, landmarks_.getMemoryBytes());
+  frozen_.addToMemoryReport(report);
+  hierarchy_.addToMemoryReport(report);
+  bidirectional_.addToMemoryReport(report);
+  workspaceIndex_.addToMemoryReport(report);
+  motionCache_.addToMemoryReport(report);
+  statePool_->addToMemoryReport(report);
+
+  const NearestNeighborsRealVector *nnRealVector = dynamic_cast<const NearestNeighborsRealVector *>(nn_.get());
+  if (nnRealVector)
+    report.add(MEMORY_NEAREST_NEIGHBORS, nnRealVector->getMemoryBytes());
+  else
+    report.add(MEMORY_NEAREST_NEIGHBORS,
+               MemoryReport::estimateNearestNeighborsBytes(nn_->size(), sizeof(SparseVertex)));
+
+  return report;
 }
 
 bool SparseGraph::verifyGraph(std::size_t indent)
 {
   BOLT_FUNC(indent, true, "verifyGraph()");
+  ScopedCheckSite site(SITE_GRAPH_VERIFICATION);
 
   foreach (const SparseVertex v, boost::vertices(g_))
   {
@@ -1441,7 +1961,7 @@ void otb::SparsestarVisitor::discover_vertex(SparseVertex v, const SparseAdjList
   // Statistics
   parent_->recordNodeOpened();
 
-  if (parent_->visualizeAstar_)
+  if (BOLT_VISUALIZE(parent_->visualizeAstar_))
     parent_->getVisual()->viz4()->state(parent_->getState(v), tools::SMALL, tools::GREEN, 1);
 }
 
@@ -1450,7 +1970,7 @@ void otb::SparsestarVisitor::examine_vertex(SparseVertex v, const SparseAdjList
   // Statistics
   parent_->recordNodeClosed();
 
-  if (parent_->visualizeAstar_)
+  if (BOLT_VISUALIZE(parent_->visualizeAstar_))
   {
     parent_->getVisual()->viz4()->state(parent_->getState(v), tools::LARGE, tools::BLACK, 1);
     parent_->getVisual()->viz4()->trigger();
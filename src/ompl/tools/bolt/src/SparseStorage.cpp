@@ -40,12 +40,18 @@
 #include <ompl/tools/bolt/SparseStorage.h>
 #include <ompl/tools/bolt/SparseGraph.h>
 #include <ompl/tools/bolt/BoostGraphHeaders.h>
+#include <ompl/base/spaces/RealVectorStateSpace.h>
 
 // Boost
 #include <boost/foreach.hpp>
 #include <boost/thread.hpp>
 #include <boost/filesystem.hpp>
 
+// C++
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
 // Profiling
 #include <valgrind/callgrind.h>
 
@@ -57,6 +63,14 @@ namespace tools
 {
 namespace bolt
 {
+namespace
+{
+bool edgeEndpointsLess(const SparseStorage::BoltEdgeData &a, const SparseStorage::BoltEdgeData &b)
+{
+  return a.endpoints_ < b.endpoints_;
+}
+}  // namespace
+
 SparseStorage::SparseStorage(const base::SpaceInformationPtr &si, SparseGraph *sparseGraph)
   : si_(si), sparseGraph_(sparseGraph)
 {
@@ -85,6 +99,9 @@ void SparseStorage::save(const std::string &filePath, std::size_t indent)
   save(out);
   out.close();
 
+  if (persistMotionCache_)
+    saveMotionCache(getMotionCachePath(filePath), indent);
+
   // Log the graph size
   std::ofstream loggingFile;                              // open to append
   loggingFile.open(loggingPath_.c_str(), std::ios::out);  // no append | std::ios::app);
@@ -110,10 +127,17 @@ void SparseStorage::save(std::ostream &out)
     h.vertex_count = sparseGraph_->getNumVertices() - numQueryVertices_;
     h.edge_count = sparseGraph_->getNumEdges();
     si_->getStateSpace()->computeSignature(h.signature);
+    prepareEncoding(h);
+    h.landmark_count = sparseGraph_->getLandmarks().getNumLandmarks();
     oa << h;
+    fileHeader_ = h;
+
+    // Renumbering only happens in the file
+    fileIndex_ = computeVertexOrder(sparseGraph_->getGraph(), si_, numQueryVertices_, vertexOrder_);
 
     saveVertices(oa);
     saveEdges(oa);
+    saveLandmarks(oa);
   }
   catch (boost::archive::archive_exception &ae)
   {
@@ -123,15 +147,15 @@ void SparseStorage::save(std::ostream &out)
 
 void SparseStorage::saveVertices(boost::archive::binary_oarchive &oa)
 {
-  const base::StateSpacePtr &space = si_->getStateSpace();
-
-  std::vector<unsigned char> state(space->getSerializationLength());
   std::size_t feedbackFrequency = sparseGraph_->getNumVertices() / 10;
 
   std::cout << "         Saving vertices: " << std::flush;
   std::size_t count = 0;
   std::size_t errorCheckNumQueryVertices = 0;
-  foreach (const SparseVertex v, boost::vertices(sparseGraph_->getGraph()))
+  std::vector<SparseVertex> vertices(fileIndex_.size());
+  for (std::size_t v = 0; v < fileIndex_.size(); ++v)
+    vertices[fileIndex_[v]] = v;
+  foreach (const SparseVertex v, vertices)
   {
     // Skip the query vertex that is nullptr
     if (v < sparseGraph_->getNumQueryVertices())
@@ -147,8 +171,7 @@ void SparseStorage::saveVertices(boost::archive::binary_oarchive &oa)
     vertexData.type_ = sparseGraph_->getVertexTypeProperty(v);
 
     // Serializing the state contained in this vertex
-    space->serialize(&state[0], sparseGraph_->getStateNonConst(v));
-    vertexData.stateSerialized_ = state;
+    encodeState(fileHeader_, sparseGraph_->getState(v), vertexData.stateSerialized_);
 
     // Save to file
     oa << vertexData;
@@ -169,10 +192,12 @@ void SparseStorage::saveEdges(boost::archive::binary_oarchive &oa)
 
   std::cout << "         Saving edges: " << std::flush;
   std::size_t count = 1;
+  std::vector<BoltEdgeData> edges;
+  edges.reserve(sparseGraph_->getNumEdges());
   foreach (const SparseEdge e, boost::edges(sparseGraph_->getGraph()))
   {
-    const SparseVertex v1 = boost::source(e, sparseGraph_->getGraph());
-    const SparseVertex v2 = boost::target(e, sparseGraph_->getGraph());
+    const SparseVertex v1 = fileIndex_[boost::source(e, sparseGraph_->getGraph())];
+    const SparseVertex v2 = fileIndex_[boost::target(e, sparseGraph_->getGraph())];
 
     // Convert to new structure
     BoltEdgeData edgeData;
@@ -183,7 +208,20 @@ void SparseStorage::saveEdges(boost::archive::binary_oarchive &oa)
     // Other properties
     edgeData.weight_ = sparseGraph_->getEdgeWeightProperty(e);
     edgeData.type_ = sparseGraph_->getEdgeTypeProperty(e);
+    edges.push_back(edgeData);
+  }
+
+  // Edges of renumbered vertices are written in the new order too, so loading allocates them together
+  if (vertexOrder_ != ORDER_INSERTION)
+  {
+    foreach (BoltEdgeData &edgeData, edges)
+      if (edgeData.endpoints_.first > edgeData.endpoints_.second)
+        std::swap(edgeData.endpoints_.first, edgeData.endpoints_.second);
+    std::sort(edges.begin(), edges.end(), edgeEndpointsLess);
+  }
 
+  foreach (const BoltEdgeData &edgeData, edges)
+  {
     // Copy to file
     oa << edgeData;
 
@@ -195,6 +233,30 @@ void SparseStorage::saveEdges(boost::archive::binary_oarchive &oa)
   std::cout << std::endl;
 }
 
+void SparseStorage::saveLandmarks(boost::archive::binary_oarchive &oa)
+{
+  const LandmarkHeuristic &landmarks = sparseGraph_->getLandmarks();
+  if (landmarks.isEmpty())
+    return;
+
+  // Renumbered like the vertices, without the query vertices
+  std::vector<unsigned int> landmarkIndices;
+  foreach (const SparseVertex v, landmarks.getLandmarks())
+    landmarkIndices.push_back(fileIndex_[v] - numQueryVertices_);
+
+  std::vector<SparseVertex> vertices(fileIndex_.size());
+  for (std::size_t v = 0; v < fileIndex_.size(); ++v)
+    vertices[fileIndex_[v]] = v;
+  std::vector<double> distances;
+  distances.reserve((vertices.size() - numQueryVertices_) * landmarks.getNumLandmarks());
+  for (std::size_t index = numQueryVertices_; index < vertices.size(); ++index)
+    for (std::size_t i = 0; i < landmarks.getNumLandmarks(); ++i)
+      distances.push_back(landmarks.getDistance(vertices[index], i));
+
+  oa << landmarkIndices;
+  oa << distances;
+}
+
 bool SparseStorage::load(const std::string &filePath, std::size_t indent)
 {
   BOLT_INFO(indent, true, "------------------------------------------------");
@@ -232,6 +294,9 @@ bool SparseStorage::load(const std::string &filePath, std::size_t indent)
   // Re-enable visualizations
   sparseGraph_->visualizeSparseGraph_ = visualizeSparseGraph;
 
+  if (result && persistMotionCache_)
+    loadMotionCache(getMotionCachePath(filePath), indent);
+
   // Save previous graph size
   prevNumEdges_ = sparseGraph_->getNumEdges();
   prevNumVertices_ = sparseGraph_->getNumVertices();
@@ -272,6 +337,7 @@ bool SparseStorage::load(std::istream &in)
       OMPL_ERROR("Failed to load BoltData: StateSpace signature mismatch");
       return false;
     }
+    fileHeader_ = h;
 
     // Pre-allocate memory in graph
     sparseGraph_->getGraphNonConst().m_vertices.resize(h.vertex_count);
@@ -280,6 +346,8 @@ bool SparseStorage::load(std::istream &in)
     // Read from file
     loadVertices(h.vertex_count, ia);
     loadEdges(h.edge_count, ia);
+    if (h.landmark_count)
+      loadLandmarks(h.landmark_count, ia);
   }
   catch (boost::archive::archive_exception &ae)
   {
@@ -311,7 +379,8 @@ void SparseStorage::loadVertices(unsigned int numVertices, boost::archive::binar
 
     // Allocating a new state and deserializing it from the buffer
     base::State *state = space->allocState();
-    space->deserialize(state, &vertexData.stateSerialized_[0]);
+    if (!decodeState(fileHeader_, vertexData.stateSerialized_, state))
+      throw boost::archive::archive_exception(boost::archive::archive_exception::input_stream_error);
 
     // Add to Sparse graph
     VertexType type = static_cast<VertexType>(vertexData.type_);
@@ -397,6 +466,350 @@ void SparseStorage::loadEdges(unsigned int numEdges, boost::archive::binary_iarc
   std::cout << std::endl;
 }
 
+void SparseStorage::loadLandmarks(std::size_t numLandmarks, boost::archive::binary_iarchive &ia, std::size_t indent)
+{
+  BOLT_INFO(indent, true, "Loading landmarks from file: " << numLandmarks);
+
+  std::vector<unsigned int> landmarkIndices;
+  std::vector<double> fileDistances;
+  ia >> landmarkIndices;
+  ia >> fileDistances;
+  if (landmarkIndices.size() != numLandmarks ||
+      fileDistances.size() != (sparseGraph_->getNumVertices() - numQueryVertices_) * numLandmarks)
+  {
+    OMPL_WARN("Ignoring landmarks in file because they do not match the graph");
+    return;
+  }
+
+  // The query vertices are reached by no landmark
+  std::vector<SparseVertex> landmarks(landmarkIndices.begin(), landmarkIndices.end());
+  foreach (SparseVertex &v, landmarks)
+    v += numQueryVertices_;
+  std::vector<double> distances(numQueryVertices_ * numLandmarks, LandmarkHeuristic::UNREACHED);
+  distances.insert(distances.end(), fileDistances.begin(), fileDistances.end());
+  sparseGraph_->getLandmarksNonConst().setTables(landmarks, distances);
+}
+
+void SparseStorage::saveMotionCache(const std::string &filePath, std::size_t indent)
+{
+  std::vector<MotionCache::VertexPair> validMotions;
+  std::vector<MotionCache::VertexPair> invalidMotions;
+  sparseGraph_->getMotionCache().getResults(validMotions, invalidMotions);
+  BOLT_INFO(indent, true, "Saving motion cache: " << validMotions.size() + invalidMotions.size() << " motions");
+
+  // Renumbered like the vertices, without the query vertices. Motions of removed vertices are dropped
+  typedef std::pair<unsigned int, unsigned int> FileMotion;
+  std::vector<FileMotion> fileMotions[2];
+  const std::vector<MotionCache::VertexPair> *motions[2] = { &validMotions, &invalidMotions };
+  for (std::size_t i = 0; i < 2; ++i)
+  {
+    foreach (const MotionCache::VertexPair &motion, *motions[i])
+    {
+      if (motion.first < numQueryVertices_ || motion.second < numQueryVertices_ ||
+          motion.first >= fileIndex_.size() || motion.second >= fileIndex_.size() ||
+          sparseGraph_->stateDeleted(motion.first) || sparseGraph_->stateDeleted(motion.second))
+        continue;
+      fileMotions[i].push_back(std::make_pair(fileIndex_[motion.first] - numQueryVertices_,
+                                              fileIndex_[motion.second] - numQueryVertices_));
+    }
+  }
+
+  std::ofstream out(filePath.c_str(), std::ios::binary);
+  try
+  {
+    boost::archive::binary_oarchive oa(out);
+
+    Header h;
+    h.marker = MOTION_CACHE_ARCHIVE_MARKER;
+    h.vertex_count = fileHeader_.vertex_count;
+    h.edge_count = fileMotions[0].size() + fileMotions[1].size();
+    si_->getStateSpace()->computeSignature(h.signature);
+    oa << h;
+    oa << fileMotions[0];
+    oa << fileMotions[1];
+  }
+  catch (boost::archive::archive_exception &ae)
+  {
+    OMPL_ERROR("Failed to save motion cache: %s", ae.what());
+  }
+  out.close();
+}
+
+bool SparseStorage::loadMotionCache(const std::string &filePath, std::size_t indent)
+{
+  if (!boost::filesystem::exists(filePath))
+  {
+    BOLT_INFO(indent, true, "Motion cache file does not exist: " << filePath.c_str());
+    return false;
+  }
+
+  std::ifstream in(filePath.c_str(), std::ios::binary);
+  try
+  {
+    boost::archive::binary_iarchive ia(in);
+
+    Header h;
+    ia >> h;
+    std::vector<int> sig;
+    si_->getStateSpace()->computeSignature(sig);
+    if (h.marker != MOTION_CACHE_ARCHIVE_MARKER || h.signature != sig ||
+        h.vertex_count != sparseGraph_->getNumVertices() - numQueryVertices_)
+    {
+      OMPL_WARN("Ignoring motion cache because it does not match the graph: %s", filePath.c_str());
+      return false;
+    }
+
+    typedef std::pair<unsigned int, unsigned int> FileMotion;
+    std::vector<FileMotion> fileMotions[2];
+    ia >> fileMotions[0];
+    ia >> fileMotions[1];
+
+    // Loaded vertices follow the query vertices in file order
+    MotionCache &motionCache = sparseGraph_->getMotionCacheNonConst();
+    for (std::size_t i = 0; i < 2; ++i)
+      foreach (const FileMotion &motion, fileMotions[i])
+        motionCache.insert(motion.first + numQueryVertices_, motion.second + numQueryVertices_, i == 0);
+    BOLT_INFO(indent, true, "Loaded motion cache: " << h.edge_count << " motions");
+  }
+  catch (boost::archive::archive_exception &ae)
+  {
+    OMPL_ERROR("Failed to load motion cache: %s", ae.what());
+    return false;
+  }
+
+  return true;
+}
+
+bool SparseStorage::read(const std::string &filePath, std::vector<BoltVertexData> &vertices,
+                         std::vector<BoltEdgeData> &edges, std::size_t indent)
+{
+  BOLT_INFO(indent, true, "SparseStorage: Reading Sparse Graph from " << filePath.c_str());
+
+  if (!boost::filesystem::exists(filePath))
+  {
+    OMPL_ERROR("Database file does not exist: %s", filePath.c_str());
+    return false;
+  }
+
+  std::ifstream in(filePath.c_str(), std::ios::binary);
+  try
+  {
+    boost::archive::binary_iarchive ia(in);
+
+    Header h;
+    ia >> h;
+    if (h.marker != OMPL_PLANNER_DATA_ARCHIVE_MARKER)
+    {
+      OMPL_ERROR("Failed to read BoltData: BoltData archive marker not found");
+      return false;
+    }
+
+    std::vector<int> sig;
+    si_->getStateSpace()->computeSignature(sig);
+    if (h.signature != sig)
+    {
+      OMPL_ERROR("Failed to read BoltData: StateSpace signature mismatch");
+      return false;
+    }
+
+    // Compact encodings are widened to the native serialization, so callers can deserialize every vertex the same
+    const base::StateSpacePtr &space = si_->getStateSpace();
+    base::State *state = space->allocState();
+    std::vector<unsigned char> bytes(space->getSerializationLength());
+    vertices.resize(h.vertex_count);
+    for (std::size_t i = 0; i < vertices.size(); ++i)
+    {
+      ia >> vertices[i];
+      if (h.encoding == STATE_ENCODING_NATIVE)
+        continue;
+      if (!decodeState(h, vertices[i].stateSerialized_, state))
+      {
+        space->freeState(state);
+        OMPL_ERROR("Failed to read BoltData: vertex %u does not match its encoding",
+                   static_cast<unsigned int>(i));
+        return false;
+      }
+      space->serialize(&bytes[0], state);
+      vertices[i].stateSerialized_ = bytes;
+    }
+    space->freeState(state);
+
+    edges.resize(h.edge_count);
+    for (std::size_t i = 0; i < edges.size(); ++i)
+      ia >> edges[i];
+  }
+  catch (boost::archive::archive_exception &ae)
+  {
+    OMPL_ERROR("Failed to read BoltData: %s", ae.what());
+    return false;
+  }
+
+  BOLT_INFO(indent + 2, true, "Read " << vertices.size() << " vertices and " << edges.size() << " edges");
+  return true;
+}
+
+bool SparseStorage::write(const std::string &filePath, const std::vector<BoltVertexData> &vertices,
+                          const std::vector<BoltEdgeData> &edges, std::size_t indent)
+{
+  BOLT_INFO(indent, true, "SparseStorage: Writing " << vertices.size() << " vertices and " << edges.size()
+                                                     << " edges to " << filePath.c_str());
+
+  std::ofstream out(filePath.c_str(), std::ios::binary);
+  if (!out.good())
+  {
+    OMPL_ERROR("Failed to write BoltData: unable to open %s", filePath.c_str());
+    return false;
+  }
+
+  try
+  {
+    boost::archive::binary_oarchive oa(out);
+
+    Header h;
+    h.marker = OMPL_PLANNER_DATA_ARCHIVE_MARKER;
+    h.vertex_count = vertices.size();
+    h.edge_count = edges.size();
+    si_->getStateSpace()->computeSignature(h.signature);
+    prepareEncoding(h);
+    oa << h;
+
+    if (h.encoding == STATE_ENCODING_NATIVE)
+    {
+      for (std::size_t i = 0; i < vertices.size(); ++i)
+        oa << vertices[i];
+    }
+    else
+    {
+      // The vertices hold native serializations, re-encode each one
+      const base::StateSpacePtr &space = si_->getStateSpace();
+      base::State *state = space->allocState();
+      BoltVertexData vertexData;
+      for (std::size_t i = 0; i < vertices.size(); ++i)
+      {
+        space->deserialize(state, &vertices[i].stateSerialized_[0]);
+        vertexData.type_ = vertices[i].type_;
+        encodeState(h, state, vertexData.stateSerialized_);
+        oa << vertexData;
+      }
+      space->freeState(state);
+    }
+    for (std::size_t i = 0; i < edges.size(); ++i)
+      oa << edges[i];
+  }
+  catch (boost::archive::archive_exception &ae)
+  {
+    OMPL_ERROR("Failed to write BoltData: %s", ae.what());
+    return false;
+  }
+
+  return true;
+}
+
+void SparseStorage::prepareEncoding(Header &header) const
+{
+  header.encoding = stateEncoding_;
+  header.low.clear();
+  header.high.clear();
+  if (header.encoding == STATE_ENCODING_NATIVE)
+    return;
+
+  const base::RealVectorStateSpace *space = dynamic_cast<base::RealVectorStateSpace *>(si_->getStateSpace().get());
+  if (!space)
+  {
+    OMPL_WARN("SparseStorage: compact state encodings require a RealVectorStateSpace, saving states natively");
+    header.encoding = STATE_ENCODING_NATIVE;
+    return;
+  }
+
+  if (header.encoding == STATE_ENCODING_INT16)
+  {
+    header.low = space->getBounds().low;
+    header.high = space->getBounds().high;
+  }
+}
+
+void SparseStorage::encodeState(const Header &header, const base::State *state,
+                                std::vector<unsigned char> &bytes) const
+{
+  const base::StateSpacePtr &space = si_->getStateSpace();
+  if (header.encoding == STATE_ENCODING_NATIVE)
+  {
+    bytes.resize(space->getSerializationLength());
+    space->serialize(&bytes[0], state);
+    return;
+  }
+
+  const double *values = state->as<base::RealVectorStateSpace::StateType>()->values;
+  const std::size_t dimension = space->getDimension();
+  if (header.encoding == STATE_ENCODING_FLOAT32)
+  {
+    bytes.resize(dimension * sizeof(float));
+    for (std::size_t i = 0; i < dimension; ++i)
+    {
+      const float value = static_cast<float>(values[i]);
+      memcpy(&bytes[i * sizeof(float)], &value, sizeof(float));
+    }
+    return;
+  }
+
+  // Map [low, high] onto the full range of an int16
+  bytes.resize(dimension * sizeof(boost::int16_t));
+  for (std::size_t i = 0; i < dimension; ++i)
+  {
+    const double range = header.high[i] - header.low[i];
+    double scaled = range > 0 ? (values[i] - header.low[i]) / range * 65535.0 - 32768.0 : 0.0;
+    scaled = std::min(32767.0, std::max(-32768.0, std::floor(scaled + 0.5)));
+    const boost::int16_t value = static_cast<boost::int16_t>(scaled);
+    memcpy(&bytes[i * sizeof(boost::int16_t)], &value, sizeof(boost::int16_t));
+  }
+}
+
+bool SparseStorage::decodeState(const Header &header, const std::vector<unsigned char> &bytes,
+                                base::State *state) const
+{
+  const base::StateSpacePtr &space = si_->getStateSpace();
+  if (header.encoding == STATE_ENCODING_NATIVE)
+  {
+    if (bytes.size() != space->getSerializationLength())
+      return false;
+    space->deserialize(state, &bytes[0]);
+    return true;
+  }
+
+  // Compact encodings are only written for real vector spaces, see prepareEncoding()
+  if (!dynamic_cast<base::RealVectorStateSpace *>(space.get()))
+  {
+    OMPL_ERROR("SparseStorage: compact state encodings require a RealVectorStateSpace");
+    return false;
+  }
+
+  double *values = state->as<base::RealVectorStateSpace::StateType>()->values;
+  const std::size_t dimension = space->getDimension();
+  if (header.encoding == STATE_ENCODING_FLOAT32)
+  {
+    if (bytes.size() != dimension * sizeof(float))
+      return false;
+    for (std::size_t i = 0; i < dimension; ++i)
+    {
+      float value;
+      memcpy(&value, &bytes[i * sizeof(float)], sizeof(float));
+      values[i] = value;
+    }
+    return true;
+  }
+
+  if (header.encoding != STATE_ENCODING_INT16 || bytes.size() != dimension * sizeof(boost::int16_t) ||
+      header.low.size() != dimension || header.high.size() != dimension)
+    return false;
+  for (std::size_t i = 0; i < dimension; ++i)
+  {
+    boost::int16_t value;
+    memcpy(&value, &bytes[i * sizeof(boost::int16_t)], sizeof(boost::int16_t));
+    values[i] = header.low[i] + (value + 32768.0) / 65535.0 * (header.high[i] - header.low[i]);
+  }
+  return true;
+}
+
 }  // namespace bolt
 
 }  // namespace tools
@@ -0,0 +1,174 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2016, University of Colorado, Boulder
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the Univ of CO, Boulder nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+/* Author: Dave Coleman <dave@dav.ee>
+   Desc:   Recycles the states of rejected samples between the threads generating a sparse graph
+*/
+
+// OMPL
+#include <ompl/tools/bolt/StatePool.h>
+#include <ompl/tools/bolt/GenerationProfiler.h>
+
+// C++
+#include <algorithm>
+
+namespace ompl
+{
+namespace tools
+{
+namespace bolt
+{
+StatePool::StatePool(const base::SpaceInformationPtr &si, std::size_t numThreads, std::size_t batchSize)
+  : si_(si), batchSize_(std::max<std::size_t>(1, batchSize)), freeLists_(std::max<std::size_t>(1, numThreads) + 1)
+{
+}
+
+StatePool::~StatePool()
+{
+  clear();
+}
+
+base::State *StatePool::allocState()
+{
+  FreeList &freeList = getFreeList();
+  {
+    std::lock_guard<std::mutex> lock(freeList.mutex_);
+    if (freeList.states_.empty())
+    {
+      // Take back a batch freed by another thread
+      FreeList &shared = getSharedList();
+      std::lock_guard<std::mutex> sharedLock(shared.mutex_);
+      const std::size_t numTaken = std::min(batchSize_, shared.states_.size());
+      freeList.states_.insert(freeList.states_.end(), shared.states_.end() - numTaken, shared.states_.end());
+      shared.states_.resize(shared.states_.size() - numTaken);
+    }
+
+    if (!freeList.states_.empty())
+    {
+      base::State *state = freeList.states_.back();
+      freeList.states_.pop_back();
+      freeList.reused_++;
+      return state;
+    }
+    freeList.allocated_++;
+  }
+
+  return si_->allocState();
+}
+
+base::State *StatePool::cloneState(const base::State *source)
+{
+  base::State *state = allocState();
+  si_->copyState(state, source);
+  return state;
+}
+
+void StatePool::freeState(base::State *state)
+{
+  FreeList &freeList = getFreeList();
+  std::lock_guard<std::mutex> lock(freeList.mutex_);
+  freeList.states_.push_back(state);
+  if (freeList.states_.size() < 2 * batchSize_)
+    return;
+
+  // Hand a batch to the threads that allocate more than they free
+  FreeList &shared = getSharedList();
+  std::lock_guard<std::mutex> sharedLock(shared.mutex_);
+  shared.states_.insert(shared.states_.end(), freeList.states_.end() - batchSize_, freeList.states_.end());
+  freeList.states_.resize(freeList.states_.size() - batchSize_);
+}
+
+void StatePool::clear()
+{
+  for (std::size_t i = 0; i < freeLists_.size(); ++i)
+  {
+    std::lock_guard<std::mutex> lock(freeLists_[i].mutex_);
+    for (std::size_t j = 0; j < freeLists_[i].states_.size(); ++j)
+      si_->freeState(freeLists_[i].states_[j]);
+    freeLists_[i].states_.clear();
+  }
+}
+
+std::size_t StatePool::getNumPooled() const
+{
+  std::size_t total = 0;
+  for (std::size_t i = 0; i < freeLists_.size(); ++i)
+  {
+    std::lock_guard<std::mutex> lock(freeLists_[i].mutex_);
+    total += freeLists_[i].states_.size();
+  }
+  return total;
+}
+
+std::size_t StatePool::getNumAllocated() const
+{
+  std::size_t total = 0;
+  for (std::size_t i = 0; i < freeLists_.size(); ++i)
+  {
+    std::lock_guard<std::mutex> lock(freeLists_[i].mutex_);
+    total += freeLists_[i].allocated_;
+  }
+  return total;
+}
+
+std::size_t StatePool::getNumReused() const
+{
+  std::size_t total = 0;
+  for (std::size_t i = 0; i < freeLists_.size(); ++i)
+  {
+    std::lock_guard<std::mutex> lock(freeLists_[i].mutex_);
+    total += freeLists_[i].reused_;
+  }
+  return total;
+}
+
+void StatePool::addToMemoryReport(MemoryReport &report) const
+{
+  std::size_t bytes = freeLists_.capacity() * sizeof(FreeList);
+  for (std::size_t i = 0; i < freeLists_.size(); ++i)
+  {
+    std::lock_guard<std::mutex> lock(freeLists_[i].mutex_);
+    bytes += freeLists_[i].states_.capacity() * sizeof(base::State *);
+  }
+  report.add(MEMORY_STATE_POOL, bytes + getNumPooled() * MemoryReport::estimateStateBytes(si_));
+}
+
+StatePool::FreeList &StatePool::getFreeList()
+{
+  return freeLists_[std::min(GenerationProfiler::getThreadID(), freeLists_.size() - 2)];
+}
+
+}  // namespace bolt
+}  // namespace tools
+}  // namespace ompl
@@ -0,0 +1,189 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2016, University of Colorado, Boulder
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the Univ of CO, Boulder nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+/* Author: Dave Coleman <dave@dav.ee>
+   Desc:   Synthetic N-D box worlds with hyper-box obstacles, for benchmarking without a robot model or GUI
+*/
+
+// OMPL
+#include <ompl/tools/bolt/SyntheticEnvironment.h>
+#include <ompl/util/Exception.h>
+
+// C++
+#include <cmath>
+#include <limits>
+#include <random>
+#include <sstream>
+
+namespace ob = ompl::base;
+
+namespace ompl
+{
+namespace tools
+{
+namespace bolt
+{
+HyperBoxValidityChecker::HyperBoxValidityChecker(const base::SpaceInformationPtr &si)
+  : base::StateValidityChecker(si), dim_(si->getStateDimension())
+{
+}
+
+void HyperBoxValidityChecker::addObstacle(const std::vector<double> &low, const std::vector<double> &high)
+{
+  if (low.size() != dim_ || high.size() != dim_)
+    throw Exception("HyperBoxValidityChecker", "Obstacle dimension does not match state space");
+
+  lows_.insert(lows_.end(), low.begin(), low.end());
+  highs_.insert(highs_.end(), high.begin(), high.end());
+  numObstacles_++;
+}
+
+bool HyperBoxValidityChecker::isValid(const base::State *state) const
+{
+  const double *values = state->as<ob::RealVectorStateSpace::StateType>()->values;
+
+  for (std::size_t i = 0; i < numObstacles_; ++i)
+  {
+    const double *low = &lows_[i * dim_];
+    const double *high = &highs_[i * dim_];
+
+    bool inside = true;
+    for (std::size_t d = 0; d < dim_ && inside; ++d)
+      inside = values[d] >= low[d] && values[d] <= high[d];
+
+    if (inside)
+      return false;
+  }
+  return si_->satisfiesBounds(state);
+}
+
+bool HyperBoxValidityChecker::isValid(const base::State *state, double &dist) const
+{
+  dist = clearance(state);
+  return dist > 0 && si_->satisfiesBounds(state);
+}
+
+double HyperBoxValidityChecker::clearance(const base::State *state) const
+{
+  const double *values = state->as<ob::RealVectorStateSpace::StateType>()->values;
+
+  double minDist = std::numeric_limits<double>::infinity();
+  for (std::size_t i = 0; i < numObstacles_; ++i)
+  {
+    minDist = std::min(minDist, distanceToBox(values, i));
+    if (minDist <= 0)
+      return 0;
+  }
+  return minDist;
+}
+
+double HyperBoxValidityChecker::distanceToBox(const double *values, std::size_t boxID) const
+{
+  const double *low = &lows_[boxID * dim_];
+  const double *high = &highs_[boxID * dim_];
+
+  double sum = 0;
+  for (std::size_t d = 0; d < dim_; ++d)
+  {
+    double diff = 0;
+    if (values[d] < low[d])
+      diff = low[d] - values[d];
+    else if (values[d] > high[d])
+      diff = values[d] - high[d];
+    sum += diff * diff;
+  }
+  return sqrt(sum);
+}
+
+SyntheticEnvironment createHyperBoxEnvironment(std::size_t dim, std::size_t numObstacles, double obstacleWidth,
+                                               unsigned int seed)
+{
+  const double lowBound = 0.0;
+  const double highBound = 10.0;
+  const double width = obstacleWidth * (highBound - lowBound);
+
+  SyntheticEnvironment env;
+
+  std::stringstream name;
+  name << "box" << dim << "d_" << numObstacles << "obs";
+  env.name_ = name.str();
+
+  // State space
+  ob::RealVectorStateSpace *space = new ob::RealVectorStateSpace(dim);
+  space->setBounds(lowBound, highBound);
+  env.space_.reset(space);
+
+  // Validity checking
+  env.si_.reset(new ob::SpaceInformation(env.space_));
+  env.checker_.reset(new HyperBoxValidityChecker(env.si_));
+  env.si_->setStateValidityChecker(env.checker_);
+
+  // Use our own generator rather than OMPL's so the world does not depend on the global seed
+  std::mt19937 generator(seed);
+  std::uniform_real_distribution<double> corner(lowBound, highBound - width);
+
+  std::vector<double> low(dim);
+  std::vector<double> high(dim);
+  for (std::size_t i = 0; i < numObstacles; ++i)
+  {
+    for (std::size_t d = 0; d < dim; ++d)
+    {
+      low[d] = corner(generator);
+      high[d] = low[d] + width;
+    }
+    env.checker_->addObstacle(low, high);
+  }
+
+  // Estimate how cluttered the world is
+  const std::size_t numSamples = 10000;
+  std::uniform_real_distribution<double> uniform(lowBound, highBound);
+  ob::State *state = env.space_->allocState();
+  double *values = state->as<ob::RealVectorStateSpace::StateType>()->values;
+  std::size_t numInvalid = 0;
+  for (std::size_t i = 0; i < numSamples; ++i)
+  {
+    for (std::size_t d = 0; d < dim; ++d)
+      values[d] = uniform(generator);
+    if (!env.checker_->isValid(state))
+      numInvalid++;
+  }
+  env.space_->freeState(state);
+  env.obstacleDensity_ = numInvalid / double(numSamples);
+
+  return env;
+}
+
+}  // namespace bolt
+}  // namespace tools
+}  // namespace ompl
@@ -41,6 +41,7 @@
 #include <ompl/util/Console.h>
 #include <ompl/datastructures/NearestNeighborsGNAT.h>
 #include <ompl/base/DiscreteMotionValidator.h>
+#include <ompl/base/spaces/RealVectorStateSpace.h>
 
 // Boost
 #include <boost/graph/incremental_components.hpp>
@@ -52,6 +53,7 @@
 #include <boost/thread.hpp>
 
 // C++
+#include <cmath>
 #include <limits>
 #include <queue>
 #include <algorithm>  // std::random_shuffle
@@ -72,6 +74,8 @@ namespace tools
 {
 namespace bolt
 {
+const SparseVertex TaskGraph::NO_SPARSE_VERTEX;
+
 TaskGraph::TaskGraph(SparseGraphPtr sg)
   : sg_(sg)
   // Property accessors of edges
@@ -87,6 +91,9 @@ TaskGraph::TaskGraph(SparseGraphPtr sg)
   // Save number of threads available
   numThreads_ = boost::thread::hardware_concurrency();
 
+  if (isEuclideanSpace(si_->getStateSpace()))
+    euclideanDimension_ = si_->getStateDimension();
+
   // Copy the pointers of various components
   si_ = sg_->getSpaceInformation();
   visual_ = sg_->getVisual();
@@ -136,14 +143,58 @@ void TaskGraph::freeMemory()
   }
 
   g_.clear();
+  frozen_.clear();
+  hierarchy_.clear();
+  bidirectional_.clear();
+  workspaceIndex_.clear(workspaceIndex_.getCellSize());
   nn_->clear();
+  sparseVertices_.clear();
+}
+
+void TaskGraph::freeze(std::size_t indent)
+{
+  BOLT_FUNC(indent, verbose_, "TaskGraph.freeze()");
+  if (isFrozen())
+    return;
+
+  time::point startTime = time::now();  // Benchmark
+  const std::size_t bytesBefore = getMemoryReport().getTotal();
+  frozen_.build(g_);
+
+  // Keep the vertices and their properties, but none of the edges or their per-vertex lists
+  TaskAdjList vertices(boost::num_vertices(g_));
+  foreach (TaskVertex v, boost::vertices(g_))
+  {
+    boost::put(vertex_state_t(), vertices, v, vertexStateProperty_[v]);
+    boost::put(vertex_type_t(), vertices, v, vertexTypeProperty_[v]);
+    boost::put(vertex_task_mirror_t(), vertices, v, vertexTaskMirrorProperty_[v]);
+  }
+  g_.swap(vertices);
+
+  BOLT_DEBUG(indent, verbose_, "Froze " << getNumEdges() << " edges in " << time::seconds(time::now() - startTime)
+                                        << " seconds, memory went from " << MemoryReport::formatBytes(bytesBefore)
+                                        << " to " << MemoryReport::formatBytes(getMemoryReport().getTotal()));
+}
+
+void TaskGraph::buildHierarchy(std::size_t indent)
+{
+  BOLT_FUNC(indent, verbose_, "TaskGraph.buildHierarchy()");
+  if (!isFrozen())
+    throw Exception(name_, "Only a frozen graph can be contracted");
+
+  time::point startTime = time::now();  // Benchmark
+  hierarchy_.build(frozen_);
+  BOLT_DEBUG(indent, verbose_, "Contracted " << getNumVertices() << " vertices with " << hierarchy_.getNumShortcuts()
+                                             << " shortcuts in " << time::seconds(time::now() - startTime)
+                                             << " seconds");
 }
 
 void TaskGraph::initializeQueryState()
 {
   if (boost::num_vertices(g_) > 0)
   {
-    OMPL_WARN("Not initializing query state because already is of size %u", boost::num_vertices(g_));
+    OMPL_WARN("Not initializing query state because already is of size %u",
+              static_cast<unsigned int>(boost::num_vertices(g_)));
     return;  // assume its already been setup
   }
 
@@ -164,6 +215,42 @@ bool TaskGraph::astarSearch(const TaskVertex start, const TaskVertex goal, std::
 {
   BOLT_FUNC(indent, vSearch_, "TaskGraph.astarSearch()");
 
+  if (isFrozen())
+  {
+    std::vector<CompactGraph::Index> compactPath;
+    if (!hierarchy_.empty())
+    {
+      std::size_t nodesSettled;
+      if (!hierarchy_.search(start, goal, compactPath, distance, nodesSettled))
+      {
+        BOLT_WARN(indent, vSearch_, "Did not find goal");
+        return false;
+      }
+      numNodesOpened_ = numNodesClosed_ = nodesSettled;
+      if (frozen_.isPathFree(compactPath))
+      {
+        vertexPath.assign(compactPath.begin(), compactPath.end());
+        return true;
+      }
+      BOLT_DEBUG(indent, vSearch_, "Hierarchy path crosses an edge in collision, falling back to A*");
+    }
+
+    if (bidirectionalSearch_)
+      return astarSearchBidirectional(start, goal, vertexPath, distance, indent);
+
+    const CompactGraph::HeuristicFunction heuristic = boost::bind(&otb::TaskGraph::astarTaskHeuristic, this, _1, goal);
+    const bool found =
+        frozen_.astarSearch(start, goal, heuristic, compactPath, distance, numNodesOpened_, numNodesClosed_);
+    if (found)
+      vertexPath.assign(compactPath.begin(), compactPath.end());
+    else
+      BOLT_WARN(indent, vSearch_, "Did not find goal");
+    return found;
+  }
+
+  if (bidirectionalSearch_)
+    return astarSearchBidirectional(start, goal, vertexPath, distance, indent);
+
   // Hold a list of the shortest path parent to each vertex
   TaskVertex *vertexPredecessors = new TaskVertex[getNumVertices()];
   // boost::vector_property_map<TaskVertex> vertexPredecessors(getNumVertices());
@@ -175,7 +262,7 @@ bool TaskGraph::astarSearch(const TaskVertex start, const TaskVertex goal, std::
   numNodesOpened_ = 0;
   numNodesClosed_ = 0;
 
-  if (visualizeAstar_)
+  if (BOLT_VISUALIZE(visualizeAstar_))
   {
     // Assume this was cleared by the parent program
     // visual_->viz4()->deleteAllMarkers();
@@ -205,7 +292,7 @@ bool TaskGraph::astarSearch(const TaskVertex start, const TaskVertex goal, std::
     BOLT_DEBUG(indent, vSearch_, "Number nodes opened: " << numNodesOpened_
                                                          << ", Number nodes closed: " << numNodesClosed_);
 
-    if (isinf(vertexDistances[goal]))  // TODO(davetcoleman): test that this works
+    if (std::isinf(vertexDistances[goal]))  // TODO(davetcoleman): test that this works
     {
       throw Exception(name_, "Distance to goal is infinity");
       foundGoal = false;
@@ -237,7 +324,7 @@ bool TaskGraph::astarSearch(const TaskVertex start, const TaskVertex goal, std::
     BOLT_WARN(indent, vSearch_, "Did not find goal");
 
   // Show all predecessors
-  if (visualizeAstar_)
+  if (BOLT_VISUALIZE(visualizeAstar_))
   {
     BOLT_DEBUG(indent + 2, vSearch_, "Show all predecessors");
     for (std::size_t i = numThreads_; i < getNumVertices(); ++i)  // skip vertex 0-11 because those are query vertices
@@ -265,7 +352,7 @@ double TaskGraph::astarHeuristic(const TaskVertex a, const TaskVertex b) const
   // Assume vertex 'a' is the one we care about its populariy
 
   // Get the classic distance
-  double dist = si_->distance(getState(a), getState(b));
+  double dist = distanceFunction(a, b);
 
   // if (false)  // method 1
   // {
@@ -315,6 +402,10 @@ double TaskGraph::astarHeuristic(const TaskVertex a, const TaskVertex b) const
 
 double TaskGraph::distanceFunction(const TaskVertex a, const TaskVertex b) const
 {
+  // Euclidean spaces skip the virtual call, query vertices are handled by getCoordinates()
+  if (euclideanDimension_)
+    return std::sqrt(distanceKernels_.distanceSquared_(getCoordinates(a), getCoordinates(b), euclideanDimension_));
+
   // Special case: query vertices store their states elsewhere. Both cannot be query vertices
   if (a < numThreads_)
   {
@@ -331,11 +422,28 @@ double TaskGraph::distanceFunction(const TaskVertex a, const TaskVertex b) const
   return si_->distance(getState(a), getState(b));
 }
 
+bool TaskGraph::astarSearchBidirectional(const TaskVertex start, const TaskVertex goal,
+                                         std::vector<TaskVertex> &vertexPath, double &distance, std::size_t indent)
+{
+  const BidirectionalAstar::HeuristicFunction toGoal =
+      boost::bind(&otb::TaskGraph::astarTaskHeuristic, this, _1, goal);
+  const BidirectionalAstar::HeuristicFunction toStart =
+      boost::bind(&otb::TaskGraph::astarTaskHeuristic, this, _1, start);
+  const bool found =
+      isFrozen() ? bidirectional_.search(frozen_, getNumVertices(), start, goal, toGoal, toStart, vertexPath, distance,
+                                         numNodesOpened_, numNodesClosed_) :
+                   bidirectional_.search(g_, getNumVertices(), start, goal, toGoal, toStart, vertexPath, distance,
+                                         numNodesOpened_, numNodesClosed_);
+  if (!found)
+    BOLT_WARN(indent, vSearch_, "Did not find goal");
+  return found;
+}
+
 double TaskGraph::astarTaskHeuristic(const TaskVertex a, const TaskVertex b) const
 {
   // Do not use task distance if that mode is not enabled
   if (!taskPlanningEnabled_)
-    return distanceFunction(a, b);
+    return levelDistance(a, b);
 
   std::size_t indent = 0;
 
@@ -349,83 +457,38 @@ double TaskGraph::astarTaskHeuristic(const TaskVertex a, const TaskVertex b) con
     return astarTaskHeuristic(b, a);
   }
 
+  // Level 0 only connects to level 1 through the start of the cartesian path, and level 2 through its end. Every
+  // bound below is a straight line or landmark distance routed through those two vertices, so it stays consistent
+  // across level changes, which the bidirectional search relies on
   double dist = 0;  // the result
 
-  // Note: this value should be synced with TaskGraph
-  static const double TASK_LEVEL_COST = 100.0;  // cost to change levels/tasks
-
-  // Error check
-  assert(vertexStateProperty_[a]);
-  assert(vertexStateProperty_[b]);
-  assert(vertexStateProperty_[startConnectorVertex_]);
-  assert(vertexStateProperty_[goalConnectorVertex_]);
-
-  if (taskLevelA == 0)
+  if (taskLevelA == taskLevelB && taskLevelA != 1)
   {
-    if (taskLevelB == 0)  // regular distance for bottom level
-    {
-      BOLT_DEBUG(indent, vHeuristic_, "Distance Mode a");
-      dist = si_->distance(vertexStateProperty_[a], vertexStateProperty_[b]);
-    }
-    else if (taskLevelB == 1)
-    {
-      BOLT_DEBUG(indent, vHeuristic_, "Distance Mode b");
-      dist = si_->distance(vertexStateProperty_[a], vertexStateProperty_[startConnectorVertex_]) + TASK_LEVEL_COST +
-             si_->distance(vertexStateProperty_[startConnectorVertex_], vertexStateProperty_[b]);
-    }
-    else if (taskLevelB == 2)
-    {
-      BOLT_DEBUG(indent, vHeuristic_, "Distance Mode c");
-      dist = si_->distance(vertexStateProperty_[a], vertexStateProperty_[startConnectorVertex_]) + TASK_LEVEL_COST +
-             shortestDistAcrossCartGraph_ + TASK_LEVEL_COST +
-             si_->distance(vertexStateProperty_[goalConnectorVertex_], vertexStateProperty_[b]);
-    }
-    else
-    {
-      OMPL_ERROR("Unknown task level mode");
-      exit(-1);
-    }
+    BOLT_DEBUG(indent, vHeuristic_, "Distance Mode a");
+    // Shortest of staying on the level and a detour through the end of the cartesian path it connects to
+    const TaskVertex connector = taskLevelA == 0 ? cartStartVertex_ : cartGoalVertex_;
+    dist = std::min(levelDistance(a, b), distanceFunction(a, connector) + distanceFunction(connector, b));
   }
-  else if (taskLevelA == 1)
+  else if (taskLevelA == 1 && taskLevelB == 1)
   {
-    if (taskLevelB == 0)
-    {
-      OMPL_ERROR("Unknown task level mode");
-      exit(-1);
-    }
-    else if (taskLevelB == 1)
-    {
-      BOLT_DEBUG(indent, vHeuristic_, "Distance Mode d");
-      dist = si_->distance(vertexStateProperty_[a], vertexStateProperty_[b]);
-    }
-    else if (taskLevelB == 2)
-    {
-      BOLT_DEBUG(indent, vHeuristic_, "Distance Mode e");
-
-      dist = si_->distance(vertexStateProperty_[a], vertexStateProperty_[goalConnectorVertex_]) + TASK_LEVEL_COST +
-             si_->distance(vertexStateProperty_[goalConnectorVertex_], vertexStateProperty_[b]);
-    }
-    else
-    {
-      OMPL_WARN("Unknown task level mode");
-    }
+    BOLT_DEBUG(indent, vHeuristic_, "Distance Mode b");
+    dist = distanceFunction(a, b);
   }
-  else if (taskLevelA == 2)
+  else if (taskLevelA == 0 && taskLevelB == 1)
   {
-    if (taskLevelB == 0 || taskLevelB == 1)
-    {
-      OMPL_ERROR("Unknown task level mode");
-      exit(-1);
-    }
-    else if (taskLevelB == 2)
-    {
-      BOLT_DEBUG(indent, vHeuristic_, "Distance Mode f");
-      dist = si_->distance(vertexStateProperty_[a], vertexStateProperty_[b]);
-    }
-    else
-    {
-      OMPL_WARN("Unknown task level mode");
-    }
+    BOLT_DEBUG(indent, vHeuristic_, "Distance Mode c");
+    dist = distanceFunction(a, cartStartVertex_) + distanceFunction(cartStartVertex_, b);
+  }
+  else if (taskLevelA == 1 && taskLevelB == 2)
+  {
+    BOLT_DEBUG(indent, vHeuristic_, "Distance Mode d");
+    dist = distanceFunction(a, cartGoalVertex_) + distanceFunction(cartGoalVertex_, b);
+  }
+  else if (taskLevelA == 0 && taskLevelB == 2)
+  {
+    BOLT_DEBUG(indent, vHeuristic_, "Distance Mode e");
+    dist = distanceFunction(a, cartStartVertex_) + distanceFunction(cartStartVertex_, cartGoalVertex_) +
+           distanceFunction(cartGoalVertex_, b);
   }
   else
   {
@@ -437,6 +500,16 @@ double TaskGraph::astarTaskHeuristic(const TaskVertex a, const TaskVertex b) con
   return dist;
 }
 
+double TaskGraph::levelDistance(const TaskVertex a, const TaskVertex b) const
+{
+  const double dist = distanceFunction(a, b);
+  if (a >= sparseVertices_.size() || b >= sparseVertices_.size() || sparseVertices_[a] == NO_SPARSE_VERTEX ||
+      sparseVertices_[b] == NO_SPARSE_VERTEX || getTaskLevel(a) != getTaskLevel(b))
+    return dist;
+
+  return std::max(dist, sg_->getLandmarks().getLowerBound(sparseVertices_[a], sparseVertices_[b]));
+}
+
 bool TaskGraph::isEmpty() const
 {
   assert(!(getNumVertices() < getNumQueryVertices()));
@@ -446,6 +519,7 @@ bool TaskGraph::isEmpty() const
 void TaskGraph::generateTaskSpace(std::size_t indent)
 {
   BOLT_FUNC(indent, verbose_, "TaskGraph.generateTaskSpace()");
+  ScopedCheckSite site(SITE_TASK_GRAPH);
   time::point startTime = time::now();  // Benchmark
 
   // Clear pre-existing graphs
@@ -485,6 +559,14 @@ void TaskGraph::generateTaskSpace(std::size_t indent)
     vertexTaskMirrorProperty_[taskV2] = taskV1;
   }
 
+  // Both copies share the landmark distances of their sparse vertex
+  sparseVertices_.assign(getNumVertices(), NO_SPARSE_VERTEX);
+  for (SparseVertex sparseV = sg_->getNumQueryVertices(); sparseV < sg_->getNumVertices(); ++sparseV)
+  {
+    sparseVertices_[sparseToTaskVertex1[sparseV]] = sparseV;
+    sparseVertices_[sparseToTaskVertex2[sparseV]] = sparseV;
+  }
+
   // Loop through every edge in sparse graph and copy twice to task graph
   BOLT_DEBUG(indent + 2, vGenerateTask_, "Adding task space edges");
   foreach (const SparseEdge sparseE, boost::edges(sg_->getGraph()))
@@ -536,6 +618,8 @@ bool TaskGraph::addCartPath(std::vector<base::State *> path, std::size_t indent)
 
   // Record min cost for cost-to-go heurstic distance function later
   shortestDistAcrossCartGraph_ = distanceFunction(startVertex, goalVertex);
+  cartStartVertex_ = startVertex;
+  cartGoalVertex_ = goalVertex;
 
   // Connect Start to graph --------------------------------------
   BOLT_DEBUG(indent, verbose_, "Creating start connector");
@@ -588,6 +672,8 @@ bool TaskGraph::addCartPath(std::vector<base::State *> path, std::size_t indent)
 void TaskGraph::clearCartesianVerticesDeprecated(std::size_t indent)
 {
   BOLT_FUNC(indent, verbose_, "TaskGraph.clearCartesianVerticesDeprecated()");
+  if (isFrozen())
+    throw Exception(name_, "Cannot remove vertices from a frozen graph");
 
   time::point startTime = time::now();  // Benchmark
 
@@ -626,6 +712,8 @@ void TaskGraph::clearCartesianVerticesDeprecated(std::size_t indent)
   // Reset min connector vars
   startConnectorVertex_ = 0;
   goalConnectorVertex_ = 0;
+  cartStartVertex_ = 0;
+  cartGoalVertex_ = 0;
   startConnectorMinCost_ = std::numeric_limits<double>::infinity();
   goalConnectorMinCost_ = std::numeric_limits<double>::infinity();
 
@@ -641,6 +729,9 @@ void TaskGraph::clearCartesianVerticesDeprecated(std::size_t indent)
   // Reset disjoint sets
   disjointSets_ = TaskDisjointSetType(boost::get(boost::vertex_rank, g_), boost::get(boost::vertex_predecessor, g_));
 
+  // Vertices were renumbered, so the copies no longer know their sparse vertex
+  sparseVertices_.clear();
+
   // Reinsert vertices into nearest neighbor
   foreach (TaskVertex v, boost::vertices(g_))
   {
@@ -661,6 +752,10 @@ void TaskGraph::clearCartesianVerticesDeprecated(std::size_t indent)
     disjointSets_.union_set(v1, v2);
   }
 
+  // The workspace index holds vertex ids
+  if (sweptVolume_)
+    indexWorkspace();
+
   // Clear the visualization and redisplay
   // bool showVertices = true;
   // displayDatabase(showVertices, indent);
@@ -790,7 +885,7 @@ bool TaskGraph::checkTaskPathSolution(og::PathGeometric &path, ob::State *start,
 
       if (level != 0)
       {
-        OMPL_ERROR("Start state is not at level 0, instead %i", level);
+        OMPL_ERROR("Start state is not at level 0, instead %u", static_cast<unsigned int>(level));
         error = true;
       }
     }
@@ -806,7 +901,7 @@ bool TaskGraph::checkTaskPathSolution(og::PathGeometric &path, ob::State *start,
 
       if (level != 2)
       {
-        OMPL_ERROR("Goal state is not at level 2, instead %i", level);
+        OMPL_ERROR("Goal state is not at level 2, instead %u", static_cast<unsigned int>(level));
         error = true;
       }
     }
@@ -814,7 +909,7 @@ bool TaskGraph::checkTaskPathSolution(og::PathGeometric &path, ob::State *start,
     // Ensure that level is always increasing
     if (level < current_level)
     {
-      OMPL_ERROR("State decreased in level (%i) from previous level of ", current_level);
+      OMPL_ERROR("State decreased in level (%u) from previous level of ", static_cast<unsigned int>(current_level));
       error = true;
     }
     current_level = level;
@@ -828,7 +923,7 @@ bool TaskGraph::checkTaskPathSolution(og::PathGeometric &path, ob::State *start,
     for (std::size_t i = 0; i < path.getStateCount(); ++i)
     {
       VertexLevel level = si_->getStateSpace()->getLevel(path.getState(i));
-      OMPL_INFORM(" - Path state %i has level %i", i, level);
+      OMPL_INFORM(" - Path state %u has level %u", static_cast<unsigned int>(i), static_cast<unsigned int>(level));
     }
   }
 
@@ -837,10 +932,105 @@ bool TaskGraph::checkTaskPathSolution(og::PathGeometric &path, ob::State *start,
 
 void TaskGraph::clearEdgeCollisionStates()
 {
+  if (isFrozen())
+  {
+    frozen_.clearCollisionStates();
+    return;
+  }
+
   foreach (const TaskEdge e, boost::edges(g_))
     edgeCollisionStatePropertyTask_[e] = NOT_CHECKED;  // each edge has an unknown state
 }
 
+void TaskGraph::buildWorkspaceIndex(const SweptVolumeFunction &sweptVolume, double cellSize, std::size_t indent)
+{
+  BOLT_FUNC(indent, verbose_, "TaskGraph.buildWorkspaceIndex()");
+
+  time::point startTime = time::now();  // Benchmark
+  sweptVolume_ = sweptVolume;
+  workspaceIndex_.clear(cellSize);
+  indexWorkspace();
+  BOLT_DEBUG(indent, verbose_, "Indexed " << workspaceIndex_.getNumEdges() << " edges in "
+                                          << workspaceIndex_.getNumCells() << " cells in "
+                                          << time::seconds(time::now() - startTime) << " seconds");
+}
+
+void TaskGraph::indexWorkspace()
+{
+  workspaceIndex_.clear(workspaceIndex_.getCellSize());
+  if (isFrozen())
+  {
+    // Each edge once, from its lower endpoint, and parallel edges once for both
+    for (CompactGraph::Index v = 0; v < frozen_.getNumVertices(); ++v)
+    {
+      CompactGraph::Index previous = v;
+      for (CompactGraph::Index i = frozen_.beginNeighbors(v); i < frozen_.endNeighbors(v); ++i)
+      {
+        const CompactGraph::Index u = frozen_.getNeighbor(i);
+        if (v < u && u != previous)
+          indexEdgeWorkspace(v, u);
+        previous = u;
+      }
+    }
+    return;
+  }
+
+  foreach (const TaskEdge e, boost::edges(g_))
+    indexEdgeWorkspace(boost::source(e, g_), boost::target(e, g_));
+}
+
+void TaskGraph::indexEdgeWorkspace(TaskVertex v1, TaskVertex v2)
+{
+  sweptBoxes_.clear();
+  sweptVolume_(getState(v1), getState(v2), sweptBoxes_);
+  workspaceIndex_.addEdge(v1, v2, sweptBoxes_);
+}
+
+std::size_t TaskGraph::invalidateWorkspace(const WorkspaceBox &region, std::size_t indent)
+{
+  BOLT_FUNC(indent, vSearch_, "TaskGraph.invalidateWorkspace()");
+  if (!sweptVolume_)
+    throw Exception(name_, "buildWorkspaceIndex() must be called before invalidateWorkspace()");
+
+  std::vector<WorkspaceIndex::VertexPair> edges;
+  workspaceIndex_.getEdges(region, edges);
+  std::size_t numReset = 0;
+  for (std::size_t i = 0; i < edges.size(); ++i)
+    numReset += resetEdgeCollisionStates(edges[i].first, edges[i].second);
+
+  BOLT_DEBUG(indent, vSearch_, "Reset " << numReset << " of " << edges.size() << " edges near the change");
+  return numReset;
+}
+
+std::size_t TaskGraph::resetEdgeCollisionStates(TaskVertex v1, TaskVertex v2)
+{
+  // The index may still list edges that were removed since, and their vertices may be gone too
+  std::size_t numReset = 0;
+  if (isFrozen())
+  {
+    for (CompactGraph::Index i = frozen_.beginNeighbors(v1); i < frozen_.endNeighbors(v1); ++i)
+    {
+      const CompactGraph::Index e = frozen_.getNeighborEdge(i);
+      if (frozen_.getNeighbor(i) != v2 || frozen_.getCollisionState(e) == NOT_CHECKED)
+        continue;
+      frozen_.setCollisionState(e, NOT_CHECKED);
+      numReset++;
+    }
+    return numReset;
+  }
+
+  if (v1 >= boost::num_vertices(g_) || v2 >= boost::num_vertices(g_))
+    return 0;
+  foreach (const TaskEdge e, boost::out_edges(v1, g_))
+  {
+    if (boost::target(e, g_) != v2 || edgeCollisionStatePropertyTask_[e] == NOT_CHECKED)
+      continue;
+    edgeCollisionStatePropertyTask_[e] = NOT_CHECKED;
+    numReset++;
+  }
+  return numReset;
+}
+
 void TaskGraph::errorCheckDuplicateStates(std::size_t indent)
 {
   BOLT_ERROR(indent, verbose_, "TaskGraph.errorCheckDuplicateStates() - NOT IMPLEMENTEDpart of super debug");
@@ -866,9 +1056,10 @@ void TaskGraph::errorCheckDuplicateStates(std::size_t indent)
 bool TaskGraph::smoothQualityPathOriginal(geometric::PathGeometric *path, std::size_t indent)
 {
   BOLT_ERROR(indent, visualizeQualityPathSimp_, "smoothQualityPathOriginal()");
+  ScopedCheckSite site(SITE_SIMPLIFICATION);
 
   // Visualize path
-  if (visualizeQualityPathSimp_)
+  if (BOLT_VISUALIZE(visualizeQualityPathSimp_))
   {
     visual_->viz2()->deleteAllMarkers();
     visual_->viz2()->path(path, tools::SMALL, tools::BLUE);
@@ -878,7 +1069,7 @@ bool TaskGraph::smoothQualityPathOriginal(geometric::PathGeometric *path, std::s
 
   BOLT_DEBUG(indent, visualizeQualityPathSimp_, "Created 'quality path' candidate with " << path->getStateCount()
                                                                                          << " states");
-  if (visualizeQualityPathSimp_)
+  if (BOLT_VISUALIZE(visualizeQualityPathSimp_))
     visual_->waitForUserFeedback("path simplification");
 
   pathSimplifier_->reduceVertices(*path, 10);
@@ -896,9 +1087,10 @@ bool TaskGraph::smoothQualityPathOriginal(geometric::PathGeometric *path, std::s
 bool TaskGraph::smoothQualityPath(geometric::PathGeometric *path, double clearance, std::size_t indent)
 {
   BOLT_FUNC(indent, visualizeQualityPathSimp_, "TaskGraph.smoothQualityPath()");
+  ScopedCheckSite site(SITE_SIMPLIFICATION);
 
   // Visualize path
-  if (visualizeQualityPathSimp_)
+  if (BOLT_VISUALIZE(visualizeQualityPathSimp_))
   {
     visual_->viz2()->deleteAllMarkers();
     visual_->viz2()->path(path, tools::SMALL, tools::BLUE);
@@ -908,19 +1100,18 @@ bool TaskGraph::smoothQualityPath(geometric::PathGeometric *path, double clearan
 
   BOLT_DEBUG(indent, visualizeQualityPathSimp_, "Created 'quality path' candidate with " << path->getStateCount()
                                                                                          << " states");
-  if (visualizeQualityPathSimp_)
+  if (BOLT_VISUALIZE(visualizeQualityPathSimp_))
     visual_->waitForUserFeedback("path simplification");
 
   // Set the motion validator to use clearance, this way isValid() checks clearance before confirming valid
-  base::DiscreteMotionValidator *dmv =
-      dynamic_cast<base::DiscreteMotionValidator *>(si_->getMotionValidatorNonConst().get());
+  base::DiscreteMotionValidator *dmv = CollisionCheckCounter::getDiscreteMotionValidator(si_);
   dmv->setRequiredStateClearance(clearance);
 
   for (std::size_t i = 0; i < 3; ++i)
   {
     pathSimplifier_->simplifyMax(*path);
 
-    if (visualizeQualityPathSimp_)
+    if (BOLT_VISUALIZE(visualizeQualityPathSimp_))
     {
       visual_->viz2()->deleteAllMarkers();
       visual_->viz2()->path(path, tools::SMALL, tools::ORANGE);
@@ -931,7 +1122,7 @@ bool TaskGraph::smoothQualityPath(geometric::PathGeometric *path, double clearan
 
     pathSimplifier_->reduceVertices(*path, 1000, path->getStateCount() * 4);
 
-    if (visualizeQualityPathSimp_)
+    if (BOLT_VISUALIZE(visualizeQualityPathSimp_))
     {
       visual_->viz2()->deleteAllMarkers();
       visual_->viz2()->path(path, tools::SMALL, tools::BLUE);
@@ -945,7 +1136,7 @@ bool TaskGraph::smoothQualityPath(geometric::PathGeometric *path, double clearan
 
   pathSimplifier_->reduceVertices(*path, 1000, path->getStateCount() * 4);
 
-  if (visualizeQualityPathSimp_)
+  if (BOLT_VISUALIZE(visualizeQualityPathSimp_))
   {
     visual_->viz2()->deleteAllMarkers();
     visual_->viz2()->path(path, tools::SMALL, tools::GREEN);
@@ -965,13 +1156,24 @@ bool TaskGraph::smoothQualityPath(geometric::PathGeometric *path, double clearan
 std::size_t TaskGraph::getDisjointSetsCount(bool verbose)
 {
   std::size_t numSets = 0;
+  CompactGraph::Index nextComponent = 0;
   foreach (TaskVertex v, boost::vertices(g_))
   {
+    // Components of a frozen graph are numbered in order of their first vertex
+    bool isRepresentative;
+    if (isFrozen())
+    {
+      isRepresentative = frozen_.getComponent(v) == nextComponent;
+      nextComponent = std::max<CompactGraph::Index>(nextComponent, frozen_.getComponent(v) + 1);
+    }
+    else
+      isRepresentative = boost::get(boost::get(boost::vertex_predecessor, g_), v) == v;
+
     // Do not count the search vertex within the sets
     if (v <= queryVertices_.back())
       continue;
 
-    if (boost::get(boost::get(boost::vertex_predecessor, g_), v) == v)
+    if (isRepresentative)
     {
       std::size_t indent = 0;
       BOLT_DEBUG(indent, verbose, "Disjoint set: " << v);
@@ -1105,11 +1307,16 @@ std::size_t TaskGraph::checkConnectedComponents()
 
 bool TaskGraph::sameComponent(TaskVertex v1, TaskVertex v2)
 {
+  if (isFrozen())
+    return frozen_.sameComponent(v1, v2);
   return boost::same_component(v1, v2, disjointSets_);
 }
 
 TaskVertex TaskGraph::addVertex(base::State *state, const VertexType &type, VertexLevel level, std::size_t indent)
 {
+  if (isFrozen())
+    throw Exception(name_, "Cannot add a vertex to a frozen graph");
+
   // Create vertex
   TaskVertex v = boost::add_vertex(g_);
   BOLT_FUNC(indent, vAdd_, "TaskGraph.addVertex(): v: " << v << " type " << type << " level: " << level);
@@ -1131,7 +1338,7 @@ TaskVertex TaskGraph::addVertex(base::State *state, const VertexType &type, Vert
   }
 
   // Visualize
-  if (visualizeTaskGraph_)
+  if (BOLT_VISUALIZE(visualizeTaskGraph_))
   {
     visualizeVertex(v);
 
@@ -1147,6 +1354,9 @@ TaskVertex TaskGraph::addVertex(base::State *state, const VertexType &type, Vert
 
 void TaskGraph::removeVertex(TaskVertex v)
 {
+  if (isFrozen())
+    throw Exception(name_, "Cannot remove a vertex from a frozen graph");
+
   // Remove from nearest neighbor
   nn_->remove(v);
 
@@ -1170,6 +1380,8 @@ void TaskGraph::removeDeletedVertices(std::size_t indent)
 {
   BOLT_FUNC(indent, verbose_, "TaskGraph.removeDeletedVertices()");
   bool verbose = true;
+  if (isFrozen())
+    throw Exception(name_, "Cannot remove vertices from a frozen graph");
 
   // Remove all vertices that are set to 0
   std::size_t numRemoved = 0;
@@ -1227,11 +1439,17 @@ void TaskGraph::removeDeletedVertices(std::size_t indent)
     TaskVertex v2 = boost::target(e, g_);
     disjointSets_.union_set(v1, v2);
   }
+
+  // The workspace index holds vertex ids
+  if (sweptVolume_)
+    indexWorkspace();
 }
 
 TaskEdge TaskGraph::addEdge(TaskVertex v1, TaskVertex v2, EdgeType type, std::size_t indent)
 {
   BOLT_FUNC(indent, vAdd_, "TaskGraph.addEdge(): from vertex " << v1 << " to " << v2 << " type " << type);
+  if (isFrozen())
+    throw Exception(name_, "Cannot add an edge to a frozen graph");
 
   BOOST_ASSERT_MSG(v1 <= getNumVertices(), "Vertex1 is larger than max vertex id");
   BOOST_ASSERT_MSG(v2 <= getNumVertices(), "Vertex2 is larger than max vertex id");
@@ -1251,12 +1469,14 @@ TaskEdge TaskGraph::addEdge(TaskVertex v1, TaskVertex v2, EdgeType type, std::si
 
   // Collision properties
   edgeCollisionStatePropertyTask_[e] = NOT_CHECKED;
+  if (sweptVolume_)
+    indexEdgeWorkspace(v1, v2);
 
   // Add the edge to the incrementeal connected components datastructure
   disjointSets_.union_set(v1, v2);
 
   // Visualize
-  if (visualizeTaskGraph_)
+  if (BOLT_VISUALIZE(visualizeTaskGraph_))
   {
     visualizeEdge(v1, v2);
 
@@ -1272,9 +1492,26 @@ TaskEdge TaskGraph::addEdge(TaskVertex v1, TaskVertex v2, EdgeType type, std::si
 
 bool TaskGraph::hasEdge(TaskVertex v1, TaskVertex v2)
 {
+  if (isFrozen())
+    return frozen_.findEdge(v1, v2) != CompactGraph::NO_EDGE;
   return boost::edge(v1, v2, g_).second;
 }
 
+EdgeCollisionState TaskGraph::getEdgeCollisionState(TaskVertex v1, TaskVertex v2) const
+{
+  if (isFrozen())
+    return frozen_.getCollisionState(frozen_.findEdge(v1, v2));
+  return static_cast<EdgeCollisionState>(edgeCollisionStatePropertyTask_[boost::edge(v1, v2, g_).first]);
+}
+
+void TaskGraph::setEdgeCollisionState(TaskVertex v1, TaskVertex v2, EdgeCollisionState state)
+{
+  if (isFrozen())
+    frozen_.setCollisionState(frozen_.findEdge(v1, v2), state);
+  else
+    edgeCollisionStatePropertyTask_[boost::edge(v1, v2, g_).first] = state;
+}
+
 base::State *&TaskGraph::getQueryStateNonConst(TaskVertex v)
 {
   BOOST_ASSERT_MSG(v < queryVertices_.size(), "Attempted to request state of regular vertex using query function");
@@ -1293,8 +1530,17 @@ const base::State *TaskGraph::getState(TaskVertex v) const
   return vertexStateProperty_[v];
 }
 
-void TaskGraph::displayDatabase(bool showVertices, std::size_t indent)
+const double *TaskGraph::getCoordinates(TaskVertex v) const
 {
+  const base::State *state = v < queryStates_.size() ? queryStates_[v] : vertexStateProperty_[v];
+  return state->as<base::RealVectorStateSpace::StateType>()->values;
+}
+
+void TaskGraph::displayDatabase(bool /*showVertices*/, std::size_t indent)
+{
+#ifdef BOLT_HEADLESS
+  return;
+#endif
   BOLT_FUNC(indent, vVisualize_, "TaskGraph.displayDatabase()");
 
   // Error check
@@ -1463,10 +1709,27 @@ void TaskGraph::debugNN()
   std::cout << std::endl;
   std::cout << "-------------------------------------------------------" << std::endl;
   NearestNeighborsGNAT<TaskVertex> *gnat = dynamic_cast<NearestNeighborsGNAT<TaskVertex> *>(nn_.get());
-  std::cout << "GNAT: " << *gnat << std::endl;
+  if (gnat)
+    std::cout << "GNAT: " << *gnat << std::endl;
+  else
+    std::cout << "Nearest neighbors: " << getNearestNeighborsName(nnType_) << ", " << nn_->size() << " elements"
+              << std::endl;
   std::cout << std::endl;
 }
 
+void TaskGraph::setNearestNeighborsType(NearestNeighborsType type)
+{
+  std::vector<TaskVertex> vertices;
+  nn_->list(vertices);
+
+  nn_.reset(allocNearestNeighbors(type, si_->getStateSpace(), boost::bind(&otb::TaskGraph::getCoordinates, this, _1)));
+  nn_->setDistanceFunction(boost::bind(&otb::TaskGraph::distanceFunction, this, _1, _2));
+  nn_->add(vertices);
+
+  // The factory falls back to GNAT for spaces other than RealVector
+  nnType_ = dynamic_cast<NearestNeighborsRealVector *>(nn_.get()) ? type : NN_GNAT;
+}
+
 void TaskGraph::printGraphStats()
 {
   // Get the average vertex degree (number of connected edges)
@@ -1479,9 +1742,15 @@ void TaskGraph::printGraphStats()
   double totalEdgeLength = 0;
   double maxEdgeLength = -1 * std::numeric_limits<double>::infinity();
   double minEdgeLength = std::numeric_limits<double>::infinity();
-  foreach (const TaskEdge e, boost::edges(g_))
+  std::vector<double> lengths;
+  if (isFrozen())
+    for (std::size_t i = 0; i < frozen_.getNumEdges(); ++i)
+      lengths.push_back(frozen_.getWeight(i));
+  else
+    foreach (const TaskEdge e, boost::edges(g_))
+      lengths.push_back(edgeWeightProperty_[e]);
+  foreach (const double length, lengths)
   {
-    const double length = edgeWeightProperty_[e];
     totalEdgeLength += length;
     if (maxEdgeLength < length)
       maxEdgeLength = length;
@@ -1502,6 +1771,39 @@ void TaskGraph::printGraphStats()
   BOLT_DEBUG(indent, 1, "      Min:                 " << minEdgeLength);
   BOLT_DEBUG(indent, 1, "      Average:             " << averageEdgeLength);
   BOLT_DEBUG(indent, 1, "------------------------------------------------------");
+  getMemoryReport().print("TaskGraph");
+}
+
+MemoryReport TaskGraph::getMemoryReport() const
+{
+  MemoryReport report;
+  report.numVertices_ = getNumVertices();
+  report.numEdges_ = getNumEdges();
+
+  // Both levels clone the states of the sparse graph rather than sharing them
+  std::size_t numStates = 0;
+  foreach (const TaskVertex v, boost::vertices(g_))
+  {
+    if (v >= queryVertices_.size() && vertexStateProperty_[v])
+      numStates++;
+  }
+  report.add(MEMORY_STATES, numStates * MemoryReport::estimateStateBytes(si_));
+
+  // The predecessor and rank used by the disjoint sets are vertex properties
+  report.addAdjacencyList(g_);
+  report.transfer(MEMORY_VERTICES, MEMORY_DISJOINT_SETS, boost::num_vertices(g_) * 2 * sizeof(VertexIndexType));
+  frozen_.addToMemoryReport(report);
+  hierarchy_.addToMemoryReport(report);
+  bidirectional_.addToMemoryReport(report);
+  workspaceIndex_.addToMemoryReport(report);
+
+  const NearestNeighborsRealVector *nnRealVector = dynamic_cast<const NearestNeighborsRealVector *>(nn_.get());
+  if (nnRealVector)
+    report.add(MEMORY_NEAREST_NEIGHBORS, nnRealVector->getMemoryBytes());
+  else
+    report.add(MEMORY_NEAREST_NEIGHBORS, MemoryReport::estimateNearestNeighborsBytes(nn_->size(), sizeof(TaskVertex)));
+
+  return report;
 }
 
 }  // namespace bolt
@@ -1534,7 +1836,7 @@ void otb::TaskAstarVisitor::discover_vertex(TaskVertex v, const TaskAdjList &) c
   // Statistics
   parent_->recordNodeOpened();
 
-  if (parent_->visualizeAstar_)
+  if (BOLT_VISUALIZE(parent_->visualizeAstar_))
     parent_->getVisual()->viz4()->state(parent_->getState(v), tools::SMALL, tools::GREEN, 1);
 }
 
@@ -1542,7 +1844,7 @@ void otb::TaskAstarVisitor::examine_vertex(TaskVertex v, const TaskAdjList &) co
 {
   parent_->recordNodeClosed();  // Statistics
 
-  if (parent_->visualizeAstar_)  // Visualize
+  if (BOLT_VISUALIZE(parent_->visualizeAstar_))  // Visualize
   {
     // Show state
     parent_->visualizeVertex(v, 4 /*windowID*/);
@@ -88,7 +88,7 @@ bool VertexDiscretizer::generateGrid(std::size_t indent)
     si_->setup();
   }
 
-  if (numThreads_ > 1 && visualizeGridGeneration_)
+  if (numThreads_ > 1 && BOLT_VISUALIZE(visualizeGridGeneration_))
   {
     OMPL_WARN("Visualizing in non-thread-safe manner. Auto reduced to 1 thread for debug mode");
     numThreads_ = 1;
@@ -239,6 +239,7 @@ void VertexDiscretizer::generateVerticesThread(std::size_t threadID, double star
                                                base::SpaceInformationPtr si, std::size_t indent)
 {
   BOLT_FUNC(indent, vThread_, "generateVerticesThread()");
+  ScopedCheckSite site(SITE_DISCRETIZATION);
 
   std::size_t jointID = 0;
   ob::RealVectorBounds bounds = si->getStateSpace()->getBounds();
@@ -349,7 +350,7 @@ void VertexDiscretizer::recursiveDiscretization(std::size_t threadID, std::vecto
   }
 }
 
-void VertexDiscretizer::createState(std::size_t threadID, std::vector<double> &values, base::SpaceInformationPtr si,
+void VertexDiscretizer::createState(std::size_t /*threadID*/, std::vector<double> &values, base::SpaceInformationPtr si,
                                     base::State *candidateState, std::size_t indent)
 {
   BOLT_FUNC(indent, vThread_, "createState()");
@@ -364,14 +365,14 @@ void VertexDiscretizer::createState(std::size_t threadID, std::vector<double> &v
     BOLT_ERROR(indent, vThread_, "Rejected because of validity");
 
     // Visualize
-    if (visualizeGridGeneration_)
+    if (BOLT_VISUALIZE(visualizeGridGeneration_))
     {
       // Candidate node rejected
       visual_->viz1()->state(candidateState, LARGE, RED, 0);
       visual_->viz1()->state(candidateState, ROBOT, RED, 0);
       visual_->viz1()->trigger();
 
-      if (visualizeGridGenerationWait_)
+      if (BOLT_VISUALIZE(visualizeGridGenerationWait_))
         visual_->waitForUserFeedback("rejected");
       else
         usleep(0.001 * 1000000);
@@ -385,14 +386,14 @@ void VertexDiscretizer::createState(std::size_t threadID, std::vector<double> &v
     BOLT_WARN(indent, vThread_, "Rejected because of clearance " << dist << " required: " << clearance_);
 
     // Visualize
-    if (visualizeGridGeneration_)
+    if (BOLT_VISUALIZE(visualizeGridGeneration_))
     {
       // Candidate node rejected
       visual_->viz1()->state(candidateState, LARGE, YELLOW, 0);
       visual_->viz1()->state(candidateState, ROBOT, YELLOW, 0);
       visual_->viz1()->trigger();
 
-      if (visualizeGridGenerationWait_)
+      if (BOLT_VISUALIZE(visualizeGridGenerationWait_))
         visual_->waitForUserFeedback("clearance");
       else
         usleep(0.001 * 1000000);
@@ -411,13 +412,13 @@ void VertexDiscretizer::createState(std::size_t threadID, std::vector<double> &v
   }
 
   // Visualize
-  if (visualizeGridGeneration_)
+  if (BOLT_VISUALIZE(visualizeGridGeneration_))
   {
     visual_->viz1()->state(candidateState, LARGE, GREEN, 0);
     visual_->viz1()->state(candidateState, ROBOT, GREEN, 0);
     visual_->viz1()->trigger();
 
-    if (visualizeGridGenerationWait_)
+    if (BOLT_VISUALIZE(visualizeGridGenerationWait_))
       visual_->waitForUserFeedback("accepted");
     else
       usleep(0.01 * 1000000);
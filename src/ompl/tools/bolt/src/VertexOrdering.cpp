@@ -0,0 +1,261 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2016, University of Colorado, Boulder
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the Univ of CO, Boulder nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+/* Author: Dave Coleman <dave@dav.ee>
+   Desc:   Renumbering of roadmap vertices so that nearby vertices are nearby in memory
+*/
+
+// OMPL
+#include <ompl/tools/bolt/VertexOrdering.h>
+
+// C++
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <utility>
+
+namespace ompl
+{
+namespace tools
+{
+namespace bolt
+{
+namespace
+{
+/** \brief Skilling's transform of quantized coordinates into the transposed Hilbert index, in place */
+void axesToTranspose(std::vector<std::uint32_t> &x, std::size_t bits)
+{
+  const std::size_t n = x.size();
+  const std::uint32_t m = 1u << (bits - 1);
+
+  // Inverse undo
+  for (std::uint32_t q = m; q > 1; q >>= 1)
+  {
+    const std::uint32_t p = q - 1;
+    for (std::size_t i = 0; i < n; ++i)
+    {
+      if (x[i] & q)
+        x[0] ^= p;  // invert
+      else
+      {
+        const std::uint32_t t = (x[0] ^ x[i]) & p;  // exchange
+        x[0] ^= t;
+        x[i] ^= t;
+      }
+    }
+  }
+
+  // Gray encode
+  for (std::size_t i = 1; i < n; ++i)
+    x[i] ^= x[i - 1];
+  std::uint32_t t = 0;
+  for (std::uint32_t q = m; q > 1; q >>= 1)
+    if (x[n - 1] & q)
+      t ^= q - 1;
+  for (std::size_t i = 0; i < n; ++i)
+    x[i] ^= t;
+}
+
+/** \brief Order vertices by visiting each component breadth first, neighbors by increasing degree */
+std::vector<SparseVertex> breadthFirstOrder(const SparseAdjList &g, const std::vector<SparseVertex> &vertices)
+{
+  std::vector<std::pair<std::size_t, SparseVertex> > byDegree;
+  byDegree.reserve(vertices.size());
+  for (std::size_t i = 0; i < vertices.size(); ++i)
+    byDegree.push_back(std::make_pair(boost::out_degree(vertices[i], g), vertices[i]));
+  std::sort(byDegree.begin(), byDegree.end());
+
+  // Query and deleted vertices are never entered
+  std::vector<bool> visited(boost::num_vertices(g), true);
+  for (std::size_t i = 0; i < vertices.size(); ++i)
+    visited[vertices[i]] = false;
+  std::vector<SparseVertex> order;
+  order.reserve(vertices.size());
+  std::vector<std::pair<std::size_t, SparseVertex> > neighbors;
+  for (std::size_t i = 0; i < byDegree.size(); ++i)
+  {
+    if (visited[byDegree[i].second])
+      continue;
+
+    // Vertices are appended as they are discovered, so the order is also the queue
+    std::size_t head = order.size();
+    visited[byDegree[i].second] = true;
+    order.push_back(byDegree[i].second);
+    while (head < order.size())
+    {
+      const SparseVertex v = order[head++];
+      neighbors.clear();
+      SparseAdjList::adjacency_iterator neighbor, end;
+      for (boost::tie(neighbor, end) = boost::adjacent_vertices(v, g); neighbor != end; ++neighbor)
+        if (!visited[*neighbor])
+          neighbors.push_back(std::make_pair(boost::out_degree(*neighbor, g), *neighbor));
+      std::sort(neighbors.begin(), neighbors.end());
+      for (std::size_t j = 0; j < neighbors.size(); ++j)
+      {
+        if (visited[neighbors[j].second])  // listed twice through parallel edges
+          continue;
+        visited[neighbors[j].second] = true;
+        order.push_back(neighbors[j].second);
+      }
+    }
+  }
+  return order;
+}
+}  // namespace
+
+std::string getVertexOrderName(VertexOrder order)
+{
+  switch (order)
+  {
+    case ORDER_INSERTION:
+      return "insertion";
+    case ORDER_HILBERT:
+      return "hilbert";
+    case ORDER_BFS:
+      return "bfs";
+  }
+  return "unknown";
+}
+
+bool parseVertexOrder(const std::string &name, VertexOrder &order)
+{
+  for (int i = ORDER_INSERTION; i <= ORDER_BFS; ++i)
+  {
+    if (getVertexOrderName(static_cast<VertexOrder>(i)) == name)
+    {
+      order = static_cast<VertexOrder>(i);
+      return true;
+    }
+  }
+  return false;
+}
+
+std::vector<std::size_t> getHilbertOrder(const std::vector<std::vector<double> > &points)
+{
+  std::vector<std::size_t> order(points.size());
+  for (std::size_t i = 0; i < order.size(); ++i)
+    order[i] = i;
+  if (points.empty() || points.front().empty())
+    return order;
+
+  const std::size_t dimension = std::min<std::size_t>(points.front().size(), 64);
+  const std::size_t bits = std::max<std::size_t>(1, std::min<std::size_t>(16, 64 / dimension));
+  const double cells = static_cast<double>((1u << bits) - 1);
+
+  // Bounding box
+  std::vector<double> low(dimension, std::numeric_limits<double>::infinity());
+  std::vector<double> high(dimension, -std::numeric_limits<double>::infinity());
+  for (std::size_t i = 0; i < points.size(); ++i)
+    for (std::size_t d = 0; d < dimension; ++d)
+    {
+      low[d] = std::min(low[d], points[i][d]);
+      high[d] = std::max(high[d], points[i][d]);
+    }
+
+  // Interleave the transposed index into one key, most significant bits first
+  std::vector<std::pair<std::uint64_t, std::size_t> > keys(points.size());
+  std::vector<std::uint32_t> x(dimension);
+  for (std::size_t i = 0; i < points.size(); ++i)
+  {
+    for (std::size_t d = 0; d < dimension; ++d)
+    {
+      const double range = high[d] - low[d];
+      x[d] = range > 0 ? static_cast<std::uint32_t>((points[i][d] - low[d]) / range * cells + 0.5) : 0;
+    }
+    axesToTranspose(x, bits);
+
+    std::uint64_t key = 0;
+    for (std::size_t b = bits; b-- > 0;)
+      for (std::size_t d = 0; d < dimension; ++d)
+        key = (key << 1) | ((x[d] >> b) & 1u);
+    keys[i] = std::make_pair(key, i);
+  }
+
+  std::sort(keys.begin(), keys.end());
+  for (std::size_t i = 0; i < keys.size(); ++i)
+    order[i] = keys[i].second;
+  return order;
+}
+
+std::vector<SparseVertex> computeVertexOrder(const SparseAdjList &g, const base::SpaceInformationPtr &si,
+                                             std::size_t numQueryVertices, VertexOrder order)
+{
+  const std::size_t numVertices = boost::num_vertices(g);
+  std::vector<SparseVertex> newIndex(numVertices);
+  for (std::size_t v = 0; v < numVertices; ++v)
+    newIndex[v] = v;
+  if (order == ORDER_INSERTION)
+    return newIndex;
+
+  // Only vertices that still have a state are reordered
+  std::vector<SparseVertex> vertices;
+  std::vector<SparseVertex> deleted;
+  for (std::size_t v = numQueryVertices; v < numVertices; ++v)
+  {
+    if (boost::get(vertex_state_t(), g, v))
+      vertices.push_back(v);
+    else
+      deleted.push_back(v);
+  }
+
+  std::vector<SparseVertex> ordered;
+  if (order == ORDER_HILBERT)
+  {
+    const base::StateSpacePtr &space = si->getStateSpace();
+    const std::size_t numValues = space->getValueLocations().size();
+    std::vector<std::vector<double> > points(vertices.size(), std::vector<double>(numValues));
+    for (std::size_t i = 0; i < vertices.size(); ++i)
+    {
+      const base::State *state = boost::get(vertex_state_t(), g, vertices[i]);
+      for (std::size_t j = 0; j < numValues; ++j)
+        points[i][j] = *space->getValueAddressAtIndex(state, j);
+    }
+
+    const std::vector<std::size_t> hilbert = getHilbertOrder(points);
+    ordered.reserve(vertices.size());
+    for (std::size_t i = 0; i < hilbert.size(); ++i)
+      ordered.push_back(vertices[hilbert[i]]);
+  }
+  else
+    ordered = breadthFirstOrder(g, vertices);
+
+  ordered.insert(ordered.end(), deleted.begin(), deleted.end());
+  for (std::size_t i = 0; i < ordered.size(); ++i)
+    newIndex[ordered[i]] = numQueryVertices + i;
+  return newIndex;
+}
+
+}  // namespace bolt
+}  // namespace tools
+}  // namespace ompl
@@ -0,0 +1,157 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2016, University of Colorado, Boulder
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the Univ of CO, Boulder nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+/* Author: Dave Coleman <dave@dav.ee>
+   Desc:   Spatial hash from regions of the workspace to the roadmap edges whose motions sweep through them
+*/
+
+// OMPL
+#include <ompl/tools/bolt/WorkspaceIndex.h>
+
+// C++
+#include <cmath>
+#include <limits>
+
+namespace ompl
+{
+namespace tools
+{
+namespace bolt
+{
+namespace
+{
+/** \brief Cells along each axis either side of the origin that have distinct keys */
+const long CELL_LIMIT = 1L << 20;
+}  // namespace
+
+void WorkspaceIndex::clear(double cellSize)
+{
+  cellSize_ = cellSize;
+  edges_.clear();
+  cells_.clear();
+  visits_.clear();
+  lookupID_ = 0;
+}
+
+std::uint64_t WorkspaceIndex::getKey(long x, long y, long z) const
+{
+  const std::uint64_t mask = (1u << 21) - 1;
+  return (static_cast<std::uint64_t>(x + CELL_LIMIT) & mask) << 42 |
+         (static_cast<std::uint64_t>(y + CELL_LIMIT) & mask) << 21 | (static_cast<std::uint64_t>(z + CELL_LIMIT) & mask);
+}
+
+bool WorkspaceIndex::getCellRange(const WorkspaceBox &box, long low[3], long high[3]) const
+{
+  for (std::size_t i = 0; i < 3; ++i)
+  {
+    if (!(box.low_[i] <= box.high_[i]))
+      return false;
+
+    // Clamped, so cells far outside the limit share keys with cells at it, which only adds false positives
+    const double limit = static_cast<double>(CELL_LIMIT - 1);
+    low[i] = static_cast<long>(std::max(-limit, std::min(limit, std::floor(box.low_[i] / cellSize_))));
+    high[i] = static_cast<long>(std::max(-limit, std::min(limit, std::floor(box.high_[i] / cellSize_))));
+  }
+  return true;
+}
+
+void WorkspaceIndex::addEdge(std::size_t v1, std::size_t v2, const std::vector<WorkspaceBox> &boxes)
+{
+  const Index e = edges_.size();
+  edges_.push_back(std::make_pair(v1, v2));
+  visits_.push_back(0);
+
+  long low[3], high[3];
+  for (std::size_t i = 0; i < boxes.size(); ++i)
+  {
+    if (!getCellRange(boxes[i], low, high))
+      continue;
+
+    for (long x = low[0]; x <= high[0]; ++x)
+      for (long y = low[1]; y <= high[1]; ++y)
+        for (long z = low[2]; z <= high[2]; ++z)
+        {
+          // Boxes of one edge overlap, so the edge may already be the last one listed in the cell
+          std::vector<Index> &cell = cells_[getKey(x, y, z)];
+          if (cell.empty() || cell.back() != e)
+            cell.push_back(e);
+        }
+  }
+}
+
+void WorkspaceIndex::getEdges(const WorkspaceBox &region, std::vector<VertexPair> &edges)
+{
+  edges.clear();
+  long low[3], high[3];
+  if (!getCellRange(region, low, high))
+    return;
+
+  if (lookupID_ == std::numeric_limits<std::uint32_t>::max())
+  {
+    visits_.assign(visits_.size(), 0);
+    lookupID_ = 0;
+  }
+  lookupID_++;
+
+  for (long x = low[0]; x <= high[0]; ++x)
+    for (long y = low[1]; y <= high[1]; ++y)
+      for (long z = low[2]; z <= high[2]; ++z)
+      {
+        boost::unordered_map<std::uint64_t, std::vector<Index> >::const_iterator cell = cells_.find(getKey(x, y, z));
+        if (cell == cells_.end())
+          continue;
+        for (std::size_t i = 0; i < cell->second.size(); ++i)
+        {
+          const Index e = cell->second[i];
+          if (visits_[e] == lookupID_)
+            continue;
+          visits_[e] = lookupID_;
+          edges.push_back(edges_[e]);
+        }
+      }
+}
+
+void WorkspaceIndex::addToMemoryReport(MemoryReport &report) const
+{
+  std::size_t bytes = edges_.capacity() * sizeof(VertexPair) + visits_.capacity() * sizeof(std::uint32_t) +
+                      MemoryReport::estimateHashMapBytes(cells_);
+  for (boost::unordered_map<std::uint64_t, std::vector<Index> >::const_iterator cell = cells_.begin();
+       cell != cells_.end(); ++cell)
+    bytes += cell->second.capacity() * sizeof(Index) + MemoryReport::ALLOCATION_OVERHEAD;
+  report.add(MEMORY_WORKSPACE_INDEX, bytes);
+}
+
+}  // namespace bolt
+}  // namespace tools
+}  // namespace ompl